@@ -0,0 +1,173 @@
+// Tests that a $group pushed down into the SBE query plan returns the same results as the $group
+// executed by the classic engine, for each of the accumulators which can be pushed down, and that
+// the same holds for a pushed down $unwind.
+
+(function() {
+"use strict";
+
+load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
+
+const isSBEEnabled = checkSBEEnabled(db);
+if (!isSBEEnabled) {
+    jsTestLog("Skipping test because the SBE feature flag is disabled");
+    return;
+}
+
+const coll = db.sbe_group_pushdown;
+coll.drop();
+
+assert.commandWorked(coll.insert([
+    {_id: 0, a: 1, b: 5, s: "abc"},
+    {_id: 1, a: 2, b: -1, s: "ABC"},
+    {_id: 2, a: 1, b: 3.5, s: "def"},
+    {_id: 3, a: 3, b: NumberLong(7), s: "abc"},
+    {_id: 4, a: 2, b: null, s: "Def"},
+    {_id: 5, a: 1, s: "ghi"},
+    {_id: 6, a: 3, b: "str", s: "abc"},
+    {_id: 7, b: NumberDecimal("2.5"), s: "def"},
+    {_id: 8, a: null, b: [1, 2], s: "ghi"},
+    {_id: 9, a: 2, b: {x: 1}, s: "ABC"},
+    {_id: 10, a: 1, b: 5, s: "abc"},
+]));
+
+// Returns the 'slotBasedPlan' string from anywhere in the explain output of 'pipeline'.
+function getSlotBasedPlan(pipeline, options) {
+    const explain = coll.explain().aggregate(pipeline, options);
+    let plan = null;
+    (function find(obj) {
+        if (plan !== null || typeof obj !== "object" || obj === null) {
+            return;
+        }
+        if (obj.hasOwnProperty("slotBasedPlan")) {
+            plan = obj.slotBasedPlan.stages;
+            return;
+        }
+        Object.values(obj).forEach(find);
+    })(explain);
+    assert.neq(plan, null, explain);
+    return plan;
+}
+
+function bsonWoCompareValues(x, y) {
+    return bsonWoCompare({_: x}, {_: y});
+}
+
+// The order of the groups, and of the values accumulated by $addToSet, is not defined. With a
+// case-insensitive collation, any of the equal strings may be kept, so strings are lowercased.
+function normalize(results, unorderedFields, caseInsensitive) {
+    const canonical = (value) => {
+        if (caseInsensitive && typeof value === "string") {
+            return value.toLowerCase();
+        }
+        return Array.isArray(value) ? value.map(canonical) : value;
+    };
+    results = results.map((doc) => {
+        const out = {};
+        Object.keys(doc).forEach((field) => {
+            out[field] = canonical(doc[field]);
+        });
+        unorderedFields.forEach((field) => out[field].sort(bsonWoCompareValues));
+        return out;
+    });
+    return results.sort((x, y) => bsonWoCompareValues(x._id, y._id));
+}
+
+function setForceClassicEngine(value) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryForceClassicEngine: value}));
+}
+
+function assertSameResultsAsClassic(
+    {pipeline, options = {}, unorderedFields = [], pushedDownStages = ["group"]}) {
+    setForceClassicEngine(false);
+    const plan = getSlotBasedPlan(pipeline, options);
+    pushedDownStages.forEach((stage) => assert(plan.includes(stage), plan));
+    const caseInsensitive = options.hasOwnProperty("collation");
+    const sbeResults =
+        normalize(coll.aggregate(pipeline, options).toArray(), unorderedFields, caseInsensitive);
+
+    setForceClassicEngine(true);
+    const classicResults =
+        normalize(coll.aggregate(pipeline, options).toArray(), unorderedFields, caseInsensitive);
+    assert.eq(sbeResults, classicResults, pipeline);
+}
+
+const originalForceClassicEngine =
+    assert
+        .commandWorked(db.adminCommand({getParameter: 1, internalQueryForceClassicEngine: 1}))
+        .internalQueryForceClassicEngine;
+
+try {
+    // $first and $last follow the order of the documents, which is fixed by the $sort absorbed
+    // into the query.
+    [{$min: "$b"},
+     {$max: "$b"},
+     {$first: "$b"},
+     {$last: "$b"},
+     {$push: "$b"},
+     {$addToSet: "$b"},
+    ].forEach((accumulator) => {
+        const unorderedFields = accumulator.hasOwnProperty("$addToSet") ? ["acc"] : [];
+        assertSameResultsAsClassic({
+            pipeline: [{$sort: {_id: 1}}, {$group: {_id: "$a", acc: accumulator}}],
+            unorderedFields: unorderedFields
+        });
+        assertSameResultsAsClassic({
+            pipeline: [{$sort: {_id: -1}}, {$group: {_id: "$s", acc: accumulator}}],
+            unorderedFields: unorderedFields
+        });
+        assertSameResultsAsClassic({
+            pipeline: [
+                {$match: {b: {$ne: null}}},
+                {$sort: {_id: 1}},
+                {$group: {_id: null, acc: accumulator}}
+            ],
+            unorderedFields: unorderedFields
+        });
+    });
+
+    // All of the accumulators in the same $group, grouped by an expression.
+    assertSameResultsAsClassic({
+        pipeline: [
+            {$sort: {_id: 1}},
+            {
+                $group: {
+                    _id: {$add: ["$a", 1]},
+                    min: {$min: "$s"},
+                    max: {$max: "$s"},
+                    first: {$first: "$s"},
+                    last: {$last: "$s"},
+                    push: {$push: "$s"},
+                    set: {$addToSet: "$s"}
+                }
+            }
+        ],
+        unorderedFields: ["set"]
+    });
+
+    // A case-insensitive collation applies to the group key, $min, $max and $addToSet.
+    assertSameResultsAsClassic({
+        pipeline: [
+            {$sort: {_id: 1}},
+            {$group: {_id: "$s", min: {$min: "$s"}, max: {$max: "$s"}, set: {$addToSet: "$s"}}}
+        ],
+        options: {collation: {locale: "en_US", strength: 2}},
+        unorderedFields: ["set"]
+    });
+
+    // An $unwind of a top-level field, on its own and followed by a $group. The documents of the
+    // same _id are produced in the order of the array by both engines.
+    [{$unwind: "$b"},
+     {$unwind: {path: "$b", preserveNullAndEmptyArrays: true}},
+    ].forEach((unwind) => {
+        assertSameResultsAsClassic(
+            {pipeline: [{$sort: {_id: 1}}, unwind], pushedDownStages: ["unwind"]});
+        assertSameResultsAsClassic({
+            pipeline: [{$sort: {_id: 1}}, unwind, {$group: {_id: "$a", acc: {$push: "$b"}}}],
+            pushedDownStages: ["unwind", "group"]
+        });
+    });
+} finally {
+    setForceClassicEngine(originalForceClassicEngine);
+}
+}());
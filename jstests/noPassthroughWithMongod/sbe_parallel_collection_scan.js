@@ -0,0 +1,81 @@
+// Tests that a collection scan split across exchange producers by
+// 'internalQuerySlotBasedExecutionParallelScanDegree' returns the same documents as the serial
+// scan.
+
+(function() {
+"use strict";
+
+load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
+
+const isSBEEnabled = checkSBEEnabled(db);
+if (!isSBEEnabled) {
+    jsTestLog("Skipping test because the SBE feature flag is disabled");
+    return;
+}
+
+const coll = db.sbe_parallel_collection_scan;
+coll.drop();
+
+const numDocs = 2000;
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({_id: i, a: i % 7, b: "str" + i});
+}
+assert.commandWorked(coll.insert(docs));
+
+function setParallelScanParams(degree, minRecords) {
+    assert.commandWorked(db.adminCommand({
+        setParameter: 1,
+        internalQuerySlotBasedExecutionParallelScanDegree: degree,
+        internalQuerySlotBasedExecutionParallelScanMinRecords: minRecords,
+    }));
+}
+
+function getSlotBasedPlan(cursor) {
+    const explain = cursor.explain();
+    assert(explain.queryPlanner.winningPlan.hasOwnProperty("slotBasedPlan"), explain);
+    return explain.queryPlanner.winningPlan.slotBasedPlan.stages;
+}
+
+// The exchange does not preserve the storage order, so the results are compared by _id.
+function getSortedResults(filter) {
+    return coll.find(filter).toArray().sort((x, y) => x._id - y._id);
+}
+
+const originalParams = assert.commandWorked(db.adminCommand({
+    getParameter: 1,
+    internalQuerySlotBasedExecutionParallelScanDegree: 1,
+    internalQuerySlotBasedExecutionParallelScanMinRecords: 1,
+}));
+
+try {
+    const filters = [{}, {a: 3}, {a: {$gt: 4}, b: {$ne: "str10"}}, {a: 100}];
+
+    setParallelScanParams(1, 0);
+    const serialResults = filters.map((filter) => {
+        const plan = getSlotBasedPlan(coll.find(filter));
+        assert(!plan.includes("exchange"), plan);
+        return getSortedResults(filter);
+    });
+
+    setParallelScanParams(4, 100);
+    filters.forEach((filter, i) => {
+        const plan = getSlotBasedPlan(coll.find(filter));
+        assert(plan.includes("exchange"), plan);
+        assert(plan.includes("pscan"), plan);
+        assert.eq(getSortedResults(filter), serialResults[i], filter);
+    });
+
+    // A $natural hint asks for the storage order, which the exchange does not preserve.
+    let plan = getSlotBasedPlan(coll.find().hint({$natural: 1}));
+    assert(!plan.includes("exchange"), plan);
+
+    // A collection with fewer records than the threshold is scanned serially.
+    setParallelScanParams(4, numDocs + 1);
+    plan = getSlotBasedPlan(coll.find());
+    assert(!plan.includes("exchange"), plan);
+} finally {
+    setParallelScanParams(originalParams.internalQuerySlotBasedExecutionParallelScanDegree,
+                          originalParams.internalQuerySlotBasedExecutionParallelScanMinRecords);
+}
+}());
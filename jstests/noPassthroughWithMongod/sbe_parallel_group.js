@@ -0,0 +1,138 @@
+// Tests that a $group pushed down over a parallel collection scan is aggregated partially below the
+// exchange and merged above it, and that it returns the same results as the serial plan.
+
+(function() {
+"use strict";
+
+load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
+
+const isSBEEnabled = checkSBEEnabled(db);
+if (!isSBEEnabled) {
+    jsTestLog("Skipping test because the SBE feature flag is disabled");
+    return;
+}
+
+const coll = db.sbe_parallel_group;
+coll.drop();
+
+const numDocs = 2000;
+const strings = ["abc", "ABC", "def", "Def", "ghi"];
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({_id: i, a: i % 7, n: (i * 37) % 1000, s: strings[i % strings.length]});
+}
+assert.commandWorked(coll.insert(docs));
+
+function setParallelScanParams(degree, minRecords) {
+    assert.commandWorked(db.adminCommand({
+        setParameter: 1,
+        internalQuerySlotBasedExecutionParallelScanDegree: degree,
+        internalQuerySlotBasedExecutionParallelScanMinRecords: minRecords,
+    }));
+}
+
+// Returns the 'slotBasedPlan' string from anywhere in the explain output of 'pipeline'.
+function getSlotBasedPlan(pipeline, options = {}) {
+    const explain = coll.explain().aggregate(pipeline, options);
+    let plan = null;
+    (function find(obj) {
+        if (plan !== null || typeof obj !== "object" || obj === null) {
+            return;
+        }
+        if (obj.hasOwnProperty("slotBasedPlan")) {
+            plan = obj.slotBasedPlan.stages;
+            return;
+        }
+        Object.values(obj).forEach(find);
+    })(explain);
+    assert.neq(plan, null, explain);
+    return plan;
+}
+
+function assertTwoPhaseGroup(pipeline, options = {}) {
+    const plan = getSlotBasedPlan(pipeline, options);
+    const exchangePos = plan.indexOf("exchange");
+    assert.gte(exchangePos, 0, plan);
+    assert.gte(plan.lastIndexOf("group", exchangePos), 0, "no merge group above exchange: " + plan);
+    assert.gte(plan.indexOf("group", exchangePos), 0, "no partial group below exchange: " + plan);
+    assert(plan.includes("pscan"), plan);
+}
+
+function assertSerialGroup(pipeline, options = {}) {
+    const plan = getSlotBasedPlan(pipeline, options);
+    assert(!plan.includes("exchange"), plan);
+    assert(plan.includes("group"), plan);
+}
+
+// Puts the results in a canonical form: the groups are sorted by _id and the accumulated arrays,
+// whose order depends on the order the documents were read in, are sorted. With a
+// case-insensitive collation any of the equal strings may be kept, so the strings are lowercased.
+function normalize(results, caseInsensitive) {
+    const canonical = (value) => {
+        if (typeof value === "string") {
+            return caseInsensitive ? value.toLowerCase() : value;
+        }
+        if (Array.isArray(value)) {
+            return value.map(canonical).sort();
+        }
+        return value;
+    };
+    return results
+        .map((doc) => {
+            const out = {};
+            Object.keys(doc).forEach((field) => {
+                out[field] = canonical(doc[field]);
+            });
+            return out;
+        })
+        .sort((x, y) => bsonWoCompare({_: x._id}, {_: y._id}));
+}
+
+const originalParams = assert.commandWorked(db.adminCommand({
+    getParameter: 1,
+    internalQuerySlotBasedExecutionParallelScanDegree: 1,
+    internalQuerySlotBasedExecutionParallelScanMinRecords: 1,
+}));
+
+const caseInsensitive = {collation: {locale: "en_US", strength: 2}};
+
+// Pipelines whose accumulators can all be merged, and the options they are run with.
+const mergeable = [
+    {pipeline: [{$group: {_id: "$a", min: {$min: "$n"}, max: {$max: "$n"}}}]},
+    {pipeline: [{$group: {_id: "$a", pushed: {$push: "$n"}, set: {$addToSet: "$s"}}}]},
+    {pipeline: [{$match: {n: {$gt: 500}}}, {$group: {_id: "$s", set: {$addToSet: "$a"}}}]},
+    {pipeline: [{$group: {_id: null, min: {$min: "$_id"}, max: {$max: "$_id"}}}]},
+    {
+        pipeline: [{$group: {_id: "$a", set: {$addToSet: "$s"}, min: {$min: "$s"}}}],
+        options: caseInsensitive
+    },
+];
+
+// Pipelines which depend on the order of the documents and must keep the serial plan.
+const orderDependent = [
+    [{$group: {_id: "$a", first: {$first: "$n"}}}],
+    [{$group: {_id: "$a", last: {$last: "$n"}, max: {$max: "$n"}}}],
+];
+
+try {
+    setParallelScanParams(1, 0);
+    const serialResults = mergeable.map(({pipeline, options = {}}) => {
+        assertSerialGroup(pipeline, options);
+        return normalize(coll.aggregate(pipeline, options).toArray(),
+                         options.hasOwnProperty("collation"));
+    });
+
+    setParallelScanParams(4, 100);
+    mergeable.forEach(({pipeline, options = {}}, i) => {
+        assertTwoPhaseGroup(pipeline, options);
+        const results = normalize(coll.aggregate(pipeline, options).toArray(),
+                                  options.hasOwnProperty("collation"));
+        assert.eq(results, serialResults[i], pipeline);
+    });
+
+    orderDependent.forEach((pipeline) => assertSerialGroup(pipeline));
+} finally {
+    setParallelScanParams(originalParams.internalQuerySlotBasedExecutionParallelScanDegree,
+                          originalParams.internalQuerySlotBasedExecutionParallelScanMinRecords);
+}
+}());
@@ -0,0 +1,43 @@
+/**
+ * Tests that a node added with the 'fileCopyBased' initial sync method copies the data files of its
+ * sync source and shuts down, and that once it is restarted the copies replace its data files and
+ * it replicates the writes made since.
+ *
+ * @tags: [requires_persistence, requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const coll = primary.getDB("test").getCollection("coll");
+assert.commandWorked(coll.createIndex({a: 1}));
+const docs = [];
+for (let i = 0; i < 100; ++i) {
+    docs.push({_id: i, a: i});
+}
+assert.commandWorked(coll.insert(docs));
+
+const secondary = rst.add({
+    rsConfig: {priority: 0, votes: 0},
+    setParameter: {initialSyncMethod: "fileCopyBased", numInitialSyncAttempts: 1},
+});
+rst.reInitiate();
+
+// The node shuts down cleanly once it has copied the data files of the primary.
+assert.eq(0, waitProgram(secondary.pid));
+
+assert.commandWorked(coll.insert({_id: 100, a: 100}));
+rst.start(secondary, {}, true /* restart */);
+rst.awaitSecondaryNodes();
+rst.awaitReplication();
+
+const secondaryColl = rst.getSecondary().getDB("test").getCollection("coll");
+assert.eq(101, secondaryColl.find().itcount());
+assert.eq(2, secondaryColl.getIndexes().length);
+
+rst.stopSet();
+})();
@@ -0,0 +1,448 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/bsoncolumn.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/base/data_view.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+constexpr uint8_t kDeltaControl = 0x80;
+constexpr uint8_t kRepeatControl = 0xC0;
+constexpr uint8_t kSkipControl = 0xE0;
+
+constexpr int kMaxDeltaCount = 0x3F;
+constexpr int kMaxRepeatCount = 0x1F;
+// 0xFF is the type byte of MinKey, so a skip block holds one value less than a repeat block.
+constexpr int kMaxSkipCount = 0x1E;
+
+bool isLiteral(uint8_t control) {
+    return control < kDeltaControl || control == static_cast<uint8_t>(MinKey);
+}
+
+bool supportsDelta(BSONType type) {
+    switch (type) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case Date:
+        case bsonTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the bits of a value whose type supports deltas. 32-bit integers are sign extended so
+// that the difference between two of them does not depend on their type.
+uint64_t valueBits(const BSONElement& elem) {
+    if (elem.type() == NumberInt) {
+        return static_cast<uint64_t>(
+            static_cast<int64_t>(ConstDataView(elem.value()).read<LittleEndian<int32_t>>()));
+    }
+    return ConstDataView(elem.value()).read<LittleEndian<uint64_t>>();
+}
+
+uint64_t encodeZigZag(uint64_t value) {
+    return (value << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+uint64_t decodeZigZag(uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+// A double which differs from the previous one only in a few of its low mantissa bits leaves
+// trailing zeros in the XOR, a double with the same sign and exponent leaves leading zeros.
+// Dropping the trailing zero nibbles keeps both cases short once varint encoded.
+boost::optional<uint64_t> encodeXor(uint64_t bits) {
+    if (bits == 0) {
+        return 0;
+    }
+    int nibbles = std::min(countTrailingZeros64(bits) / 4, 15);
+    uint64_t shifted = bits >> (4 * nibbles);
+    if (shifted >> 60) {
+        return boost::none;
+    }
+    return (shifted << 4) | nibbles;
+}
+
+uint64_t decodeXor(uint64_t encoded) {
+    return (encoded >> 4) << (4 * (encoded & 0xF));
+}
+
+void appendVarint(BufBuilder* builder, uint64_t value) {
+    while (value >= 0x80) {
+        builder->appendUChar(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    builder->appendUChar(static_cast<unsigned char>(value));
+}
+
+uint64_t readVarint(const char** pos, const char* end) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uassert(5754720, "Truncated varint in BSONColumn", *pos < end && shift < 64);
+        uint8_t byte = **pos;
+        ++*pos;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+// Reads the literal at 'pos' and validates that it fits in the binary.
+BSONElement readLiteral(const char* pos, const char* end) {
+    uassert(5754721,
+            "Invalid literal in BSONColumn",
+            isValidBSONType(static_cast<signed char>(*pos)) && end - pos >= 2 && pos[1] == '\0');
+    BSONElement elem(pos, 1, -1, BSONElement::CachedSizeTag{});
+    uassert(5754722, "Truncated literal in BSONColumn", elem.size() <= end - pos);
+    return elem;
+}
+
+}  // namespace
+
+BSONColumn::BSONColumn(BSONElement bin) : _name(bin.fieldNameStringData()) {
+    uassert(5754723,
+            "Invalid BSON type for column",
+            bin.type() == BinData && bin.binDataType() == BinDataType::Column);
+    _binary = bin.binData(_size);
+    uassert(5754724,
+            "BSONColumn data must be terminated by EOO",
+            _size > 0 && _binary[_size - 1] == EOO);
+}
+
+BSONColumn::Iterator BSONColumn::begin() const {
+    Iterator it{_binary, _binary + _size};
+    ++it;
+    return it;
+}
+
+BSONColumn::Iterator BSONColumn::end() const {
+    return Iterator{_binary + _size, _binary + _size};
+}
+
+size_t BSONColumn::size() const {
+    size_t count = 0;
+    const char* pos = _binary;
+    const char* end = _binary + _size;
+    while (true) {
+        uassert(5754725, "Unexpected end of BSONColumn", pos < end);
+        uint8_t control = *pos;
+        if (control == EOO) {
+            return count;
+        }
+
+        if (isLiteral(control)) {
+            pos += readLiteral(pos, end).size();
+            ++count;
+            continue;
+        }
+
+        ++pos;
+        if ((control & 0xC0) == kDeltaControl) {
+            int n = control & kMaxDeltaCount;
+            for (int i = 0; i < n; ++i) {
+                readVarint(&pos, end);
+            }
+            count += n;
+        } else {
+            count += control & kMaxRepeatCount;
+        }
+    }
+}
+
+BSONColumn::Iterator::Iterator(const char* pos, const char* end) : _pos(pos), _end(end) {}
+
+BSONColumn::Iterator::Iterator(const Iterator& other) {
+    *this = other;
+}
+
+BSONColumn::Iterator& BSONColumn::Iterator::operator=(const Iterator& other) {
+    _pos = other._pos;
+    _end = other._end;
+    _current = other._current;
+    _currentIsDecoded = other._currentIsDecoded;
+    _block = other._block;
+    _remaining = other._remaining;
+    _literal = other._literal;
+    _value = other._value;
+    _delta = other._delta;
+
+    // A decoded value must point at our own buffer rather than at the one of 'other'.
+    if (_currentIsDecoded) {
+        _materialize();
+    }
+    return *this;
+}
+
+BSONColumn::Iterator& BSONColumn::Iterator::operator++() {
+    if (_remaining == 0) {
+        uassert(5754726, "Unexpected end of BSONColumn", _pos < _end);
+        uint8_t control = *_pos;
+        if (control == EOO) {
+            _pos = _end;
+            _block = Block::kNone;
+            _current = BSONElement();
+            _currentIsDecoded = false;
+            return *this;
+        }
+
+        if (isLiteral(control)) {
+            _literal = readLiteral(_pos, _end);
+            _pos += _literal.size();
+            _block = Block::kNone;
+            _current = _literal;
+            _currentIsDecoded = false;
+            _value = supportsDelta(_literal.type()) ? valueBits(_literal) : 0;
+            _delta = 0;
+            return *this;
+        }
+
+        ++_pos;
+        if ((control & 0xC0) == kDeltaControl) {
+            _block = Block::kDelta;
+            _remaining = control & kMaxDeltaCount;
+        } else if ((control & 0xE0) == kRepeatControl) {
+            _block = Block::kRepeat;
+            _remaining = control & kMaxRepeatCount;
+        } else {
+            _block = Block::kSkip;
+            _remaining = control & kMaxRepeatCount;
+        }
+        uassert(5754727, "Empty block in BSONColumn", _remaining > 0);
+    }
+
+    --_remaining;
+    if (_block == Block::kSkip) {
+        _current = BSONElement();
+        _currentIsDecoded = false;
+        return *this;
+    }
+
+    uassert(5754728, "BSONColumn block is not preceded by a literal", !_literal.eoo());
+    _applyDelta(_block == Block::kDelta ? readVarint(&_pos, _end) : 0);
+    return *this;
+}
+
+BSONColumn::Iterator BSONColumn::Iterator::operator++(int) {
+    auto ret = *this;
+    operator++();
+    return ret;
+}
+
+void BSONColumn::Iterator::_applyDelta(uint64_t encoded) {
+    switch (_literal.type()) {
+        case NumberInt:
+        case NumberLong:
+            _value += decodeZigZag(encoded);
+            break;
+        case Date:
+        case bsonTimestamp:
+            _delta += decodeZigZag(encoded);
+            _value += _delta;
+            break;
+        case NumberDouble:
+            _value ^= decodeXor(encoded);
+            break;
+        default:
+            uassert(5754729,
+                    str::stream() << "BSONColumn delta for unsupported type "
+                                  << typeName(_literal.type()),
+                    encoded == 0);
+            _current = _literal;
+            _currentIsDecoded = false;
+            return;
+    }
+    _materialize();
+}
+
+void BSONColumn::Iterator::_materialize() {
+    auto type = _literal.type();
+    _decoded[0] = type;
+    _decoded[1] = '\0';
+    int valueSize = 8;
+    if (type == NumberInt) {
+        DataView(_decoded + 2).write<LittleEndian<int32_t>>(static_cast<int32_t>(_value));
+        valueSize = 4;
+    } else {
+        DataView(_decoded + 2).write<LittleEndian<uint64_t>>(_value);
+    }
+    _current = BSONElement(_decoded, 1, 2 + valueSize, BSONElement::CachedSizeTag{});
+    _currentIsDecoded = true;
+}
+
+BSONColumnBuilder::BSONColumnBuilder(StringData fieldName) : _fieldName(fieldName.toString()) {}
+
+BSONColumnBuilder& BSONColumnBuilder::append(BSONElement elem) {
+    invariant(!_finalized);
+    if (elem.eoo()) {
+        return skip();
+    }
+
+    ++_size;
+    auto type = elem.type();
+    if (type != _type) {
+        _appendLiteral(elem);
+        return *this;
+    }
+
+    switch (type) {
+        case NumberInt:
+        case NumberLong: {
+            uint64_t value = valueBits(elem);
+            _appendEncoded(encodeZigZag(value - _value));
+            _value = value;
+            break;
+        }
+        case Date:
+        case bsonTimestamp: {
+            uint64_t value = valueBits(elem);
+            uint64_t delta = value - _value;
+            _appendEncoded(encodeZigZag(delta - _delta));
+            _value = value;
+            _delta = delta;
+            break;
+        }
+        case NumberDouble: {
+            uint64_t value = valueBits(elem);
+            auto encoded = encodeXor(value ^ _value);
+            if (!encoded) {
+                _appendLiteral(elem);
+                break;
+            }
+            _appendEncoded(*encoded);
+            _value = value;
+            break;
+        }
+        default:
+            if (elem.valuesize() == _literal.len() &&
+                std::memcmp(elem.value(), _literal.buf(), _literal.len()) == 0) {
+                _appendEncoded(0);
+            } else {
+                _appendLiteral(elem);
+            }
+            break;
+    }
+    return *this;
+}
+
+BSONColumnBuilder& BSONColumnBuilder::skip() {
+    invariant(!_finalized);
+    ++_size;
+    _extendBlock(Block::kSkip);
+    return *this;
+}
+
+BSONBinData BSONColumnBuilder::finalize() {
+    if (!_finalized) {
+        _flushBlock();
+        _bufBuilder.appendChar(EOO);
+        _finalized = true;
+    }
+    return {_bufBuilder.buf(), _bufBuilder.len(), BinDataType::Column};
+}
+
+void BSONColumnBuilder::_appendLiteral(BSONElement elem) {
+    _flushBlock();
+
+    _type = elem.type();
+    _bufBuilder.appendChar(_type);
+    _bufBuilder.appendChar('\0');
+    _bufBuilder.appendBuf(elem.value(), elem.valuesize());
+
+    _literal.reset();
+    _literal.appendBuf(elem.value(), elem.valuesize());
+    _value = supportsDelta(_type) ? valueBits(elem) : 0;
+    _delta = 0;
+}
+
+void BSONColumnBuilder::_appendEncoded(uint64_t encoded) {
+    if (encoded == 0) {
+        _extendBlock(Block::kRepeat);
+        return;
+    }
+    _extendBlock(Block::kDelta);
+    appendVarint(&_blockDeltas, encoded);
+}
+
+void BSONColumnBuilder::_extendBlock(Block block) {
+    if (_block != block || _blockCount == _maxBlockCount(block)) {
+        _flushBlock();
+        _block = block;
+    }
+    ++_blockCount;
+}
+
+void BSONColumnBuilder::_flushBlock() {
+    switch (_block) {
+        case Block::kNone:
+            return;
+        case Block::kDelta:
+            _bufBuilder.appendUChar(kDeltaControl | _blockCount);
+            _bufBuilder.appendBuf(_blockDeltas.buf(), _blockDeltas.len());
+            _blockDeltas.reset();
+            break;
+        case Block::kRepeat:
+            _bufBuilder.appendUChar(kRepeatControl | _blockCount);
+            break;
+        case Block::kSkip:
+            _bufBuilder.appendUChar(kSkipControl | _blockCount);
+            break;
+    }
+    _block = Block::kNone;
+    _blockCount = 0;
+}
+
+int BSONColumnBuilder::_maxBlockCount(Block block) {
+    switch (block) {
+        case Block::kDelta:
+            return kMaxDeltaCount;
+        case Block::kRepeat:
+            return kMaxRepeatCount;
+        case Block::kSkip:
+            return kMaxSkipCount;
+        case Block::kNone:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <iterator>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+/**
+ * A column is a sequence of BSON values, typically all the values of one field of a time-series
+ * bucket, compressed into a BinData of subtype 'Column'. Missing values ("skips") are allowed so
+ * that several columns can be iterated side by side and stay aligned by position.
+ *
+ * The binary is a sequence of blocks terminated by an EOO byte:
+ *
+ *   literal := <type> 0x00 <value>         An uncompressed BSON element with an empty field name.
+ *   delta   := 0x80|n <varint> x n         n in [1, 63]. Each varint encodes the next value
+ *                                          relative to the previous one (see below).
+ *   repeat  := 0xC0|n                      n in [1, 31]. The next n values each have a zero delta.
+ *   skip    := 0xE0|n                      n in [1, 30]. The next n values are missing.
+ *
+ * The type byte of a literal is always below 0x80 except for MinKey (0xFF), which is why the skip
+ * count stops at 30. How a delta is applied depends on the type of the last literal:
+ *
+ *   NumberInt, NumberLong   zigzag encoded difference from the previous value.
+ *   Date, Timestamp         zigzag encoded difference from the previous difference, so that values
+ *                           taken at a regular interval compress to a single repeat block.
+ *   NumberDouble            XOR of the bits of the previous value, shifted right over its trailing
+ *                           zero nibbles, with the number of shifted nibbles in the low 4 bits.
+ *   any other type          not allowed, only repeats of the last literal.
+ */
+class BSONColumn {
+    friend class BSONColumnBuilder;
+
+    // The kinds of blocks that hold encoded values. Literals are not a block, they hold one value.
+    enum class Block { kNone, kDelta, kRepeat, kSkip };
+
+public:
+    /**
+     * Forward iterator over the values of a column. A missing value is returned as an EOO element.
+     *
+     * Values that are decoded from a delta or a repeat are materialized in a buffer owned by the
+     * iterator. They remain valid until the iterator is advanced or destroyed; copy them out (for
+     * example into a Value) if they need to outlive that.
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using value_type = BSONElement;
+        using pointer = const BSONElement*;
+        using reference = const BSONElement&;
+
+        Iterator(const Iterator& other);
+        Iterator& operator=(const Iterator& other);
+
+        reference operator*() const {
+            return _current;
+        }
+        pointer operator->() const {
+            return &_current;
+        }
+
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const {
+            return _pos == other._pos && _remaining == other._remaining;
+        }
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class BSONColumn;
+
+        Iterator(const char* pos, const char* end);
+
+        // Decodes the next value, applying 'encoded' as its delta for numeric types.
+        void _applyDelta(uint64_t encoded);
+
+        // Points '_current' at the materialized value in '_decoded'.
+        void _materialize();
+
+        const char* _pos;
+        const char* _end;
+
+        BSONElement _current;
+        bool _currentIsDecoded = false;
+
+        // The block being decoded and how many values it still holds.
+        Block _block = Block::kNone;
+        int _remaining = 0;
+
+        // The last literal and, for the types which support deltas, the bits of the last value
+        // and the last difference.
+        BSONElement _literal;
+        uint64_t _value = 0;
+        uint64_t _delta = 0;
+
+        // Type byte, empty field name and up to 8 bytes of value.
+        char _decoded[10];
+    };
+
+    /**
+     * Reads the column stored in 'bin', which must be BinData of subtype 'Column'. The data is not
+     * copied and must outlive the BSONColumn and its iterators.
+     */
+    explicit BSONColumn(BSONElement bin);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    /**
+     * Returns the number of values in the column, including missing ones. Runs in time linear in
+     * the size of the binary but does not decode any values.
+     */
+    size_t size() const;
+
+    StringData name() const {
+        return _name;
+    }
+
+private:
+    const char* _binary;
+    int _size;
+    StringData _name;
+};
+
+/**
+ * Builds the binary read by BSONColumn. Values are appended one at a time and are encoded as they
+ * come in; only the last value and the current block are buffered.
+ */
+class BSONColumnBuilder {
+public:
+    explicit BSONColumnBuilder(StringData fieldName);
+
+    /**
+     * Appends a value. An EOO element is appended as a missing value.
+     */
+    BSONColumnBuilder& append(BSONElement elem);
+
+    /**
+     * Appends a missing value.
+     */
+    BSONColumnBuilder& skip();
+
+    /**
+     * Returns the number of values appended so far, including missing ones.
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    StringData fieldName() const {
+        return _fieldName;
+    }
+
+    /**
+     * Terminates the column and returns its binary. The returned data is owned by the builder,
+     * which must not be appended to afterwards.
+     */
+    BSONBinData finalize();
+
+private:
+    using Block = BSONColumn::Block;
+
+    void _appendLiteral(BSONElement elem);
+
+    // Appends a value encoded against the previous one. A zero goes to a repeat block.
+    void _appendEncoded(uint64_t encoded);
+
+    // Adds one value to the current block, first flushing it if it is of another kind or full.
+    void _extendBlock(Block block);
+    void _flushBlock();
+
+    static int _maxBlockCount(Block block);
+
+    std::string _fieldName;
+    BufBuilder _bufBuilder;
+    size_t _size = 0;
+
+    // Copy of the last literal and the state needed to encode the next value against it.
+    BufBuilder _literal;
+    BSONType _type = EOO;
+    uint64_t _value = 0;
+    uint64_t _delta = 0;
+
+    // The block being accumulated.
+    Block _block = Block::kNone;
+    int _blockCount = 0;
+    BufBuilder _blockDeltas;
+
+    bool _finalized = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include <vector>
+
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class BSONColumnTest : public unittest::Test {
+public:
+    // Appends 'values' to a column builder, where an empty object stands for a missing value.
+    BSONObj build(const std::vector<BSONObj>& values) {
+        BSONColumnBuilder cb("f");
+        for (auto&& value : values) {
+            cb.append(value.firstElement());
+        }
+        ASSERT_EQ(cb.size(), values.size());
+        return BSON(cb.fieldName() << cb.finalize());
+    }
+
+    // Checks that the column holds exactly 'values'.
+    void assertColumnEq(const BSONObj& column, const std::vector<BSONObj>& values) {
+        BSONColumn col(column.firstElement());
+        ASSERT_EQ(col.name(), "f");
+        ASSERT_EQ(col.size(), values.size());
+
+        auto it = col.begin();
+        for (auto&& value : values) {
+            ASSERT(it != col.end());
+            auto expected = value.firstElement();
+            if (expected.eoo()) {
+                ASSERT(it->eoo());
+            } else {
+                ASSERT_EQ(it->type(), expected.type());
+                ASSERT(it->binaryEqualValues(expected)) << *it << " != " << expected;
+            }
+            ++it;
+        }
+        ASSERT(it == col.end());
+    }
+
+    void roundTrip(const std::vector<BSONObj>& values) {
+        assertColumnEq(build(values), values);
+    }
+
+    int binarySize(const BSONObj& column) {
+        int len;
+        column.firstElement().binData(len);
+        return len;
+    }
+};
+
+TEST_F(BSONColumnTest, Empty) {
+    auto column = build({});
+    ASSERT_EQ(binarySize(column), 1);
+    roundTrip({});
+}
+
+TEST_F(BSONColumnTest, RegularDatesCompressToRepeats) {
+    std::vector<BSONObj> values;
+    auto start = Date_t::fromMillisSinceEpoch(1622505600000);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(BSON("" << start + Seconds(i)));
+    }
+    auto column = build(values);
+    assertColumnEq(column, values);
+
+    // A literal, one delta for the interval and repeats for the rest.
+    ASSERT_LT(binarySize(column), 64);
+}
+
+TEST_F(BSONColumnTest, IrregularDates) {
+    std::vector<BSONObj> values;
+    auto date = Date_t::fromMillisSinceEpoch(1622505600000);
+    for (int i = 0; i < 200; ++i) {
+        date += Milliseconds(1000 + (i % 7) * 13 - (i % 3) * 29);
+        values.push_back(BSON("" << date));
+    }
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, Timestamps) {
+    std::vector<BSONObj> values;
+    for (unsigned i = 0; i < 100; ++i) {
+        values.push_back(BSON("" << Timestamp(1000 + i, i % 5)));
+    }
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, Integers) {
+    std::vector<BSONObj> values;
+    for (int i = 0; i < 150; ++i) {
+        values.push_back(BSON("" << (i * 37) % 101 - 50));
+    }
+    values.push_back(BSON("" << std::numeric_limits<int>::max()));
+    values.push_back(BSON("" << std::numeric_limits<int>::min()));
+    values.push_back(BSON("" << std::numeric_limits<int>::max()));
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, Longs) {
+    std::vector<BSONObj> values;
+    for (long long i = 0; i < 100; ++i) {
+        values.push_back(BSON("" << (i << 40) - 7));
+    }
+    values.push_back(BSON("" << std::numeric_limits<long long>::max()));
+    values.push_back(BSON("" << std::numeric_limits<long long>::min()));
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, Doubles) {
+    std::vector<BSONObj> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(BSON("" << 20.5 + (i % 4) * 0.25));
+    }
+    values.push_back(BSON("" << -0.0));
+    values.push_back(BSON("" << 0.0));
+    values.push_back(BSON("" << std::numeric_limits<double>::quiet_NaN()));
+    values.push_back(BSON("" << std::numeric_limits<double>::infinity()));
+    values.push_back(BSON("" << 1.0 / 3));
+    values.push_back(BSON("" << 2.0 / 3));
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, RepeatedStrings) {
+    std::vector<BSONObj> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(BSON("" << (i < 70 ? "sensor-a" : "sensor-b")));
+    }
+    auto column = build(values);
+    assertColumnEq(column, values);
+    ASSERT_LT(binarySize(column), 48);
+}
+
+TEST_F(BSONColumnTest, MixedTypes) {
+    std::vector<BSONObj> values{BSON("" << 1),
+                                BSON("" << 2LL),
+                                BSON("" << 3.0),
+                                BSON("" << true),
+                                BSON("" << true),
+                                BSON("" << BSON("a" << 1)),
+                                BSON("" << BSON("a" << 1)),
+                                BSON("" << BSON_ARRAY(1 << 2)),
+                                BSON("" << BSONNULL),
+                                BSON("" << MINKEY),
+                                BSON("" << MINKEY),
+                                BSON("" << MAXKEY),
+                                BSON("" << Decimal128("1.5")),
+                                BSON("" << OID::gen()),
+                                BSON("" << 4)};
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, MissingValues) {
+    std::vector<BSONObj> values;
+    for (int i = 0; i < 300; ++i) {
+        values.push_back(i % 5 == 0 || (i > 100 && i < 200) ? BSONObj() : BSON("" << i));
+    }
+    roundTrip(values);
+}
+
+TEST_F(BSONColumnTest, LeadingMissingValues) {
+    roundTrip({BSONObj(), BSONObj(), BSON("" << 1.5), BSONObj(), BSON("" << 1.5)});
+}
+
+TEST_F(BSONColumnTest, IteratorCopyKeepsDecodedValue) {
+    std::vector<BSONObj> values{BSON("" << 1), BSON("" << 2), BSON("" << 3)};
+    auto column = build(values);
+    BSONColumn col(column.firstElement());
+
+    auto it = col.begin();
+    ++it;
+    auto copy = it;
+    ++it;
+    ASSERT_EQ(copy->numberInt(), 2);
+    ASSERT_EQ(it->numberInt(), 3);
+    ASSERT_EQ((copy++)->numberInt(), 2);
+    ASSERT(copy == it);
+}
+
+TEST_F(BSONColumnTest, RejectsOtherBinDataSubtypes) {
+    BSONObj obj = BSON("f" << BSONBinData("\0", 1, BinDataGeneral));
+    ASSERT_THROWS_CODE(BSONColumn(obj.firstElement()), DBException, 5754723);
+}
+
+TEST_F(BSONColumnTest, RejectsUnterminatedBinary) {
+    const char data[] = {'\x10', '\0', '\x01', '\0', '\0', '\0'};
+    BSONObj obj = BSON("f" << BSONBinData(data, sizeof(data) - 1, BinDataType::Column));
+    ASSERT_THROWS_CODE(BSONColumn(obj.firstElement()), DBException, 5754724);
+}
+
+TEST_F(BSONColumnTest, RejectsDeltaBeforeLiteral) {
+    const char data[] = {'\x81', '\x02', '\0'};
+    BSONObj obj = BSON("f" << BSONBinData(data, sizeof(data), BinDataType::Column));
+    BSONColumn col(obj.firstElement());
+    ASSERT_THROWS_CODE(col.begin(), DBException, 5754728);
+}
+
+}  // namespace
+}  // namespace mongo
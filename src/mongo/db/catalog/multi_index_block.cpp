@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -48,18 +49,22 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/tenant_migration_conflict_info.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/future.h"
 #include "mongo/util/log_and_backoff.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -71,6 +76,7 @@ MONGO_FAIL_POINT_DEFINE(hangAfterStartingIndexBuildUnlocked);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseBeforeInsertion);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseAfterInsertion);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
+MONGO_FAIL_POINT_DEFINE(failIndexBuildBulkLoad);
 
 namespace {
 
@@ -555,6 +561,19 @@ void MultiIndexBlock::_doCollectionScan(OperationContext* opCtx,
                                         const CollectionPtr& collection,
                                         boost::optional<RecordId> resumeAfterRecordId,
                                         ProgressMeterHolder* progress) {
+    // The phase will be kCollectionScan when resuming an index build from the collection
+    // scan phase.
+    invariant(_phase == IndexBuildPhaseEnum::kInitialized ||
+                  _phase == IndexBuildPhaseEnum::kCollectionScan,
+              IndexBuildPhase_serializer(_phase).toString());
+    _phase = IndexBuildPhaseEnum::kCollectionScan;
+
+    const auto numThreads = _getCollectionScanParallelism(opCtx, collection, resumeAfterRecordId);
+    if (numThreads > 1) {
+        _doParallelCollectionScan(opCtx, collection, numThreads, progress);
+        return;
+    }
+
     PlanYieldPolicy::YieldPolicy yieldPolicy;
     if (isBackgroundBuilding()) {
         yieldPolicy = PlanYieldPolicy::YieldPolicy::YIELD_AUTO;
@@ -565,13 +584,6 @@ void MultiIndexBlock::_doCollectionScan(OperationContext* opCtx,
     auto exec = collection->makePlanExecutor(
         opCtx, collection, yieldPolicy, Collection::ScanDirection::kForward, resumeAfterRecordId);
 
-    // The phase will be kCollectionScan when resuming an index build from the collection
-    // scan phase.
-    invariant(_phase == IndexBuildPhaseEnum::kInitialized ||
-                  _phase == IndexBuildPhaseEnum::kCollectionScan,
-              IndexBuildPhase_serializer(_phase).toString());
-    _phase = IndexBuildPhaseEnum::kCollectionScan;
-
     BSONObj objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -608,6 +620,235 @@ void MultiIndexBlock::_doCollectionScan(OperationContext* opCtx,
     }
 }
 
+size_t MultiIndexBlock::_getCollectionScanParallelism(
+    OperationContext* opCtx,
+    const CollectionPtr& collection,
+    const boost::optional<RecordId>& resumeAfterRecordId) const {
+    const auto numThreads = static_cast<size_t>(maxIndexBuildCollectionScanThreads.load());
+    if (numThreads <= 1) {
+        return 1;
+    }
+
+    // The scanning threads take their own collection locks while the index build thread releases
+    // its locks, which is only possible for builds that yield. The RecordIds of clustered
+    // collections cannot be split into ranges arithmetically, and the scan of a capped collection
+    // has to restart when its position gets deleted, so those are scanned on a single thread, as
+    // are the builds which resume from a position of the collection scan. So are the builds which
+    // are set to hang part way through the scan by a failpoint, as it only applies to the
+    // single-threaded scan.
+    if (!isBackgroundBuilding() || resumeAfterRecordId || collection->isCapped() ||
+        collection->isClustered() ||
+        MONGO_unlikely(hangAfterStartingIndexBuild.shouldFail()) ||
+        MONGO_unlikely(hangIndexBuildDuringCollectionScanPhaseBeforeInsertion.shouldFail()) ||
+        MONGO_unlikely(hangIndexBuildDuringCollectionScanPhaseAfterInsertion.shouldFail())) {
+        return 1;
+    }
+
+    if (collection->numRecords(opCtx) < minIndexBuildParallelCollectionScanRecords.load()) {
+        return 1;
+    }
+
+    return numThreads;
+}
+
+void MultiIndexBlock::_doParallelCollectionScan(OperationContext* opCtx,
+                                                const CollectionPtr& collection,
+                                                size_t numThreads,
+                                                ProgressMeterHolder* progress) {
+    auto first = collection->getCursor(opCtx, true /* forward */)->next();
+    auto last = collection->getCursor(opCtx, false /* forward */)->next();
+    if (!first || !last) {
+        return;
+    }
+
+    // Split the RecordIds between the first and the last record into ranges of equal width. The
+    // last range is unbounded, so that records inserted from now on are scanned just like they
+    // would be by a single-threaded scan.
+    const auto firstId = first->id.getLong();
+    const auto rangeWidth =
+        (last->id.getLong() - firstId) / static_cast<long long>(numThreads) + 1;
+    std::vector<RecordId> rangeBegins;
+    for (size_t i = 0; i < numThreads; ++i) {
+        rangeBegins.emplace_back(firstId + rangeWidth * static_cast<long long>(i));
+    }
+
+    // Each thread sorts the keys it generates in its own BulkBuilder per index, which shares the
+    // memory budget of the index with the BulkBuilders of the other threads.
+    const auto maxMemoryUsageBytes =
+        getEachIndexBuildMaxMemoryUsageBytes(_indexes.size()) / numThreads;
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> bulks(numThreads);
+    for (auto& threadBulks : bulks) {
+        for (auto& index : _indexes) {
+            threadBulks.push_back(index.real->initiateBulk(
+                maxMemoryUsageBytes, /*stateInfo=*/boost::none, collection->ns().db()));
+        }
+    }
+
+    LOGV2(5754710,
+          "Index build: scanning collection on multiple threads",
+          "buildUUID"_attr = _buildUUID,
+          "collectionUUID"_attr = _collectionUUID,
+          logAttrs(collection->ns()),
+          "numThreads"_attr = numThreads);
+
+    // The scanning threads read from the same source as this thread.
+    const NamespaceStringOrUUID nssOrUUID{collection->ns().db().toString(), collection->uuid()};
+    const auto readSource = opCtx->recoveryUnit()->getTimestampReadSource();
+    const auto readTimestamp = readSource == RecoveryUnit::ReadSource::kProvided
+        ? opCtx->recoveryUnit()->getPointInTimeReadTimestamp(opCtx)
+        : boost::none;
+    const bool readOnce = opCtx->recoveryUnit()->getReadOnce();
+    const bool shouldConflictWithSecondaryBatchApplication =
+        opCtx->lockState()->shouldConflictWithSecondaryBatchApplication();
+
+    AtomicWord<bool> stop{false};
+    AtomicWord<long long> numScanned{0};
+    std::vector<RecordId> lastScanned(numThreads);
+    std::vector<Future<void>> futures;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        auto pf = makePromiseFuture<void>();
+        futures.push_back(std::move(pf.future));
+        threads.emplace_back([&, i, promise = std::move(pf.promise)]() mutable {
+            Client::initThread(std::string(str::stream() << "IndexBuildCollectionScan-" << i));
+            auto threadOpCtx = cc().makeOperationContext();
+            threadOpCtx->recoveryUnit()->setTimestampReadSource(readSource, readTimestamp);
+            threadOpCtx->recoveryUnit()->setReadOnce(readOnce);
+            threadOpCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(
+                shouldConflictWithSecondaryBatchApplication);
+
+            promise.setWith([&] {
+                _scanRecordIdRange(threadOpCtx.get(),
+                                   nssOrUUID,
+                                   rangeBegins[i],
+                                   i + 1 < numThreads ? boost::make_optional(rangeBegins[i + 1])
+                                                      : boost::none,
+                                   bulks[i],
+                                   stop,
+                                   &numScanned,
+                                   &lastScanned[i]);
+            });
+        });
+    }
+
+    // Release the locks while the other threads scan the collection, as they yield theirs
+    // periodically and could otherwise get queued behind a conflicting lock request that is itself
+    // queued behind the locks of this thread.
+    collection.yield();
+    Locker::LockSnapshot lockInfo;
+    invariant(opCtx->lockState()->saveLockStateAndUnlock(&lockInfo));
+
+    // Every thread has to be waited for, even once one of them failed or this operation got
+    // interrupted, since they refer to state owned by this function.
+    Status status = Status::OK();
+    long long numReported = 0;
+    for (auto& future : futures) {
+        if (status.isOK()) {
+            status = future.waitNoThrow(opCtx);
+            if (status.isOK()) {
+                status = future.getNoThrow();
+            }
+            if (!status.isOK()) {
+                stop.store(true);
+            }
+        }
+
+        const auto numScannedSoFar = numScanned.load();
+        progress->hit(static_cast<int>(numScannedSoFar - numReported));
+        numReported = numScannedSoFar;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    {
+        UninterruptibleLockGuard noInterrupt(opCtx->lockState());
+        opCtx->lockState()->restoreLockState(opCtx, lockInfo);
+    }
+    opCtx->recoveryUnit()->abandonSnapshot();
+    collection.restore();
+
+    // The BulkBuilders of the threads are discarded on failure, leaving those of '_indexes' as they
+    // were before the scan.
+    uassertStatusOK(status);
+
+    for (auto& threadBulks : bulks) {
+        for (size_t i = 0; i < _indexes.size(); ++i) {
+            _indexes[i].bulk->mergePartial(std::move(threadBulks[i]));
+        }
+    }
+    _scannedCollectionInParallel = true;
+
+    for (const auto& id : lastScanned) {
+        if (!id.isNull() && (!_lastRecordIdInserted || id > *_lastRecordIdInserted)) {
+            _lastRecordIdInserted = id;
+        }
+    }
+
+    progress->get()->setTotalWhileRunning(collection->numRecords(opCtx));
+}
+
+void MultiIndexBlock::_scanRecordIdRange(
+    OperationContext* opCtx,
+    const NamespaceStringOrUUID& nssOrUUID,
+    const RecordId& begin,
+    const boost::optional<RecordId>& end,
+    const std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>& bulks,
+    const AtomicWord<bool>& stop,
+    AtomicWord<long long>* numScanned,
+    RecordId* lastScanned) const {
+    bool done = false;
+    while (!done && !stop.load()) {
+        {
+            AutoGetCollection collection(opCtx, nssOrUUID, MODE_IS);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nssOrUUID.toString()
+                                  << " was dropped during the collection scan of an index build",
+                    collection);
+
+            writeConflictRetry(opCtx, "indexBuildCollectionScan", collection->ns().ns(), [&] {
+                auto cursor = collection->getCursor(opCtx);
+
+                // Resume after the last record whose keys were inserted. seekNear() may position
+                // the cursor on either side of the requested RecordId.
+                const bool resuming = !lastScanned->isNull();
+                auto record = cursor->seekNear(resuming ? *lastScanned : begin);
+                if (record && (resuming ? record->id <= *lastScanned : record->id < begin)) {
+                    record = cursor->next();
+                }
+
+                // Scan a bounded number of records before releasing the locks and the snapshot,
+                // like a yielding collection scan does.
+                const int maxRecords = internalQueryExecYieldIterations.load();
+                for (int numRecords = 0; record; record = cursor->next()) {
+                    if (end && record->id >= *end) {
+                        done = true;
+                        return;
+                    }
+
+                    const auto doc = record->data.toBson();
+                    for (size_t i = 0; i < _indexes.size(); ++i) {
+                        const auto& index = _indexes[i];
+                        if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+                            continue;
+                        }
+                        uassertStatusOK(bulks[i]->insert(opCtx, doc, record->id, index.options));
+                    }
+                    *lastScanned = record->id;
+                    numScanned->fetchAndAdd(1);
+
+                    if (++numRecords >= maxRecords || stop.load()) {
+                        return;
+                    }
+                    opCtx->checkForInterrupt();
+                }
+                done = true;
+            });
+        }
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+}
+
 Status MultiIndexBlock::insertSingleDocumentForInitialSyncOrRecovery(OperationContext* opCtx,
                                                                      const BSONObj& doc,
                                                                      const RecordId& loc) {
@@ -665,55 +906,170 @@ Status MultiIndexBlock::dumpInsertsFromBulk(
               IndexBuildPhase_serializer(_phase).toString());
     _phase = IndexBuildPhaseEnum::kBulkLoad;
 
+    const auto numThreads = std::min(static_cast<size_t>(maxIndexBuildBulkLoadThreads.load()),
+                                     _indexes.size());
+    if (numThreads > 1 && !onDuplicateRecord) {
+        return _dumpInsertsFromBulkInParallel(opCtx, collection, numThreads);
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
-        // When onDuplicateRecord is passed, 'dupsAllowed' should be passed to reflect whether or
-        // not the index is unique.
-        bool dupsAllowed = (onDuplicateRecord)
-            ? !_indexes[i].block->getEntry(opCtx, collection)->descriptor()->unique()
-            : _indexes[i].options.dupsAllowed;
-        const IndexCatalogEntry* entry = _indexes[i].block->getEntry(opCtx, collection);
-        LOGV2_DEBUG(20392,
-                    1,
-                    "Index build: inserting from external sorter into index",
-                    "index"_attr = entry->descriptor()->indexName(),
-                    "buildUUID"_attr = _buildUUID);
-
-        // SERVER-41918 This call to commitBulk() results in file I/O that may result in an
-        // exception.
-        try {
-            Status status = _indexes[i].real->commitBulk(
-                opCtx,
-                _indexes[i].bulk.get(),
-                dupsAllowed,
-                [=](const KeyString::Value& duplicateKey) {
-                    // Do not record duplicates when explicitly ignored. This may be the case on
-                    // secondaries.
-                    return writeConflictRetry(
-                        opCtx, "recordingDuplicateKey", entry->getNSSFromCatalog(opCtx).ns(), [&] {
-                            if (dupsAllowed && !onDuplicateRecord && !_ignoreUnique &&
-                                entry->indexBuildInterceptor()) {
-                                WriteUnitOfWork wuow(opCtx);
-                                Status status = entry->indexBuildInterceptor()->recordDuplicateKey(
-                                    opCtx, duplicateKey);
-                                if (!status.isOK()) {
-                                    return status;
-                                }
-                                wuow.commit();
+        auto status = _dumpInsertsFromBulk(opCtx, collection, i, onDuplicateRecord);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_dumpInsertsFromBulk(
+    OperationContext* opCtx,
+    const CollectionPtr& collection,
+    size_t indexNum,
+    const IndexAccessMethod::RecordIdHandlerFn& onDuplicateRecord) {
+    auto& index = _indexes[indexNum];
+
+    // When onDuplicateRecord is passed, 'dupsAllowed' should be passed to reflect whether or
+    // not the index is unique.
+    bool dupsAllowed = (onDuplicateRecord)
+        ? !index.block->getEntry(opCtx, collection)->descriptor()->unique()
+        : index.options.dupsAllowed;
+    const IndexCatalogEntry* entry = index.block->getEntry(opCtx, collection);
+    LOGV2_DEBUG(20392,
+                1,
+                "Index build: inserting from external sorter into index",
+                "index"_attr = entry->descriptor()->indexName(),
+                "buildUUID"_attr = _buildUUID);
+
+    // SERVER-41918 This call to commitBulk() results in file I/O that may result in an
+    // exception.
+    try {
+        failIndexBuildBulkLoad.executeIf(
+            [&](const BSONObj&) {
+                uasserted(ErrorCodes::InternalError,
+                          str::stream() << "failIndexBuildBulkLoad fail point enabled for index "
+                                        << entry->descriptor()->indexName());
+            },
+            [&](const BSONObj& data) {
+                return data["indexName"].str() == entry->descriptor()->indexName();
+            });
+
+        return index.real->commitBulk(
+            opCtx,
+            index.bulk.get(),
+            dupsAllowed,
+            [=](const KeyString::Value& duplicateKey) {
+                // Do not record duplicates when explicitly ignored. This may be the case on
+                // secondaries.
+                return writeConflictRetry(
+                    opCtx, "recordingDuplicateKey", entry->getNSSFromCatalog(opCtx).ns(), [&] {
+                        if (dupsAllowed && !onDuplicateRecord && !_ignoreUnique &&
+                            entry->indexBuildInterceptor()) {
+                            WriteUnitOfWork wuow(opCtx);
+                            Status status = entry->indexBuildInterceptor()->recordDuplicateKey(
+                                opCtx, duplicateKey);
+                            if (!status.isOK()) {
+                                return status;
                             }
-                            return Status::OK();
-                        });
-                },
-                onDuplicateRecord);
+                            wuow.commit();
+                        }
+                        return Status::OK();
+                    });
+            },
+            onDuplicateRecord);
+    } catch (...) {
+        return exceptionToStatus();
+    }
+}
 
-            if (!status.isOK()) {
-                return status;
+Status MultiIndexBlock::_dumpInsertsFromBulkInParallel(OperationContext* opCtx,
+                                                       const CollectionPtr& collection,
+                                                       size_t numThreads) {
+    LOGV2(5754712,
+          "Index build: inserting from external sorters into indexes on multiple threads",
+          "buildUUID"_attr = _buildUUID,
+          "collectionUUID"_attr = _collectionUUID,
+          "numIndexes"_attr = _indexes.size(),
+          "numThreads"_attr = numThreads);
+
+    // The OperationContexts of the threads are registered here so that they can be killed if this
+    // operation gets interrupted or one of the threads fails.
+    auto mutex = MONGO_MAKE_LATCH("MultiIndexBlock::dumpInsertsFromBulk");
+    std::vector<OperationContext*> threadOpCtxs(numThreads, nullptr);
+    boost::optional<Status> killStatus;
+
+    // Records the first failure and kills the threads which are still running. Later failures are
+    // usually caused by the kill and are not reported.
+    auto killThreads = [&](const Status& status) {
+        stdx::lock_guard<Latch> lk(mutex);
+        if (killStatus) {
+            return;
+        }
+        killStatus = status;
+        for (auto threadOpCtx : threadOpCtxs) {
+            if (threadOpCtx) {
+                stdx::lock_guard<Client> clientLock(*threadOpCtx->getClient());
+                threadOpCtx->getServiceContext()->killOperation(
+                    clientLock, threadOpCtx, ErrorCodes::Interrupted);
             }
-        } catch (...) {
-            return exceptionToStatus();
         }
+    };
+
+    // Thread 't' bulk loads the indexes whose position in '_indexes' is congruent to 't' modulo
+    // 'numThreads'.
+    std::vector<Future<void>> futures;
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        auto pf = makePromiseFuture<void>();
+        futures.push_back(std::move(pf.future));
+        threads.emplace_back([&, t, promise = std::move(pf.promise)]() mutable {
+            Client::initThread(std::string(str::stream() << "IndexBuildBulkLoad-" << t));
+            auto threadOpCtx = cc().makeOperationContext();
+
+            promise.setWith([&] {
+                {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    if (killStatus) {
+                        uassertStatusOK(*killStatus);
+                    }
+                    threadOpCtxs[t] = threadOpCtx.get();
+                }
+                ON_BLOCK_EXIT([&] {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    threadOpCtxs[t] = nullptr;
+                });
+
+                try {
+                    for (size_t i = t; i < _indexes.size(); i += numThreads) {
+                        uassertStatusOK(_dumpInsertsFromBulk(threadOpCtx.get(), collection, i, {}));
+                    }
+                } catch (const DBException& ex) {
+                    // Stop the other threads now rather than once this thread is waited for.
+                    killThreads(ex.toStatus());
+                    throw;
+                }
+            });
+        });
+    }
+
+    // Every thread has to be joined, even once one of them failed or this operation got
+    // interrupted, since they refer to state owned by this MultiIndexBlock.
+    for (auto& future : futures) {
+        auto status = future.waitNoThrow(opCtx);
+        if (status.isOK()) {
+            status = future.getNoThrow();
+        }
+        if (!status.isOK()) {
+            killThreads(status);
+            break;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
     }
 
-    return Status::OK();
+    stdx::lock_guard<Latch> lk(mutex);
+    return killStatus ? *killStatus : Status::OK();
 }
 
 Status MultiIndexBlock::drainBackgroundWrites(
@@ -883,6 +1239,15 @@ void MultiIndexBlock::abortWithoutCleanup(OperationContext* opCtx,
 
     auto action = TemporaryRecordStore::FinalizationAction::kDelete;
 
+    if (isResumable && _scannedCollectionInParallel &&
+        IndexBuildPhaseEnum::kBulkLoad == _phase) {
+        LOGV2(5754711,
+              "Index build: not writing resumable state to disk because the bulk load phase "
+              "merges the keys of a parallel collection scan",
+              "buildUUID"_attr = _buildUUID);
+        isResumable = false;
+    }
+
     if (isResumable) {
         invariant(_buildUUID);
         invariant(_method == IndexBuildMethod::kHybrid);
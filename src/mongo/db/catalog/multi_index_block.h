@@ -48,6 +48,7 @@
 #include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/resumable_index_builds_gen.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/fail_point.h"
 
@@ -179,6 +180,9 @@ public:
      * violators of uniqueness constraints will be handled by 'onDuplicateRecord'.
      *
      * Should not be called inside of a WriteUnitOfWork.
+     *
+     * The indexes are bulk loaded on up to 'maxIndexBuildBulkLoadThreads' threads at a time, unless
+     * 'onDuplicateRecord' is passed, since it may write to the collection using 'opCtx'.
      */
     Status dumpInsertsFromBulk(OperationContext* opCtx, const CollectionPtr& collection);
     Status dumpInsertsFromBulk(OperationContext* opCtx,
@@ -322,6 +326,60 @@ private:
                            boost::optional<RecordId> resumeAfterRecordId,
                            ProgressMeterHolder* progress);
 
+    /**
+     * Returns the number of threads the collection scan of the given collection can be split
+     * across, or 1 if it has to run on the index build thread.
+     */
+    size_t _getCollectionScanParallelism(
+        OperationContext* opCtx,
+        const CollectionPtr& collection,
+        const boost::optional<RecordId>& resumeAfterRecordId) const;
+
+    /**
+     * Splits the collection scan across 'numThreads' threads, each of which scans a separate range
+     * of RecordIds and inserts the keys into its own BulkBuilder per index. The locks of 'opCtx'
+     * are released while the threads run. Once every range has been scanned, the BulkBuilders of
+     * the threads are merged into the BulkBuilders of '_indexes'.
+     */
+    void _doParallelCollectionScan(OperationContext* opCtx,
+                                   const CollectionPtr& collection,
+                                   size_t numThreads,
+                                   ProgressMeterHolder* progress);
+
+    /**
+     * Inserts the keys of the records of the given collection whose RecordId is in
+     * ['begin', 'end') into 'bulks', which hold one BulkBuilder per entry of '_indexes'. Runs on
+     * its own thread during a parallel collection scan, acquiring and periodically releasing the
+     * collection lock with 'opCtx'. 'lastScanned' is set to the RecordId of the last record whose
+     * keys were inserted.
+     */
+    void _scanRecordIdRange(
+        OperationContext* opCtx,
+        const NamespaceStringOrUUID& nssOrUUID,
+        const RecordId& begin,
+        const boost::optional<RecordId>& end,
+        const std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>& bulks,
+        const AtomicWord<bool>& stop,
+        AtomicWord<long long>* numScanned,
+        RecordId* lastScanned) const;
+
+    /**
+     * Inserts the keys sorted by the BulkBuilder of '_indexes[indexNum]' into the index.
+     */
+    Status _dumpInsertsFromBulk(OperationContext* opCtx,
+                                const CollectionPtr& collection,
+                                size_t indexNum,
+                                const IndexAccessMethod::RecordIdHandlerFn& onDuplicateRecord);
+
+    /**
+     * Bulk loads the indexes on 'numThreads' threads, each of which loads a separate subset of the
+     * indexes with its own OperationContext. The locks held by 'opCtx' protect the indexes for the
+     * duration of the load.
+     */
+    Status _dumpInsertsFromBulkInParallel(OperationContext* opCtx,
+                                          const CollectionPtr& collection,
+                                          size_t numThreads);
+
     // Is set during init() and ensures subsequent function calls act on the same Collection.
     boost::optional<UUID> _collectionUUID;
 
@@ -331,6 +389,10 @@ private:
 
     bool _ignoreUnique = false;
 
+    // Set to true when the keys of the collection scan were generated by multiple threads. Their
+    // sorted keys are only merged by the bulk load phase, which therefore cannot be resumed.
+    bool _scannedCollectionInParallel = false;
+
     // Set to true when no work remains to be done, the object can safely destruct without leaving
     // incorrect state set anywhere.
     bool _buildIsCleanedUp = true;
@@ -34,8 +34,11 @@
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
 
 namespace mongo {
 namespace {
@@ -183,5 +186,150 @@ TEST_F(MultiIndexBlockTest, InitWriteConflictException) {
     indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
 }
 
+TEST_F(MultiIndexBlockTest, ParallelCollectionScanInsertsKeysOfEveryDocument) {
+    RAIIServerParameterControllerForTest numThreads("maxIndexBuildCollectionScanThreads", 4);
+    RAIIServerParameterControllerForTest minRecords("minIndexBuildParallelCollectionScanRecords",
+                                                    0LL);
+
+    // Every document generates two keys, which makes the index multikey.
+    const int numDocs = 1000;
+    std::vector<InsertStatement> docs;
+    for (int i = 0; i < numDocs; ++i) {
+        docs.emplace_back(BSON("_id" << i << "a" << BSON_ARRAY(i << numDocs + i)));
+    }
+    ASSERT_OK(storageInterface()->insertDocuments(operationContext(), getNSS(), docs));
+
+    auto indexer = getIndexer();
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    BSONObj spec = BSON("key" << BSON("a" << 1) << "name"
+                              << "a_1"
+                              << "v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer->init(operationContext(), coll, {spec}, MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    ASSERT_OK(indexer->dumpInsertsFromBulk(operationContext(), coll.get()));
+    ASSERT_OK(indexer->checkConstraints(operationContext(), coll.get()));
+
+    {
+        WriteUnitOfWork wunit(operationContext());
+        ASSERT_OK(indexer->commit(operationContext(),
+                                  coll.getWritableCollection(),
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wunit.commit();
+    }
+
+    auto indexCatalog = coll.get()->getIndexCatalog();
+    auto entry = indexCatalog->getEntry(indexCatalog->findIndexByName(operationContext(), "a_1"));
+    ASSERT_EQUALS(2 * numDocs,
+                  entry->accessMethod()->getSortedDataInterface()->numEntries(operationContext()));
+    ASSERT_TRUE(entry->isMultikey());
+}
+
+TEST_F(MultiIndexBlockTest, ParallelBulkLoadInsertsKeysIntoEveryIndex) {
+    RAIIServerParameterControllerForTest numThreads("maxIndexBuildBulkLoadThreads", 2);
+
+    const int numDocs = 1000;
+    std::vector<InsertStatement> docs;
+    for (int i = 0; i < numDocs; ++i) {
+        docs.emplace_back(BSON("_id" << i << "a" << i << "b" << -i << "c" << i % 10));
+    }
+    ASSERT_OK(storageInterface()->insertDocuments(operationContext(), getNSS(), docs));
+
+    auto indexer = getIndexer();
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    std::vector<BSONObj> specs;
+    for (auto field : {"a", "b", "c"}) {
+        specs.push_back(BSON("key" << BSON(field << 1) << "name" << std::string(field) + "_1"
+                                   << "v"
+                                   << static_cast<int>(IndexDescriptor::kLatestIndexVersion)));
+    }
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer->init(operationContext(), coll, specs, MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    ASSERT_OK(indexer->dumpInsertsFromBulk(operationContext(), coll.get()));
+    ASSERT_OK(indexer->checkConstraints(operationContext(), coll.get()));
+
+    {
+        WriteUnitOfWork wunit(operationContext());
+        ASSERT_OK(indexer->commit(operationContext(),
+                                  coll.getWritableCollection(),
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wunit.commit();
+    }
+
+    auto indexCatalog = coll.get()->getIndexCatalog();
+    for (auto name : {"a_1", "b_1", "c_1"}) {
+        auto desc = indexCatalog->findIndexByName(operationContext(), name);
+        auto entry = indexCatalog->getEntry(desc);
+        ASSERT_EQUALS(
+            numDocs,
+            entry->accessMethod()->getSortedDataInterface()->numEntries(operationContext()));
+    }
+}
+
+TEST_F(MultiIndexBlockTest, ParallelBulkLoadFailureKillsTheOtherThreads) {
+    RAIIServerParameterControllerForTest numThreads("maxIndexBuildBulkLoadThreads", 2);
+
+    std::vector<InsertStatement> docs;
+    for (int i = 0; i < 10; ++i) {
+        docs.emplace_back(BSON("_id" << i << "a" << i << "b" << -i << "c" << i));
+    }
+    ASSERT_OK(storageInterface()->insertDocuments(operationContext(), getNSS(), docs));
+
+    auto indexer = getIndexer();
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    std::vector<BSONObj> specs;
+    for (auto field : {"a", "b", "c"}) {
+        specs.push_back(BSON("key" << BSON(field << 1) << "name" << std::string(field) + "_1"
+                                   << "v"
+                                   << static_cast<int>(IndexDescriptor::kLatestIndexVersion)));
+    }
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer->init(operationContext(), coll, specs, MultiIndexBlock::kNoopOnInitFn)
+                      .getStatus());
+        wuow.commit();
+    }
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+
+    // The first thread loads a_1 and c_1, the second one b_1. The first thread hangs until it is
+    // killed, so the index build only completes if the failure of the second thread kills it.
+    {
+        FailPointEnableBlock hangOnA("hangIndexBuildDuringBulkLoadPhase",
+                                     BSON("iteration" << 0 << "indexNames" << BSON_ARRAY("a_1")));
+        FailPointEnableBlock failOnB("failIndexBuildBulkLoad", BSON("indexName"
+                                                                    << "b_1"));
+        ASSERT_EQUALS(ErrorCodes::InternalError,
+                      indexer->dumpInsertsFromBulk(operationContext(), coll.get()));
+    }
+
+    indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/pipeline/aggregation_request_helper.h"
 #include "mongo/db/pipeline/variables.h"
+#include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
@@ -372,6 +373,13 @@ public:
                 opCtx->lockState()->skipAcquireTicket();
             }
 
+            // A find by _id of a client reads at most one document through the _id index, so it
+            // queues for its ticket ahead of the other operations of clients, which may be long
+            // scans. Inside a transaction the ticket is taken once for all of its operations.
+            if (opCtx->getClient()->session() && !opCtx->inMultiDocumentTransaction() &&
+                CanonicalQuery::isSimpleIdQuery(findCommand->getFilter())) {
+                opCtx->lockState()->setTicketLane(TicketLane::kShortRead);
+            }
 
             // Acquire locks. If the query is on a view, we release our locks and convert the query
             // request into an aggregation command.
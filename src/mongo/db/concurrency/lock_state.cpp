@@ -37,6 +37,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
@@ -359,10 +360,16 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         if (opCtx)
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
+        auto lane = getTicketLane();
+        if (!lane) {
+            const bool internal = opCtx && opCtx->getClient() && !opCtx->getClient()->session();
+            lane = internal ? TicketLane::kInternal : TicketLane::kUser;
+        }
+
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, *lane);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, *lane)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <climits>  // For UINT_MAX
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/ticket_lane.h"
 
 namespace mongo {
 
@@ -477,6 +479,18 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * Sets the lane in which this Locker queues for tickets. By default, operations of threads
+     * without a client connection queue in the internal lane and all others in the user lane. Must
+     * be called before the global lock is acquired to take effect.
+     */
+    void setTicketLane(TicketLane lane) {
+        _ticketLane = lane;
+    }
+    boost::optional<TicketLane> getTicketLane() const {
+        return _ticketLane;
+    }
+
     /**
      * This will opt out of the ticket mechanism. This should be used sparingly for special purpose
      * threads, such as FTDC and committing or aborting prepared transactions.
@@ -539,6 +553,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    boost::optional<TicketLane> _ticketLane;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
@@ -88,6 +88,10 @@ int BucketUnpacker::computeMeasurementCount(int targetTimestampObjSize) {
 void BucketUnpacker::reset(BSONObj&& bucket) {
     _fieldIters.clear();
     _timeFieldIter = boost::none;
+    _fieldColumns.clear();
+    _timeColumn = boost::none;
+    _selectedRows.clear();
+    _rowIndex = 0;
 
     _bucket = std::move(bucket);
     uassert(5346510, "An empty bucket cannot be unpacked", !_bucket.isEmpty());
@@ -96,6 +100,7 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
     if (dataRegion.isEmpty()) {
         // If the data field of a bucket is present but it holds an empty object, there's nothing to
         // unpack.
+        _numberOfMeasurements = 0;
         return;
     }
 
@@ -104,7 +109,14 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
             "The $_internalUnpackBucket stage requires the data region to have a timeField object",
             timeFieldElem);
 
-    _timeFieldIter = BSONObjIterator{timeFieldElem.Obj()};
+    // The columns of a compressed bucket are BSONColumns rather than objects keyed by row.
+    bool compressed = timeFieldElem.type() == BinData;
+    if (compressed) {
+        BSONColumn timeColumn{timeFieldElem};
+        _timeColumn = ColumnIterator{timeColumn.begin(), timeColumn.end()};
+    } else {
+        _timeFieldIter = BSONObjIterator{timeFieldElem.Obj()};
+    }
 
     _metaValue = _bucket[timeseries::kBucketMetaFieldName];
     if (_spec.metaField) {
@@ -136,7 +148,14 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
 
         // Includes a field when '_unpackerBehavior' is 'kInclude' and it's found in 'fieldSet' or
         // _unpackerBehavior is 'kExclude' and it's not found in 'fieldSet'.
-        if (determineIncludeField(colName, _unpackerBehavior, _spec)) {
+        if (!determineIncludeField(colName, _unpackerBehavior, _spec)) {
+            continue;
+        }
+        if (compressed) {
+            BSONColumn column{elem};
+            _fieldColumns.emplace_back(colName.toString(),
+                                       ColumnIterator{column.begin(), column.end()});
+        } else {
             _fieldIters.emplace_back(colName.toString(), BSONObjIterator{elem.Obj()});
         }
     }
@@ -148,8 +167,103 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
         }
     }
 
-    // Save the measurement count for the bucket.
-    _numberOfMeasurements = computeMeasurementCount(timeFieldElem.objsize());
+    // Save the measurement count for the bucket. Compressed buckets record it in control.count.
+    if (compressed) {
+        auto countElem =
+            _bucket[timeseries::kBucketControlFieldName][timeseries::kBucketControlCountFieldName];
+        _numberOfMeasurements = countElem.isNumber() ? countElem.numberInt()
+                                                     : BSONColumn{timeFieldElem}.size();
+    } else {
+        _numberOfMeasurements = computeMeasurementCount(timeFieldElem.objsize());
+    }
+
+    if (!_measurementFilter.empty()) {
+        _selectMeasurements(dataRegion, timeFieldElem);
+        _skipUnselectedMeasurements();
+    }
+}
+
+void BucketUnpacker::_selectMeasurements(const BSONObj& dataRegion,
+                                         const BSONElement& timeFieldElem) {
+    // The matcher also compares against each element of an array, which can't be done with the
+    // array alone, so arrays always pass and are left for the caller to filter. A missing value is
+    // evaluated as EOO, as the matcher does for a missing top-level field.
+    auto passes = [](const PathMatchExpression& predicate, const BSONElement& value) {
+        return value.type() == Array || predicate.matchesSingleElement(value);
+    };
+
+    if (timeFieldElem.type() == BinData) {
+        auto numRows = BSONColumn{timeFieldElem}.size();
+        _selectedRows.assign(numRows, true);
+        for (auto&& predicate : _measurementFilter) {
+            auto columnElem = dataRegion[predicate->path()];
+            size_t row = 0;
+            if (columnElem.type() == BinData) {
+                BSONColumn column{columnElem};
+                for (auto it = column.begin(); it != column.end() && row < numRows; ++it, ++row) {
+                    if (_selectedRows[row] && !passes(*predicate, *it)) {
+                        _selectedRows[row] = false;
+                    }
+                }
+            }
+            for (; row < numRows; ++row) {
+                if (_selectedRows[row] && !passes(*predicate, BSONElement())) {
+                    _selectedRows[row] = false;
+                }
+            }
+        }
+        return;
+    }
+
+    auto timeObj = timeFieldElem.Obj();
+    _selectedRows.assign(timeObj.nFields(), true);
+    for (auto&& predicate : _measurementFilter) {
+        auto columnElem = dataRegion[predicate->path()];
+        auto columnObj = columnElem.type() == Object ? columnElem.Obj() : BSONObj();
+        auto columnIter = BSONObjIterator{columnObj};
+
+        // The rows of a column are a subset of the rows of the time column, in the same order.
+        size_t row = 0;
+        for (auto&& timeElem : timeObj) {
+            BSONElement value;
+            if (columnIter.more() &&
+                (*columnIter).fieldNameStringData() == timeElem.fieldNameStringData()) {
+                value = columnIter.next();
+            }
+            if (_selectedRows[row] && !passes(*predicate, value)) {
+                _selectedRows[row] = false;
+            }
+            ++row;
+        }
+    }
+}
+
+void BucketUnpacker::_skipUnselectedMeasurements() {
+    if (_selectedRows.empty()) {
+        return;
+    }
+
+    while (hasNext() && _rowIndex < _selectedRows.size() && !_selectedRows[_rowIndex]) {
+        if (_timeColumn) {
+            ++_timeColumn->it;
+            for (auto&& fieldColumn : _fieldColumns) {
+                auto& column = fieldColumn.second;
+                if (column.it != column.end) {
+                    ++column.it;
+                }
+            }
+        } else {
+            auto&& timeElem = _timeFieldIter->next();
+            for (auto&& fieldIter : _fieldIters) {
+                auto& colIter = fieldIter.second;
+                if (colIter.more() &&
+                    (*colIter).fieldNameStringData() == timeElem.fieldNameStringData()) {
+                    colIter.next();
+                }
+            }
+        }
+        ++_rowIndex;
+    }
 }
 
 void BucketUnpacker::setBucketSpecAndBehavior(BucketSpec&& bucketSpec, Behavior behavior) {
@@ -182,6 +296,10 @@ Document BucketUnpacker::getNext() {
     tassert(5521503, "'getNext()' requires the bucket to be owned", _bucket.isOwned());
     tassert(5422100, "'getNext()' was called after the bucket has been exhausted", hasNext());
 
+    if (_timeColumn) {
+        return _getNextFromColumns();
+    }
+
     auto measurement = MutableDocument{};
     auto&& timeElem = _timeFieldIter->next();
     if (_includeTimeField) {
@@ -206,6 +324,43 @@ Document BucketUnpacker::getNext() {
         measurement.addField(name, Value{_computedMetaProjections[name]});
     }
 
+    ++_rowIndex;
+    _skipUnselectedMeasurements();
+
+    return measurement.freeze();
+}
+
+Document BucketUnpacker::_getNextFromColumns() {
+    auto measurement = MutableDocument{};
+
+    // Values decoded by a column iterator only live until it is advanced, so they are copied into
+    // the measurement first.
+    if (_includeTimeField) {
+        measurement.addField(_spec.timeField, Value{*_timeColumn->it});
+    }
+    ++_timeColumn->it;
+
+    if (_includeMetaField && _metaValue) {
+        measurement.addField(*_spec.metaField, Value{_metaValue});
+    }
+
+    for (auto&& [colName, column] : _fieldColumns) {
+        if (column.it == column.end) {
+            continue;
+        }
+        if (auto&& elem = *column.it; !elem.eoo()) {
+            measurement.addField(colName, Value{elem});
+        }
+        ++column.it;
+    }
+
+    for (auto&& name : _spec.computedMetaProjFields) {
+        measurement.addField(name, Value{_computedMetaProjections[name]});
+    }
+
+    ++_rowIndex;
+    _skipUnselectedMeasurements();
+
     return measurement.freeze();
 }
 
@@ -230,6 +385,18 @@ Document BucketUnpacker::extractSingleMeasurement(int j) {
         if (!determineIncludeField(colName, _unpackerBehavior, _spec)) {
             continue;
         }
+        if (dataElem.type() == BinData) {
+            // A compressed column has to be decoded up to the j-th value.
+            BSONColumn column{dataElem};
+            auto it = column.begin();
+            for (int i = 0; i < j && it != column.end(); ++i) {
+                ++it;
+            }
+            if (it != column.end() && !it->eoo()) {
+                measurement.addField(colName, Value{*it});
+            }
+            continue;
+        }
         auto value = dataElem[targetIdx];
         if (value) {
             measurement.addField(dataElem.fieldNameStringData(), Value{value});
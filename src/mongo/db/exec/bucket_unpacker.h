@@ -30,10 +30,14 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/util/bsoncolumn.h"
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/matcher/expression_path.h"
 
 namespace mongo {
 /**
@@ -107,7 +111,8 @@ public:
     Document extractSingleMeasurement(int j);
 
     bool hasNext() const {
-        return _timeFieldIter && _timeFieldIter->more();
+        return (_timeFieldIter && _timeFieldIter->more()) ||
+            (_timeColumn && _timeColumn->it != _timeColumn->end);
     }
 
     /**
@@ -141,10 +146,41 @@ public:
 
     void setBucketSpecAndBehavior(BucketSpec&& bucketSpec, Behavior behavior);
 
+    /**
+     * Sets predicates on top-level measurement fields that are evaluated column by column over each
+     * bucket passed to 'reset()', before any measurement is materialized. 'getNext()' skips the
+     * measurements which do not satisfy all of them. A measurement whose value for a field is an
+     * array is never skipped on account of that field, so the caller must still apply the
+     * predicates to the unpacked measurements.
+     */
+    void setMeasurementFilter(std::vector<std::shared_ptr<const PathMatchExpression>> predicates) {
+        _measurementFilter = std::move(predicates);
+    }
+
+    const std::vector<std::shared_ptr<const PathMatchExpression>>& measurementFilter() const {
+        return _measurementFilter;
+    }
+
     // Add computed meta projection names to the bucket specification.
     void addComputedMetaProjFields(const std::vector<StringData>& computedFieldNames);
 
 private:
+    // Implements 'getNext()' for compressed buckets.
+    Document _getNextFromColumns();
+
+    // Evaluates '_measurementFilter' over the columns of 'dataRegion' and records which
+    // measurements pass it in '_selectedRows'.
+    void _selectMeasurements(const BSONObj& dataRegion, const BSONElement& timeFieldElem);
+
+    // Advances the iterators past the measurements that do not pass '_measurementFilter'.
+    void _skipUnselectedMeasurements();
+
+    // The position of the next value to unpack from a column of a compressed bucket.
+    struct ColumnIterator {
+        BSONColumn::Iterator it;
+        BSONColumn::Iterator end;
+    };
+
     BucketSpec _spec;
     Behavior _unpackerBehavior;
 
@@ -169,12 +205,27 @@ private:
     // phase according to the provided 'Behavior' and 'BucketSpec'.
     std::vector<std::pair<std::string, BSONObjIterator>> _fieldIters;
 
+    // Used instead of '_timeFieldIter' and '_fieldIters' when the bucket is compressed. All the
+    // columns of a compressed bucket have one value per measurement, so they advance together.
+    boost::optional<ColumnIterator> _timeColumn;
+    std::vector<std::pair<std::string, ColumnIterator>> _fieldColumns;
+
     // Map <name, BSONElement> for the computed meta field projections. Updated for
     // every bucket upon reset().
     stdx::unordered_map<std::string, BSONElement> _computedMetaProjections;
 
     // The number of measurements in the bucket.
     int32_t _numberOfMeasurements = 0;
+
+    // Predicates evaluated column-wise to skip measurements before they are materialized.
+    std::vector<std::shared_ptr<const PathMatchExpression>> _measurementFilter;
+
+    // Whether each measurement of the bucket passes '_measurementFilter', indexed by row. Empty
+    // when there is no filter.
+    std::vector<bool> _selectedRows;
+
+    // The row of the next measurement to be returned by 'getNext()'.
+    size_t _rowIndex = 0;
 };
 
 /**
@@ -30,6 +30,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/json.h"
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/exec/bucket_unpacker.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/unittest/unittest.h"
@@ -77,6 +79,30 @@ public:
     void assertGetNext(BucketUnpacker& unpacker, const Document& expected) {
         ASSERT_DOCUMENT_EQ(unpacker.getNext(), expected);
     }
+
+    /**
+     * Returns a copy of 'bucket' whose data region columns are stored as BSONColumns, keeping the
+     * rows in the order of their keys. Each column is as long as the time column.
+     */
+    BSONObj compressBucket(const BSONObj& bucket) {
+        auto numRows = bucket["data"][kUserDefinedTimeName].Obj().nFields();
+        BSONObjBuilder builder;
+        for (auto&& elem : bucket) {
+            if (elem.fieldNameStringData() != "data") {
+                builder.append(elem);
+                continue;
+            }
+            BSONObjBuilder dataBuilder(builder.subobjStart("data"));
+            for (auto&& column : elem.Obj()) {
+                BSONColumnBuilder columnBuilder(column.fieldNameStringData());
+                for (int row = 0; row < numRows; ++row) {
+                    columnBuilder.append(column.Obj()[std::to_string(row)]);
+                }
+                dataBuilder.append(columnBuilder.fieldName(), columnBuilder.finalize());
+            }
+        }
+        return builder.obj();
+    }
 };
 
 TEST_F(BucketUnpackerTest, UnpackBasicIncludeAllMeasurementFields) {
@@ -542,6 +568,135 @@ TEST_F(BucketUnpackerTest, ExtractSingleMeasurementSparse) {
     ASSERT_DOCUMENT_EQ(next, expected);
 }
 
+TEST_F(BucketUnpackerTest, UnpackCompressedBucketWithSparseColumns) {
+    std::set<std::string> fields{"b"};
+
+    auto bucket = compressBucket(fromjson(
+        "{meta: {'m1': 999, 'm2': 9999}, data: {_id: {'0':1, '1':2, '2':3}, time: {'0':1, '1':2, "
+        "'2':3}, a:{'0':1, '2':1}, b:{'1':1}, c:{'1':'x', '2':'x'}}}"));
+    ASSERT_EQ(bucket["data"]["time"].type(), BinData);
+
+    auto unpacker = makeBucketUnpacker(std::move(fields),
+                                       BucketUnpacker::Behavior::kExclude,
+                                       std::move(bucket),
+                                       kUserDefinedMetaName.toString());
+    ASSERT_EQ(unpacker.numberOfMeasurements(), 3);
+
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker,
+                  Document{fromjson("{time: 1, myMeta: {m1: 999, m2: 9999}, _id: 1, a: 1}")});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker,
+                  Document{fromjson("{time: 2, myMeta: {m1: 999, m2: 9999}, _id: 2, c: 'x'}")});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(
+        unpacker,
+        Document{fromjson("{time: 3, myMeta: {m1: 999, m2: 9999}, _id: 3, a: 1, c: 'x'}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+TEST_F(BucketUnpackerTest, UnpackCompressedBucketUsesControlCount) {
+    auto bucket = compressBucket(
+        fromjson("{control: {version: 2, count: 2}, data: {time: {'0':1, '1':2}, a:{'1':1}}}"));
+
+    auto unpacker = makeBucketUnpacker({"a"}, BucketUnpacker::Behavior::kInclude, bucket);
+    ASSERT_EQ(unpacker.numberOfMeasurements(), 2);
+    assertGetNext(unpacker, Document{});
+    assertGetNext(unpacker, Document{fromjson("{a: 1}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+TEST_F(BucketUnpackerTest, ExtractSingleMeasurementFromCompressedBucket) {
+    std::set<std::string> fields{
+        "_id", kUserDefinedMetaName.toString(), kUserDefinedTimeName.toString(), "a", "b"};
+    auto spec = BucketSpec{
+        kUserDefinedTimeName.toString(), kUserDefinedMetaName.toString(), std::move(fields)};
+    auto unpacker = BucketUnpacker{std::move(spec), BucketUnpacker::Behavior::kInclude};
+
+    auto d1 = dateFromISOString("2020-02-17T00:00:00.000Z").getValue();
+    auto d2 = dateFromISOString("2020-02-17T01:00:00.000Z").getValue();
+    auto d3 = dateFromISOString("2020-02-17T02:00:00.000Z").getValue();
+    auto bucket = compressBucket(BSON(
+        "meta" << BSON("m1" << 999 << "m2" << 9999) << "data"
+               << BSON("_id" << BSON("0" << 1 << "1" << 2 << "2" << 3) << "time"
+                             << BSON("0" << d1 << "1" << d2 << "2" << d3) << "a"
+                             << BSON("0" << 1 << "2" << 3) << "b" << BSON("1" << 1))));
+
+    unpacker.reset(std::move(bucket));
+    ASSERT_EQ(unpacker.numberOfMeasurements(), 3);
+
+    auto next = unpacker.extractSingleMeasurement(2);
+    auto expected = Document{
+        {"myMeta", Document{{"m1", 999}, {"m2", 9999}}}, {"_id", 3}, {"time", d3}, {"a", 3}};
+    ASSERT_DOCUMENT_EQ(next, expected);
+
+    next = unpacker.extractSingleMeasurement(1);
+    expected = Document{
+        {"myMeta", Document{{"m1", 999}, {"m2", 9999}}}, {"_id", 2}, {"time", d2}, {"b", 1}};
+    ASSERT_DOCUMENT_EQ(next, expected);
+}
+
+TEST_F(BucketUnpackerTest, MeasurementFilterSkipsMeasurementsBeforeMaterializing) {
+    auto bucket = fromjson(
+        "{meta: {'m1': 999}, data: {_id: {'0':1, '1':2, '2':3, '3':4}, time: {'0':1, '1':2, "
+        "'2':3, '3':4}, a:{'0':1, '1':5, '2':7, '3':2}, b:{'1':1, '3':1}}}");
+
+    auto unpacker = makeBucketUnpacker(
+        {"_id", "b"}, BucketUnpacker::Behavior::kInclude, bucket, kUserDefinedMetaName.toString());
+    unpacker.setMeasurementFilter({std::make_shared<GTMatchExpression>("a"_sd, Value(3))});
+    unpacker.reset(BSONObj(bucket));
+
+    // The filter applies to the 'a' column even though it isn't unpacked.
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{_id: 2, b: 1}")});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{_id: 3}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+TEST_F(BucketUnpackerTest, MeasurementFilterRejectsMissingValuesAndKeepsArrays) {
+    auto bucket = fromjson(
+        "{data: {time: {'0':1, '1':2, '2':3, '3':4}, a:{'0':1, '2':[1, 5], '3':'x'}, "
+        "b:{'0':1, '1':1, '2':1, '3':1}}}");
+
+    auto unpacker = makeBucketUnpacker({"time", "a"}, BucketUnpacker::Behavior::kInclude, bucket);
+    unpacker.setMeasurementFilter({std::make_shared<LTMatchExpression>("a"_sd, Value(3)),
+                                   std::make_shared<EqualityMatchExpression>("b"_sd, Value(1))});
+    unpacker.reset(BSONObj(bucket));
+
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{time: 1, a: 1}")});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{time: 3, a: [1, 5]}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+TEST_F(BucketUnpackerTest, MeasurementFilterOnCompressedBucket) {
+    auto bucket = compressBucket(
+        fromjson("{data: {time: {'0':1, '1':2, '2':3}, a:{'0':1, '2':7}, b:{'1':1, '2':2}}}"));
+
+    auto unpacker = makeBucketUnpacker({"a"}, BucketUnpacker::Behavior::kExclude, bucket);
+    unpacker.setMeasurementFilter({std::make_shared<GTEMatchExpression>("a"_sd, Value(1))});
+    unpacker.reset(BSONObj(bucket));
+
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{time: 1}")});
+    ASSERT_TRUE(unpacker.hasNext());
+    assertGetNext(unpacker, Document{fromjson("{time: 3, b: 2}")});
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
+TEST_F(BucketUnpackerTest, MeasurementFilterCanRejectWholeBucket) {
+    auto bucket = fromjson("{data: {time: {'0':1, '1':2}, a:{'0':1, '1':2}}}");
+
+    auto unpacker = makeBucketUnpacker({}, BucketUnpacker::Behavior::kExclude, bucket);
+    unpacker.setMeasurementFilter({std::make_shared<GTMatchExpression>("a"_sd, Value(2))});
+    unpacker.reset(BSONObj(bucket));
+
+    ASSERT_EQ(unpacker.numberOfMeasurements(), 2);
+    ASSERT_FALSE(unpacker.hasNext());
+}
+
 TEST_F(BucketUnpackerTest, ComputeMeasurementCountLowerBoundsAreCorrect) {
     // The last table entry is a sentinel for an upper bound on the interval that covers measurement
     // counts up to 16 MB.
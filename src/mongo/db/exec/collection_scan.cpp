@@ -42,6 +42,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/fail_point.h"
@@ -62,7 +63,8 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     : RequiresCollectionStage(kStageType, expCtx, collection),
       _workingSet(workingSet),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
-      _params(params) {
+      _params(params),
+      _useBatches(!params.tailable && !collection->isCapped()) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     _specificStats.minRecord = params.minRecord;
@@ -179,7 +181,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
 
         if (!record) {
-            record = _cursor->next();
+            record = nextRecord();
         }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
@@ -211,12 +213,33 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
-    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson());
+    member->resetDocument(_batchSnapshotId, record->data.releaseToBson());
     _workingSet->transitionToRecordIdAndObj(id);
 
     return returnIfMatches(member, id, out);
 }
 
+boost::optional<Record> CollectionScan::nextRecord() {
+    if (_batchPosition == _batch.size()) {
+        // A batch of one record would only add a copy of it, so the cursor is read directly.
+        const auto batchSize = internalQueryCollectionScanBatchSize.load();
+        if (!_useBatches || batchSize <= 1) {
+            auto record = _cursor->next();
+            _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+            return record;
+        }
+
+        _batchPosition = 0;
+        _cursor->nextBatch(&_batch, batchSize);
+        _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+        if (_batch.empty()) {
+            return boost::none;
+        }
+    }
+
+    return std::move(_batch[_batchPosition++]);
+}
+
 void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
@@ -292,6 +315,12 @@ bool CollectionScan::isEOF() {
 }
 
 void CollectionScan::doSaveStateRequiresCollection() {
+    // The records which have been fetched but not returned yet are only valid until the cursor is
+    // saved, so take ownership of them first.
+    for (size_t i = _batchPosition; i < _batch.size(); ++i) {
+        _batch[i].data.makeOwned();
+    }
+
     if (_cursor) {
         _cursor->save();
     }
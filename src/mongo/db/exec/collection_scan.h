@@ -30,11 +30,14 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/s/resharding/resume_token_gen.h"
 
 namespace mongo {
@@ -117,6 +120,14 @@ private:
      */
     void assertTsHasNotFallenOffOplog(const Record& record);
 
+    /**
+     * Returns the next record of the scan, taking it from '_batch' if possible and otherwise
+     * fetching up to 'internalQueryCollectionScanBatchSize' more records from '_cursor'. When that
+     * knob is 1, the record is read from '_cursor' directly. Can throw a WriteConflictException, in
+     * which case no record is considered consumed.
+     */
+    boost::optional<Record> nextRecord();
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
@@ -129,6 +140,15 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Records fetched from '_cursor' but not yet returned by this stage, and the snapshot the last
+    // record returned by nextRecord() was read in. Batching is only done for scans which are neither tailable nor over a capped
+    // collection, so that the cursor never has to restore a position past '_lastSeenId' which may
+    // have been removed from under it.
+    const bool _useBatches;
+    std::vector<Record> _batch;
+    size_t _batchPosition = 0;
+    SnapshotId _batchSnapshotId;
+
     // If _params.shouldTrackLatestOplogTimestamp is set and the collection is the oplog, the latest
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
@@ -386,6 +386,11 @@ static stdx::unordered_map<std::string, BuiltinFn> kBuiltinFunctions = {
     {"addToArray", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::addToArray, true}},
     {"addToSet", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::addToSet, true}},
     {"collAddToSet", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::collAddToSet, true}},
+    {"aggConcatArrays",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggConcatArrays, true}},
+    {"aggSetUnion", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggSetUnion, true}},
+    {"aggCollSetUnion",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::aggCollSetUnion, true}},
     {"doubleDoubleSum",
      BuiltinFn{[](size_t n) { return n > 0; }, vm::Builtin::doubleDoubleSum, false}},
     {"bitTestZero", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::bitTestZero, false}},
@@ -512,6 +517,43 @@ static stdx::unordered_map<std::string, InstrFn> kInstrFunctions = {
 };
 }  // namespace
 
+std::unique_ptr<vm::CodeFragment> EFunction::compileImmediateInstruction(CompileCtx& ctx) const {
+    // The field name of 'getField' and the default value of 'fillEmpty' are nearly always
+    // constants. Encoding them directly in the instruction saves pushing the constant on the stack
+    // and popping it again for every row, which adds up in filter-heavy scans.
+    if (_nodes.size() != 2) {
+        return nullptr;
+    }
+    auto constant = dynamic_cast<const EConstant*>(_nodes[1].get());
+    if (!constant) {
+        return nullptr;
+    }
+    auto [tag, val] = constant->getConstant();
+
+    if (_name == "getField" && value::isString(tag)) {
+        auto fieldName = value::getStringView(tag, val);
+        if (fieldName.size() > std::numeric_limits<uint8_t>::max()) {
+            return nullptr;
+        }
+
+        auto code = _nodes[0]->compile(ctx);
+        code->appendGetField(fieldName);
+        return code;
+    }
+
+    if (_name == "fillEmpty" && (tag == value::TypeTags::Null || tag == value::TypeTags::Boolean)) {
+        auto k = tag == value::TypeTags::Null
+            ? vm::Instruction::Null
+            : (value::bitcastTo<bool>(val) ? vm::Instruction::True : vm::Instruction::False);
+
+        auto code = _nodes[0]->compile(ctx);
+        code->appendFillEmpty(k);
+        return code;
+    }
+
+    return nullptr;
+}
+
 std::unique_ptr<vm::CodeFragment> EFunction::compile(CompileCtx& ctx) const {
     if (auto it = kBuiltinFunctions.find(_name); it != kBuiltinFunctions.end()) {
         auto arity = _nodes.size();
@@ -546,6 +588,11 @@ std::unique_ptr<vm::CodeFragment> EFunction::compile(CompileCtx& ctx) const {
                       str::stream()
                           << "function call: " << _name << " has wrong arity: " << _nodes.size());
         }
+
+        if (auto code = compileImmediateInstruction(ctx)) {
+            return code;
+        }
+
         auto code = std::make_unique<vm::CodeFragment>();
 
         if (it->second.aggregate) {
@@ -886,6 +933,31 @@ std::unique_ptr<RuntimeEnvironment> RuntimeEnvironment::makeCopy(bool isSmp) {
     return std::unique_ptr<RuntimeEnvironment>(new RuntimeEnvironment(*this));
 }
 
+std::unique_ptr<RuntimeEnvironment> RuntimeEnvironment::makeDeepCopy() const {
+    tassert(5754707, "Cannot make a deep copy of a parallel environment", !_isSmp);
+
+    auto env = std::make_unique<RuntimeEnvironment>();
+    auto& state = *env->_state;
+    state.namedSlots = _state->namedSlots;
+    state.slots = _state->slots;
+    state.typeTags = _state->typeTags;
+    state.vals = _state->vals;
+    state.owned = _state->owned;
+
+    for (size_t idx = 0; idx < state.vals.size(); ++idx) {
+        if (state.owned[idx]) {
+            std::tie(state.typeTags[idx], state.vals[idx]) =
+                value::copyValue(state.typeTags[idx], state.vals[idx]);
+        }
+    }
+
+    for (auto&& [slotId, index] : state.slots) {
+        env->emplaceAccessor(slotId, index);
+    }
+
+    return env;
+}
+
 void RuntimeEnvironment::debugString(StringBuilder* builder) {
     using namespace std::literals;
 
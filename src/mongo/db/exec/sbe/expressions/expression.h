@@ -165,6 +165,16 @@ public:
      */
     std::unique_ptr<RuntimeEnvironment> makeCopy(bool isSmp);
 
+    /**
+     * Make a deep copy of this environment. Unlike 'makeCopy()', the new environment does not share
+     * slot values with this environment: owned values are copied, and unowned values are copied as
+     * views. The copy can be used independently of this environment, for example when a cached
+     * plan is cloned for execution by another query.
+     *
+     * Must not be called on a parallel environment.
+     */
+    std::unique_ptr<RuntimeEnvironment> makeDeepCopy() const;
+
     /**
      * Dumps all the slots currently defined in this environment into the given string builder.
      */
@@ -353,6 +363,10 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    std::pair<value::TypeTags, value::Value> getConstant() const {
+        return {_tag, _val};
+    }
+
 private:
     value::TypeTags _tag;
     value::Value _val;
@@ -481,6 +495,13 @@ public:
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
 private:
+    /**
+     * Compiles calls to instruction functions whose last argument is a constant which can be
+     * encoded in the instruction itself (e.g. the field name of 'getField'). Returns nullptr if
+     * this function call does not have such a form.
+     */
+    std::unique_ptr<vm::CodeFragment> compileImmediateInstruction(CompileCtx& ctx) const;
+
     std::string _name;
 };
 
@@ -1133,6 +1133,8 @@ void Parser::walkGroup(AstQuery& ast) {
         lookupSlots(std::move(ast.nodes[1]->projects)),
         collatorSlotPos ? lookupSlot(std::move(ast.nodes[collatorSlotPos]->identifier))
                         : boost::none,
+        std::numeric_limits<size_t>::max(),
+        false,
         getCurrentPlanNodeId());
 }
 
@@ -1156,6 +1158,8 @@ void Parser::walkHashJoin(AstQuery& ast) {
                              lookupSlots(innerNode->nodes[0]->identifiers),  // inner conditions
                              lookupSlots(innerNode->nodes[1]->identifiers),  // inner projections
                              collatorSlot,                                   // collator
+                             std::numeric_limits<size_t>::max(),             // memory limit
+                             false,                                          // allow disk use
                              getCurrentPlanNodeId());
 }
 
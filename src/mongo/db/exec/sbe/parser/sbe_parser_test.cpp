@@ -364,6 +364,8 @@ protected:
                             stage_builder::makeFunction(
                                 "max", sbe::makeE<sbe::EVariable>(sbe::value::SlotId{1}))),
                 boost::none, /* optional collator slot */
+                std::numeric_limits<size_t>::max(),
+                false,
                 planNodeId),
             // GROUP with a collator slot.
             sbe::makeS<sbe::HashAggStage>(
@@ -376,6 +378,8 @@ protected:
                             stage_builder::makeFunction(
                                 "max", sbe::makeE<sbe::EVariable>(sbe::value::SlotId{1}))),
                 sbe::value::SlotId{4}, /* optional collator slot */
+                std::numeric_limits<size_t>::max(),
+                false,
                 planNodeId),
             // LIMIT
             sbe::makeS<sbe::LimitSkipStage>(
@@ -424,6 +428,8 @@ protected:
                                            sbe::makeSV(1, 2) /* inner conditions */,
                                            sbe::makeSV(5, 6) /* inner projections */,
                                            boost::none, /* optional collator slot */
+                                           std::numeric_limits<size_t>::max(),
+                                           false,
                                            planNodeId),
             // HJOIN with a collator slot.
             sbe::makeS<sbe::HashJoinStage>(sbe::makeS<sbe::CoScanStage>(planNodeId),
@@ -433,6 +439,8 @@ protected:
                                            sbe::makeSV(1, 2) /* inner conditions */,
                                            sbe::makeSV(5, 6) /* inner projections */,
                                            sbe::value::SlotId{7}, /* optional collator slot */
+                                           std::numeric_limits<size_t>::max(),
+                                           false,
                                            planNodeId),
             // FILTER
             sbe::makeS<sbe::FilterStage<false>>(
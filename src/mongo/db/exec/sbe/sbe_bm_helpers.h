@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * Document shapes shared by the SBE benchmarks, so that the costs they measure for the VM, the
+ * stages and the scans of a record store can be compared with each other.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/random.h"
+
+namespace mongo::sbe {
+
+// Number of distinct values of the 'g' field, i.e. the number of groups for $group-like plans and
+// the number of rows on the build side of a join.
+constexpr int kNumGroups = 100;
+
+// Values of the 'k' field are uniformly distributed in [0, kKeyRange).
+constexpr int kKeyRange = 1000;
+
+/**
+ * Registers the document shapes a benchmark is run with, as pairs of (number of filler fields, size
+ * of each filler value in bytes).
+ */
+inline void documentShapes(benchmark::internal::Benchmark* bm) {
+    bm->ArgNames({"fields", "valueSize"});
+    for (int numFields : {4, 32}) {
+        for (int valueSize : {8, 256}) {
+            bm->Args({numFields, valueSize});
+        }
+    }
+}
+
+/**
+ * Builds 'numDocuments' documents of the shape requested by the arguments of 'state', as registered
+ * by documentShapes(). Every document has an integer '_id', followed by the filler fields and by
+ * the integer fields 'g' and 'k', so that looking up the fields used by a plan has to skip over
+ * the filler fields.
+ */
+inline std::vector<BSONObj> makeShapedDocuments(const benchmark::State& state,
+                                                size_t numDocuments) {
+    const auto numFields = state.range(0);
+    const std::string value(state.range(1), 'x');
+
+    PseudoRandom random(1);
+    std::vector<BSONObj> docs;
+    docs.reserve(numDocuments);
+    for (size_t i = 0; i < numDocuments; ++i) {
+        BSONObjBuilder bob;
+        bob.append("_id", static_cast<int>(i));
+        for (int64_t field = 0; field < numFields; ++field) {
+            bob.append("f" + std::to_string(field), value);
+        }
+        bob.append("g", static_cast<int>(i % kNumGroups));
+        bob.append("k", random.nextInt32(kKeyRange));
+        docs.push_back(bob.obj());
+    }
+    return docs;
+}
+
+}  // namespace mongo::sbe
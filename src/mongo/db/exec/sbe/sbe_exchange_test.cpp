@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for sbe::ExchangeConsumer and sbe::ExchangeProducer.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
+
+namespace mongo::sbe {
+
+class ExchangeStageTest : public PlanStageTestFixture {
+public:
+    /**
+     * Makes an exchange whose 'numProducers' producers each scan the integers [0, numValues).
+     */
+    std::pair<value::SlotId, std::unique_ptr<PlanStage>> makeExchange(size_t numProducers,
+                                                                      int64_t numValues) {
+        auto [inputTag, inputVal] = value::makeNewArray();
+        value::ValueGuard inputGuard{inputTag, inputVal};
+        auto inputView = value::getArrayView(inputVal);
+        for (int64_t i = 0; i < numValues; ++i) {
+            inputView->push_back(value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(i));
+        }
+
+        inputGuard.reset();
+        auto [scanSlot, scanStage] = generateVirtualScan(inputTag, inputVal);
+        auto exchange = makeS<ExchangeConsumer>(std::move(scanStage),
+                                                numProducers,
+                                                makeSV(scanSlot),
+                                                ExchangePolicy::roundrobin,
+                                                nullptr,
+                                                nullptr,
+                                                kEmptyPlanNodeId);
+        return {scanSlot, std::move(exchange)};
+    }
+};
+
+TEST_F(ExchangeStageTest, EveryProducerRunsAClonedSubtree) {
+    constexpr size_t kNumProducers = 4;
+    constexpr int64_t kNumValues = 1000;
+
+    auto ctx = makeCompileCtx();
+    auto [scanSlot, exchange] = makeExchange(kNumProducers, kNumValues);
+    auto resultAccessor = prepareTree(ctx.get(), exchange.get(), scanSlot);
+
+    // The producers do not partition their input, so every value is returned once per producer.
+    int64_t count = 0;
+    int64_t sum = 0;
+    while (exchange->getNext() == PlanState::ADVANCED) {
+        auto [tag, val] = resultAccessor->getViewOfValue();
+        ASSERT_TRUE(tag == value::TypeTags::NumberInt64);
+        sum += value::bitcastTo<int64_t>(val);
+        ++count;
+    }
+    exchange->close();
+
+    ASSERT_EQ(count, static_cast<int64_t>(kNumProducers) * kNumValues);
+    ASSERT_EQ(sum, static_cast<int64_t>(kNumProducers) * kNumValues * (kNumValues - 1) / 2);
+
+    // The subtree is owned by the producers once opened; the stats of every producer are reported
+    // as children of the consumer after it is closed.
+    auto stats = exchange->getStats(false);
+    ASSERT_EQ(stats->children.size(), kNumProducers);
+    for (auto&& producerStats : stats->children) {
+        ASSERT_EQ(producerStats->common.closes, 1U);
+        ASSERT_EQ(producerStats->children.size(), 1U);
+    }
+    ASSERT_FALSE(DebugPrinter{}.print(*exchange).empty());
+}
+
+TEST_F(ExchangeStageTest, CloseBeforeEofStopsTheProducers) {
+    // The producers produce far more than fits in the pipe, so they are blocked waiting for empty
+    // buffers when the consumer is closed.
+    auto ctx = makeCompileCtx();
+    auto [scanSlot, exchange] = makeExchange(4, 100000);
+    prepareTree(ctx.get(), exchange.get(), scanSlot);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(exchange->getNext(), PlanState::ADVANCED);
+    }
+    exchange->close();
+
+    auto stats = exchange->getStats(false);
+    ASSERT_EQ(stats->children.size(), 4U);
+}
+
+TEST_F(ExchangeStageTest, KillingTheConsumerStopsTheProducers) {
+    auto ctx = makeCompileCtx();
+    auto [scanSlot, stage] = makeExchange(4, 100000);
+    auto exchange = stage.get();
+    prepareTree(ctx.get(), exchange, scanSlot);
+
+    ASSERT_EQ(exchange->getNext(), PlanState::ADVANCED);
+    {
+        stdx::lock_guard<Client> clientLock(*opCtx()->getClient());
+        opCtx()->getServiceContext()->killOperation(clientLock, opCtx(), ErrorCodes::Interrupted);
+    }
+    ASSERT_THROWS_CODE(
+        [&] {
+            while (exchange->getNext() == PlanState::ADVANCED) {
+            }
+        }(),
+        DBException,
+        ErrorCodes::Interrupted);
+
+    // The producers were interrupted along with the consumer, which is not reported again.
+    exchange->close();
+}
+
+TEST_F(ExchangeStageTest, ProducersInheritTheConsumerDeadline) {
+    auto ctx = makeCompileCtx();
+    auto [scanSlot, stage] = makeExchange(4, 100000);
+    auto exchange = stage.get();
+
+    opCtx()->setDeadlineAfterNowBy(Milliseconds(0), ErrorCodes::MaxTimeMSExpired);
+    prepareTree(ctx.get(), exchange, scanSlot);
+
+    ASSERT_THROWS_CODE(
+        [&] {
+            while (exchange->getNext() == PlanState::ADVANCED) {
+            }
+        }(),
+        DBException,
+        ErrorCodes::MaxTimeMSExpired);
+    exchange->close();
+}
+
+}  // namespace mongo::sbe
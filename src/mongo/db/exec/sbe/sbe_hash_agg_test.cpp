@@ -35,8 +35,12 @@
 
 
 #include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 
@@ -82,6 +86,8 @@ TEST_F(HashAggStageTest, HashAggMinMaxTest) {
                    stage_builder::makeFunction(
                        "collMax", collExpr->clone(), makeE<EVariable>(scanSlot))),
             boost::none,
+            std::numeric_limits<size_t>::max(),
+            false,
             kEmptyPlanNodeId);
 
         auto outSlot = generateSlotId();
@@ -136,6 +142,8 @@ TEST_F(HashAggStageTest, HashAggAddToSetTest) {
                    stage_builder::makeFunction(
                        "collAddToSet", std::move(collExpr), makeE<EVariable>(scanSlot))),
             boost::none,
+            std::numeric_limits<size_t>::max(),
+            false,
             kEmptyPlanNodeId);
 
         return std::make_pair(hashAggSlot, std::move(hashAggStage));
@@ -220,6 +228,8 @@ TEST_F(HashAggStageTest, HashAggCollationTest) {
                                                makeE<EConstant>(value::TypeTags::NumberInt64,
                                                                 value::bitcastFrom<int64_t>(1)))),
                                     boost::optional<value::SlotId>{useCollator, collatorSlot},
+                                    std::numeric_limits<size_t>::max(),
+                                    false,
                                     kEmptyPlanNodeId);
 
             return std::make_pair(countsSlot, std::move(hashAggStage));
@@ -280,4 +290,192 @@ TEST_F(HashAggStageTest, HashAggCollationTest) {
     }
 }
 
+TEST_F(HashAggStageTest, HashAggSpillsToDiskWhenMemoryLimitIsExceeded) {
+    unittest::TempDir tempDir("HashAggStageTest");
+    auto originalDbPath = storageGlobalParams.dbpath;
+    storageGlobalParams.dbpath = tempDir.path();
+    ON_BLOCK_EXIT([&] { storageGlobalParams.dbpath = originalDbPath; });
+
+    // Build 100 groups of 10 rows each, interleaved so that the groups which do not fit in memory
+    // keep receiving rows after the hash table has been frozen.
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 1000; ++i) {
+        bab.append(BSON_ARRAY(i % 100 << 1LL));
+    }
+    auto [scanSlots, scanStage] = generateVirtualScanMulti(2, bab.arr());
+
+    auto sumSlot = generateSlotId();
+    auto stage = makeS<HashAggStage>(
+        std::move(scanStage),
+        makeSV(scanSlots[0]),
+        makeEM(sumSlot, stage_builder::makeFunction("sum", makeE<EVariable>(scanSlots[1]))),
+        boost::none,
+        1024 /* memoryLimit */,
+        true /* allowDiskUse */,
+        kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto accessors = prepareTree(ctx.get(), stage.get(), makeSV(scanSlots[0], sumSlot));
+
+    std::map<int32_t, int64_t> sums;
+    while (stage->getNext() == PlanState::ADVANCED) {
+        auto [keyTag, keyVal] = accessors[0]->getViewOfValue();
+        ASSERT_EQ(keyTag, value::TypeTags::NumberInt32);
+        auto [sumTag, sumVal] = accessors[1]->getViewOfValue();
+        ASSERT_EQ(sumTag, value::TypeTags::NumberInt64);
+
+        // Every group must be produced exactly once.
+        auto [it, inserted] =
+            sums.emplace(value::bitcastTo<int32_t>(keyVal), value::bitcastTo<int64_t>(sumVal));
+        ASSERT(inserted);
+    }
+
+    ASSERT_EQ(sums.size(), 100U);
+    for (auto&& [key, sum] : sums) {
+        ASSERT_EQ(sum, 10) << "group " << key;
+    }
+
+    auto stats = static_cast<const HashAggStats*>(stage->getSpecificStats());
+    ASSERT_GT(stats->spills, 0U);
+    ASSERT_GT(stats->spilledRecords, 0U);
+
+    stage->close();
+}
+
+TEST_F(HashAggStageTest, HashAggFailsWhenMemoryLimitIsExceededWithoutDiskUse) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 1000; ++i) {
+        bab.append(i);
+    }
+    auto [scanSlot, scanStage] = generateVirtualScan(bab.arr());
+
+    auto countSlot = generateSlotId();
+    auto stage = makeS<HashAggStage>(
+        std::move(scanStage),
+        makeSV(scanSlot),
+        makeEM(countSlot,
+               stage_builder::makeFunction(
+                   "sum",
+                   makeE<EConstant>(value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(1)))),
+        boost::none,
+        1024 /* memoryLimit */,
+        false /* allowDiskUse */,
+        kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    ASSERT_THROWS_CODE(prepareTree(ctx.get(), stage.get(), countSlot),
+                       DBException,
+                       ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
+TEST_F(HashAggStageTest, HashAggFailsWhenGroupsInMemoryGrowPastTheLimitWhileSpilling) {
+    unittest::TempDir tempDir("HashAggStageTest");
+    auto originalDbPath = storageGlobalParams.dbpath;
+    storageGlobalParams.dbpath = tempDir.path();
+    ON_BLOCK_EXIT([&] { storageGlobalParams.dbpath = originalDbPath; });
+
+    // The first 100 rows fill the hash table until it is frozen, the remaining ones keep adding
+    // distinct values to the set of group 0, which stays in memory.
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(BSON_ARRAY(i << 0));
+    }
+    for (int i = 1; i <= 5000; ++i) {
+        bab.append(BSON_ARRAY(0 << i));
+    }
+    auto [scanSlots, scanStage] = generateVirtualScanMulti(2, bab.arr());
+
+    auto setSlot = generateSlotId();
+    auto stage = makeS<HashAggStage>(
+        std::move(scanStage),
+        makeSV(scanSlots[0]),
+        makeEM(setSlot, stage_builder::makeFunction("addToSet", makeE<EVariable>(scanSlots[1]))),
+        boost::none,
+        1024 /* memoryLimit */,
+        true /* allowDiskUse */,
+        kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    ASSERT_THROWS_CODE(prepareTree(ctx.get(), stage.get(), setSlot),
+                       DBException,
+                       ErrorCodes::ExceededMemoryLimit);
+}
+
+TEST_F(HashAggStageTest, HashAggMergesPartialAggregatesFromExchangeProducers) {
+    constexpr size_t kNumProducers = 3;
+    constexpr int64_t kNumValues = 5;
+
+    auto [inputTag, inputVal] = value::makeNewArray();
+    value::ValueGuard inputGuard{inputTag, inputVal};
+    for (int64_t i = 0; i < kNumValues; ++i) {
+        value::getArrayView(inputVal)->push_back(value::TypeTags::NumberInt64,
+                                                 value::bitcastFrom<int64_t>(i));
+    }
+    inputGuard.reset();
+    auto [scanSlot, scanStage] = generateVirtualScan(inputTag, inputVal);
+
+    // Every producer computes the partial aggregates over its own copy of the input.
+    auto partialMinSlot = generateSlotId();
+    auto partialPushSlot = generateSlotId();
+    auto partialSetSlot = generateSlotId();
+    auto partialAgg = makeS<HashAggStage>(
+        std::move(scanStage),
+        makeSV(),
+        makeEM(partialMinSlot,
+               stage_builder::makeFunction("min", makeE<EVariable>(scanSlot)),
+               partialPushSlot,
+               stage_builder::makeFunction("addToArray", makeE<EVariable>(scanSlot)),
+               partialSetSlot,
+               stage_builder::makeFunction("addToSet", makeE<EVariable>(scanSlot))),
+        boost::none,
+        std::numeric_limits<size_t>::max(),
+        false,
+        kEmptyPlanNodeId);
+
+    auto exchange = makeS<ExchangeConsumer>(std::move(partialAgg),
+                                            kNumProducers,
+                                            makeSV(partialMinSlot, partialPushSlot, partialSetSlot),
+                                            ExchangePolicy::roundrobin,
+                                            nullptr,
+                                            nullptr,
+                                            kEmptyPlanNodeId);
+
+    // The partial aggregates are merged above the exchange.
+    auto minSlot = generateSlotId();
+    auto pushSlot = generateSlotId();
+    auto setSlot = generateSlotId();
+    auto mergeAgg = makeS<HashAggStage>(
+        std::move(exchange),
+        makeSV(),
+        makeEM(minSlot,
+               stage_builder::makeFunction("min", makeE<EVariable>(partialMinSlot)),
+               pushSlot,
+               stage_builder::makeFunction("aggConcatArrays", makeE<EVariable>(partialPushSlot)),
+               setSlot,
+               stage_builder::makeFunction("aggSetUnion", makeE<EVariable>(partialSetSlot))),
+        boost::none,
+        std::numeric_limits<size_t>::max(),
+        false,
+        kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto accessors = prepareTree(ctx.get(), mergeAgg.get(), makeSV(minSlot, pushSlot, setSlot));
+    ASSERT_TRUE(mergeAgg->getNext() == PlanState::ADVANCED);
+
+    auto [minTag, minVal] = accessors[0]->getViewOfValue();
+    ASSERT_TRUE(minTag == value::TypeTags::NumberInt64);
+    ASSERT_EQ(value::bitcastTo<int64_t>(minVal), 0);
+
+    auto [pushTag, pushVal] = accessors[1]->getViewOfValue();
+    ASSERT_TRUE(pushTag == value::TypeTags::Array);
+    ASSERT_EQ(value::getArrayView(pushVal)->size(), kNumProducers * kNumValues);
+
+    auto [setTag, setVal] = accessors[2]->getViewOfValue();
+    ASSERT_TRUE(setTag == value::TypeTags::ArraySet);
+    ASSERT_EQ(value::getArraySetView(setVal)->size(), static_cast<size_t>(kNumValues));
+
+    ASSERT_TRUE(mergeAgg->getNext() == PlanState::IS_EOF);
+    mergeAgg->close();
+}
+
 }  // namespace mongo::sbe
@@ -37,6 +37,9 @@
 #include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
 #include "mongo/db/exec/sbe/stages/hash_join.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 
@@ -79,6 +82,8 @@ TEST_F(HashJoinStageTest, HashJoinCollationTest) {
                                      makeSV(innerCondSlot),
                                      makeSV(),
                                      boost::optional<value::SlotId>{useCollator, collatorSlot},
+                                     std::numeric_limits<size_t>::max(),
+                                     false,
                                      kEmptyPlanNodeId);
 
             return std::make_pair(makeSV(innerCondSlot, outerCondSlot), std::move(hashJoinStage));
@@ -136,4 +141,86 @@ TEST_F(HashJoinStageTest, HashJoinCollationTest) {
     }
 }
 
+TEST_F(HashJoinStageTest, HashJoinSpillsToDiskWhenMemoryLimitIsExceeded) {
+    unittest::TempDir tempDir("HashJoinStageTest");
+    auto originalDbPath = storageGlobalParams.dbpath;
+    storageGlobalParams.dbpath = tempDir.path();
+    ON_BLOCK_EXIT([&] { storageGlobalParams.dbpath = originalDbPath; });
+
+    // The outer side holds the keys [0, 500) while the inner side holds each of the keys
+    // [0, 1000) twice, so every outer row is expected to be joined with two inner rows.
+    BSONArrayBuilder outerBab;
+    for (int i = 0; i < 500; ++i) {
+        outerBab.append(i);
+    }
+    BSONArrayBuilder innerBab;
+    for (int i = 0; i < 2000; ++i) {
+        innerBab.append(i % 1000);
+    }
+    auto [outerCondSlot, outerStage] = generateVirtualScan(outerBab.arr());
+    auto [innerCondSlot, innerStage] = generateVirtualScan(innerBab.arr());
+
+    auto stage = makeS<HashJoinStage>(std::move(outerStage),
+                                      std::move(innerStage),
+                                      makeSV(outerCondSlot),
+                                      makeSV(),
+                                      makeSV(innerCondSlot),
+                                      makeSV(),
+                                      boost::none,
+                                      1024 /* memoryLimit */,
+                                      true /* allowDiskUse */,
+                                      kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto accessors = prepareTree(ctx.get(), stage.get(), makeSV(outerCondSlot, innerCondSlot));
+
+    std::map<int32_t, size_t> matches;
+    while (stage->getNext() == PlanState::ADVANCED) {
+        auto [outerTag, outerVal] = accessors[0]->getViewOfValue();
+        ASSERT_EQ(outerTag, value::TypeTags::NumberInt32);
+        auto [innerTag, innerVal] = accessors[1]->getViewOfValue();
+        ASSERT_EQ(innerTag, value::TypeTags::NumberInt32);
+        ASSERT_EQ(value::bitcastTo<int32_t>(outerVal), value::bitcastTo<int32_t>(innerVal));
+
+        ++matches[value::bitcastTo<int32_t>(outerVal)];
+    }
+
+    ASSERT_EQ(matches.size(), 500U);
+    for (auto&& [key, count] : matches) {
+        ASSERT_EQ(count, 2U) << "key " << key;
+    }
+
+    auto stats = static_cast<const HashJoinStats*>(stage->getSpecificStats());
+    ASSERT_GT(stats->spilledPartitions, 0U);
+    ASSERT_GT(stats->spilledBuildRecords, 0U);
+    ASSERT_GT(stats->spilledProbeRecords, 0U);
+
+    stage->close();
+}
+
+TEST_F(HashJoinStageTest, HashJoinFailsWhenMemoryLimitIsExceededWithoutDiskUse) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 500; ++i) {
+        bab.append(i);
+    }
+    auto [outerCondSlot, outerStage] = generateVirtualScan(bab.arr());
+    auto [innerCondSlot, innerStage] = generateVirtualScan(bab.arr());
+
+    auto stage = makeS<HashJoinStage>(std::move(outerStage),
+                                      std::move(innerStage),
+                                      makeSV(outerCondSlot),
+                                      makeSV(),
+                                      makeSV(innerCondSlot),
+                                      makeSV(),
+                                      boost::none,
+                                      1024 /* memoryLimit */,
+                                      false /* allowDiskUse */,
+                                      kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    ASSERT_THROWS_CODE(prepareTree(ctx.get(), stage.get(), outerCondSlot),
+                       DBException,
+                       ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
 }  // namespace mongo::sbe
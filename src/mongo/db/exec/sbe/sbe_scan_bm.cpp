@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * Benchmarks for the SBE ScanStage reading a collection from WiredTiger. The documents have the
+ * shapes of those read by the BSONScanStage in sbe_stages_bm.cpp, so the difference between
+ * BM_ScanStage and BM_BSONScan is the cost of reading the records from the storage engine.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/exec/sbe/sbe_bm_helpers.h"
+#include "mongo/db/exec/sbe/stages/scan.h"
+#include "mongo/db/repl/oplog.h"
+
+namespace mongo::sbe {
+namespace {
+
+const size_t kNumDocuments = 10000;
+
+/**
+ * Creates a collection holding documents of the shape requested by the benchmark arguments and
+ * runs a ScanStage over it to completion once per benchmark iteration. The scan extracts the 'g'
+ * and 'k' fields into slots, as the scans of the plans in sbe_stages_bm.cpp do.
+ */
+class ScanStageBenchmark : public CatalogTestFixture {
+public:
+    explicit ScanStageBenchmark(benchmark::State& state)
+        : CatalogTestFixture("wiredTiger"), _state(state) {}
+
+private:
+    void _doTest() override {
+        auto opCtx = operationContext();
+        const NamespaceString nss("test.sbe_scan_bm");
+        ASSERT_OK(storageInterface()->createCollection(opCtx, nss, CollectionOptions()));
+
+        std::vector<InsertStatement> docs;
+        size_t dataSize = 0;
+        for (auto&& doc : makeShapedDocuments(_state, kNumDocuments)) {
+            dataSize += doc.objsize();
+            docs.emplace_back(doc);
+        }
+        ASSERT_OK(storageInterface()->insertDocuments(opCtx, nss, docs));
+
+        auto uuid = CollectionCatalog::get(opCtx)->lookupUUIDByNSS(opCtx, nss);
+        ASSERT(uuid);
+
+        value::SlotIdGenerator slotIdGenerator;
+        auto scan = makeS<ScanStage>(*uuid,
+                                     slotIdGenerator.generate(),
+                                     slotIdGenerator.generate(),
+                                     boost::none,
+                                     boost::none,
+                                     boost::none,
+                                     boost::none,
+                                     boost::none,
+                                     std::vector<std::string>{"g", "k"},
+                                     makeSV(slotIdGenerator.generate(), slotIdGenerator.generate()),
+                                     boost::none,
+                                     true /* forward */,
+                                     nullptr /* yieldPolicy */,
+                                     kEmptyPlanNodeId,
+                                     ScanCallbacks({}));
+
+        // The ScanStage acquires the collection when it is prepared, so it has to be attached to
+        // the OperationContext first.
+        CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+        scan->attachToOperationContext(opCtx);
+        scan->prepare(ctx);
+
+        size_t numResults = 0;
+        for (auto keepRunning : _state) {
+            scan->open(false);
+            while (scan->getNext() == PlanState::ADVANCED) {
+                ++numResults;
+            }
+            scan->close();
+            opCtx->recoveryUnit()->abandonSnapshot();
+        }
+        benchmark::DoNotOptimize(numResults);
+
+        _state.SetItemsProcessed(_state.iterations() * kNumDocuments);
+        _state.SetBytesProcessed(_state.iterations() * dataSize);
+    }
+
+    benchmark::State& _state;
+};
+
+void BM_ScanStage(benchmark::State& state) {
+    ScanStageBenchmark bm{state};
+    bm.run();
+}
+
+BENCHMARK(BM_ScanStage)->Apply(documentShapes);
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,298 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Benchmarks for the SBE plan stages which make up the hot path of most queries. Every stage reads
+ * its input from a BSONScanStage over an in-memory buffer of documents, which extracts top-level
+ * fields into slots the same way a ScanStage over a record store does. sbe_scan_bm.cpp measures
+ * the ScanStage itself over the same documents.
+ *
+ * Each benchmark is run for the document shapes registered by documentShapes().
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/sbe_bm_helpers.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/exec/sbe/stages/filter.h"
+#include "mongo/db/exec/sbe/stages/hash_agg.h"
+#include "mongo/db/exec/sbe/stages/hash_join.h"
+#include "mongo/db/exec/sbe/stages/makeobj.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/sort.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/query/sbe_stage_builder_helpers.h"
+
+namespace mongo::sbe {
+namespace {
+using stage_builder::makeBinaryOp;
+using stage_builder::makeConstant;
+using stage_builder::makeFillEmptyFalse;
+using stage_builder::makeFunction;
+using stage_builder::makeVariable;
+
+const size_t kNumDocuments = 10000;
+
+void appendDocument(std::string* buffer, const BSONObj& doc) {
+    buffer->append(doc.objdata(), doc.objsize());
+}
+
+/**
+ * Holds the documents of the requested shape and the context needed to run a plan over them.
+ */
+class StageBenchmark {
+public:
+    explicit StageBenchmark(benchmark::State& state)
+        : _opCtx(_serviceContext.makeOperationContext()) {
+        for (auto&& doc : makeShapedDocuments(state, kNumDocuments)) {
+            appendDocument(&_documents, doc);
+        }
+    }
+
+    value::SlotId generateSlotId() {
+        return _slotIdGenerator.generate();
+    }
+
+    /**
+     * Returns a scan of all the documents which puts the document into 'docSlot' and the values of
+     * the 'g' and 'k' fields into 'gSlot' and 'kSlot', respectively.
+     */
+    std::unique_ptr<PlanStage> makeScan(value::SlotId docSlot,
+                                        value::SlotId gSlot,
+                                        value::SlotId kSlot) {
+        return makeS<BSONScanStage>(_documents.data(),
+                                    _documents.data() + _documents.size(),
+                                    docSlot,
+                                    std::vector<std::string>{"g", "k"},
+                                    makeSV(gSlot, kSlot),
+                                    kEmptyPlanNodeId);
+    }
+
+    /**
+     * Prepares the plan rooted at 'root' and runs it to completion once per benchmark iteration.
+     */
+    void run(benchmark::State& state, PlanStage* root) {
+        CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+        root->prepare(ctx);
+        root->attachToOperationContext(_opCtx.get());
+
+        size_t numResults = 0;
+        for (auto keepRunning : state) {
+            root->open(false);
+            while (root->getNext() == PlanState::ADVANCED) {
+                ++numResults;
+            }
+            root->close();
+            benchmark::ClobberMemory();
+        }
+        benchmark::DoNotOptimize(numResults);
+
+        state.SetItemsProcessed(state.iterations() * kNumDocuments);
+        state.SetBytesProcessed(state.iterations() * _documents.size());
+    }
+
+private:
+    QueryTestServiceContext _serviceContext;
+    ServiceContext::UniqueOperationContext _opCtx;
+    value::SlotIdGenerator _slotIdGenerator;
+
+    // The documents to scan, stored back to back.
+    std::string _documents;
+};
+
+void BM_BSONScan(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto docSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(docSlot, bm.generateSlotId(), bm.generateSlotId());
+    bm.run(state, scan.get());
+}
+
+void BM_FilterEq(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto gSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(bm.generateSlotId(), gSlot, bm.generateSlotId());
+
+    // Selects 1% of the documents.
+    auto filter = makeS<FilterStage<false>>(
+        std::move(scan),
+        makeFillEmptyFalse(makeBinaryOp(EPrimBinary::eq,
+                                        makeVariable(gSlot),
+                                        makeConstant(value::TypeTags::NumberInt32, 7))),
+        kEmptyPlanNodeId);
+    bm.run(state, filter.get());
+}
+
+void BM_FilterRange(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto kSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(bm.generateSlotId(), bm.generateSlotId(), kSlot);
+
+    // Selects 25% of the documents.
+    auto filter = makeS<FilterStage<false>>(
+        std::move(scan),
+        makeBinaryOp(
+            EPrimBinary::logicAnd,
+            makeFillEmptyFalse(makeBinaryOp(EPrimBinary::greaterEq,
+                                            makeVariable(kSlot),
+                                            makeConstant(value::TypeTags::NumberInt32, 250))),
+            makeFillEmptyFalse(makeBinaryOp(EPrimBinary::less,
+                                            makeVariable(kSlot),
+                                            makeConstant(value::TypeTags::NumberInt32, 500)))),
+        kEmptyPlanNodeId);
+    bm.run(state, filter.get());
+}
+
+void BM_FilterGetField(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto docSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(docSlot, bm.generateSlotId(), bm.generateSlotId());
+
+    // Same predicate as BM_FilterEq, but the field is looked up in the document by the filter
+    // rather than extracted by the scan.
+    auto filter = makeS<FilterStage<false>>(
+        std::move(scan),
+        makeFillEmptyFalse(
+            makeBinaryOp(EPrimBinary::eq,
+                         makeFunction("getField", makeVariable(docSlot), makeConstant("g")),
+                         makeConstant(value::TypeTags::NumberInt32, 7))),
+        kEmptyPlanNodeId);
+    bm.run(state, filter.get());
+}
+
+void BM_HashAgg(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto gSlot = bm.generateSlotId();
+    auto kSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(bm.generateSlotId(), gSlot, kSlot);
+
+    auto sumSlot = bm.generateSlotId();
+    auto minSlot = bm.generateSlotId();
+    auto pushSlot = bm.generateSlotId();
+    auto agg = makeS<HashAggStage>(std::move(scan),
+                                   makeSV(gSlot),
+                                   makeEM(sumSlot,
+                                          makeFunction("sum", makeVariable(kSlot)),
+                                          minSlot,
+                                          makeFunction("min", makeVariable(kSlot)),
+                                          pushSlot,
+                                          makeFunction("addToArray", makeVariable(kSlot))),
+                                   boost::none,
+                                   std::numeric_limits<size_t>::max(),
+                                   false,
+                                   kEmptyPlanNodeId);
+    bm.run(state, agg.get());
+}
+
+void BM_HashJoin(benchmark::State& state) {
+    StageBenchmark bm{state};
+
+    // The build side holds one small document per group.
+    std::string dimensions;
+    for (int g = 0; g < kNumGroups; ++g) {
+        appendDocument(&dimensions, BSON("g" << g << "name" << ("group" + std::to_string(g))));
+    }
+
+    auto dimSlot = bm.generateSlotId();
+    auto dimGroupSlot = bm.generateSlotId();
+    auto outer = makeS<BSONScanStage>(dimensions.data(),
+                                      dimensions.data() + dimensions.size(),
+                                      dimSlot,
+                                      std::vector<std::string>{"g"},
+                                      makeSV(dimGroupSlot),
+                                      kEmptyPlanNodeId);
+
+    auto docSlot = bm.generateSlotId();
+    auto gSlot = bm.generateSlotId();
+    auto inner = bm.makeScan(docSlot, gSlot, bm.generateSlotId());
+
+    auto join = makeS<HashJoinStage>(std::move(outer),
+                                     std::move(inner),
+                                     makeSV(dimGroupSlot),
+                                     makeSV(dimSlot),
+                                     makeSV(gSlot),
+                                     makeSV(docSlot),
+                                     boost::none,
+                                     std::numeric_limits<size_t>::max(),
+                                     false,
+                                     kEmptyPlanNodeId);
+    bm.run(state, join.get());
+}
+
+void BM_Sort(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto docSlot = bm.generateSlotId();
+    auto kSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(docSlot, bm.generateSlotId(), kSlot);
+
+    auto sort = makeS<SortStage>(std::move(scan),
+                                 makeSV(kSlot),
+                                 std::vector<value::SortDirection>{value::SortDirection::Ascending},
+                                 makeSV(docSlot),
+                                 std::numeric_limits<size_t>::max(),
+                                 std::numeric_limits<size_t>::max(),
+                                 false,
+                                 kEmptyPlanNodeId);
+    bm.run(state, sort.get());
+}
+
+void BM_MakeObj(benchmark::State& state) {
+    StageBenchmark bm{state};
+    auto docSlot = bm.generateSlotId();
+    auto gSlot = bm.generateSlotId();
+    auto kSlot = bm.generateSlotId();
+    auto scan = bm.makeScan(docSlot, gSlot, kSlot);
+
+    // An inclusion projection of a few fields plus a computed one, like {_id: 1, g: 1, x: "$k"}.
+    auto objSlot = bm.generateSlotId();
+    auto makeObj = makeS<MakeBsonObjStage>(std::move(scan),
+                                           objSlot,
+                                           docSlot,
+                                           MakeBsonObjStage::FieldBehavior::keep,
+                                           std::vector<std::string>{"_id", "g"},
+                                           std::vector<std::string>{"x"},
+                                           makeSV(kSlot),
+                                           false,
+                                           false,
+                                           kEmptyPlanNodeId);
+    bm.run(state, makeObj.get());
+}
+
+BENCHMARK(BM_BSONScan)->Apply(documentShapes);
+BENCHMARK(BM_FilterEq)->Apply(documentShapes);
+BENCHMARK(BM_FilterRange)->Apply(documentShapes);
+BENCHMARK(BM_FilterGetField)->Apply(documentShapes);
+BENCHMARK(BM_HashAgg)->Apply(documentShapes);
+BENCHMARK(BM_HashJoin)->Apply(documentShapes);
+BENCHMARK(BM_Sort)->Apply(documentShapes);
+BENCHMARK(BM_MakeObj)->Apply(documentShapes);
+}  // namespace
+}  // namespace mongo::sbe
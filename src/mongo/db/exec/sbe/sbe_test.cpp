@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
@@ -274,6 +275,70 @@ TEST(SBEVM, Add) {
     }
 }
 
+TEST(SBEVM, GetFieldImm) {
+    auto obj = BSON("a" << 1 << "bb" << "str");
+    auto objTag = value::TypeTags::bsonObject;
+    auto objVal = value::bitcastFrom<const char*>(obj.objdata());
+
+    {
+        vm::CodeFragment code;
+        code.appendConstVal(objTag, objVal);
+        code.appendGetField("bb"_sd);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+
+        ASSERT_FALSE(owned);
+        ASSERT_TRUE(value::isString(tag));
+        ASSERT_EQUALS(value::getStringView(tag, val), "str"_sd);
+    }
+    {
+        vm::CodeFragment code;
+        code.appendConstVal(objTag, objVal);
+        code.appendGetField("missing"_sd);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+
+        ASSERT_EQUALS(tag, value::TypeTags::Nothing);
+    }
+}
+
+TEST(SBEVM, FillEmptyImm) {
+    {
+        vm::CodeFragment code;
+        code.appendConstVal(value::TypeTags::Nothing, 0);
+        code.appendFillEmpty(vm::Instruction::False);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+
+        ASSERT_EQUALS(tag, value::TypeTags::Boolean);
+        ASSERT_FALSE(value::bitcastTo<bool>(val));
+    }
+    {
+        vm::CodeFragment code;
+        code.appendConstVal(value::TypeTags::Nothing, 0);
+        code.appendFillEmpty(vm::Instruction::Null);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+
+        ASSERT_EQUALS(tag, value::TypeTags::Null);
+    }
+    {
+        vm::CodeFragment code;
+        code.appendConstVal(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(7));
+        code.appendFillEmpty(vm::Instruction::True);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+
+        ASSERT_EQUALS(tag, value::TypeTags::NumberInt32);
+        ASSERT_EQUALS(value::bitcastTo<int32_t>(val), 7);
+    }
+}
+
 TEST(SBEVM, CompareBinData) {
     {
         uint8_t byteArray1[] = {1, 2, 3, 4};
@@ -0,0 +1,210 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/sbe_bm_helpers.h"
+#include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/values/slot.h"
+#include "mongo/db/exec/sbe/vm/vm.h"
+
+namespace mongo::sbe {
+namespace {
+const size_t kNumDocuments = 1000;
+
+/**
+ * Builds documents shaped like a typical collection scan input, with the filtered field 'x'
+ * placed after a handful of other fields so that the field lookup has some work to do.
+ */
+std::vector<BSONObj> makeDocuments() {
+    std::vector<BSONObj> docs;
+    for (size_t i = 0; i < kNumDocuments; ++i) {
+        BSONObjBuilder bob;
+        bob.append("_id", static_cast<int>(i));
+        bob.append("name", "document");
+        bob.append("count", static_cast<long long>(i * 7));
+        if (i % 10 != 0) {
+            bob.append("x", static_cast<int>(i % 200));
+        }
+        docs.push_back(bob.obj());
+    }
+    return docs;
+}
+
+/**
+ * Runs the predicate 'fillEmpty(getField(doc, "x") < 100, false)' over every document. When
+ * 'useImmediates' is false, the predicate is compiled to the plain instruction sequence; otherwise
+ * the field name and the default value are encoded in the getFieldImm and fillEmptyImm
+ * superinstructions.
+ */
+void runFilterBenchmark(benchmark::State& state, bool useImmediates) {
+    auto docs = makeDocuments();
+    value::ViewOfValueAccessor accessor;
+
+    vm::CodeFragment code;
+    code.appendAccessVal(&accessor);
+    if (useImmediates) {
+        code.appendGetField("x"_sd);
+    } else {
+        auto [fieldTag, fieldVal] = value::makeSmallString("x"_sd);
+        code.appendConstVal(fieldTag, fieldVal);
+        code.appendGetField();
+    }
+    code.appendConstVal(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(100));
+    code.appendLess();
+    if (useImmediates) {
+        code.appendFillEmpty(vm::Instruction::False);
+    } else {
+        code.appendConstVal(value::TypeTags::Boolean, value::bitcastFrom<bool>(false));
+        code.appendFillEmpty();
+    }
+
+    vm::ByteCode interpreter;
+    size_t numMatched = 0;
+    for (auto keepRunning : state) {
+        for (auto&& doc : docs) {
+            accessor.reset(value::TypeTags::bsonObject,
+                           value::bitcastFrom<const char*>(doc.objdata()));
+            numMatched += interpreter.runPredicate(&code);
+        }
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(numMatched);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_FilterGetFieldLess(benchmark::State& state) {
+    runFilterBenchmark(state, false /* useImmediates */);
+}
+
+void BM_FilterGetFieldLessImmediate(benchmark::State& state) {
+    runFilterBenchmark(state, true /* useImmediates */);
+}
+
+/**
+ * Compiles the expression returned by 'makeExpr', which reads the current document from the given
+ * slot, and evaluates it over every document of the shape requested by the benchmark arguments.
+ */
+void runExpressionBenchmark(
+    benchmark::State& state,
+    const std::function<std::unique_ptr<EExpression>(value::SlotId)>& makeExpr) {
+    auto docs = makeShapedDocuments(state, kNumDocuments);
+
+    CoScanStage root{kEmptyPlanNodeId};
+    CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+    ctx.root = &root;
+
+    value::SlotIdGenerator slotIdGenerator;
+    value::ViewOfValueAccessor accessor;
+    auto docSlot = slotIdGenerator.generate();
+    ctx.pushCorrelated(docSlot, &accessor);
+
+    auto code = makeExpr(docSlot)->compile(ctx);
+
+    vm::ByteCode interpreter;
+    for (auto keepRunning : state) {
+        for (auto&& doc : docs) {
+            accessor.reset(value::TypeTags::bsonObject,
+                           value::bitcastFrom<const char*>(doc.objdata()));
+            auto [owned, tag, val] = interpreter.run(code.get());
+            if (owned) {
+                value::releaseValue(tag, val);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+std::unique_ptr<EExpression> makeGetField(value::SlotId docSlot, StringData field) {
+    auto [tag, val] = value::makeNewString(field);
+    return makeE<EFunction>("getField",
+                            makeEs(makeE<EVariable>(docSlot), makeE<EConstant>(tag, val)));
+}
+
+std::unique_ptr<EExpression> makeStringConstant(StringData str) {
+    auto [tag, val] = value::makeNewString(str);
+    return makeE<EConstant>(tag, val);
+}
+
+void BM_BuiltinGetField(benchmark::State& state) {
+    runExpressionBenchmark(state, [](value::SlotId docSlot) { return makeGetField(docSlot, "k"); });
+}
+
+void BM_BuiltinNewObj(benchmark::State& state) {
+    runExpressionBenchmark(state, [](value::SlotId docSlot) {
+        return makeE<EFunction>("newObj",
+                                makeEs(makeStringConstant("g"),
+                                       makeGetField(docSlot, "g"),
+                                       makeStringConstant("k"),
+                                       makeGetField(docSlot, "k")));
+    });
+}
+
+void BM_BuiltinDropFields(benchmark::State& state) {
+    runExpressionBenchmark(state, [](value::SlotId docSlot) {
+        return makeE<EFunction>(
+            "dropFields",
+            makeEs(makeE<EVariable>(docSlot), makeStringConstant("f0"), makeStringConstant("g")));
+    });
+}
+
+void BM_BuiltinConcat(benchmark::State& state) {
+    runExpressionBenchmark(state, [](value::SlotId docSlot) {
+        return makeE<EFunction>("concat",
+                                makeEs(makeGetField(docSlot, "f0"), makeStringConstant("suffix")));
+    });
+}
+
+void BM_BuiltinIsMember(benchmark::State& state) {
+    runExpressionBenchmark(state, [](value::SlotId docSlot) {
+        auto [setTag, setVal] = value::makeNewArraySet();
+        for (int32_t i = 0; i < kKeyRange; i += 10) {
+            value::getArraySetView(setVal)->push_back(value::TypeTags::NumberInt32,
+                                                      value::bitcastFrom<int32_t>(i));
+        }
+        return makeE<EFunction>(
+            "isMember", makeEs(makeGetField(docSlot, "k"), makeE<EConstant>(setTag, setVal)));
+    });
+}
+
+BENCHMARK(BM_FilterGetFieldLess);
+BENCHMARK(BM_FilterGetFieldLessImmediate);
+BENCHMARK(BM_BuiltinGetField)->Apply(documentShapes);
+BENCHMARK(BM_BuiltinNewObj)->Apply(documentShapes);
+BENCHMARK(BM_BuiltinDropFields)->Apply(documentShapes);
+BENCHMARK(BM_BuiltinConcat)->Apply(documentShapes);
+BENCHMARK(BM_BuiltinIsMember)->Apply(documentShapes);
+}  // namespace
+}  // namespace mongo::sbe
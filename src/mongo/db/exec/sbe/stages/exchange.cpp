@@ -31,8 +31,11 @@
 
 #include "mongo/db/exec/sbe/stages/exchange.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/db/client.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 std::unique_ptr<ThreadPool> s_globalThreadPool;
@@ -68,10 +71,11 @@ void ExchangePipe::close() {
     _cond.notify_all();
 }
 
-std::unique_ptr<ExchangeBuffer> ExchangePipe::getEmptyBuffer() {
+std::unique_ptr<ExchangeBuffer> ExchangePipe::getEmptyBuffer(OperationContext* opCtx) {
     stdx::unique_lock lock(_mutex);
 
-    _cond.wait(lock, [this]() { return _closed || _emptyCount > 0; });
+    opCtx->waitForConditionOrInterrupt(
+        _cond, lock, [this]() { return _closed || _emptyCount > 0; });
 
     if (_closed) {
         return nullptr;
@@ -82,10 +86,11 @@ std::unique_ptr<ExchangeBuffer> ExchangePipe::getEmptyBuffer() {
     return std::move(_emptyBuffers[_emptyCount]);
 }
 
-std::unique_ptr<ExchangeBuffer> ExchangePipe::getFullBuffer() {
+std::unique_ptr<ExchangeBuffer> ExchangePipe::getFullBuffer(OperationContext* opCtx) {
     stdx::unique_lock lock(_mutex);
 
-    _cond.wait(lock, [this]() { return _closed || _fullCount != _fullPosition; });
+    opCtx->waitForConditionOrInterrupt(
+        _cond, lock, [this]() { return _closed || _fullCount != _fullPosition; });
 
     if (_closed) {
         return nullptr;
@@ -124,6 +129,7 @@ ExchangeState::ExchangeState(size_t numOfProducers,
                              std::unique_ptr<EExpression> orderLess)
     : _policy(policy),
       _numOfProducers(numOfProducers),
+      _producerStats(numOfProducers),
       _fields(std::move(fields)),
       _partition(std::move(partition)),
       _orderLess(std::move(orderLess)) {}
@@ -132,12 +138,51 @@ ExchangePipe* ExchangeState::pipe(size_t consumerTid, size_t producerTid) {
     return _consumers[consumerTid]->pipe(producerTid);
 }
 
+void ExchangeState::registerProducerOpCtx(OperationContext* opCtx) {
+    stdx::lock_guard lock(_producerOpCtxsMutex);
+    _producerOpCtxs.push_back(opCtx);
+
+    if (_producersKillCode != ErrorCodes::OK) {
+        stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+        opCtx->getServiceContext()->killOperation(clientLock, opCtx, _producersKillCode);
+    }
+}
+
+void ExchangeState::unregisterProducerOpCtx(OperationContext* opCtx) {
+    stdx::lock_guard lock(_producerOpCtxsMutex);
+    _producerOpCtxs.erase(std::find(_producerOpCtxs.begin(), _producerOpCtxs.end(), opCtx));
+}
+
+void ExchangeState::cancelProducers(ErrorCodes::Error killCode) {
+    stdx::lock_guard lock(_producerOpCtxsMutex);
+    if (_producersKillCode != ErrorCodes::OK) {
+        return;
+    }
+    _producersKillCode = killCode;
+
+    for (auto opCtx : _producerOpCtxs) {
+        stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+        opCtx->getServiceContext()->killOperation(clientLock, opCtx, killCode);
+    }
+}
+
+bool ExchangeState::isProducerCancellation(const Status& status) {
+    stdx::lock_guard lock(_producerOpCtxsMutex);
+    return _producersKillCode != ErrorCodes::OK && status == _producersKillCode;
+}
+
 ExchangeBuffer* ExchangeConsumer::getBuffer(size_t producerId) {
     if (_fullBuffers[producerId]) {
         return _fullBuffers[producerId].get();
     }
 
-    _fullBuffers[producerId] = _pipes[producerId]->getFullBuffer();
+    try {
+        _fullBuffers[producerId] = _pipes[producerId]->getFullBuffer(_opCtx);
+    } catch (const DBException& ex) {
+        // The consumer has been interrupted, stop the producers for the same reason.
+        _state->cancelProducers(ex.code());
+        throw;
+    }
 
     return _fullBuffers[producerId].get();
 }
@@ -173,6 +218,16 @@ ExchangeConsumer::ExchangeConsumer(std::shared_ptr<ExchangeState> state, PlanNod
     _tid = _state->addConsumer(this);
     _orderPreserving = _state->isOrderPreserving();
 }
+ExchangeConsumer::~ExchangeConsumer() {
+    // The producers write into the pipes owned by the consumers, so they must not outlive them even
+    // when the plan is destroyed without being closed.
+    if (_tid == 0 && !_producersJoined) {
+        for (auto& p : _pipes) {
+            p->close();
+        }
+        joinProducers(ErrorCodes::Interrupted);
+    }
+}
 std::unique_ptr<PlanStage> ExchangeConsumer::clone() const {
     return std::make_unique<ExchangeConsumer>(_state, _commonStats.nodeId);
 }
@@ -249,15 +304,25 @@ void ExchangeConsumer::open(bool reOpen) {
                 }
             }
 
-            // Start n producers.
+            // Start n producers. They run under their own OperationContexts, which inherit the
+            // deadline of the consumer and are killed when the consumer is interrupted or closed.
             invariant(_state->producerCompileCtxs().size() == _state->numOfProducers());
+            const auto deadline = _opCtx->getDeadline();
+            const auto timeoutError = _opCtx->getTimeoutError();
             for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
                 auto pf = makePromiseFuture<void>();
                 s_globalThreadPool->schedule(
-                    [this, idx, promise = std::move(pf.promise)](auto status) mutable {
-                        invariant(status);
+                    [this, idx, deadline, timeoutError, promise = std::move(pf.promise)](
+                        auto status) mutable {
+                        if (!status.isOK()) {
+                            promise.setError(status);
+                            return;
+                        }
 
                         auto opCtx = cc().makeOperationContext();
+                        opCtx->setDeadlineByDate(deadline, timeoutError);
+                        _state->registerProducerOpCtx(opCtx.get());
+                        ON_BLOCK_EXIT([&] { _state->unregisterProducerOpCtx(opCtx.get()); });
 
                         promise.setWith([&] {
                             ExchangeProducer::start(opCtx.get(),
@@ -340,10 +405,9 @@ void ExchangeConsumer::close() {
 
         if (_tid == 0) {
             // Consumer ID 0
-            // Wait for n producers to finish.
-            for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
-                _state->producerResults()[idx].wait();
-            }
+            // Stop the producers that are still running, nobody is going to read their output,
+            // and wait for all of them to finish.
+            joinProducers(ErrorCodes::Interrupted);
         }
 
         if (_state->consumerClose() == _state->numOfConsumers()) {
@@ -355,19 +419,39 @@ void ExchangeConsumer::close() {
                 lock, [this]() { return _state->consumerClose() == _state->numOfConsumers(); });
         }
     }
-    // Rethrow the first stored exception from producers.
-    // We can do it outside of the lock as everybody else is gone by now.
+    // Rethrow the first stored exception from producers, other than the ones caused by stopping
+    // them. We can do it outside of the lock as everybody else is gone by now.
     if (_tid == 0) {
         // Consumer ID 0
-        for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
-            _state->producerResults()[idx].get();
+        for (auto&& result : _state->producerResults()) {
+            auto status = result.getNoThrow();
+            if (!status.isOK() && !_state->isProducerCancellation(status)) {
+                uassertStatusOK(status);
+            }
         }
     }
 }
 
+void ExchangeConsumer::joinProducers(ErrorCodes::Error killCode) {
+    _state->cancelProducers(killCode);
+    for (auto&& result : _state->producerResults()) {
+        result.wait();
+    }
+    _producersJoined = true;
+}
+
 std::unique_ptr<PlanStageStats> ExchangeConsumer::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
-    ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    if (!_children.empty()) {
+        // The producers have not been started yet.
+        ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    } else if (_producersJoined) {
+        for (auto&& stats : _state->producerStats()) {
+            if (stats) {
+                ret->children.emplace_back(stats->clone());
+            }
+        }
+    }
     return ret;
 }
 
@@ -400,8 +484,11 @@ std::vector<DebugPrinter::Block> ExchangeConsumer::debugPrint() const {
             uasserted(4822835, "policy not yet implemented");
     }
 
-    DebugPrinter::addNewLine(ret);
-    DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+    // Once opened, the subtree is owned by the producers.
+    if (!_children.empty()) {
+        DebugPrinter::addNewLine(ret);
+        DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+    }
 
     return ret;
 }
@@ -419,7 +506,7 @@ ExchangeBuffer* ExchangeProducer::getBuffer(size_t consumerId) {
         return _emptyBuffers[consumerId].get();
     }
 
-    _emptyBuffers[consumerId] = _pipes[consumerId]->getEmptyBuffer();
+    _emptyBuffers[consumerId] = _pipes[consumerId]->getEmptyBuffer(_opCtx);
 
     if (!_emptyBuffers[consumerId]) {
         closePipes();
@@ -474,9 +561,11 @@ void ExchangeProducer::start(OperationContext* opCtx,
         }
 
         p->close();
+        p->_state->producerStats()[p->_tid] = p->getStats(true);
     } catch (...) {
         // This is a bit sketchy but close the pipes as minimum.
         p->closePipes();
+        p->_state->producerStats()[p->_tid] = p->getStats(true);
         throw;
     }
 }
@@ -122,8 +122,13 @@ public:
     ExchangePipe(size_t size);
 
     void close();
-    std::unique_ptr<ExchangeBuffer> getEmptyBuffer();
-    std::unique_ptr<ExchangeBuffer> getFullBuffer();
+
+    /**
+     * Wait for a buffer to become available, or for the pipe to be closed in which case nullptr is
+     * returned. Throw if 'opCtx' is interrupted or its deadline expires while waiting.
+     */
+    std::unique_ptr<ExchangeBuffer> getEmptyBuffer(OperationContext* opCtx);
+    std::unique_ptr<ExchangeBuffer> getFullBuffer(OperationContext* opCtx);
     void putEmptyBuffer(std::unique_ptr<ExchangeBuffer>);
     void putFullBuffer(std::unique_ptr<ExchangeBuffer>);
 
@@ -173,6 +178,23 @@ public:
         _producerResults.emplace_back(std::move(f));
     }
 
+    /**
+     * Register the OperationContext a producer runs under so that cancelProducers() can interrupt
+     * it. A producer registered after the cancellation is interrupted right away.
+     */
+    void registerProducerOpCtx(OperationContext* opCtx);
+    void unregisterProducerOpCtx(OperationContext* opCtx);
+
+    /**
+     * Interrupt every running producer with 'killCode'. Only the first cancellation is recorded.
+     */
+    void cancelProducers(ErrorCodes::Error killCode);
+
+    /**
+     * Returns true if 'status' is the failure of a producer caused by cancelProducers().
+     */
+    bool isProducerCancellation(const Status& status);
+
     auto& consumerOpenMutex() {
         return _consumerOpenMutex;
     }
@@ -205,6 +227,10 @@ public:
         return _producerResults;
     }
 
+    auto& producerStats() {
+        return _producerStats;
+    }
+
     auto numOfConsumers() const {
         return _consumers.size();
     }
@@ -226,6 +252,10 @@ private:
     std::vector<CompileCtx> _producerCompileCtxs;
     std::vector<Future<void>> _producerResults;
 
+    // Stats of the producer plans, recorded by the producer threads before the plans are
+    // destroyed. Must not be read before all the producers have finished.
+    std::vector<std::unique_ptr<PlanStageStats>> _producerStats;
+
     // Variables (fields) that pass through the exchange.
     const value::SlotVector _fields;
 
@@ -244,6 +274,11 @@ private:
     mongo::Mutex _consumerCloseMutex;
     stdx::condition_variable _consumerCloseCond;
     size_t _consumerClose{0};
+
+    // OperationContexts of the running producers, and the code they were canceled with.
+    mongo::Mutex _producerOpCtxsMutex = MONGO_MAKE_LATCH("ExchangeState::_producerOpCtxsMutex");
+    std::vector<OperationContext*> _producerOpCtxs;
+    ErrorCodes::Error _producersKillCode{ErrorCodes::OK};
 };
 
 class ExchangeConsumer final : public PlanStage {
@@ -258,6 +293,8 @@ public:
 
     ExchangeConsumer(std::shared_ptr<ExchangeState> state, PlanNodeId planNodeId);
 
+    ~ExchangeConsumer();
+
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -276,6 +313,9 @@ private:
     ExchangeBuffer* getBuffer(size_t producerId);
     void putBuffer(size_t producerId);
 
+    // Cancel the producers and wait for all of them to finish.
+    void joinProducers(ErrorCodes::Error killCode);
+
     std::shared_ptr<ExchangeState> _state;
     size_t _tid{0};
 
@@ -296,6 +336,9 @@ private:
 
     bool _orderPreserving{false};
 
+    // Set once the producers have finished and their stats can be read.
+    bool _producersJoined{false};
+
     size_t _rowProcessed{0};
 };
 
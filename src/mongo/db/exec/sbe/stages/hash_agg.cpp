@@ -31,36 +31,59 @@
 
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 
+#include "mongo/db/exec/sbe/util/spilling.h"
 #include "mongo/util/str.h"
 
+namespace {
+std::string nextFileName() {
+    static mongo::AtomicWord<unsigned> hashAggFileCounter;
+    return "extsort-hash-agg-sbe." + std::to_string(hashAggFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
+#include "mongo/db/sorter/sorter.cpp"
+
 namespace mongo {
 namespace sbe {
 HashAggStage::HashAggStage(std::unique_ptr<PlanStage> input,
                            value::SlotVector gbs,
                            value::SlotMap<std::unique_ptr<EExpression>> aggs,
                            boost::optional<value::SlotId> collatorSlot,
+                           size_t memoryLimit,
+                           bool allowDiskUse,
                            PlanNodeId planNodeId)
     : PlanStage("group"_sd, planNodeId),
       _gbs(std::move(gbs)),
       _aggs(std::move(aggs)),
-      _collatorSlot(collatorSlot) {
+      _collatorSlot(collatorSlot),
+      _memoryLimit(memoryLimit),
+      _allowDiskUse(allowDiskUse) {
     _children.emplace_back(std::move(input));
 }
 
+HashAggStage::~HashAggStage() {
+    removeSpilledFiles();
+}
+
 std::unique_ptr<PlanStage> HashAggStage::clone() const {
     value::SlotMap<std::unique_ptr<EExpression>> aggs;
     for (auto& [k, v] : _aggs) {
         aggs.emplace(k, v->clone());
     }
-    return std::make_unique<HashAggStage>(
-        _children[0]->clone(), _gbs, std::move(aggs), _collatorSlot, _commonStats.nodeId);
+    return std::make_unique<HashAggStage>(_children[0]->clone(),
+                                          _gbs,
+                                          std::move(aggs),
+                                          _collatorSlot,
+                                          _memoryLimit,
+                                          _allowDiskUse,
+                                          _commonStats.nodeId);
 }
 
 void HashAggStage::prepare(CompileCtx& ctx) {
     _children[0]->prepare(ctx);
 
     if (_collatorSlot) {
-        _collatorAccessor = getAccessor(ctx, *_collatorSlot);
+        _collatorAccessor = _children[0]->getAccessor(ctx, *_collatorSlot);
         tassert(5402501,
                 "collator accessor should exist if collator slot provided to HashAggStage",
                 _collatorAccessor != nullptr);
@@ -73,7 +96,7 @@ void HashAggStage::prepare(CompileCtx& ctx) {
         auto [it, inserted] = dupCheck.emplace(slot);
         uassert(4822827, str::stream() << "duplicate field: " << slot, inserted);
 
-        _inKeyAccessors.emplace_back(_children[0]->getAccessor(ctx, slot));
+        _inKeyAccessors.emplace_back(getSpillableInputAccessor(ctx, slot));
         _outKeyAccessors.emplace_back(std::make_unique<HashKeyAccessor>(_htIt, counter++));
         _outAccessors[slot] = _outKeyAccessors.back().get();
     }
@@ -106,18 +129,37 @@ value::SlotAccessor* HashAggStage::getAccessor(CompileCtx& ctx, value::SlotId sl
             return it->second;
         }
     } else {
-        return _children[0]->getAccessor(ctx, slot);
+        // The aggregate expressions are being compiled, so this is an input slot.
+        return getSpillableInputAccessor(ctx, slot);
     }
 
     return ctx.getAccessor(slot);
 }
 
-void HashAggStage::open(bool reOpen) {
-    auto optTimer(getOptTimer(_opCtx));
+value::SlotAccessor* HashAggStage::getSpillableInputAccessor(CompileCtx& ctx,
+                                                             value::SlotId slot) {
+    if (auto it = _inSwitchAccessors.find(slot); it != _inSwitchAccessors.end()) {
+        return it->second;
+    }
 
-    _commonStats.opens++;
-    _children[0]->open(reOpen);
+    auto accessor = _children[0]->getAccessor(ctx, slot);
+    // Slots from the runtime environment hold the same value for every input row, so they do not
+    // need to be written to disk.
+    if (dynamic_cast<RuntimeEnvironment::Accessor*>(accessor)) {
+        return accessor;
+    }
+
+    _spilledRowAccessors.emplace_back(
+        std::make_unique<value::MaterializedRowKeyAccessor<SpilledRow*>>(
+            _spilledRowIt, _switchAccessors.size()));
+    _switchAccessors.emplace_back(std::make_unique<value::SwitchAccessor>(
+        std::vector<value::SlotAccessor*>{accessor, _spilledRowAccessors.back().get()}));
+    _inSwitchAccessors.emplace(slot, _switchAccessors.back().get());
+
+    return _switchAccessors.back().get();
+}
 
+void HashAggStage::makeTable() {
     if (_collatorAccessor) {
         auto [tag, collatorVal] = _collatorAccessor->getViewOfValue();
         uassert(5402503, "collatorSlot must be of collator type", tag == value::TypeTags::collator);
@@ -129,32 +171,182 @@ void HashAggStage::open(bool reOpen) {
         _ht.emplace();
     }
 
-    while (_children[0]->getNext() == PlanState::ADVANCED) {
-        value::MaterializedRow key{_inKeyAccessors.size()};
-        // Copy keys in order to do the lookup.
-        size_t idx = 0;
-        for (auto& p : _inKeyAccessors) {
-            auto [tag, val] = p->getViewOfValue();
-            key.reset(idx++, false, tag, val);
-        }
+    _sampledBytes = 0;
+    _numSamples = 0;
+    _updatesSinceLastSample = 0;
+}
 
-        auto [it, inserted] = _ht->try_emplace(std::move(key), value::MaterializedRow{0});
+void HashAggStage::consumeRow(size_t level) {
+    value::MaterializedRow key{_inKeyAccessors.size()};
+    // Copy keys in order to do the lookup.
+    size_t idx = 0;
+    for (auto& p : _inKeyAccessors) {
+        auto [tag, val] = p->getViewOfValue();
+        key.reset(idx++, false, tag, val);
+    }
+
+    TableType::iterator it;
+    bool inserted = false;
+    if (_spillWriters.empty()) {
+        std::tie(it, inserted) = _ht->try_emplace(std::move(key), value::MaterializedRow{0});
         if (inserted) {
             // Copy keys.
             const_cast<value::MaterializedRow&>(it->first).makeOwned();
             // Initialize accumulators.
             it->second.resize(_outAggAccessors.size());
         }
+    } else {
+        // The hash table is frozen, only the groups which are already in it can be updated.
+        it = _ht->find(key);
+        if (it == _ht->end()) {
+            spillRow(key, level);
+            return;
+        }
+    }
 
-        // Accumulate.
-        _htIt = it;
-        for (size_t idx = 0; idx < _outAggAccessors.size(); ++idx) {
-            auto [owned, tag, val] = _bytecode.run(_aggCodes[idx].get());
-            _outAggAccessors[idx]->reset(owned, tag, val);
+    // Accumulate.
+    _htIt = it;
+    for (size_t idx = 0; idx < _outAggAccessors.size(); ++idx) {
+        auto [owned, tag, val] = _bytecode.run(_aggCodes[idx].get());
+        _outAggAccessors[idx]->reset(owned, tag, val);
+    }
+
+    trackMemoryUsage(it, inserted);
+}
+
+void HashAggStage::trackMemoryUsage(TableType::iterator it, bool inserted) {
+    if (!inserted && ++_updatesSinceLastSample < kMemoryUsageSampleInterval) {
+        return;
+    }
+    _updatesSinceLastSample = 0;
+
+    _sampledBytes += it->first.memUsageForSorter() + it->second.memUsageForSorter();
+    ++_numSamples;
+    const size_t estimatedBytes = _sampledBytes / _numSamples * _ht->size();
+
+    if (!_spillWriters.empty()) {
+        // The hash table is frozen, but the accumulators of its groups can still grow. They cannot
+        // be spilled, since only input rows are written to disk, so the query fails instead.
+        uassert(ErrorCodes::ExceededMemoryLimit,
+                str::stream() << "Exceeded memory limit for $group: the groups which were kept in "
+                                 "memory when spilling to disk grew past the limit of "
+                              << _memoryLimit << " bytes",
+                estimatedBytes <= _memoryLimit);
+        return;
+    }
+
+    // When spilling is allowed, part of the memory limit is left for the groups in the frozen hash
+    // table to grow into.
+    const size_t freezeLimit = _allowDiskUse
+        ? _memoryLimit / kFrozenTableGrowthDivisor * (kFrozenTableGrowthDivisor - 1)
+        : _memoryLimit;
+    if (estimatedBytes <= freezeLimit) {
+        return;
+    }
+
+    uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+            "Exceeded memory limit for $group, but didn't allow external spilling. Pass "
+            "allowDiskUse:true to opt in.",
+            _allowDiskUse);
+
+    _spillWriters.resize(kNumSpillPartitions);
+    _spillFileNames.resize(kNumSpillPartitions);
+}
+
+void HashAggStage::spillRow(const value::MaterializedRow& key, size_t level) {
+    auto partition = getSpillPartition(_ht->hash_function()(key), level, kNumSpillPartitions);
+    auto& writer = _spillWriters[partition];
+    if (!writer) {
+        SortOptions opts;
+        opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+        _spillFileNames[partition] = opts.tempDir + "/" + nextFileName();
+        writer = std::make_unique<SpillWriter>(opts, _spillFileNames[partition], 0);
+    }
+
+    value::MaterializedRow row{_switchAccessors.size()};
+    for (size_t idx = 0; idx < _switchAccessors.size(); ++idx) {
+        auto [tag, val] = _switchAccessors[idx]->getViewOfValue();
+        row.reset(idx, false, tag, val);
+    }
+    writer->addAlreadySorted(row, value::MaterializedRow{0});
+    ++_specificStats.spilledRecords;
+}
+
+void HashAggStage::finishSpilling(size_t level) {
+    for (size_t partition = 0; partition < _spillWriters.size(); ++partition) {
+        if (auto& writer = _spillWriters[partition]) {
+            _pendingPartitions.push_back({std::unique_ptr<SpillIterator>(writer->done()),
+                                          _spillFileNames[partition],
+                                          level});
+            writer.reset();
+            ++_specificStats.spills;
+        }
+    }
+    _spillWriters.clear();
+    _spillFileNames.clear();
+}
+
+bool HashAggStage::processNextSpilledPartition() {
+    if (_pendingPartitions.empty()) {
+        return false;
+    }
+
+    auto& partition = _pendingPartitions.front();
+    makeTable();
+    for (auto& accessor : _switchAccessors) {
+        accessor->setIndex(1);
+    }
+
+    partition.iterator->openSource();
+    while (partition.iterator->more()) {
+        checkForInterrupt(_opCtx);
+        _spilledRow = partition.iterator->next();
+        consumeRow(partition.level + 1);
+    }
+    partition.iterator->closeSource();
+    finishSpilling(partition.level + 1);
+
+    partition.iterator.reset();
+    boost::filesystem::remove(partition.fileName);
+    _pendingPartitions.pop_front();
+
+    return true;
+}
+
+void HashAggStage::removeSpilledFiles() {
+    _spillWriters.clear();
+    for (auto&& fileName : _spillFileNames) {
+        if (!fileName.empty()) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(fileName));
         }
     }
+    _spillFileNames.clear();
+
+    for (auto&& partition : _pendingPartitions) {
+        partition.iterator.reset();
+        DESTRUCTOR_GUARD(boost::filesystem::remove(partition.fileName));
+    }
+    _pendingPartitions.clear();
+}
+
+void HashAggStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _commonStats.opens++;
+    _children[0]->open(reOpen);
+
+    removeSpilledFiles();
+    for (auto& accessor : _switchAccessors) {
+        accessor->setIndex(0);
+    }
+    makeTable();
+
+    while (_children[0]->getNext() == PlanState::ADVANCED) {
+        consumeRow(0);
+    }
 
     _children[0]->close();
+    finishSpilling(0);
 
     _htIt = _ht->end();
 }
@@ -168,8 +360,12 @@ PlanState HashAggStage::getNext() {
         ++_htIt;
     }
 
-    if (_htIt == _ht->end()) {
-        return trackPlanState(PlanState::IS_EOF);
+    // Once the groups in memory are exhausted, move on to the groups which were spilled to disk.
+    while (_htIt == _ht->end()) {
+        if (!processNextSpilledPartition()) {
+            return trackPlanState(PlanState::IS_EOF);
+        }
+        _htIt = _ht->begin();
     }
 
     return trackPlanState(PlanState::ADVANCED);
@@ -177,11 +373,16 @@ PlanState HashAggStage::getNext() {
 
 std::unique_ptr<PlanStageStats> HashAggStage::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<HashAggStats>(_specificStats);
 
     if (includeDebugInfo) {
         DebugPrinter printer;
         BSONObjBuilder bob;
         bob.append("groupBySlots", _gbs);
+        bob.appendNumber("memLimit", static_cast<long long>(_memoryLimit));
+        bob.appendBool("usedDisk", _specificStats.spills > 0);
+        bob.appendNumber("spills", static_cast<long long>(_specificStats.spills));
+        bob.appendNumber("spilledRecords", static_cast<long long>(_specificStats.spilledRecords));
         if (!_aggs.empty()) {
             BSONObjBuilder childrenBob(bob.subobjStart("expressions"));
             for (auto&& [slot, expr] : _aggs) {
@@ -196,7 +397,7 @@ std::unique_ptr<PlanStageStats> HashAggStage::getStats(bool includeDebugInfo) co
 }
 
 const SpecificStats* HashAggStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 void HashAggStage::close() {
@@ -204,6 +405,7 @@ void HashAggStage::close() {
 
     trackClose();
     _ht = boost::none;
+    removeSpilledFiles();
 }
 
 std::vector<DebugPrinter::Block> HashAggStage::debugPrint() const {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <deque>
 #include <unordered_map>
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
@@ -37,15 +38,43 @@
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
+template <typename Key, typename Value>
+class SortIteratorInterface;
+template <typename Key, typename Value>
+class SortedFileWriter;
+
 namespace sbe {
+/**
+ * Groups the input rows by the values of the 'gbs' slots and computes the 'aggs' aggregate
+ * expressions for each group.
+ *
+ * The groups are kept in an in-memory hash table. Once the estimated size of the table exceeds
+ * 'memoryLimit' the stage either fails with 'QueryExceededMemoryLimitNoDiskUseAllowed' or, if
+ * 'allowDiskUse' is set, freezes the table: input rows which belong to a group already in the
+ * table continue to be aggregated in memory, while the rows for all other groups are written to
+ * disk, split into hash partitions by their group-by key. Once the in-memory groups have been
+ * returned, each partition is read back and aggregated in the same way, recursively partitioning
+ * again if it does not fit in memory either. Since all rows of any given group end up in the same
+ * partition, every group is produced exactly once and no merging of partial aggregates is needed.
+ *
+ * The stage can also be used for two-phase aggregation across threads: a HashAggStage below an
+ * ExchangeConsumer computes partial aggregates in every producer, and a second HashAggStage above
+ * the exchange groups by the same keys and merges them with the corresponding merge functions
+ * (e.g. 'min' over the partial minimums, or 'aggConcatArrays' over the partial 'addToArray'
+ * results).
+ */
 class HashAggStage final : public PlanStage {
 public:
     HashAggStage(std::unique_ptr<PlanStage> input,
                  value::SlotVector gbs,
                  value::SlotMap<std::unique_ptr<EExpression>> aggs,
                  boost::optional<value::SlotId> collatorSlot,
+                 size_t memoryLimit,
+                 bool allowDiskUse,
                  PlanNodeId planNodeId);
 
+    ~HashAggStage();
+
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -67,9 +96,69 @@ private:
     using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
     using HashAggAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
 
+    using SpilledRow = std::pair<value::MaterializedRow, value::MaterializedRow>;
+    using SpillWriter = SortedFileWriter<value::MaterializedRow, value::MaterializedRow>;
+    using SpillIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
+
+    /**
+     * A hash partition of input rows which has been written to disk and is waiting to be
+     * aggregated. 'level' is the recursion depth at which the partition was produced.
+     */
+    struct SpilledPartition {
+        std::unique_ptr<SpillIterator> iterator;
+        std::string fileName;
+        size_t level;
+    };
+
+    // The number of partitions the rows are split into every time the hash table overflows.
+    static constexpr size_t kNumSpillPartitions = 16;
+    // Once a group is in the hash table, the size of its accumulators is only re-measured every
+    // that many updates, as computing the size of large values (e.g. arrays) is not free.
+    static constexpr size_t kMemoryUsageSampleInterval = 1024;
+    // When spilling is allowed, the hash table is frozen once it uses all but 1/N of the memory
+    // limit, so that the groups in it can keep growing until the limit is reached.
+    static constexpr size_t kFrozenTableGrowthDivisor = 4;
+
+    /**
+     * Returns an accessor for an input 'slot' which reads either from the child stage or, while a
+     * spilled partition is being processed, from the row read back from disk.
+     */
+    value::SlotAccessor* getSpillableInputAccessor(CompileCtx& ctx, value::SlotId slot);
+
+    /**
+     * Creates an empty hash table using the collator, if any.
+     */
+    void makeTable();
+
+    /**
+     * Aggregates the current input row into the hash table, or writes it into one of the spill
+     * partitions of the given 'level' if the hash table is full and does not yet hold its group.
+     */
+    void consumeRow(size_t level);
+
+    /**
+     * Updates the memory usage estimate after the group pointed to by 'it' has been updated and
+     * starts spilling if the estimate exceeds the memory limit. Once spilling, fails the query if
+     * the groups which stayed in memory grow past the memory limit.
+     */
+    void trackMemoryUsage(TableType::iterator it, bool inserted);
+
+    void spillRow(const value::MaterializedRow& key, size_t level);
+    void finishSpilling(size_t level);
+
+    /**
+     * Rebuilds the hash table from the next pending spilled partition. Returns false if there are
+     * no partitions left.
+     */
+    bool processNextSpilledPartition();
+
+    void removeSpilledFiles();
+
     const value::SlotVector _gbs;
     const value::SlotMap<std::unique_ptr<EExpression>> _aggs;
     const boost::optional<value::SlotId> _collatorSlot;
+    const size_t _memoryLimit;
+    const bool _allowDiskUse;
 
     value::SlotAccessorMap _outAccessors;
     std::vector<value::SlotAccessor*> _inKeyAccessors;
@@ -87,6 +176,32 @@ private:
     vm::ByteCode _bytecode;
 
     bool _compiled{false};
+
+    // Input slots which must be written to disk along with the group-by keys when a row is
+    // spilled, i.e. the group-by slots and any slots read by the aggregate expressions. Each of
+    // them is read through a switch accessor which points either to the child stage (index 0) or
+    // to '_spilledRow' (index 1).
+    value::SlotMap<value::SwitchAccessor*> _inSwitchAccessors;
+    std::vector<std::unique_ptr<value::SwitchAccessor>> _switchAccessors;
+    std::vector<std::unique_ptr<value::MaterializedRowKeyAccessor<SpilledRow*>>>
+        _spilledRowAccessors;
+    SpilledRow _spilledRow;
+    SpilledRow* _spilledRowIt{&_spilledRow};
+
+    // Memory usage estimate of the hash table, based on the average size of the sampled groups.
+    size_t _sampledBytes{0};
+    size_t _numSamples{0};
+    size_t _updatesSinceLastSample{0};
+
+    // Non-empty once the hash table has been frozen and rows for new groups are being spilled.
+    // The writers are only created once the first row is written into the respective partition.
+    std::vector<std::unique_ptr<SpillWriter>> _spillWriters;
+    std::vector<std::string> _spillFileNames;
+    // Partitions are processed from the front while new ones are appended to the back, so a
+    // reference to the partition being processed remains valid.
+    std::deque<SpilledPartition> _pendingPartitions;
+
+    HashAggStats _specificStats;
 };
 }  // namespace sbe
 }  // namespace mongo
@@ -32,10 +32,31 @@
 #include "mongo/db/exec/sbe/stages/hash_join.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/util/spilling.h"
 #include "mongo/util/str.h"
 
+namespace {
+std::string nextFileName() {
+    static mongo::AtomicWord<unsigned> hashJoinFileCounter;
+    return "extsort-hash-join-sbe." + std::to_string(hashJoinFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
+#include "mongo/db/sorter/sorter.cpp"
+
 namespace mongo {
 namespace sbe {
+namespace {
+std::unique_ptr<SortedFileWriter<value::MaterializedRow, value::MaterializedRow>> makeSpillWriter(
+    std::string* fileName) {
+    SortOptions opts;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    *fileName = opts.tempDir + "/" + nextFileName();
+    return std::make_unique<SortedFileWriter<value::MaterializedRow, value::MaterializedRow>>(
+        opts, *fileName, 0);
+}
+}  // namespace
+
 HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
                              std::unique_ptr<PlanStage> inner,
                              value::SlotVector outerCond,
@@ -43,6 +64,8 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
                              value::SlotVector innerCond,
                              value::SlotVector innerProjects,
                              boost::optional<value::SlotId> collatorSlot,
+                             size_t memoryLimit,
+                             bool allowDiskUse,
                              PlanNodeId planNodeId)
     : PlanStage("hj"_sd, planNodeId),
       _outerCond(std::move(outerCond)),
@@ -50,6 +73,8 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
       _innerCond(std::move(innerCond)),
       _innerProjects(std::move(innerProjects)),
       _collatorSlot(collatorSlot),
+      _memoryLimit(memoryLimit),
+      _allowDiskUse(allowDiskUse),
       _probeKey(0) {
     if (_outerCond.size() != _innerCond.size()) {
         uasserted(4822823, "left and right size do not match");
@@ -59,6 +84,10 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
     _children.emplace_back(std::move(inner));
 }
 
+HashJoinStage::~HashJoinStage() {
+    removeSpilledFiles();
+}
+
 std::unique_ptr<PlanStage> HashJoinStage::clone() const {
     return std::make_unique<HashJoinStage>(_children[0]->clone(),
                                            _children[1]->clone(),
@@ -67,6 +96,8 @@ std::unique_ptr<PlanStage> HashJoinStage::clone() const {
                                            _innerCond,
                                            _innerProjects,
                                            _collatorSlot,
+                                           _memoryLimit,
+                                           _allowDiskUse,
                                            _commonStats.nodeId);
 }
 
@@ -97,7 +128,26 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         auto [it, inserted] = dupCheck.emplace(slot);
         uassert(4822825, str::stream() << "duplicate field: " << slot, inserted);
 
-        _inInnerKeyAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        _probeRowAccessors.emplace_back(
+            std::make_unique<value::MaterializedRowKeyAccessor<SpilledRow*>>(_probeRowIt,
+                                                                             counter++));
+        _innerSwitchAccessors.emplace_back(
+            std::make_unique<value::SwitchAccessor>(std::vector<value::SlotAccessor*>{
+                _children[1]->getAccessor(ctx, slot), _probeRowAccessors.back().get()}));
+        _inInnerKeyAccessors.emplace_back(_innerSwitchAccessors.back().get());
+        _outInnerAccessors.emplace(slot, _innerSwitchAccessors.back().get());
+    }
+
+    counter = 0;
+    for (auto& slot : _innerProjects) {
+        _probeRowAccessors.emplace_back(
+            std::make_unique<value::MaterializedRowValueAccessor<SpilledRow*>>(_probeRowIt,
+                                                                               counter++));
+        _innerSwitchAccessors.emplace_back(
+            std::make_unique<value::SwitchAccessor>(std::vector<value::SlotAccessor*>{
+                _children[1]->getAccessor(ctx, slot), _probeRowAccessors.back().get()}));
+        _innerProjectAccessors.emplace_back(_innerSwitchAccessors.back().get());
+        _outInnerAccessors.emplace(slot, _innerSwitchAccessors.back().get());
     }
 
     counter = 0;
@@ -122,15 +172,17 @@ value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
             return it->second;
         }
 
+        if (auto it = _outInnerAccessors.find(slot); it != _outInnerAccessors.end()) {
+            return it->second;
+        }
+
         return _children[1]->getAccessor(ctx, slot);
     }
 
     return ctx.getAccessor(slot);
 }
 
-void HashJoinStage::open(bool reOpen) {
-    auto optTimer(getOptTimer(_opCtx));
-
+void HashJoinStage::makeTable() {
     if (_collatorAccessor) {
         auto [tag, collatorVal] = _collatorAccessor->getViewOfValue();
         uassert(5402504, "collatorSlot must be of collator type", tag == value::TypeTags::collator);
@@ -142,6 +194,232 @@ void HashJoinStage::open(bool reOpen) {
         _ht.emplace();
     }
 
+    _memoryUsage = 0;
+}
+
+size_t HashJoinStage::getPartition(const value::MaterializedRow& key) const {
+    return getSpillPartition(_ht->hash_function()(key), _level, kNumSpillPartitions);
+}
+
+void HashJoinStage::insertBuildRow(value::MaterializedRow key, value::MaterializedRow project) {
+    if (!_spilledPartitions.empty()) {
+        auto partition = getPartition(key);
+        if (_spilledPartitions[partition]) {
+            spillBuildRow(partition, key, project);
+            return;
+        }
+    }
+
+    _memoryUsage += key.memUsageForSorter() + project.memUsageForSorter();
+    _ht->emplace(std::move(key), std::move(project));
+
+    if (_memoryUsage > _memoryLimit) {
+        evictPartitions();
+    }
+}
+
+void HashJoinStage::evictPartitions() {
+    uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+            "Exceeded memory limit for hash join, but didn't allow external spilling. Pass "
+            "allowDiskUse:true to opt in.",
+            _allowDiskUse);
+
+    if (_level >= kMaxSpillLevel) {
+        return;
+    }
+
+    if (_spilledPartitions.empty()) {
+        _spilledPartitions.resize(kNumSpillPartitions);
+        _buildWriters.resize(kNumSpillPartitions);
+        _probeWriters.resize(kNumSpillPartitions);
+        _buildFileNames.resize(kNumSpillPartitions);
+        _probeFileNames.resize(kNumSpillPartitions);
+    }
+
+    std::vector<size_t> partitionMemoryUsage(kNumSpillPartitions, 0);
+    for (auto&& [key, project] : *_ht) {
+        partitionMemoryUsage[getPartition(key)] +=
+            key.memUsageForSorter() + project.memUsageForSorter();
+    }
+
+    // Evict the largest partitions first, so that as much as possible of the outer side is
+    // written to disk by a single pass over the hash table.
+    std::vector<bool> evict(kNumSpillPartitions, false);
+    while (_memoryUsage > _memoryLimit) {
+        auto largest = std::max_element(partitionMemoryUsage.begin(), partitionMemoryUsage.end());
+        if (*largest == 0) {
+            break;
+        }
+
+        auto partition = std::distance(partitionMemoryUsage.begin(), largest);
+        evict[partition] = true;
+        _spilledPartitions[partition] = true;
+        _memoryUsage -= *largest;
+        *largest = 0;
+        ++_specificStats.spilledPartitions;
+    }
+
+    for (auto it = _ht->begin(); it != _ht->end();) {
+        auto partition = getPartition(it->first);
+        if (evict[partition]) {
+            spillBuildRow(partition, it->first, it->second);
+            it = _ht->erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void HashJoinStage::spillBuildRow(size_t partition,
+                                  const value::MaterializedRow& key,
+                                  const value::MaterializedRow& project) {
+    auto& writer = _buildWriters[partition];
+    if (!writer) {
+        writer = makeSpillWriter(&_buildFileNames[partition]);
+    }
+    writer->addAlreadySorted(key, project);
+    ++_specificStats.spilledBuildRecords;
+}
+
+void HashJoinStage::spillProbeRow(size_t partition) {
+    auto& writer = _probeWriters[partition];
+    if (!writer) {
+        writer = makeSpillWriter(&_probeFileNames[partition]);
+    }
+
+    value::MaterializedRow project{_innerProjectAccessors.size()};
+    for (size_t idx = 0; idx < _innerProjectAccessors.size(); ++idx) {
+        auto [tag, val] = _innerProjectAccessors[idx]->getViewOfValue();
+        project.reset(idx, false, tag, val);
+    }
+    writer->addAlreadySorted(_probeKey, project);
+    ++_specificStats.spilledProbeRecords;
+}
+
+bool HashJoinStage::nextProbeRow() {
+    if (!_currentPartition) {
+        return _children[1]->getNext() == PlanState::ADVANCED;
+    }
+
+    auto& probeIterator = _currentPartition->probeIterator;
+    if (!probeIterator->more()) {
+        return false;
+    }
+
+    checkForInterrupt(_opCtx);
+    _probeRow = probeIterator->next();
+    return true;
+}
+
+void HashJoinStage::finishSpilling() {
+    for (size_t partition = 0; partition < _spilledPartitions.size(); ++partition) {
+        auto& buildWriter = _buildWriters[partition];
+        auto& probeWriter = _probeWriters[partition];
+        if (buildWriter && probeWriter) {
+            _pendingPartitions.push_back(
+                {std::unique_ptr<SpillIterator>(buildWriter->done()),
+                 _buildFileNames[partition],
+                 std::unique_ptr<SpillIterator>(probeWriter->done()),
+                 _probeFileNames[partition],
+                 _level});
+            _buildFileNames[partition].clear();
+            _probeFileNames[partition].clear();
+        }
+        // Otherwise one of the sides of the partition is empty, so none of its rows can produce
+        // a match and the files left behind are removed below.
+    }
+
+    removeSpilledFiles(false /* includePendingPartitions */);
+}
+
+bool HashJoinStage::joinNextSpilledPartition() {
+    finishSpilling();
+
+    if (_currentPartition) {
+        _currentPartition->probeIterator->closeSource();
+        _currentPartition->buildIterator.reset();
+        _currentPartition->probeIterator.reset();
+        boost::filesystem::remove(_currentPartition->buildFileName);
+        boost::filesystem::remove(_currentPartition->probeFileName);
+        _currentPartition = boost::none;
+    }
+
+    if (_pendingPartitions.empty()) {
+        return false;
+    }
+
+    _currentPartition.emplace(std::move(_pendingPartitions.front()));
+    _pendingPartitions.pop_front();
+
+    _level = _currentPartition->level + 1;
+    for (auto& accessor : _innerSwitchAccessors) {
+        accessor->setIndex(1);
+    }
+
+    makeTable();
+    auto& buildIterator = _currentPartition->buildIterator;
+    buildIterator->openSource();
+    while (buildIterator->more()) {
+        checkForInterrupt(_opCtx);
+        auto [key, project] = buildIterator->next();
+        insertBuildRow(std::move(key), std::move(project));
+    }
+    buildIterator->closeSource();
+
+    _currentPartition->probeIterator->openSource();
+
+    _htIt = _ht->end();
+    _htItEnd = _ht->end();
+    return true;
+}
+
+void HashJoinStage::removeSpilledFiles(bool includePendingPartitions) {
+    _buildWriters.clear();
+    _probeWriters.clear();
+    for (auto&& fileName : _buildFileNames) {
+        if (!fileName.empty()) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(fileName));
+        }
+    }
+    for (auto&& fileName : _probeFileNames) {
+        if (!fileName.empty()) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(fileName));
+        }
+    }
+    _buildFileNames.clear();
+    _probeFileNames.clear();
+    _spilledPartitions.clear();
+
+    if (!includePendingPartitions) {
+        return;
+    }
+
+    auto removePartition = [](SpilledPartition& partition) {
+        partition.buildIterator.reset();
+        partition.probeIterator.reset();
+        DESTRUCTOR_GUARD(boost::filesystem::remove(partition.buildFileName));
+        DESTRUCTOR_GUARD(boost::filesystem::remove(partition.probeFileName));
+    };
+    for (auto&& partition : _pendingPartitions) {
+        removePartition(partition);
+    }
+    _pendingPartitions.clear();
+    if (_currentPartition) {
+        removePartition(*_currentPartition);
+        _currentPartition = boost::none;
+    }
+}
+
+void HashJoinStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    removeSpilledFiles();
+    _level = 0;
+    for (auto& accessor : _innerSwitchAccessors) {
+        accessor->setIndex(0);
+    }
+    makeTable();
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
     // Insert the outer side into the hash table.
@@ -163,7 +441,7 @@ void HashJoinStage::open(bool reOpen) {
             project.reset(idx++, true, tag, val);
         }
 
-        _ht->emplace(std::move(key), std::move(project));
+        insertBuildRow(std::move(key), std::move(project));
     }
 
     _children[0]->close();
@@ -181,27 +459,37 @@ PlanState HashJoinStage::getNext() {
         ++_htIt;
     }
 
-    if (_htIt == _htItEnd) {
-        while (_htIt == _htItEnd) {
-            auto state = _children[1]->getNext();
-            if (state == PlanState::IS_EOF) {
+    while (_htIt == _htItEnd) {
+        if (!nextProbeRow()) {
+            // Once the inner side is exhausted, move on to the partitions spilled to disk.
+            if (!joinNextSpilledPartition()) {
                 // LEFT and OUTER joins should enumerate "non-returned" rows here.
-                return trackPlanState(state);
+                return trackPlanState(PlanState::IS_EOF);
             }
+            continue;
+        }
 
-            // Copy keys in order to do the lookup.
-            size_t idx = 0;
-            for (auto& p : _inInnerKeyAccessors) {
-                auto [tag, val] = p->getViewOfValue();
-                _probeKey.reset(idx++, false, tag, val);
-            }
+        // Copy keys in order to do the lookup.
+        size_t idx = 0;
+        for (auto& p : _inInnerKeyAccessors) {
+            auto [tag, val] = p->getViewOfValue();
+            _probeKey.reset(idx++, false, tag, val);
+        }
 
-            auto [low, hi] = _ht->equal_range(_probeKey);
-            _htIt = low;
-            _htItEnd = hi;
-            // If _htIt == _htItEnd (i.e. no match) then RIGHT and OUTER joins
-            // should enumerate "non-returned" rows here.
+        if (!_spilledPartitions.empty()) {
+            auto partition = getPartition(_probeKey);
+            if (_spilledPartitions[partition]) {
+                // The matching outer rows, if any, are on disk.
+                spillProbeRow(partition);
+                continue;
+            }
         }
+
+        auto [low, hi] = _ht->equal_range(_probeKey);
+        _htIt = low;
+        _htItEnd = hi;
+        // If _htIt == _htItEnd (i.e. no match) then RIGHT and OUTER joins
+        // should enumerate "non-returned" rows here.
     }
 
     return trackPlanState(PlanState::ADVANCED);
@@ -213,17 +501,33 @@ void HashJoinStage::close() {
     trackClose();
     _children[1]->close();
     _ht = boost::none;
+    removeSpilledFiles();
 }
 
 std::unique_ptr<PlanStageStats> HashJoinStage::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<HashJoinStats>(_specificStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        bob.appendNumber("memLimit", static_cast<long long>(_memoryLimit));
+        bob.appendBool("usedDisk", _specificStats.spilledPartitions > 0);
+        bob.appendNumber("spilledPartitions",
+                         static_cast<long long>(_specificStats.spilledPartitions));
+        bob.appendNumber("spilledBuildRecords",
+                         static_cast<long long>(_specificStats.spilledBuildRecords));
+        bob.appendNumber("spilledProbeRecords",
+                         static_cast<long long>(_specificStats.spilledProbeRecords));
+        ret->debugInfo = bob.obj();
+    }
+
     ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
     ret->children.emplace_back(_children[1]->getStats(includeDebugInfo));
     return ret;
 }
 
 const SpecificStats* HashJoinStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 std::vector<DebugPrinter::Block> HashJoinStage::debugPrint() const {
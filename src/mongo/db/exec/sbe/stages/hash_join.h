@@ -29,12 +29,36 @@
 
 #pragma once
 
+#include <deque>
 #include <vector>
 
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 
+namespace mongo {
+template <typename Key, typename Value>
+class SortIteratorInterface;
+template <typename Key, typename Value>
+class SortedFileWriter;
+}  // namespace mongo
+
 namespace mongo::sbe {
+/**
+ * Joins the rows of the 'outer' (build) side with the rows of the 'inner' (probe) side for which
+ * the values of the 'outerCond' and 'innerCond' slots are equal. The outer side is loaded into an
+ * in-memory hash table which is then probed with every row of the inner side.
+ *
+ * If the estimated size of the hash table exceeds 'memoryLimit' the stage either fails with
+ * 'QueryExceededMemoryLimitNoDiskUseAllowed' or, if 'allowDiskUse' is set, runs as a hybrid grace
+ * hash join: the rows are split into hash partitions by their key and the largest partitions are
+ * evicted from the hash table to disk until it fits in memory again. Outer rows of an evicted
+ * partition are written straight to disk, as are the inner rows which would probe it. Once the
+ * inner side is exhausted, each pair of spilled partitions is joined in the same way, partitioning
+ * it once again if its outer side still does not fit in memory.
+ *
+ * Only the 'innerCond' and 'innerProjects' slots are written to disk along with a spilled inner
+ * row, so these are the only inner slots which may be read by the parent stages.
+ */
 class HashJoinStage final : public PlanStage {
 public:
     HashJoinStage(std::unique_ptr<PlanStage> outer,
@@ -44,8 +68,12 @@ public:
                   value::SlotVector innerCond,
                   value::SlotVector innerProjects,
                   boost::optional<value::SlotId> collatorSlot,
+                  size_t memoryLimit,
+                  bool allowDiskUse,
                   PlanNodeId planNodeId);
 
+    ~HashJoinStage();
+
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -67,11 +95,79 @@ private:
     using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
     using HashProjectAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
 
+    using SpilledRow = std::pair<value::MaterializedRow, value::MaterializedRow>;
+    using SpillWriter = SortedFileWriter<value::MaterializedRow, value::MaterializedRow>;
+    using SpillIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
+
+    /**
+     * The outer and inner rows of a hash partition which have been written to disk and are
+     * waiting to be joined. 'level' is the recursion depth at which the partition was produced.
+     */
+    struct SpilledPartition {
+        std::unique_ptr<SpillIterator> buildIterator;
+        std::string buildFileName;
+        std::unique_ptr<SpillIterator> probeIterator;
+        std::string probeFileName;
+        size_t level;
+    };
+
+    // The number of partitions the rows are split into at every level of partitioning.
+    static constexpr size_t kNumSpillPartitions = 16;
+    // A partition produced at this level is always joined in memory, whatever its size. This
+    // bounds the recursion for the keys which cannot be split any further, e.g. when most of the
+    // outer rows share a single key.
+    static constexpr size_t kMaxSpillLevel = 4;
+
+    void makeTable();
+
+    /**
+     * Inserts an outer row into the hash table, or writes it to disk if its partition has already
+     * been evicted.
+     */
+    void insertBuildRow(value::MaterializedRow key, value::MaterializedRow project);
+
+    /**
+     * Evicts the largest partitions from the hash table to disk until the table fits in memory.
+     */
+    void evictPartitions();
+
+    size_t getPartition(const value::MaterializedRow& key) const;
+    void spillBuildRow(size_t partition,
+                       const value::MaterializedRow& key,
+                       const value::MaterializedRow& project);
+    void spillProbeRow(size_t partition);
+
+    /**
+     * Advances the inner side, reading from the inner file of the partition being joined if there
+     * is one. Returns false once the inner side is exhausted.
+     */
+    bool nextProbeRow();
+
+    /**
+     * Hands the partitions spilled at the current level over to '_pendingPartitions' and resets
+     * the spilling state.
+     */
+    void finishSpilling();
+
+    /**
+     * Loads the outer side of the next pending partition into the hash table and starts reading
+     * its inner side. Returns false if there are no partitions left.
+     */
+    bool joinNextSpilledPartition();
+
+    /**
+     * Removes the files of the partitions being spilled at the current level and, unless
+     * 'includePendingPartitions' is false, those of all partitions which are yet to be joined.
+     */
+    void removeSpilledFiles(bool includePendingPartitions = true);
+
     const value::SlotVector _outerCond;
     const value::SlotVector _outerProjects;
     const value::SlotVector _innerCond;
     const value::SlotVector _innerProjects;
     const boost::optional<value::SlotId> _collatorSlot;
+    const size_t _memoryLimit;
+    const bool _allowDiskUse;
 
     // All defined values from the outer side (i.e. they come from the hash table).
     value::SlotAccessorMap _outOuterAccessors;
@@ -88,9 +184,18 @@ private:
     // Accessors of output projections.
     std::vector<std::unique_ptr<HashProjectAccessor>> _outOuterProjectAccessors;
 
-    // Accessors of input condition values (keys) that are being inserted into the hash table.
+    // Accessors of input condition values (keys) that are used to probe the hash table.
     std::vector<value::SlotAccessor*> _inInnerKeyAccessors;
 
+    // Accessors of the inner 'innerCond' and 'innerProjects' slots. They read either from the
+    // inner child (index 0) or from the inner row read back from disk (index 1).
+    value::SlotMap<value::SwitchAccessor*> _outInnerAccessors;
+    std::vector<std::unique_ptr<value::SwitchAccessor>> _innerSwitchAccessors;
+    std::vector<value::SwitchAccessor*> _innerProjectAccessors;
+    std::vector<std::unique_ptr<value::SlotAccessor>> _probeRowAccessors;
+    SpilledRow _probeRow;
+    SpilledRow* _probeRowIt{&_probeRow};
+
     // Accessor for collator. Only set if collatorSlot provided during construction.
     value::SlotAccessor* _collatorAccessor = nullptr;
 
@@ -104,5 +209,26 @@ private:
     vm::ByteCode _bytecode;
 
     bool _compiled{false};
+
+    // The estimated size of the rows in the hash table.
+    size_t _memoryUsage{0};
+
+    // The partitioning level of the rows being joined: 0 for the rows coming from the children,
+    // or one more than the level of the partition being read back from disk.
+    size_t _level{0};
+
+    // Non-empty once a partition has been evicted at the current level, in which case only the
+    // rows of partitions which are not marked here are joined in memory.
+    std::vector<bool> _spilledPartitions;
+    std::vector<std::unique_ptr<SpillWriter>> _buildWriters;
+    std::vector<std::unique_ptr<SpillWriter>> _probeWriters;
+    std::vector<std::string> _buildFileNames;
+    std::vector<std::string> _probeFileNames;
+
+    // Partitions are taken from the front while new ones are appended to the back.
+    std::deque<SpilledPartition> _pendingPartitions;
+    boost::optional<SpilledPartition> _currentPartition;
+
+    HashJoinStats _specificStats;
 };
 }  // namespace mongo::sbe
@@ -183,6 +183,46 @@ struct LoopJoinStats final : public SpecificStats {
     size_t innerCloses{0};
 };
 
+struct HashAggStats final : public SpecificStats {
+    std::unique_ptr<SpecificStats> clone() const final {
+        return std::make_unique<HashAggStats>(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
+    void accumulate(PlanSummaryStats& summary) const final {
+        summary.usedDisk = summary.usedDisk || spills > 0;
+    }
+
+    // The number of hash partitions of input rows which were written to disk.
+    size_t spills{0};
+    // The number of input rows which were written to disk because their group did not fit into
+    // the in-memory hash table.
+    size_t spilledRecords{0};
+};
+
+struct HashJoinStats final : public SpecificStats {
+    std::unique_ptr<SpecificStats> clone() const final {
+        return std::make_unique<HashJoinStats>(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
+    void accumulate(PlanSummaryStats& summary) const final {
+        summary.usedDisk = summary.usedDisk || spilledPartitions > 0;
+    }
+
+    // The number of hash partitions which did not fit in memory and were written to disk.
+    size_t spilledPartitions{0};
+    // The number of rows from the build (outer) and the probe (inner) side written to disk.
+    size_t spilledBuildRecords{0};
+    size_t spilledProbeRecords{0};
+};
+
 struct TraverseStats : public SpecificStats {
     std::unique_ptr<SpecificStats> clone() const final {
         return std::make_unique<TraverseStats>(*this);
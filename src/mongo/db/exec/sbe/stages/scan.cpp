@@ -34,6 +34,7 @@
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/trial_run_tracker.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/util/str.h"
 
@@ -173,6 +174,12 @@ void ScanStage::doSaveState() {
         }
     }
 
+    // Records which have been fetched but not returned yet are only valid until the cursor is
+    // saved.
+    for (size_t i = _batchPosition; i < _batch.size(); ++i) {
+        _batch[i].data.makeOwned();
+    }
+
     if (_cursor) {
         _cursor->save();
     }
@@ -264,14 +271,38 @@ void ScanStage::open(bool reOpen) {
         if (!_cursor || !_seekKeyAccessor) {
             _cursor = collection->getCursor(_opCtx, _forward);
         }
+
+        _useBatches = !_seekKeyAccessor && !_oplogTsSlot && !collection->isCapped() &&
+            !_scanCallbacks.indexKeyCorruptionCheckCallback &&
+            !_scanCallbacks.indexKeyConsistencyCheckCallBack;
     } else {
         _cursor.reset();
     }
 
+    _batch.clear();
+    _batchPosition = 0;
     _open = true;
     _firstGetNext = true;
 }
 
+boost::optional<Record> ScanStage::nextRecord() {
+    if (_batchPosition == _batch.size()) {
+        // A batch of one record would only add a copy of it, so the cursor is read directly.
+        const auto batchSize = internalQueryCollectionScanBatchSize.load();
+        if (!_useBatches || batchSize <= 1) {
+            return _cursor->next();
+        }
+
+        _batchPosition = 0;
+        _cursor->nextBatch(&_batch, batchSize);
+        if (_batch.empty()) {
+            return boost::none;
+        }
+    }
+
+    return std::move(_batch[_batchPosition++]);
+}
+
 PlanState ScanStage::getNext() {
     auto optTimer(getOptTimer(_opCtx));
 
@@ -286,7 +317,7 @@ PlanState ScanStage::getNext() {
     checkForInterrupt(_opCtx);
 
     auto res = _firstGetNext && _seekKeyAccessor;
-    auto nextRecord = res ? _cursor->seekExact(_key) : _cursor->next();
+    auto nextRecord = res ? _cursor->seekExact(_key) : this->nextRecord();
     _firstGetNext = false;
 
     if (!nextRecord) {
@@ -376,6 +407,8 @@ void ScanStage::close() {
     trackClose();
     _cursor.reset();
     _coll.reset();
+    _batch.clear();
+    _batchPosition = 0;
     _open = false;
 }
 
@@ -590,7 +623,8 @@ void ParallelScanStage::prepare(CompileCtx& ctx) {
         _indexKeyPatternAccessor = ctx.getAccessor(*_indexKeyPatternSlot);
     }
 
-    std::tie(_collName, _catalogEpoch) = acquireCollection(_opCtx, _collUuid, nullptr, _coll);
+    std::tie(_collName, _catalogEpoch) =
+        acquireCollection(_opCtx, _collUuid, _scanCallbacks.lockAcquisitionCallback, _coll);
 }
 
 value::SlotAccessor* ParallelScanStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
@@ -638,7 +672,8 @@ void ParallelScanStage::doRestoreState() {
         return;
     }
 
-    restoreCollection(_opCtx, _collName, _collUuid, _catalogEpoch, nullptr, _coll);
+    restoreCollection(
+        _opCtx, _collName, _collUuid, _catalogEpoch, _scanCallbacks.lockAcquisitionCallback, _coll);
 
     if (_cursor) {
         const bool couldRestore = _cursor->restore();
@@ -671,7 +706,12 @@ void ParallelScanStage::open(bool reOpen) {
         // we're being opened after 'close()'. we need to re-acquire '_coll' in this case and
         // make some validity checks (the collection has not been dropped, renamed, etc.).
         tassert(5071013, "ParallelScanStage is not open but have _cursor", !_cursor);
-        restoreCollection(_opCtx, _collName, _collUuid, _catalogEpoch, nullptr, _coll);
+        restoreCollection(_opCtx,
+                          _collName,
+                          _collUuid,
+                          _catalogEpoch,
+                          _scanCallbacks.lockAcquisitionCallback,
+                          _coll);
     }
 
     const auto& collection = _coll->getCollection();
@@ -773,6 +813,8 @@ PlanState ParallelScanStage::getNext() {
         }
     } while (!nextRecord);
 
+    ++_specificStats.numReads;
+
     if (_recordAccessor) {
         _recordAccessor->reset(false,
                                value::TypeTags::bsonObject,
@@ -826,11 +868,19 @@ void ParallelScanStage::close() {
 
 std::unique_ptr<PlanStageStats> ParallelScanStage::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<ScanStats>(_specificStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        bob.appendNumber("numReads", static_cast<long long>(_specificStats.numReads));
+        ret->debugInfo = bob.obj();
+    }
+
     return ret;
 }
 
 const SpecificStats* ParallelScanStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 std::vector<DebugPrinter::Block> ParallelScanStage::debugPrint() const {
@@ -94,6 +94,12 @@ protected:
     void doAttachToTrialRunTracker(TrialRunTracker* tracker) override;
 
 private:
+    /**
+     * Returns the next record from '_batch', refilling it from '_cursor' when all of its records
+     * have been returned. If batching is disabled, simply advances '_cursor'.
+     */
+    boost::optional<Record> nextRecord();
+
     const CollectionUUID _collUuid;
     const boost::optional<value::SlotId> _recordSlot;
     const boost::optional<value::SlotId> _recordIdSlot;
@@ -137,6 +143,14 @@ private:
     RecordId _key;
     bool _firstGetNext{false};
 
+    // Records fetched from '_cursor' by a single call to nextBatch() and the position of the next
+    // one to return. Only plain scans over collections which are not capped use batches, since
+    // seeks and the callbacks used for index fetches expect the cursor to stay on the current
+    // record.
+    bool _useBatches{false};
+    std::vector<Record> _batch;
+    size_t _batchPosition{0};
+
     ScanStats _specificStats;
 };
 
@@ -240,6 +254,8 @@ private:
 
     std::unique_ptr<SeekableRecordCursor> _cursor;
     boost::optional<AutoGetCollectionForReadMaybeLockFree> _coll;
+
+    ScanStats _specificStats;
 };
 }  // namespace sbe
 }  // namespace mongo
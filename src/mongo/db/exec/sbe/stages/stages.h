@@ -343,7 +343,7 @@ public:
     }
 
 protected:
-    PlanYieldPolicy* const _yieldPolicy{nullptr};
+    PlanYieldPolicy* _yieldPolicy{nullptr};
 
 private:
     static const int kInterruptCheckPeriod = 128;
@@ -405,6 +405,22 @@ public:
      */
     virtual void close() = 0;
 
+    /**
+     * Rebinds every stage in this tree which is responsible for yielding to the given
+     * 'yieldPolicy'. Stages which were built with yielding disabled are left intact. A tree cloned
+     * from a cached plan must be rebound this way before it is executed, since its stages still
+     * refer to the yield policy of the query the cached plan was originally built for.
+     */
+    void setYieldPolicy(PlanYieldPolicy* yieldPolicy) {
+        if (_yieldPolicy) {
+            _yieldPolicy = yieldPolicy;
+        }
+
+        for (auto&& child : _children) {
+            child->setYieldPolicy(yieldPolicy);
+        }
+    }
+
     virtual std::vector<DebugPrinter::Block> debugPrint() const {
         auto stats = getCommonStats();
         std::string str = str::stream() << '[' << stats->nodeId << "] " << stats->stageType;
@@ -100,7 +100,9 @@ int Instruction::stackOffset[Instruction::Tags::lastInstruction] = {
     -2,  // collCmp3w
 
     -1,  // fillEmpty
+    0,   // fillEmptyImm
     -1,  // getField
+    0,   // getFieldImm
     -1,  // getElement
     -1,  // collComparisonKey
 
@@ -307,10 +309,37 @@ void CodeFragment::appendSimpleInstruction(Instruction::Tags tag) {
     offset += writeToMemory(offset, i);
 }
 
+void CodeFragment::appendFillEmpty(Instruction::Constants k) {
+    Instruction i;
+    i.tag = Instruction::fillEmptyImm;
+    adjustStackSimple(i);
+
+    auto offset = allocateSpace(sizeof(Instruction) + sizeof(k));
+
+    offset += writeToMemory(offset, i);
+    offset += writeToMemory(offset, k);
+}
+
 void CodeFragment::appendGetField() {
     appendSimpleInstruction(Instruction::getField);
 }
 
+void CodeFragment::appendGetField(StringData fieldName) {
+    // The field name is stored in the bytecode right after its length, so it must fit in a byte.
+    invariant(fieldName.size() <= std::numeric_limits<uint8_t>::max());
+    auto size = static_cast<uint8_t>(fieldName.size());
+
+    Instruction i;
+    i.tag = Instruction::getFieldImm;
+    adjustStackSimple(i);
+
+    auto offset = allocateSpace(sizeof(Instruction) + sizeof(size) + size);
+
+    offset += writeToMemory(offset, i);
+    offset += writeToMemory(offset, size);
+    std::copy(fieldName.rawData(), fieldName.rawData() + size, offset);
+}
+
 void CodeFragment::appendGetElement() {
     appendSimpleInstruction(Instruction::getElement);
 }
@@ -469,8 +498,12 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::getField(value::TypeTa
         return {false, value::TypeTags::Nothing, 0};
     }
 
-    auto fieldStr = value::getStringView(fieldTag, fieldValue);
+    return getField(objTag, objValue, value::getStringView(fieldTag, fieldValue));
+}
 
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::getField(value::TypeTags objTag,
+                                                                   value::Value objValue,
+                                                                   StringData fieldStr) {
     if (MONGO_unlikely(failOnPoisonedFieldLookup.shouldFail())) {
         uassert(4623399, "Lookup of $POISON", fieldStr != "POISON");
     }
@@ -1134,6 +1167,66 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinCollAddToSet(Ar
     return {ownAgg, tagAgg, valAgg};
 }
 
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::aggAppendArrayElements(
+    size_t fieldIdx, value::TypeTags aggTag, const CollatorInterface* collator) {
+    auto [ownAgg, tagAgg, valAgg] = getFromStack(0);
+    auto [_, tagField, valField] = getFromStack(fieldIdx);
+
+    // Create a new array or set if it does not exist yet.
+    if (tagAgg == value::TypeTags::Nothing) {
+        ownAgg = true;
+        std::tie(tagAgg, valAgg) = aggTag == value::TypeTags::Array
+            ? value::makeNewArray()
+            : value::makeNewArraySet(collator);
+    } else {
+        // Take ownership of the accumulator.
+        topStack(false, value::TypeTags::Nothing, 0);
+    }
+    value::ValueGuard guard{tagAgg, valAgg};
+
+    invariant(ownAgg && tagAgg == aggTag);
+    auto appendElements = [&](auto arr) {
+        if (!value::isArray(tagField)) {
+            return;
+        }
+        for (value::ArrayEnumerator it{tagField, valField}; !it.atEnd(); it.advance()) {
+            auto [tagElem, valElem] = it.getViewOfValue();
+            auto [tagCopy, valCopy] = value::copyValue(tagElem, valElem);
+            arr->push_back(tagCopy, valCopy);
+        }
+    };
+    if (tagAgg == value::TypeTags::Array) {
+        appendElements(value::getArrayView(valAgg));
+    } else {
+        appendElements(value::getArraySetView(valAgg));
+    }
+
+    guard.reset();
+    return {ownAgg, tagAgg, valAgg};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggConcatArrays(ArityType arity) {
+    return aggAppendArrayElements(1, value::TypeTags::Array);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggSetUnion(ArityType arity) {
+    return aggAppendArrayElements(1, value::TypeTags::ArraySet);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggCollSetUnion(ArityType arity) {
+    auto [ownAgg, tagAgg, valAgg] = getFromStack(0);
+    auto [ownColl, tagColl, valColl] = getFromStack(1);
+
+    // If the collator is Nothing or if it's some unexpected type, don't append the values and
+    // just return the accumulator.
+    if (tagColl != value::TypeTags::collator) {
+        topStack(false, value::TypeTags::Nothing, 0);
+        return {ownAgg, tagAgg, valAgg};
+    }
+
+    return aggAppendArrayElements(2, value::TypeTags::ArraySet, value::getCollatorView(valColl));
+}
+
 std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinRunJsPredicate(ArityType arity) {
     invariant(arity == 2);
 
@@ -3097,6 +3190,12 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinAddToSet(arity);
         case Builtin::collAddToSet:
             return builtinCollAddToSet(arity);
+        case Builtin::aggConcatArrays:
+            return builtinAggConcatArrays(arity);
+        case Builtin::aggSetUnion:
+            return builtinAggSetUnion(arity);
+        case Builtin::aggCollSetUnion:
+            return builtinAggCollSetUnion(arity);
         case Builtin::doubleDoubleSum:
             return builtinDoubleDoubleSum(arity);
         case Builtin::bitTestZero:
@@ -3741,6 +3840,32 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     }
                     break;
                 }
+                case Instruction::fillEmptyImm: {
+                    auto k = readFromMemory<Instruction::Constants>(pcPointer);
+                    pcPointer += sizeof(k);
+
+                    auto [owned, tag, val] = getFromStack(0);
+                    if (tag == value::TypeTags::Nothing) {
+                        switch (k) {
+                            case Instruction::Null:
+                                topStack(false, value::TypeTags::Null, 0);
+                                break;
+                            case Instruction::False:
+                                topStack(false,
+                                         value::TypeTags::Boolean,
+                                         value::bitcastFrom<bool>(false));
+                                break;
+                            case Instruction::True:
+                                topStack(false,
+                                         value::TypeTags::Boolean,
+                                         value::bitcastFrom<bool>(true));
+                                break;
+                            default:
+                                MONGO_UNREACHABLE;
+                        }
+                    }
+                    break;
+                }
                 case Instruction::getField: {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
@@ -3758,6 +3883,23 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     }
                     break;
                 }
+                case Instruction::getFieldImm: {
+                    auto size = readFromMemory<uint8_t>(pcPointer);
+                    pcPointer += sizeof(size);
+                    StringData fieldName(reinterpret_cast<const char*>(pcPointer), size);
+                    pcPointer += size;
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [owned, tag, val] = getField(lhsTag, lhsVal, fieldName);
+
+                    topStack(owned, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    break;
+                }
                 case Instruction::getElement: {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
@@ -235,7 +235,9 @@ struct Instruction {
         collCmp3w,
 
         fillEmpty,
+        fillEmptyImm,  // fillEmpty with a constant default encoded in the instruction
         getField,
+        getFieldImm,  // getField with the field name encoded in the instruction
         getElement,
         collComparisonKey,
 
@@ -274,6 +276,15 @@ struct Instruction {
         lastInstruction  // this is just a marker used to calculate number of instructions
     };
 
+    /**
+     * Constant operands which can be encoded directly in an instruction.
+     */
+    enum Constants : uint8_t {
+        Null,
+        False,
+        True,
+    };
+
     // Make sure that values in this arrays are always in-sync with the enum.
     static int stackOffset[];
 
@@ -309,6 +320,9 @@ enum class Builtin : uint8_t {
     addToArray,       // agg function to append to an array
     addToSet,         // agg function to append to a set
     collAddToSet,     // agg function to append to a set (with collation)
+    aggConcatArrays,  // agg function to append the elements of an array to an array
+    aggSetUnion,      // agg function to append the elements of an array to a set
+    aggCollSetUnion,  // agg function to append the elements of an array to a set (with collation)
     doubleDoubleSum,  // special double summation
     bitTestZero,      // test bitwise mask & value is zero
     bitTestMask,      // test bitwise mask & value is mask
@@ -445,7 +459,9 @@ public:
     void appendFillEmpty() {
         appendSimpleInstruction(Instruction::fillEmpty);
     }
+    void appendFillEmpty(Instruction::Constants k);
     void appendGetField();
+    void appendGetField(StringData fieldName);
     void appendGetElement();
     void appendCollComparisonKey();
     void appendSum();
@@ -598,6 +614,10 @@ private:
                                                              value::TypeTags fieldTag,
                                                              value::Value fieldValue);
 
+    std::tuple<bool, value::TypeTags, value::Value> getField(value::TypeTags objTag,
+                                                             value::Value objValue,
+                                                             StringData fieldStr);
+
     std::tuple<bool, value::TypeTags, value::Value> getElement(value::TypeTags objTag,
                                                                value::Value objValue,
                                                                value::TypeTags fieldTag,
@@ -694,6 +714,15 @@ private:
                                                                      value::TypeTags timezoneTag,
                                                                      value::Value timezoneValue);
 
+    /**
+     * Appends the elements of the array at stack position 'fieldIdx' to the accumulator at
+     * position 0, ignoring anything but an array. 'aggTag' decides how the elements are inserted:
+     * an Array keeps every element, an ArraySet drops the ones it already contains according to
+     * 'collator'. If the accumulator does not exist yet, a new one of type 'aggTag' is created.
+     */
+    std::tuple<bool, value::TypeTags, value::Value> aggAppendArrayElements(
+        size_t fieldIdx, value::TypeTags aggTag, const CollatorInterface* collator = nullptr);
+
     std::tuple<bool, value::TypeTags, value::Value> builtinSplit(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinDate(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinDateWeekYear(ArityType arity);
@@ -721,6 +750,9 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> builtinAddToArray(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinAddToSet(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinCollAddToSet(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggConcatArrays(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggSetUnion(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggCollSetUnion(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinDoubleDoubleSum(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinBitTestZero(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinBitTestMask(ArityType arity);
@@ -76,10 +76,16 @@ PlanStage::StageState UnpackTimeseriesBucket::doWork(WorkingSetID* out) {
             // calls to 'doWork()'.
             auto ownedBucket = member->doc.value().toBson().getOwned();
             _bucketUnpacker.reset(std::move(ownedBucket));
+            ++_specificStats.nBucketsUnpacked;
+
+            // The unpacker's measurement filter may have rejected every measurement.
+            if (!_bucketUnpacker.hasNext()) {
+                _ws.free(id);
+                return PlanStage::NEED_TIME;
+            }
 
             auto measurement = _bucketUnpacker.getNext();
             transitionToOwnedObj(std::move(measurement), member);
-            ++_specificStats.nBucketsUnpacked;
 
             *out = id;
         } else if (PlanStage::NEED_YIELD == status) {
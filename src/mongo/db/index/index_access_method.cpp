@@ -36,6 +36,7 @@
 #include <utility>
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -499,6 +500,8 @@ public:
      */
     Sorter::Iterator* done() final;
 
+    void mergePartial(std::unique_ptr<BulkBuilder> partial) final;
+
     int64_t getKeysInserted() const final;
 
     Sorter::PersistedState persistDataForShutdown() final;
@@ -506,6 +509,12 @@ public:
 private:
     void _insertMultikeyMetadataKeysIntoSorter();
 
+    /**
+     * Adds the keys of the partial BulkBuilders into '_sorter', so that they are all persisted
+     * together with the keys of this BulkBuilder.
+     */
+    void _insertPartialKeysIntoSorter();
+
     Sorter* _makeSorter(
         size_t maxMemoryUsageBytes,
         StringData dbName,
@@ -515,9 +524,15 @@ private:
     Sorter::Settings _makeSorterSettings() const;
 
     const IndexCatalogEntry* _indexCatalogEntry;
+    const size_t _maxMemoryUsageBytes;
+    const std::string _dbName;
     std::unique_ptr<Sorter> _sorter;
     int64_t _keysInserted = 0;
 
+    // BulkBuilders for the same index whose keys are merged with the keys in '_sorter' by done().
+    // They must outlive the iterator returned by done().
+    std::vector<std::unique_ptr<BulkBuilderImpl>> _partials;
+
     // Set to true if any document added to the BulkBuilder causes the index to become multikey.
     bool _isMultiKey = false;
 
@@ -544,13 +559,18 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initi
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes,
                                                             StringData dbName)
-    : _indexCatalogEntry(index), _sorter(_makeSorter(maxMemoryUsageBytes, dbName)) {}
+    : _indexCatalogEntry(index),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _dbName(dbName.toString()),
+      _sorter(_makeSorter(maxMemoryUsageBytes, dbName)) {}
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes,
                                                             const IndexStateInfo& stateInfo,
                                                             StringData dbName)
     : _indexCatalogEntry(index),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _dbName(dbName.toString()),
       _sorter(
           _makeSorter(maxMemoryUsageBytes, dbName, stateInfo.getFileName(), stateInfo.getRanges())),
       _keysInserted(stateInfo.getNumKeys().value_or(0)),
@@ -631,7 +651,52 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
     _insertMultikeyMetadataKeysIntoSorter();
-    return _sorter->done();
+    if (_partials.empty()) {
+        return _sorter->done();
+    }
+
+    // Each partial BulkBuilder has sorted its own keys, so a k-way merge of all the sorted streams
+    // produces the keys of the whole index in order.
+    std::vector<std::shared_ptr<Sorter::Iterator>> iterators;
+    iterators.reserve(_partials.size() + 1);
+    iterators.emplace_back(_sorter->done());
+    for (auto& partial : _partials) {
+        iterators.emplace_back(partial->_sorter->done());
+    }
+    return Sorter::Iterator::merge(iterators,
+                                   makeSortOptions(_maxMemoryUsageBytes, _dbName),
+                                   BtreeExternalSortComparison());
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::mergePartial(
+    std::unique_ptr<BulkBuilder> partial) {
+    auto partialImpl = checked_cast<BulkBuilderImpl*>(partial.get());
+    invariant(partialImpl->_indexCatalogEntry == _indexCatalogEntry);
+    invariant(partialImpl->_partials.empty());
+
+    const auto& partialMultikeyPaths = partialImpl->_indexMultikeyPaths;
+    if (!partialMultikeyPaths.empty()) {
+        if (_indexMultikeyPaths.empty()) {
+            _indexMultikeyPaths = partialMultikeyPaths;
+        } else {
+            invariant(_indexMultikeyPaths.size() == partialMultikeyPaths.size());
+            for (size_t i = 0; i < partialMultikeyPaths.size(); ++i) {
+                _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
+                                              partialMultikeyPaths[i].begin(),
+                                              partialMultikeyPaths[i].end());
+            }
+        }
+    }
+    _isMultiKey = _isMultiKey || partialImpl->_isMultiKey;
+
+    // Multikey metadata keys may be generated by several partial BulkBuilders, so they are
+    // deduplicated here rather than inserted into each of their sorters.
+    _multikeyMetadataKeys.insert(partialImpl->_multikeyMetadataKeys.begin(),
+                                 partialImpl->_multikeyMetadataKeys.end());
+    partialImpl->_multikeyMetadataKeys.clear();
+    _keysInserted += partialImpl->_keysInserted;
+
+    _partials.emplace_back(checked_cast<BulkBuilderImpl*>(partial.release()));
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
@@ -641,6 +706,7 @@ int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
 AbstractIndexAccessMethod::BulkBuilder::Sorter::PersistedState
 AbstractIndexAccessMethod::BulkBuilderImpl::persistDataForShutdown() {
     _insertMultikeyMetadataKeysIntoSorter();
+    _insertPartialKeysIntoSorter();
     return _sorter->persistDataForShutdown();
 }
 
@@ -655,6 +721,18 @@ void AbstractIndexAccessMethod::BulkBuilderImpl::_insertMultikeyMetadataKeysInto
     _multikeyMetadataKeys.clear();
 }
 
+void AbstractIndexAccessMethod::BulkBuilderImpl::_insertPartialKeysIntoSorter() {
+    // The keys of the partial BulkBuilders have already been counted in '_keysInserted'.
+    for (auto& partial : _partials) {
+        std::unique_ptr<Sorter::Iterator> it(partial->_sorter->done());
+        while (it->more()) {
+            auto data = it->next();
+            _sorter->add(data.first, data.second);
+        }
+    }
+    _partials.clear();
+}
+
 AbstractIndexAccessMethod::BulkBuilderImpl::Sorter::Settings
 AbstractIndexAccessMethod::BulkBuilderImpl::_makeSorterSettings() const {
     return std::pair<KeyString::Value::SorterDeserializeSettings,
@@ -254,6 +254,15 @@ public:
          */
         virtual Sorter::Iterator* done() = 0;
 
+        /**
+         * Takes ownership of 'partial', a BulkBuilder for the same index which was filled
+         * independently of this one, for example by another thread scanning a different range of
+         * the collection. The multikey information of 'partial' is merged into this BulkBuilder
+         * right away, whereas its keys are merged with the keys of this BulkBuilder by done(). No
+         * more keys may be inserted into 'partial'.
+         */
+        virtual void mergePartial(std::unique_ptr<BulkBuilder> partial) = 0;
+
         /**
          * Returns number of keys inserted using this BulkBuilder.
          */
@@ -73,9 +73,12 @@ void SkippedRecordTracker::record(OperationContext* opCtx, const RecordId& recor
     BSONObj toInsert = builder.obj();
 
     // Lazily initialize table when we record the first document.
-    if (!_skippedRecordsTable) {
-        _skippedRecordsTable =
-            opCtx->getServiceContext()->getStorageEngine()->makeTemporaryRecordStore(opCtx);
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_skippedRecordsTable) {
+            _skippedRecordsTable =
+                opCtx->getServiceContext()->getStorageEngine()->makeTemporaryRecordStore(opCtx);
+        }
     }
 
     writeConflictRetry(
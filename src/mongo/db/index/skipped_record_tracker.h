@@ -33,6 +33,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/temporary_record_store.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 
 namespace mongo {
 
@@ -88,6 +89,10 @@ private:
     // kept along with it with a call to finalizeTemporaryTable().
     std::unique_ptr<TemporaryRecordStore> _skippedRecordsTable;
 
+    // Protects the lazy creation of '_skippedRecordsTable', since a parallel collection scan may
+    // record documents from several threads.
+    Mutex _mutex = MONGO_MAKE_LATCH("SkippedRecordTracker::_mutex");
+
     AtomicWord<std::uint32_t> _skippedRecordCounter{0};
 };
 
@@ -29,8 +29,11 @@
 
 #include "mongo/db/matcher/expression.h"
 
+#include <cmath>
+
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression_leaf.h"
 
 namespace mongo {
 
@@ -95,6 +98,44 @@ bool matchExpressionLessThan(const MatchExpression* lhs, const MatchExpression*
     return matchExpressionComparator(lhs, rhs) < 0;
 }
 
+/**
+ * Returns true if the given constant can be replaced with an input parameter. Constants of other
+ * types (e.g. null, arrays or NaN) are special-cased when building a query plan, so substituting
+ * them at runtime could produce wrong results.
+ */
+bool isParameterizableConstant(const BSONElement& elem) {
+    switch (elem.type()) {
+        case NumberInt:
+        case NumberLong:
+        case String:
+        case Date:
+        case jstOID:
+        case Bool:
+        case bsonTimestamp:
+            return true;
+        case NumberDouble:
+            return !std::isnan(elem.numberDouble());
+        case NumberDecimal:
+            return !elem.numberDecimal().isNaN();
+        default:
+            return false;
+    }
+}
+
+void parameterizeTree(MatchExpression* tree, std::vector<const MatchExpression*>* params) {
+    if (ComparisonMatchExpression::isComparisonMatchExpression(tree)) {
+        auto expr = static_cast<ComparisonMatchExpressionBase*>(tree);
+        if (isParameterizableConstant(expr->getData())) {
+            expr->setInputParamId(static_cast<MatchExpression::InputParamId>(params->size()));
+            params->push_back(expr);
+        }
+    }
+
+    for (size_t i = 0; i < tree->numChildren(); ++i) {
+        parameterizeTree(tree->getChild(i), params);
+    }
+}
+
 }  // namespace
 
 MatchExpression::MatchExpression(MatchType type, clonable_ptr<ErrorAnnotation> annotation)
@@ -112,6 +153,13 @@ void MatchExpression::sortTree(MatchExpression* tree) {
     }
 }
 
+// static
+std::vector<const MatchExpression*> MatchExpression::parameterize(MatchExpression* tree) {
+    std::vector<const MatchExpression*> params;
+    parameterizeTree(tree, &params);
+    return params;
+}
+
 std::string MatchExpression::toString() const {
     return serialize().toString();
 }
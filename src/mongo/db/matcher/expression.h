@@ -62,6 +62,9 @@ class MatchExpression {
     MatchExpression& operator=(const MatchExpression&) = delete;
 
 public:
+    // Identifies an input parameter of a query. See MatchExpression::parameterize().
+    using InputParamId = int32_t;
+
     enum MatchType {
         // tree types
         AND,
@@ -295,6 +298,17 @@ public:
         return tree;
     }
 
+    /**
+     * Traverses expression tree pre-order and marks the constants which can be supplied to a query
+     * plan at runtime as input parameters, so that a plan built for one query can be reused by any
+     * query of the same shape. Currently only the right-hand sides of $eq, $lt, $lte, $gt and $gte
+     * are parameterized, provided that the type of the constant does not affect the generated plan
+     * (e.g. numbers other than NaN, strings, dates or ObjectIds).
+     *
+     * Returns a vector of the parameterized expressions, indexed by the assigned InputParamId.
+     */
+    static std::vector<const MatchExpression*> parameterize(MatchExpression* tree);
+
     MatchExpression(MatchType type, clonable_ptr<ErrorAnnotation> annotation = nullptr);
     virtual ~MatchExpression() {}
 
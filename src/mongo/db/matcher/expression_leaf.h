@@ -155,6 +155,18 @@ public:
         return _collator;
     }
 
+    /**
+     * Marks the RHS of this expression as an input parameter of the query. See
+     * MatchExpression::parameterize().
+     */
+    void setInputParamId(InputParamId paramId) {
+        _inputParamId = paramId;
+    }
+
+    boost::optional<InputParamId> getInputParamId() const {
+        return _inputParamId;
+    }
+
 protected:
     /**
      * 'collator' must outlive the ComparisonMatchExpression and any clones made of it.
@@ -170,6 +182,9 @@ protected:
     // Collator used to compare elements. By default, simple binary comparison will be used.
     const CollatorInterface* _collator = nullptr;
 
+    // Set if the RHS of this expression was marked as an input parameter of the query.
+    boost::optional<InputParamId> _inputParamId;
+
 private:
     ExpressionOptimizerFunc getOptimizer() const final {
         return [](std::unique_ptr<MatchExpression> expression) { return expression; };
@@ -234,6 +249,9 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        if (_inputParamId) {
+            e->setInputParamId(*_inputParamId);
+        }
         return e;
     }
 
@@ -270,6 +288,9 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        if (_inputParamId) {
+            e->setInputParamId(*_inputParamId);
+        }
         return e;
     }
 
@@ -306,6 +327,9 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        if (_inputParamId) {
+            e->setInputParamId(*_inputParamId);
+        }
         return e;
     }
 
@@ -347,6 +371,9 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        if (_inputParamId) {
+            e->setInputParamId(*_inputParamId);
+        }
         return e;
     }
 
@@ -387,6 +414,9 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        if (_inputParamId) {
+            e->setInputParamId(*_inputParamId);
+        }
         return e;
     }
 
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(query, std::move(expCtx));
+    ASSERT_OK(swExpr.getStatus());
+    return std::move(swExpr.getValue());
+}
+
+boost::optional<MatchExpression::InputParamId> getInputParamId(const MatchExpression* expr) {
+    return static_cast<const ComparisonMatchExpressionBase*>(expr)->getInputParamId();
+}
+
+TEST(MatchExpressionParameterizationTest, ComparisonsAreParameterizedInPreOrder) {
+    auto query = fromjson("{a: 1, b: {$gt: 'x', $lte: 'z'}, c: {$lt: 2.5}}");
+    auto expr = parse(query);
+    auto params = MatchExpression::parameterize(expr.get());
+
+    ASSERT_EQ(params.size(), 4U);
+    for (size_t i = 0; i < params.size(); ++i) {
+        ASSERT_EQ(getInputParamId(params[i]), static_cast<MatchExpression::InputParamId>(i));
+    }
+    ASSERT_EQ(params[0]->matchType(), MatchExpression::EQ);
+    ASSERT_EQ(params[1]->matchType(), MatchExpression::GT);
+    ASSERT_EQ(params[2]->matchType(), MatchExpression::LTE);
+    ASSERT_EQ(params[3]->matchType(), MatchExpression::LT);
+}
+
+TEST(MatchExpressionParameterizationTest, ConstantsWhichAffectThePlanAreNotParameterized) {
+    auto query = fromjson(
+        "{a: null, b: NaN, c: [1, 2], d: {x: 1}, e: {$gt: {$minKey: 1}}, f: {$lt: {$maxKey: 1}},"
+        " g: 1}");
+    auto expr = parse(query);
+    auto params = MatchExpression::parameterize(expr.get());
+
+    ASSERT_EQ(params.size(), 1U);
+    ASSERT_EQ(params[0]->path(), "g"_sd);
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        auto child = expr->getChild(i);
+        if (child->path() != "g"_sd) {
+            ASSERT_FALSE(getInputParamId(child));
+        }
+    }
+}
+
+TEST(MatchExpressionParameterizationTest, ComparisonsUnderOtherExpressionsAreParameterized) {
+    auto query = fromjson("{$or: [{a: {$elemMatch: {$gte: 5}}}, {b: {$not: {$eq: 3}}}]}");
+    auto expr = parse(query);
+    auto params = MatchExpression::parameterize(expr.get());
+
+    ASSERT_EQ(params.size(), 2U);
+    ASSERT_EQ(params[0]->matchType(), MatchExpression::GTE);
+    ASSERT_EQ(params[1]->matchType(), MatchExpression::EQ);
+}
+
+TEST(MatchExpressionParameterizationTest, InputParamIdIsPreservedByClone) {
+    auto expr = parse(fromjson("{a: {$gt: 1}}"));
+    MatchExpression::parameterize(expr.get());
+
+    auto clone = expr->shallowClone();
+    ASSERT_EQ(getInputParamId(clone.get()), MatchExpression::InputParamId{0});
+}
+
+}  // namespace
+}  // namespace mongo
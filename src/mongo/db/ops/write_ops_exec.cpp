@@ -1261,6 +1261,72 @@ Status performAtomicTimeseriesWrites(
     return ex.toStatus();
 }
 
+Status performAtomicTimeseriesBucketMerge(OperationContext* opCtx,
+                                          const NamespaceString& ns,
+                                          const std::vector<BSONObj>& originalBuckets,
+                                          const BSONObj& mergedBucket) try {
+    invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+    invariant(!opCtx->inMultiDocumentTransaction());
+    invariant(!originalBuckets.empty());
+
+    DisableDocumentValidation disableDocumentValidation{opCtx};
+
+    AutoGetCollection coll{opCtx, ns, MODE_IX};
+    if (!coll) {
+        return {ErrorCodes::NamespaceNotFound,
+                str::stream() << "Could not find time-series buckets collection " << ns};
+    }
+
+    auto curOp = CurOp::get(opCtx);
+    curOp->raiseDbProfileLevel(CollectionCatalog::get(opCtx)->getDatabaseProfileLevel(ns.db()));
+
+    assertCanWrite_inlock(opCtx, ns);
+
+    WriteUnitOfWork wuow{opCtx};
+
+    for (auto it = originalBuckets.begin(); it != originalBuckets.end(); ++it) {
+        auto query = BSON("_id" << (*it)["_id"]);
+
+        // TODO (SERVER-56270): Remove handling for non-clustered time-series collections.
+        auto recordId = coll->isClustered() ? record_id_helpers::keyForOID((*it)["_id"].OID())
+                                            : Helpers::findOne(opCtx, *coll, query, false);
+
+        Snapshotted<BSONObj> original;
+        if (recordId.isNull() || !coll->findDoc(opCtx, recordId, &original) ||
+            !original.value().binaryEqual(*it)) {
+            return {ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "Time-series bucket " << query
+                                  << " was modified while it was being merged"};
+        }
+
+        if (it != originalBuckets.begin()) {
+            coll->deleteDocument(
+                opCtx, original, kUninitializedStmtId, recordId, &curOp->debug());
+            continue;
+        }
+
+        CollectionUpdateArgs args;
+        args.preImageDoc = original.value();
+        args.updatedDoc = mergedBucket;
+        args.update = mergedBucket;
+        args.criteria = query;
+        args.source = OperationSource::kTimeseries;
+        coll->updateDocument(opCtx,
+                             recordId,
+                             original,
+                             mergedBucket,
+                             true /* indexesAffected */,
+                             &curOp->debug(),
+                             &args);
+    }
+
+    wuow.commit();
+
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
 void recordUpdateResultInOpDebug(const UpdateResult& updateResult, OpDebug* opDebug) {
     invariant(opDebug);
     opDebug->additiveMetrics.nMatched = updateResult.numMatched;
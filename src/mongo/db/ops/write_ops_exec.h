@@ -86,6 +86,19 @@ Status performAtomicTimeseriesWrites(OperationContext* opCtx,
                                      const std::vector<write_ops::InsertCommandRequest>& insertOps,
                                      const std::vector<write_ops::UpdateCommandRequest>& updateOps);
 
+/**
+ * Replaces the first of the time-series buckets 'originalBuckets' with 'mergedBucket', which holds
+ * the measurements of all of them, and deletes the others, in a single storage transaction. Fails
+ * without writing anything if any of the buckets was modified since it was read.
+ *
+ * The merge is not part of any user's write, so it must run on an internal client: its oplog
+ * entries advance the lastOp of the client, which write concerns of later operations wait for.
+ */
+Status performAtomicTimeseriesBucketMerge(OperationContext* opCtx,
+                                          const NamespaceString& ns,
+                                          const std::vector<BSONObj>& originalBuckets,
+                                          const BSONObj& mergedBucket);
+
 /**
  * Populate 'opDebug' with stats describing the execution of an update operation. Illegal to call
  * with a null OpDebug pointer.
@@ -0,0 +1,342 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_compress_timeseries_buckets.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/ops/write_ops_exec.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Rewrites the given closed bucket of the time-series collection 'ns' in the compressed format.
+ * Returns whether the bucket was compressed; it is left as it is otherwise.
+ */
+bool compressBucket(OperationContext* opCtx,
+                    const NamespaceString& ns,
+                    const BucketCatalog::ClosedBucket& closedBucket) {
+    auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+    auto query = BSON(timeseries::kBucketIdFieldName << closedBucket.bucketId);
+
+    BSONObj bucketDoc;
+    {
+        AutoGetCollectionForRead bucketsColl(opCtx, bucketsNs);
+        if (!bucketsColl ||
+            !Helpers::findOne(opCtx, bucketsColl.getCollection(), query, bucketDoc)) {
+            return false;
+        }
+    }
+
+    auto compressed = timeseries::compressBucket(bucketDoc, closedBucket.timeField);
+    if (!compressed) {
+        return false;
+    }
+
+    // Do not overwrite the bucket if it was compressed concurrently.
+    BSONObjBuilder queryBuilder(std::move(query));
+    queryBuilder.append(str::stream() << timeseries::kBucketControlFieldName << "."
+                                      << timeseries::kBucketControlVersionFieldName,
+                        timeseries::kTimeseriesControlDefaultVersion);
+    write_ops::UpdateOpEntry update(
+        queryBuilder.obj(),
+        write_ops::UpdateModification(*compressed, write_ops::UpdateModification::ClassicTag{}));
+    write_ops::UpdateCommandRequest op(bucketsNs, {update});
+
+    // The schema validation configured in the bucket collection is intended for direct operations
+    // by end users and is not applicable here.
+    write_ops::WriteCommandRequestBase base;
+    base.setBypassDocumentValidation(true);
+    op.setWriteCommandRequestBase(std::move(base));
+
+    auto reply = write_ops_exec::performUpdates(opCtx, op, OperationSource::kTimeseries);
+    invariant(reply.results.size() == 1);
+    const auto& result = reply.results.front();
+    if (!result.isOK()) {
+        uassertStatusOK(result.getStatus().withContext("Failed to compress time-series bucket"));
+    }
+    return result.getValue().getNModified() == 1;
+}
+
+/**
+ * Merges the given closed buckets of the time-series collection 'ns' into the first one, which must
+ * be the earliest, and compresses it. Returns whether the buckets were merged; they are left as
+ * they are otherwise. Runs on the client of the periodic job, so that the lastOp of the clients
+ * whose inserts closed the buckets does not include the merge.
+ */
+bool mergeBuckets(OperationContext* opCtx,
+                  const NamespaceString& ns,
+                  const BucketCatalog::ClosedBuckets& closedBuckets) {
+    auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+
+    std::vector<BSONObj> bucketDocs;
+    boost::optional<BSONObj> merged;
+    {
+        AutoGetCollectionForRead bucketsColl(opCtx, bucketsNs);
+        if (!bucketsColl) {
+            return false;
+        }
+        for (auto&& closedBucket : closedBuckets) {
+            BSONObj bucketDoc;
+            if (!Helpers::findOne(opCtx,
+                                  bucketsColl.getCollection(),
+                                  BSON(timeseries::kBucketIdFieldName << closedBucket.bucketId),
+                                  bucketDoc)) {
+                return false;
+            }
+            bucketDocs.push_back(bucketDoc.getOwned());
+        }
+        merged = timeseries::mergeBuckets(
+            bucketDocs, closedBuckets.front().timeField, bucketsColl->getDefaultCollator());
+    }
+    if (!merged || merged->objsize() > gTimeseriesBucketMaxSize) {
+        return false;
+    }
+
+    auto status =
+        write_ops_exec::performAtomicTimeseriesBucketMerge(opCtx, bucketsNs, bucketDocs, *merged);
+    if (status == ErrorCodes::ConflictingOperationInProgress) {
+        return false;
+    }
+    uassertStatusOK(status);
+    return true;
+}
+
+/**
+ * Splits the closed buckets of the time-series collection 'ns' into groups which can each be
+ * merged into a single bucket: their buckets have the same metadata and together stay within the
+ * limits on the number of measurements and the time range of a bucket. Each group is ordered by
+ * time. Every bucket is in a group of its own unless timeseriesBucketMerging is enabled.
+ */
+std::vector<BucketCatalog::ClosedBuckets> groupClosedBuckets(
+    OperationContext* opCtx,
+    const NamespaceString& ns,
+    BucketCatalog::ClosedBuckets closedBuckets) {
+    boost::optional<Seconds> maxSpan;
+    if (gTimeseriesBucketMerging.load() && closedBuckets.size() > 1) {
+        AutoGetCollectionForRead bucketsColl(opCtx, ns.makeTimeseriesBucketsNamespace());
+        if (bucketsColl && bucketsColl->getTimeseriesOptions()) {
+            maxSpan = Seconds(*bucketsColl->getTimeseriesOptions()->getBucketMaxSpanSeconds());
+        }
+    }
+
+    std::vector<BucketCatalog::ClosedBuckets> groups;
+    if (!maxSpan) {
+        for (auto&& closedBucket : closedBuckets) {
+            groups.push_back({std::move(closedBucket)});
+        }
+        return groups;
+    }
+
+    std::sort(closedBuckets.begin(), closedBuckets.end(), [](const auto& lhs, const auto& rhs) {
+        if (auto cmp = lhs.metadata.woCompare(rhs.metadata)) {
+            return cmp < 0;
+        }
+        return lhs.bucketId.asDateT() < rhs.bucketId.asDateT();
+    });
+
+    uint32_t numMeasurements = 0;
+    Date_t latestTime;
+    for (auto&& closedBucket : closedBuckets) {
+        auto fits = !groups.empty() &&
+            closedBucket.metadata.binaryEqual(groups.back().front().metadata) &&
+            numMeasurements + closedBucket.numMeasurements <=
+                static_cast<uint32_t>(gTimeseriesBucketMaxCount) &&
+            std::max(latestTime, closedBucket.latestTime) -
+                    groups.back().front().bucketId.asDateT() <
+                *maxSpan;
+        if (fits) {
+            numMeasurements += closedBucket.numMeasurements;
+            latestTime = std::max(latestTime, closedBucket.latestTime);
+            groups.back().push_back(std::move(closedBucket));
+        } else {
+            numMeasurements = closedBucket.numMeasurements;
+            latestTime = closedBucket.latestTime;
+            groups.push_back({std::move(closedBucket)});
+        }
+    }
+    return groups;
+}
+
+/**
+ * Compresses the buckets of the time-series collection 'ns' which the bucket catalog closed,
+ * merging the ones which fit together first. Compression is best effort: a bucket which cannot be
+ * compressed is left as it is. If the operation is interrupted, the buckets which were not handled
+ * yet are given back to the bucket catalog for the next run.
+ */
+void compressClosedBuckets(OperationContext* opCtx, const NamespaceString& ns) {
+    auto& bucketCatalog = BucketCatalog::get(opCtx);
+    auto closedBuckets = bucketCatalog.takeClosedBuckets(ns);
+    if (closedBuckets.empty()) {
+        return;
+    }
+
+    auto groups = groupClosedBuckets(opCtx, ns, std::move(closedBuckets));
+    size_t next = 0;
+    ON_BLOCK_EXIT([&] {
+        BucketCatalog::ClosedBuckets remaining;
+        for (; next < groups.size(); ++next) {
+            std::move(groups[next].begin(), groups[next].end(), std::back_inserter(remaining));
+        }
+        bucketCatalog.returnClosedBuckets(ns, std::move(remaining));
+    });
+
+    for (; next < groups.size(); ++next) {
+        // The featureCompatibilityVersion may have been downgraded in the meantime, in which case
+        // the closed buckets are dropped.
+        if (!BucketCatalog::isBucketCompressionEnabled()) {
+            next = groups.size();
+            return;
+        }
+        opCtx->checkForInterrupt();
+
+        auto& group = groups[next];
+        if (group.size() > 1) {
+            bool merged = false;
+            try {
+                merged = mergeBuckets(opCtx, ns, group);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                throw;
+            } catch (const ExceptionForCat<ErrorCategory::NotPrimaryError>&) {
+                throw;
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(5754736,
+                              "Failed to merge time-series buckets",
+                              "namespace"_attr = ns,
+                              "bucketId"_attr = group.front().bucketId,
+                              "numBuckets"_attr = group.size(),
+                              "error"_attr = redact(ex.toStatus()));
+            }
+            if (merged) {
+                bucketCatalog.reportBucketMerge(ns, group.size() - 1);
+                bucketCatalog.reportBucketCompression(ns, true);
+                continue;
+            }
+        }
+
+        for (auto&& closedBucket : group) {
+            bool compressed = false;
+            try {
+                compressed = compressBucket(opCtx, ns, closedBucket);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                throw;
+            } catch (const ExceptionForCat<ErrorCategory::NotPrimaryError>&) {
+                throw;
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(5754735,
+                              "Failed to compress time-series bucket",
+                              "namespace"_attr = ns,
+                              "bucketId"_attr = closedBucket.bucketId,
+                              "error"_attr = redact(ex.toStatus()));
+            }
+            bucketCatalog.reportBucketCompression(ns, compressed);
+        }
+    }
+}
+
+}  // namespace
+
+auto PeriodicThreadToCompressTimeseriesBuckets::get(ServiceContext* serviceContext)
+    -> PeriodicThreadToCompressTimeseriesBuckets& {
+    auto& jobContainer = _serviceDecoration(serviceContext);
+    jobContainer._init(serviceContext);
+
+    return jobContainer;
+}
+
+auto PeriodicThreadToCompressTimeseriesBuckets::operator*() const noexcept -> PeriodicJobAnchor& {
+    stdx::lock_guard lk(_mutex);
+    return *_anchor;
+}
+
+auto PeriodicThreadToCompressTimeseriesBuckets::operator->() const noexcept
+    -> PeriodicJobAnchor* {
+    stdx::lock_guard lk(_mutex);
+    return _anchor.get();
+}
+
+void PeriodicThreadToCompressTimeseriesBuckets::_init(ServiceContext* serviceContext) {
+    stdx::lock_guard lk(_mutex);
+    if (_anchor) {
+        return;
+    }
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "compressTimeseriesBuckets",
+        [](Client* client) {
+            if (!BucketCatalog::isBucketCompressionEnabled()) {
+                return;
+            }
+
+            // The opCtx destructor handles unsetting itself from the Client. (The PeriodicRunner's
+            // Client must be reset before returning.)
+            auto opCtx = client->makeOperationContext();
+
+            // The buckets can only be rewritten on a primary, so the job must not hold up a
+            // stepdown.
+            opCtx->setAlwaysInterruptAtStepDownOrUp();
+
+            auto& bucketCatalog = BucketCatalog::get(opCtx.get());
+            for (auto&& ns : bucketCatalog.getNamespacesWithClosedBuckets()) {
+                try {
+                    compressClosedBuckets(opCtx.get(), ns);
+                } catch (const ExceptionForCat<ErrorCategory::NotPrimaryError>&) {
+                    // The closed buckets are kept, and compressed once this node is primary
+                    // again.
+                    return;
+                } catch (const ExceptionForCat<ErrorCategory::Interruption>& ex) {
+                    LOGV2_DEBUG(5754752, 2, "Periodic job canceled", "reason"_attr = ex.reason());
+                    return;
+                }
+            }
+        },
+        Milliseconds(gTimeseriesBucketCompressionIntervalMillis));
+
+    _anchor = std::make_shared<PeriodicJobAnchor>(periodicRunner->makeJob(std::move(job)));
+}
+
+}  // namespace mongo
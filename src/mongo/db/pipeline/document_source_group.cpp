@@ -474,6 +474,12 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 
     intrusive_ptr<DocumentSourceGroup> groupStage(new DocumentSourceGroup(expCtx));
 
+    // Track whether all of the expressions of this $group are supported by SBE. The flag on the
+    // ExpressionContext is shared by the whole pipeline, so it is reset here and restored once the
+    // $group specification is parsed.
+    const bool sbeCompatibleBefore = expCtx->sbeCompatible;
+    expCtx->sbeCompatible = true;
+
     BSONObj groupObj(elem.Obj());
     BSONObjIterator groupIterator(groupObj);
     VariablesParseState vps = expCtx->variablesParseState;
@@ -500,6 +506,9 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 
     uassert(
         15955, "a group specification must include an _id", !groupStage->_idExpressions.empty());
+
+    groupStage->_sbeCompatible = expCtx->sbeCompatible;
+    expCtx->sbeCompatible = sbeCompatibleBefore && groupStage->_sbeCompatible;
     return groupStage;
 }
 
@@ -157,6 +157,14 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if all of the expressions of this $group stage can be translated into SBE, so
+     * that the stage may be pushed down into the SBE query plan.
+     */
+    bool sbeCompatible() const {
+        return _sbeCompatible;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -262,6 +270,9 @@ private:
 
     bool _doingMerge;
 
+    // Only set by createFromBson(), stages created by other means are never pushed down into SBE.
+    bool _sbeCompatible = false;
+
     MemoryUsageTracker _memoryTracker;
 
     GroupStats _stats;
@@ -494,15 +494,20 @@ DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
     }
 
     auto nextResult = pSource->getNext();
-    if (nextResult.isAdvanced()) {
+    while (nextResult.isAdvanced()) {
         auto bucket = nextResult.getDocument().toBson();
         _bucketUnpacker.reset(std::move(bucket));
         uassert(5346509,
                 str::stream() << "A bucket with _id "
                               << _bucketUnpacker.bucket()[timeseries::kBucketIdFieldName].toString()
                               << " contains an empty data region",
-                _bucketUnpacker.hasNext());
-        return _bucketUnpacker.getNext();
+                _bucketUnpacker.hasNext() || _bucketUnpacker.numberOfMeasurements() > 0);
+        if (_bucketUnpacker.hasNext()) {
+            return _bucketUnpacker.getNext();
+        }
+
+        // The measurement filter rejected every measurement in the bucket.
+        nextResult = pSource->getNext();
     }
 
     return nextResult;
@@ -727,6 +732,47 @@ DocumentSourceInternalUnpackBucket::createPredicatesOnBucketLevelField(
         if (andMatchExpr->numChildren() > 0) {
             return andMatchExpr;
         }
+    } else if (matchExpr->matchType() == MatchExpression::OR) {
+        // A bucket can only be skipped if it matches none of the disjuncts, so every child must be
+        // mapped for the $or to be mapped.
+        auto nextOr = static_cast<const OrMatchExpression*>(matchExpr);
+        auto orMatchExpr = std::make_unique<OrMatchExpression>();
+
+        for (size_t i = 0; i < nextOr->numChildren(); i++) {
+            auto child = createPredicatesOnBucketLevelField(nextOr->getChild(i));
+            if (!child) {
+                return nullptr;
+            }
+            orMatchExpr->add(std::move(child));
+        }
+        if (orMatchExpr->numChildren() > 0) {
+            return orMatchExpr;
+        }
+    } else if (matchExpr->matchType() == MatchExpression::MATCH_IN) {
+        // Map {a: {$in: [x, y]}} as if it were {$or: [{a: {$eq: x}}, {a: {$eq: y}}]}. Regexes and
+        // null have no equivalent range on the control field, so those are not mapped.
+        auto inExpr = static_cast<const InMatchExpression*>(matchExpr);
+        if (!inExpr->getRegexes().empty() || inExpr->hasNull() ||
+            inExpr->getEqualities().empty()) {
+            return nullptr;
+        }
+
+        auto orMatchExpr = std::make_unique<OrMatchExpression>();
+        for (auto&& equality : inExpr->getEqualities()) {
+            EqualityMatchExpression eqExpr(inExpr->path(), equality);
+            auto child = createComparisonPredicate(&eqExpr,
+                                                   _bucketUnpacker.bucketSpec(),
+                                                   _bucketMaxSpanSeconds,
+                                                   pExpCtx->collationMatchesDefault);
+            if (!child) {
+                return nullptr;
+            }
+            orMatchExpr->add(std::move(child));
+        }
+        if (orMatchExpr->numChildren() == 1) {
+            return orMatchExpr->releaseChild(0);
+        }
+        return orMatchExpr;
     } else if (ComparisonMatchExpression::isComparisonMatchExpression(matchExpr)) {
         return createComparisonPredicate(static_cast<const ComparisonMatchExpression*>(matchExpr),
                                          _bucketUnpacker.bucketSpec(),
@@ -737,6 +783,56 @@ DocumentSourceInternalUnpackBucket::createPredicatesOnBucketLevelField(
     return nullptr;
 }
 
+std::vector<std::shared_ptr<const PathMatchExpression>>
+DocumentSourceInternalUnpackBucket::createMeasurementFilter(
+    const MatchExpression* matchExpr) const {
+    std::vector<std::shared_ptr<const PathMatchExpression>> predicates;
+    auto&& bucketSpec = _bucketUnpacker.bucketSpec();
+
+    auto addPredicate = [&](const MatchExpression* expr) {
+        if (!ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+            return;
+        }
+        auto comparison = static_cast<const ComparisonMatchExpression*>(expr);
+
+        // Only top-level fields map onto a single column of the bucket. The meta field and computed
+        // fields are not stored in the data region at all.
+        auto path = comparison->path();
+        if (path.empty() || path.find('.') != std::string::npos ||
+            (bucketSpec.metaField && path == bucketSpec.metaField.get()) ||
+            fieldIsComputed(bucketSpec, path.toString())) {
+            return;
+        }
+
+        // Comparisons against these types can match missing values or values nested in compound
+        // types, which can't be decided from the column value alone.
+        switch (comparison->getData().type()) {
+            case BSONType::Object:
+            case BSONType::Array:
+            case BSONType::jstNULL:
+            case BSONType::Undefined:
+            case BSONType::MinKey:
+            case BSONType::MaxKey:
+                return;
+            default:
+                break;
+        }
+
+        predicates.emplace_back(
+            static_cast<PathMatchExpression*>(comparison->shallowClone().release()));
+    };
+
+    if (matchExpr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < matchExpr->numChildren(); i++) {
+            addPredicate(matchExpr->getChild(i));
+        }
+    } else {
+        addPredicate(matchExpr);
+    }
+
+    return predicates;
+}
+
 std::pair<boost::intrusive_ptr<DocumentSourceMatch>, boost::intrusive_ptr<DocumentSourceMatch>>
 DocumentSourceInternalUnpackBucket::splitMatchOnMetaAndRename(
     boost::intrusive_ptr<DocumentSourceMatch> match) {
@@ -951,6 +1047,13 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
         }
     }
 
+    // Evaluate simple predicates on bucketed fields column-wise while unpacking, so that the
+    // measurements they reject are never materialized. The $match itself stays after this stage.
+    if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get())) {
+        _bucketUnpacker.setMeasurementFilter(
+            createMeasurementFilter(nextMatch->getMatchExpression()));
+    }
+
     // Attempt to map predicates on bucketed fields to predicates on the control field.
     if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get());
         nextMatch && !_triedBucketLevelFieldsPredicatesPushdown) {
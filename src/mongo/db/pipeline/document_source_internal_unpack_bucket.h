@@ -155,11 +155,24 @@ public:
      *      {control.min.time: {$_internalExprLt: new Date(...)}}
      * ]}
      *
+     * Conjunctions are mapped child by child, dropping children that cannot be mapped. A
+     * disjunction is only mapped if all of its children can be. $in is mapped as the disjunction of
+     * one equality per element, so {a: {$in: [1, 5]}} is mapped like {$or: [{a: 1}, {a: 5}]}.
+     *
      * If the provided predicate is ineligible for this mapping, the function will return a nullptr.
      */
     std::unique_ptr<MatchExpression> createPredicatesOnBucketLevelField(
         const MatchExpression* matchExpr) const;
 
+    /**
+     * Returns the conjuncts of 'matchExpr' that the bucket unpacker can evaluate column-wise to
+     * skip measurements before materializing them. These are comparisons of a top-level bucketed
+     * field against a scalar, for example {a: {$gt: 5}} or the 'a' child of
+     * {$and: [{a: {$gt: 5}}, {b: {$ne: 1}}]}. Returns an empty vector if there are none.
+     */
+    std::vector<std::shared_ptr<const PathMatchExpression>> createMeasurementFilter(
+        const MatchExpression* matchExpr) const;
+
     /**
      * Sets the sample size to 'n' and the maximum number of measurements in a bucket to be
      * 'bucketMaxCount'. Calling this method implicitly changes the behavior from having the stage
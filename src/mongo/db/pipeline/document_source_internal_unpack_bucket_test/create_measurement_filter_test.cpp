@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/util/make_data_structure.h"
+
+namespace mongo {
+namespace {
+
+class InternalUnpackBucketCreateMeasurementFilterTest : public AggregationContextFixture {
+protected:
+    /**
+     * Returns the serialized measurement filter created for 'matchSpec' by an unpack stage with
+     * the given 'unpackSpec'.
+     */
+    std::vector<BSONObj> createMeasurementFilter(const BSONObj& unpackSpec,
+                                                 const BSONObj& matchSpec) {
+        auto pipeline = Pipeline::parse(makeVector(unpackSpec, matchSpec), getExpCtx());
+        auto& container = pipeline->getSources();
+        ASSERT_EQ(container.size(), 2U);
+
+        auto original = dynamic_cast<DocumentSourceMatch*>(container.back().get());
+        auto predicates = dynamic_cast<DocumentSourceInternalUnpackBucket*>(container.front().get())
+                              ->createMeasurementFilter(original->getMatchExpression());
+
+        std::vector<BSONObj> serialized;
+        for (auto&& predicate : predicates) {
+            serialized.push_back(predicate->MatchExpression::serialize());
+        }
+        return serialized;
+    }
+
+    const BSONObj kUnpackSpec = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'myMeta', "
+        "bucketMaxSpanSeconds: 3600}}");
+};
+
+TEST_F(InternalUnpackBucketCreateMeasurementFilterTest, MapsSingleComparison) {
+    auto predicates = createMeasurementFilter(kUnpackSpec, fromjson("{$match: {a: {$gt: 1}}}"));
+    ASSERT_EQ(predicates.size(), 1U);
+    ASSERT_BSONOBJ_EQ(predicates[0], fromjson("{a: {$gt: 1}}"));
+}
+
+TEST_F(InternalUnpackBucketCreateMeasurementFilterTest, MapsEligibleConjuncts) {
+    auto predicates = createMeasurementFilter(
+        kUnpackSpec,
+        fromjson("{$match: {$and: [{a: {$lte: 5}}, {b: {$ne: 1}}, {'c.d': {$eq: 2}}, "
+                 "{myMeta: {$eq: 3}}, {time: {$gte: {$date: 0}}}]}}"));
+    ASSERT_EQ(predicates.size(), 2U);
+    ASSERT_BSONOBJ_EQ(predicates[0], fromjson("{a: {$lte: 5}}"));
+    ASSERT_BSONOBJ_EQ(predicates[1], fromjson("{time: {$gte: {$date: 0}}}"));
+}
+
+TEST_F(InternalUnpackBucketCreateMeasurementFilterTest, DoesNotMapNonScalarOrNullOperands) {
+    ASSERT(createMeasurementFilter(kUnpackSpec, fromjson("{$match: {a: {$eq: null}}}")).empty());
+    ASSERT(createMeasurementFilter(kUnpackSpec, fromjson("{$match: {a: {$gt: {b: 1}}}}")).empty());
+    ASSERT(createMeasurementFilter(kUnpackSpec, fromjson("{$match: {a: {$lt: [1]}}}")).empty());
+    ASSERT(
+        createMeasurementFilter(kUnpackSpec, fromjson("{$match: {a: {$gte: {$minKey: 1}}}}"))
+            .empty());
+}
+
+TEST_F(InternalUnpackBucketCreateMeasurementFilterTest, DoesNotMapDisjunctions) {
+    ASSERT(createMeasurementFilter(kUnpackSpec,
+                                   fromjson("{$match: {$or: [{a: {$gt: 1}}, {b: {$lt: 1}}]}}"))
+               .empty());
+}
+
+TEST_F(InternalUnpackBucketCreateMeasurementFilterTest, OptimizeSetsMeasurementFilter) {
+    auto pipeline = Pipeline::parse(
+        makeVector(kUnpackSpec, fromjson("{$match: {$and: [{a: {$gt: 1}}, {b: {$ne: 1}}]}}")),
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    // The $match is kept after the unpack stage, since arrays are not filtered by the unpacker.
+    auto& container = pipeline->getSources();
+    ASSERT(dynamic_cast<DocumentSourceMatch*>(container.back().get()));
+    auto unpack =
+        dynamic_cast<DocumentSourceInternalUnpackBucket*>(std::prev(container.end(), 2)->get());
+    ASSERT(unpack);
+
+    auto&& filter = unpack->bucketUnpacker().measurementFilter();
+    ASSERT_EQ(filter.size(), 1U);
+    ASSERT_BSONOBJ_EQ(filter[0]->MatchExpression::serialize(), fromjson("{a: {$gt: 1}}"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,7 +30,10 @@
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
 
 namespace mongo {
@@ -888,5 +891,40 @@ TEST_F(InternalUnpackBucketExecTest, ParserRoundtripsComputedMetaProjFieldOverri
     unpackBucket->serializeToArray(array);
     ASSERT_BSONOBJ_EQ(array[0].getDocument().toBson(), bson);
 }
+
+TEST_F(InternalUnpackBucketExecTest, UnpackSkipsMeasurementsRejectedByMeasurementFilter) {
+    auto expCtx = getExpCtx();
+    auto pipeline = Pipeline::parse(
+        makeVector(fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time', "
+                            "metaField: 'myMeta', bucketMaxSpanSeconds: 3600}}"),
+                   fromjson("{$match: {a: {$gte: 2}}}")),
+        expCtx);
+    pipeline->optimizePipeline();
+    auto& container = pipeline->getSources();
+    auto unpack =
+        dynamic_cast<DocumentSourceInternalUnpackBucket*>(std::prev(container.end(), 2)->get());
+    ASSERT(unpack);
+
+    // No measurement of the first bucket passes the filter, so it is skipped entirely.
+    auto source = DocumentSourceMock::createForTest(
+        {"{meta: {m1: 999}, data: {_id: {'0':1, '1':2}, time: {'0':1, '1':2}, a:{'0':1}}}",
+         "{meta: {m1: 9}, data: {_id: {'0':3, '1':4, '2':5}, time: {'0':3, '1':4, '2':5}, "
+         "a:{'0':1, '1':2, '2':3}}}"},
+        expCtx);
+    unpack->setSource(source.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(fromjson("{time: 4, myMeta: {m1: 9}, _id: 4, a: 2}")));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(fromjson("{time: 5, myMeta: {m1: 9}, _id: 5, a: 3}")));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isEOF());
+}
 }  // namespace
 }  // namespace mongo
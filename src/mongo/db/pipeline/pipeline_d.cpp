@@ -67,6 +67,8 @@
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/inner_pipeline_stage_interface.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/skip_and_limit.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -74,6 +76,7 @@
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/sbe_stage_builder_accumulator.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -260,6 +263,130 @@ createRandomCursorExecutor(const CollectionPtr& coll,
                      !trialStage || !trialStage->pickedBackupPlan()};
 }
 
+/**
+ * A $group stage pushed down into the query layer, to be executed by SBE as a part of the query
+ * plan.
+ */
+class InnerPipelineStageGroup final : public InnerPipelineStageInterface {
+public:
+    explicit InnerPipelineStageGroup(boost::intrusive_ptr<DocumentSourceGroup> groupStage)
+        : _groupStage(std::move(groupStage)) {}
+
+    std::unique_ptr<QuerySolutionNode> buildQuerySolutionNode(
+        std::unique_ptr<QuerySolutionNode> child) const final {
+        auto idFields = _groupStage->getIdFields();
+        invariant(idFields.size() == 1);
+
+        std::vector<GroupNode::Accumulator> accumulators;
+        for (auto&& accStmt : _groupStage->getAccumulatedFields()) {
+            accumulators.push_back({accStmt.fieldName,
+                                    accStmt.makeAccumulator()->getOpName(),
+                                    accStmt.expr.argument});
+        }
+
+        auto groupNode = std::make_unique<GroupNode>(
+            std::move(child), idFields.begin()->second, std::move(accumulators));
+        groupNode->maxMemoryUsageBytes = _groupStage->getMaxMemoryUsageBytes();
+        return groupNode;
+    }
+
+private:
+    boost::intrusive_ptr<DocumentSourceGroup> _groupStage;
+};
+
+/**
+ * An $unwind stage pushed down into the query layer, to be executed by SBE as a part of the query
+ * plan.
+ */
+class InnerPipelineStageUnwind final : public InnerPipelineStageInterface {
+public:
+    explicit InnerPipelineStageUnwind(boost::intrusive_ptr<DocumentSourceUnwind> unwindStage)
+        : _unwindStage(std::move(unwindStage)) {}
+
+    std::unique_ptr<QuerySolutionNode> buildQuerySolutionNode(
+        std::unique_ptr<QuerySolutionNode> child) const final {
+        return std::make_unique<UnwindNode>(std::move(child),
+                                            _unwindStage->getUnwindPath(),
+                                            _unwindStage->preserveNullAndEmptyArrays());
+    }
+
+private:
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindStage;
+};
+
+/**
+ * Returns true if the $group 'stage' can be executed by SBE as a part of the query plan.
+ */
+bool isGroupEligibleForSbePushdown(const DocumentSourceGroup* groupStage) {
+    if (groupStage->doingMerge() || !groupStage->sbeCompatible()) {
+        return false;
+    }
+
+    // Only a single group-by expression is supported, not the object form of _id.
+    auto idFields = groupStage->getIdFields();
+    if (idFields.size() != 1 || idFields.begin()->first != "_id"_sd) {
+        return false;
+    }
+
+    const auto& accStmts = groupStage->getAccumulatedFields();
+    return std::all_of(accStmts.begin(), accStmts.end(), [](auto&& accStmt) {
+        return stage_builder::isAccumulatorSupported(accStmt.makeAccumulator()->getOpName());
+    });
+}
+
+/**
+ * Returns true if the $unwind 'stage' can be executed by SBE as a part of the query plan. The
+ * UnwindStage does not number the elements the way 'includeArrayIndex' does, which is null rather
+ * than 0 for a preserved empty array, and unwinding a dotted path would need the enclosing objects
+ * to be rebuilt around the element, so only a top-level path without 'includeArrayIndex' is
+ * supported.
+ */
+bool isUnwindEligibleForSbePushdown(const DocumentSourceUnwind* unwindStage) {
+    return !unwindStage->indexPath() &&
+        FieldPath(unwindStage->getUnwindPath()).getPathLength() == 1;
+}
+
+/**
+ * Removes the $group and $unwind stages at the front of the 'pipeline' which can be executed by SBE
+ * as a part of the query plan for 'cq', and returns them in execution order. Nothing is removed if
+ * the query is not going to be executed by SBE.
+ *
+ * $lookup is not pushed down: the query plan holds the locks and the yield policy of the main
+ * collection only, while the foreign collection of a $lookup is resolved through the pipeline's
+ * namespaces and may be a view. A HashJoinStage also matches keys by equality, whereas a $lookup
+ * on an array 'localField' matches the foreign documents equal to any of its elements.
+ */
+std::vector<std::unique_ptr<InnerPipelineStageInterface>> extractSbeCompatibleStagesForPushdown(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const CanonicalQuery* cq,
+    size_t plannerOpts,
+    Pipeline* pipeline) {
+    std::vector<std::unique_ptr<InnerPipelineStageInterface>> stagesForPushdown;
+    if (!pipeline || cq->getForceClassicEngine() ||
+        expCtx->tailableMode != TailableModeEnum::kNormal ||
+        !isQuerySbeCompatible(expCtx->opCtx, cq, plannerOpts)) {
+        return stagesForPushdown;
+    }
+
+    while (auto stage = pipeline->peekFront()) {
+        if (auto groupStage = dynamic_cast<DocumentSourceGroup*>(stage)) {
+            if (!isGroupEligibleForSbePushdown(groupStage)) {
+                break;
+            }
+            stagesForPushdown.push_back(std::make_unique<InnerPipelineStageGroup>(groupStage));
+        } else if (auto unwindStage = dynamic_cast<DocumentSourceUnwind*>(stage)) {
+            if (!isUnwindEligibleForSbePushdown(unwindStage)) {
+                break;
+            }
+            stagesForPushdown.push_back(std::make_unique<InnerPipelineStageUnwind>(unwindStage));
+        } else {
+            break;
+        }
+        pipeline->popFront();
+    }
+    return stagesForPushdown;
+}
+
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExecutor(
     const intrusive_ptr<ExpressionContext>& expCtx,
     const CollectionPtr& collection,
@@ -272,7 +399,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     boost::optional<std::string> groupIdForDistinctScan,
     const AggregateCommandRequest* aggRequest,
     const size_t plannerOpts,
-    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
+    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures,
+    Pipeline* pipeline) {
     auto findCommand = std::make_unique<FindCommandRequest>(nss);
     query_request_helper::setTailableMode(expCtx->tailableMode, findCommand.get());
     findCommand->setFilter(queryObj.getOwned());
@@ -350,6 +478,12 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
         }
     }
 
+    // Push down the leading stages of the remaining 'pipeline' which can be executed by SBE as a
+    // part of the query plan. The dependency analysis has already accounted for these stages, so
+    // the projection pushed down into the query is still valid.
+    cq.getValue()->setPipeline(extractSbeCompatibleStagesForPushdown(
+        expCtx, cq.getValue().get(), plannerOpts, pipeline));
+
     bool permitYield = true;
     return getExecutorFind(
         expCtx->opCtx, &collection, std::move(cq.getValue()), permitYield, plannerOpts);
@@ -920,7 +1054,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                                                       rewrittenGroupStage->groupId(),
                                                       aggRequest,
                                                       plannerOpts,
-                                                      matcherFeatures);
+                                                      matcherFeatures,
+                                                      nullptr /* pipeline */);
 
         if (swExecutorGrouped.isOK()) {
             // Any $limit stage before the $group stage should make the pipeline ineligible for this
@@ -960,7 +1095,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                                 boost::none, /* groupIdForDistinctScan */
                                 aggRequest,
                                 plannerOpts,
-                                matcherFeatures);
+                                matcherFeatures,
+                                pipeline);
 }
 
 Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
@@ -35,6 +35,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/inner_pipeline_stage_interface.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/projection.h"
 #include "mongo/db/query/projection_policies.h"
@@ -244,6 +245,31 @@ public:
         return _expCtx.get();
     }
 
+    /**
+     * Returns the aggregation pipeline stages which have been pushed down into the query layer and
+     * must be executed on top of the query plan. Only supported by the SBE engine.
+     */
+    const std::vector<std::unique_ptr<InnerPipelineStageInterface>>& pipeline() const {
+        return _pipeline;
+    }
+
+    void setPipeline(std::vector<std::unique_ptr<InnerPipelineStageInterface>> pipeline) {
+        _pipeline = std::move(pipeline);
+    }
+
+    /**
+     * Returns the match expressions whose constants have been marked as input parameters by
+     * MatchExpression::parameterize(), indexed by their InputParamId. Empty if the query has not
+     * been parameterized.
+     */
+    const std::vector<const MatchExpression*>& getInputParamIdToExpressionMap() const {
+        return _inputParamIdToExpressionMap;
+    }
+
+    void setInputParamIdToExpressionMap(std::vector<const MatchExpression*> inputParamIdToExpr) {
+        _inputParamIdToExpressionMap = std::move(inputParamIdToExpr);
+    }
+
 private:
     // You must go through canonicalize to create a CanonicalQuery.
     CanonicalQuery() {}
@@ -280,6 +306,12 @@ private:
 
     // Determines whether the classic engine must be used.
     bool _forceClassicEngine = false;
+
+    // Aggregation pipeline stages pushed down into the query layer, in execution order.
+    std::vector<std::unique_ptr<InnerPipelineStageInterface>> _pipeline;
+
+    // Nodes of '_root' holding the input parameters of the query, indexed by InputParamId.
+    std::vector<const MatchExpression*> _inputParamIdToExpressionMap;
 };
 
 }  // namespace mongo
@@ -86,6 +86,7 @@
 #include "mongo/db/query/query_settings_decoration.h"
 #include "mongo/db/query/sbe_cached_solution_planner.h"
 #include "mongo/db/query/sbe_multi_planner.h"
+#include "mongo/db/query/sbe_plan_cache.h"
 #include "mongo/db/query/sbe_sub_planner.h"
 #include "mongo/db/query/stage_builder_util.h"
 #include "mongo/db/query/util/make_data_structure.h"
@@ -637,8 +638,10 @@ public:
                                     "query"_attr = redact(_cq->toStringShort()));
                     }
 
-                    return buildCachedPlan(
-                        std::move(querySolution), plannerParams, cs->decisionWorks);
+                    return buildCachedPlan(std::move(querySolution),
+                                           plannerParams,
+                                           planCacheKey,
+                                           cs->decisionWorks);
                 }
             }
         }
@@ -728,9 +731,12 @@ protected:
      *       deactivated and we use multi-planning to select an entirely new  winning plan.
      *     * Or stores additional information in the result object, in case runtime planning is
      *       implemented as a standalone component, rather than as part of the execution tree.
+     *
+     * The 'planCacheKey' is the key of the plan cache entry the 'solution' was built from.
      */
     virtual std::unique_ptr<ResultType> buildCachedPlan(std::unique_ptr<QuerySolution> solution,
                                                         const QueryPlannerParams& plannerParams,
+                                                        const PlanCacheKey& planCacheKey,
                                                         size_t decisionWorks) = 0;
 
     /**
@@ -849,6 +855,7 @@ protected:
     std::unique_ptr<ClassicPrepareExecutionResult> buildCachedPlan(
         std::unique_ptr<QuerySolution> solution,
         const QueryPlannerParams& plannerParams,
+        const PlanCacheKey& planCacheKey,
         size_t decisionWorks) final {
         auto result = makeResult();
         auto&& root = buildExecutableTree(*solution);
@@ -977,22 +984,15 @@ protected:
         auto soln = std::make_unique<QuerySolution>(plannerParams->options);
         soln->setRoot(std::move(root));
 
-        auto execTree = buildExecutableTree(*soln);
-        auto result = makeResult();
-        result->emplace(std::move(execTree), std::move(soln));
-
-        return result;
+        return buildWithSbePlanCache(std::move(soln), nullptr, boost::none);
     }
 
     std::unique_ptr<SlotBasedPrepareExecutionResult> buildCachedPlan(
         std::unique_ptr<QuerySolution> solution,
         const QueryPlannerParams& plannerParams,
+        const PlanCacheKey& planCacheKey,
         size_t decisionWorks) final {
-        auto result = makeResult();
-        auto execTree = buildExecutableTree(*solution);
-        result->emplace(std::move(execTree), std::move(solution));
-        result->setDecisionWorks(decisionWorks);
-        return result;
+        return buildWithSbePlanCache(std::move(solution), &planCacheKey, decisionWorks);
     }
 
     std::unique_ptr<SlotBasedPrepareExecutionResult> buildSubPlan(
@@ -1017,6 +1017,69 @@ protected:
         }
         return result;
     }
+
+private:
+    /**
+     * Builds the execution tree for the 'solution', unless a tree built for another query of the
+     * same shape can be retrieved from the SBE plan cache and bound to this query. A newly built
+     * tree is stored in the SBE plan cache, if eligible.
+     *
+     * The 'planCacheKey' and 'decisionWorks' must be provided if the 'solution' was built from a
+     * classic plan cache entry.
+     */
+    std::unique_ptr<SlotBasedPrepareExecutionResult> buildWithSbePlanCache(
+        std::unique_ptr<QuerySolution> solution,
+        const PlanCacheKey* planCacheKey,
+        boost::optional<size_t> decisionWorks) {
+        auto result = makeResult();
+        if (decisionWorks) {
+            result->setDecisionWorks(*decisionWorks);
+        }
+
+        if (!sbe::PlanCache::shouldCacheQuery(*_cq)) {
+            result->emplace(buildExecutableTree(*solution), std::move(solution));
+            return result;
+        }
+
+        auto& sbePlanCache = sbe::PlanCache::get(_opCtx->getServiceContext());
+        auto key = sbe::PlanCache::computeKey(_collection, *_cq, _plannerOptions, planCacheKey);
+        auto planCacheGeneration =
+            CollectionQueryInfo::get(_collection).getPlanCache()->generation();
+
+        if (auto cachedPlan = sbePlanCache.get(key, planCacheGeneration, decisionWorks)) {
+            auto& root = cachedPlan->root;
+            auto& data = cachedPlan->planStageData;
+
+            // If the cached tree cannot be bound to this query, e.g. because the bounds of some
+            // index scan are no longer a single interval, fall back to building a new tree.
+            if (stage_builder::bindRuntimeEnvironment(
+                    *_cq, _opCtx, _collection, *solution, &data)) {
+                LOGV2_DEBUG(5754708,
+                            2,
+                            "Using execution tree from the SBE plan cache",
+                            "query"_attr = redact(_cq->toStringShort()));
+
+                auto sbeYieldPolicy = dynamic_cast<PlanYieldPolicySBE*>(_yieldPolicy);
+                invariant(sbeYieldPolicy);
+                root->setYieldPolicy(sbeYieldPolicy);
+                stage_builder::prepareSlotBasedExecutableTree(
+                    _opCtx, root.get(), *_cq, sbeYieldPolicy);
+
+                result->emplace(std::make_pair(std::move(root), std::move(data)),
+                                std::move(solution));
+                return result;
+            }
+        }
+
+        auto execTree = buildExecutableTree(*solution);
+        auto&& [root, data] = execTree;
+        if (sbe::PlanCache::shouldCachePlan(*_cq, *solution, data)) {
+            sbePlanCache.set(
+                key, sbe::CachedSbePlan::create(*root, data, planCacheGeneration, decisionWorks));
+        }
+        result->emplace(std::move(execTree), std::move(solution));
+        return result;
+    }
 };
 
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getClassicExecutor(
@@ -1025,6 +1088,9 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getClassicExecu
     std::unique_ptr<CanonicalQuery> canonicalQuery,
     PlanYieldPolicy::YieldPolicy yieldPolicy,
     size_t plannerOptions) {
+    tassert(5754702,
+            "Pushed down aggregation pipeline stages are not supported by the classic engine",
+            canonicalQuery->pipeline().empty());
     auto ws = std::make_unique<WorkingSet>();
     ClassicPrepareExecutionHelper helper{
         opCtx, *collection, ws.get(), canonicalQuery.get(), nullptr, plannerOptions};
@@ -1122,6 +1188,12 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getSlotBasedExe
     PlanYieldPolicy::YieldPolicy requestedYieldPolicy,
     size_t plannerOptions) {
     invariant(cq);
+    // Mark the constants of the query which can be bound to a cached execution tree at runtime, so
+    // that the tree can be shared by all the queries of the same shape.
+    if (sbe::PlanCache::shouldCacheQuery(*cq)) {
+        cq->setInputParamIdToExpressionMap(MatchExpression::parameterize(cq->root()));
+    }
+
     auto nss = cq->nss();
     auto yieldPolicy = makeSbeYieldPolicy(opCtx, requestedYieldPolicy, collection, nss);
     SlotBasedPrepareExecutionHelper helper{
@@ -1145,6 +1217,27 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getSlotBasedExe
                                                   plannerOptions)) {
         // Do the runtime planning and pick the best candidate plan.
         auto candidates = planner->plan(std::move(solutions), std::move(roots));
+
+        if (!cq->pipeline().empty()) {
+            // The candidate plans were evaluated without the pushed down pipeline stages. Extend
+            // the winning solution with them and rebuild the execution tree, discarding any
+            // results buffered during the trial run.
+            auto& winner = candidates.winner();
+            winner.root->close();
+            yieldPolicy->clearRegisteredPlans();
+            winner.solution =
+                QueryPlanner::extendWithAggPipeline(*cq, std::move(winner.solution));
+
+            auto replanReason = std::move(winner.data.replanReason);
+            std::tie(winner.root, winner.data) = stage_builder::buildSlotBasedExecutableTree(
+                opCtx, *collection, *cq, *winner.solution, yieldPolicy.get());
+            winner.data.replanReason = std::move(replanReason);
+            winner.root->prepare(winner.data.ctx);
+            winner.root->open(false);
+            winner.results = {};
+            winner.exitedEarly = false;
+        }
+
         return plan_executor_factory::make(opCtx,
                                            std::move(cq),
                                            std::move(candidates),
@@ -1155,6 +1248,12 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getSlotBasedExe
     }
     // No need for runtime planning, just use the constructed plan stage tree.
     invariant(roots.size() == 1);
+    if (!cq->pipeline().empty()) {
+        solutions[0] = QueryPlanner::extendWithAggPipeline(*cq, std::move(solutions[0]));
+        yieldPolicy->clearRegisteredPlans();
+        roots[0] = stage_builder::buildSlotBasedExecutableTree(
+            opCtx, *collection, *cq, *solutions[0], yieldPolicy.get());
+    }
     return plan_executor_factory::make(opCtx,
                                        std::move(cq),
                                        std::move(solutions[0]),
@@ -1165,10 +1264,11 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getSlotBasedExe
                                        std::move(yieldPolicy));
 }
 
-// Checks if the given query can be executed with the SBE engine.
-inline bool isQuerySbeCompatible(OperationContext* opCtx,
-                                 const CanonicalQuery* const cq,
-                                 size_t plannerOptions) {
+}  // namespace
+
+bool isQuerySbeCompatible(OperationContext* opCtx,
+                          const CanonicalQuery* const cq,
+                          size_t plannerOptions) {
     invariant(cq);
     auto expCtx = cq->getExpCtxRaw();
     const auto& sortPattern = cq->getSortPattern();
@@ -1193,7 +1293,6 @@ inline bool isQuerySbeCompatible(OperationContext* opCtx,
         isNotLegacy && doesNotNeedEnsureSorted && isQueryNotAgainstTimeseriesCollection &&
         doesNotSortOnMetaOrPathWithNumericComponents;
 }
-}  // namespace
 
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutor(
     OperationContext* opCtx,
@@ -63,6 +63,14 @@ namespace {
 ServerStatusMetricField<Counter64> totalPlanCacheSizeEstimateBytesMetric(
     "query.planCacheTotalSizeEstimateBytes", &PlanCacheEntry::planCacheTotalSizeEstimateBytes);
 
+// Source of the values returned by PlanCache::generation(). Shared by all PlanCache instances so
+// that a generation number never identifies the state of more than one cache.
+AtomicWord<uint64_t> planCacheGenerationCounter;
+
+uint64_t nextPlanCacheGeneration() {
+    return planCacheGenerationCounter.fetchAndAdd(1);
+}
+
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
 const char kEncodeDiscriminatorsEnd = '>';
@@ -433,7 +441,7 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheMaxEntriesPerCollection.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) : _cache(size), _generation(nextPlanCacheGeneration()) {}
 
 PlanCache::~PlanCache() {}
 
@@ -677,11 +685,13 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
     stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    _generation.store(nextPlanCacheGeneration());
     return _cache.remove(computeKey(canonicalQuery));
 }
 
 void PlanCache::clear() {
     stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    _generation.store(nextPlanCacheGeneration());
     _cache.clear();
 }
 
@@ -727,6 +737,7 @@ size_t PlanCache::size() const {
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
     _indexabilityState.updateDiscriminators(indexCores);
+    _generation.store(nextPlanCacheGeneration());
 }
 
 std::vector<BSONObj> PlanCache::getMatchingStats(
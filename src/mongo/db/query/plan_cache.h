@@ -592,6 +592,17 @@ public:
      */
     void notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores);
 
+    /**
+     * Returns a number which identifies the current state of this cache. The number is unique
+     * across all PlanCache instances in the process, and is changed whenever cached plans are
+     * removed from this cache or the set of indexes on the associated collection changes. Caches of
+     * artifacts derived from this cache's entries, such as the SBE plan cache, can use it to detect
+     * that their contents are stale.
+     */
+    uint64_t generation() const {
+        return _generation.load();
+    }
+
     /**
      * Iterates over the plan cache. For each entry, serializes the PlanCacheEntry according to
      * 'serializationFunc'. Returns a vector of all serialized entries which match 'filterFunc'.
@@ -624,5 +635,8 @@ private:
     // Concurrent access is synchronized by the collection lock.  Multiple concurrent readers
     // are allowed.
     PlanCacheIndexabilityState _indexabilityState;
+
+    // See generation().
+    AtomicWord<uint64_t> _generation;
 };
 }  // namespace mongo
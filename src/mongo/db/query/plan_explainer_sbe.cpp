@@ -89,6 +89,22 @@ void statsToBSON(const QuerySolutionNode* node,
             bob->append("indexVersion", geo2dsphere->index.version);
             break;
         }
+        case STAGE_GROUP: {
+            auto gn = static_cast<const GroupNode*>(node);
+            gn->groupByExpression->serialize(false).addToBsonObj(bob, "key"_sd);
+            BSONObjBuilder accBob(bob->subobjStart("accumulators"));
+            for (auto&& acc : gn->accumulators) {
+                BSONObjBuilder opBob(accBob.subobjStart(acc.fieldName));
+                acc.argument->serialize(false).addToBsonObj(&opBob, acc.opName);
+            }
+            break;
+        }
+        case STAGE_UNWIND: {
+            auto un = static_cast<const UnwindNode*>(node);
+            bob->append("path", un->fieldName);
+            bob->append("preserveNullAndEmptyArrays", un->preserveNullAndEmptyArrays);
+            break;
+        }
         case STAGE_IXSCAN: {
             auto ixn = static_cast<const IndexScanNode*>(node);
 
@@ -1325,4 +1325,19 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::choosePlanForSubqueries
 
     return std::move(compositeSolution);
 }
+
+std::unique_ptr<QuerySolution> QueryPlanner::extendWithAggPipeline(
+    const CanonicalQuery& query, std::unique_ptr<QuerySolution> solution) {
+    invariant(solution);
+    if (query.pipeline().empty()) {
+        return solution;
+    }
+
+    auto root = solution->extractRoot();
+    for (auto&& innerStage : query.pipeline()) {
+        root = innerStage->buildQuerySolutionNode(std::move(root));
+    }
+    solution->setRoot(std::move(root));
+    return solution;
+}
 }  // namespace mongo
@@ -154,5 +154,12 @@ public:
         QueryPlanner::SubqueriesPlanningResult planningResult,
         std::function<StatusWith<std::unique_ptr<QuerySolution>>(
             CanonicalQuery* cq, std::vector<std::unique_ptr<QuerySolution>>)> multiplanCallback);
+
+    /**
+     * Extends the 'solution' with the aggregation pipeline stages which have been pushed down into
+     * the 'query', so that they are executed on top of the plan. Returns the extended solution.
+     */
+    static std::unique_ptr<QuerySolution> extendWithAggPipeline(
+        const CanonicalQuery& query, std::unique_ptr<QuerySolution> solution);
 };
 }  // namespace mongo
@@ -1396,4 +1396,59 @@ QuerySolutionNode* TextMatchNode::clone() const {
     return copy.release();
 }
 
+//
+// GroupNode
+//
+
+void GroupNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "GROUP\n";
+    addIndent(ss, indent + 1);
+    *ss << "key = " << groupByExpression->serialize(false).toString() << '\n';
+    for (auto&& acc : accumulators) {
+        addIndent(ss, indent + 1);
+        *ss << acc.fieldName << " = {" << acc.opName << ": "
+            << acc.argument->serialize(false).toString() << "}\n";
+    }
+    addCommon(ss, indent);
+    addIndent(ss, indent + 1);
+    *ss << "Child:" << '\n';
+    children[0]->appendToString(ss, indent + 2);
+}
+
+QuerySolutionNode* GroupNode::clone() const {
+    // Expressions are not modified once the plan is built, so they can be shared with the copy.
+    auto copy = std::make_unique<GroupNode>(
+        std::unique_ptr<QuerySolutionNode>(children[0]->clone()), groupByExpression, accumulators);
+    copy->sortSet = sortSet;
+    copy->maxMemoryUsageBytes = maxMemoryUsageBytes;
+    return copy.release();
+}
+
+//
+// UnwindNode
+//
+
+void UnwindNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "UNWIND\n";
+    addIndent(ss, indent + 1);
+    *ss << "path = " << fieldName << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "preserveNullAndEmptyArrays = " << preserveNullAndEmptyArrays << '\n';
+    addCommon(ss, indent);
+    addIndent(ss, indent + 1);
+    *ss << "Child:" << '\n';
+    children[0]->appendToString(ss, indent + 2);
+}
+
+QuerySolutionNode* UnwindNode::clone() const {
+    auto copy =
+        std::make_unique<UnwindNode>(std::unique_ptr<QuerySolutionNode>(children[0]->clone()),
+                                     fieldName,
+                                     preserveNullAndEmptyArrays);
+    copy->sortSet = sortSet;
+    return copy.release();
+}
+
 }  // namespace mongo
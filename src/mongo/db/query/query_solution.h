@@ -36,6 +36,7 @@
 #include "mongo/db/fts/fts_query.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/expression.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator_explain_info.h"
@@ -362,6 +363,14 @@ public:
      */
     void setRoot(std::unique_ptr<QuerySolutionNode> root);
 
+    /**
+     * Transfers the ownership of the solution tree to the caller, leaving this QuerySolution
+     * without a root.
+     */
+    std::unique_ptr<QuerySolutionNode> extractRoot() {
+        return std::move(_root);
+    }
+
     /**
      * Returns true if the execution plan which is constructed from this QuerySolution should check
      * that the node is eligible to serve reads prior to actually performing any reads.
@@ -1293,4 +1302,90 @@ struct TextMatchNode : public QuerySolutionNodeWithSortSet {
     bool wantTextScore;
 };
 
+/**
+ * Represents a $group stage which has been pushed down from the aggregation pipeline into the
+ * query layer. The node groups the documents produced by its child by 'groupByExpression' and
+ * outputs one document per group, holding the group key in the _id field followed by the values of
+ * 'accumulators'.
+ */
+struct GroupNode : public QuerySolutionNodeWithSortSet {
+    struct Accumulator {
+        // The name of the output field.
+        std::string fieldName;
+        // The name of the accumulator operator, for example "$min".
+        std::string opName;
+        // The expression evaluated once per input document to produce the accumulator input.
+        boost::intrusive_ptr<Expression> argument;
+    };
+
+    GroupNode(std::unique_ptr<QuerySolutionNode> child,
+              boost::intrusive_ptr<Expression> groupByExpression,
+              std::vector<Accumulator> accumulators)
+        : QuerySolutionNodeWithSortSet(std::move(child)),
+          groupByExpression(std::move(groupByExpression)),
+          accumulators(std::move(accumulators)) {}
+
+    StageType getType() const override {
+        return STAGE_GROUP;
+    }
+
+    void appendToString(str::stream* ss, int indent) const override;
+
+    bool fetched() const {
+        return true;
+    }
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        return FieldAvailability::kFullyProvided;
+    }
+    bool sortedByDiskLoc() const override {
+        return false;
+    }
+
+    QuerySolutionNode* clone() const override;
+
+    boost::intrusive_ptr<Expression> groupByExpression;
+    std::vector<Accumulator> accumulators;
+
+    // The estimated size of the groups held in memory above which the stage either fails or, if
+    // disk use is allowed, spills to disk.
+    size_t maxMemoryUsageBytes =
+        static_cast<size_t>(internalDocumentSourceGroupMaxMemoryBytes.load());
+};
+
+/**
+ * Represents an $unwind stage which has been pushed down from the aggregation pipeline into the
+ * query layer. For every element of the array held in the top-level field 'fieldName' of a document
+ * produced by the child, the node outputs a copy of the document with the array replaced by the
+ * element. Only $unwind stages without 'includeArrayIndex' are pushed down.
+ */
+struct UnwindNode : public QuerySolutionNodeWithSortSet {
+    UnwindNode(std::unique_ptr<QuerySolutionNode> child,
+               std::string fieldName,
+               bool preserveNullAndEmptyArrays)
+        : QuerySolutionNodeWithSortSet(std::move(child)),
+          fieldName(std::move(fieldName)),
+          preserveNullAndEmptyArrays(preserveNullAndEmptyArrays) {}
+
+    StageType getType() const override {
+        return STAGE_UNWIND;
+    }
+
+    void appendToString(str::stream* ss, int indent) const override;
+
+    bool fetched() const {
+        return true;
+    }
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        return FieldAvailability::kFullyProvided;
+    }
+    bool sortedByDiskLoc() const override {
+        return false;
+    }
+
+    QuerySolutionNode* clone() const override;
+
+    std::string fieldName;
+    bool preserveNullAndEmptyArrays;
+};
+
 }  // namespace mongo
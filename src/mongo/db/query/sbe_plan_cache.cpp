@@ -0,0 +1,217 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/sbe_plan_cache.h"
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo::sbe {
+namespace {
+const auto sbePlanCacheDecoration = ServiceContext::declareDecoration<PlanCache>();
+
+// Stands for the value of an input parameter in the serialized filter of a query.
+const BSONObj kInputParamMarker = BSON("" << "?");
+
+/**
+ * Replaces the values of the input parameters in the given expression tree with a marker.
+ */
+void replaceInputParams(MatchExpression* expr) {
+    if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        auto comparison = static_cast<ComparisonMatchExpressionBase*>(expr);
+        if (comparison->getInputParamId()) {
+            comparison->setData(kInputParamMarker.firstElement());
+        }
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        replaceInputParams(expr->getChild(i));
+    }
+}
+
+stage_builder::PlanStageData clonePlanStageData(const stage_builder::PlanStageData& data) {
+    stage_builder::PlanStageData clone{data.env->makeDeepCopy()};
+    clone.outputs = data.outputs;
+    clone.iamMap = data.iamMap;
+    clone.variableIdToSlotMap = data.variableIdToSlotMap;
+    clone.inputParamToSlotMap = data.inputParamToSlotMap;
+    clone.indexBoundsSlots = data.indexBoundsSlots;
+    clone.hasStaticScanBounds = data.hasStaticScanBounds;
+    clone.hasExchange = data.hasExchange;
+    clone.shouldTrackLatestOplogTimestamp = data.shouldTrackLatestOplogTimestamp;
+    clone.shouldTrackResumeToken = data.shouldTrackResumeToken;
+    clone.shouldUseTailableScan = data.shouldUseTailableScan;
+    return clone;
+}
+}  // namespace
+
+CachedSbePlan::CachedSbePlan(std::unique_ptr<PlanStage> root,
+                             stage_builder::PlanStageData planStageData,
+                             uint64_t planCacheGeneration,
+                             boost::optional<size_t> decisionWorks)
+    : root{std::move(root)},
+      planStageData{std::move(planStageData)},
+      planCacheGeneration{planCacheGeneration},
+      decisionWorks{decisionWorks} {
+    invariant(this->root);
+}
+
+std::unique_ptr<CachedSbePlan> CachedSbePlan::create(const PlanStage& root,
+                                                     const stage_builder::PlanStageData& data,
+                                                     uint64_t planCacheGeneration,
+                                                     boost::optional<size_t> decisionWorks) {
+    return std::make_unique<CachedSbePlan>(
+        root.clone(), clonePlanStageData(data), planCacheGeneration, decisionWorks);
+}
+
+std::unique_ptr<CachedSbePlan> CachedSbePlan::clone() const {
+    return create(*root, planStageData, planCacheGeneration, decisionWorks);
+}
+
+PlanCache& PlanCache::get(ServiceContext* serviceCtx) {
+    return sbePlanCacheDecoration(serviceCtx);
+}
+
+bool PlanCache::shouldCacheQuery(const CanonicalQuery& cq) {
+    if (internalQuerySlotBasedExecutionPlanCacheSize.load() == 0) {
+        return false;
+    }
+
+    // Pushed down pipeline stages are appended to the plan after runtime planning, so the plan
+    // built for the cached solution is not the one that gets executed.
+    if (!cq.pipeline().empty()) {
+        return false;
+    }
+
+    // The collator is owned by the query and is referenced directly from some of the stages of
+    // the plan, e.g. from the sort specification of a sort stage.
+    if (cq.getCollator()) {
+        return false;
+    }
+
+    // Tailable plans keep track of the resume position within the runtime environment.
+    return !cq.getFindCommandRequest().getTailable();
+}
+
+bool PlanCache::shouldCachePlan(const CanonicalQuery& cq,
+                                const QuerySolution& solution,
+                                const stage_builder::PlanStageData& data) {
+    // A shard filter embeds the metadata of the shard version the plan was built for.
+    if (solution.hasNode(STAGE_SHARDING_FILTER)) {
+        return false;
+    }
+
+    // The producers of an exchange are shared by all the clones of the plan.
+    if (data.hasExchange) {
+        return false;
+    }
+
+    // The scan bounds baked into the plan may have been derived from the values of the input
+    // parameters, which are not a part of the cache key.
+    if (data.hasStaticScanBounds && !cq.getInputParamIdToExpressionMap().empty()) {
+        return false;
+    }
+
+    return !data.shouldTrackLatestOplogTimestamp && !data.shouldTrackResumeToken &&
+        !data.shouldUseTailableScan;
+}
+
+std::string PlanCache::computeKey(const CollectionPtr& collection,
+                                  const CanonicalQuery& cq,
+                                  size_t plannerOptions,
+                                  const PlanCacheKey* planCacheKey) {
+    // The plan embeds the constants of the query which are not input parameters, so the key must
+    // capture the whole find command rather than just the shape of the query. The filter is taken
+    // from the parameterized match expression, with the values of the parameters left out.
+    BSONObj filter;
+    if (cq.getInputParamIdToExpressionMap().empty()) {
+        filter = cq.root()->serialize();
+    } else {
+        auto root = cq.root()->shallowClone();
+        replaceInputParams(root.get());
+        filter = root->serialize();
+    }
+    auto findCommand = cq.getFindCommandRequest().toBSON(BSONObj()).removeField("filter");
+
+    std::string key = str::stream()
+        << collection->uuid().toString() << ':' << plannerOptions << ':'
+        << (planCacheKey ? planCacheKey->toString() : "IDHACK") << ':';
+    key.append(filter.objdata(), filter.objsize());
+    key.append(findCommand.objdata(), findCommand.objsize());
+    return key;
+}
+
+PlanCache::PlanCache() : PlanCache(internalQuerySlotBasedExecutionPlanCacheSize.load()) {}
+
+PlanCache::PlanCache(size_t size) : _cache(size) {}
+
+std::unique_ptr<CachedSbePlan> PlanCache::get(const std::string& key,
+                                              uint64_t planCacheGeneration,
+                                              boost::optional<size_t> decisionWorks) {
+    std::shared_ptr<const CachedSbePlan> plan;
+    {
+        stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+        std::shared_ptr<const CachedSbePlan>* entry;
+        if (!_cache.get(key, &entry).isOK()) {
+            return nullptr;
+        }
+
+        if ((*entry)->planCacheGeneration != planCacheGeneration ||
+            (*entry)->decisionWorks != decisionWorks) {
+            _cache.remove(key).ignore();
+            return nullptr;
+        }
+
+        plan = *entry;
+    }
+
+    return plan->clone();
+}
+
+void PlanCache::set(const std::string& key, std::unique_ptr<CachedSbePlan> plan) {
+    invariant(plan);
+    auto entry = std::make_unique<std::shared_ptr<const CachedSbePlan>>(std::move(plan));
+
+    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    _cache.add(key, entry.release());
+}
+
+void PlanCache::clear() {
+    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    _cache.clear();
+}
+
+size_t PlanCache::size() const {
+    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    return _cache.size();
+}
+}  // namespace mongo::sbe
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/sbe_stage_builder.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+class ServiceContext;
+
+namespace sbe {
+/**
+ * A fully built SBE execution tree stored in the SBE plan cache, along with the auxiliary data
+ * needed to execute it. The tree is never prepared or executed while it is in the cache: every
+ * cache hit receives a clone of it.
+ */
+struct CachedSbePlan {
+    CachedSbePlan(std::unique_ptr<PlanStage> root,
+                  stage_builder::PlanStageData planStageData,
+                  uint64_t planCacheGeneration,
+                  boost::optional<size_t> decisionWorks);
+
+    /**
+     * Creates a cached plan holding deep copies of the given execution tree 'root' and its 'data'.
+     * The 'root' must not have been prepared yet.
+     */
+    static std::unique_ptr<CachedSbePlan> create(const PlanStage& root,
+                                                 const stage_builder::PlanStageData& data,
+                                                 uint64_t planCacheGeneration,
+                                                 boost::optional<size_t> decisionWorks);
+
+    /**
+     * Makes a deep copy of this cached plan which can be prepared and executed independently of
+     * this instance and of any other copy.
+     */
+    std::unique_ptr<CachedSbePlan> clone() const;
+
+    std::unique_ptr<PlanStage> root;
+    stage_builder::PlanStageData planStageData;
+
+    // The generation of the collection's classic plan cache observed before the plan was built.
+    // The plan is stale once the classic plan cache moves on to another generation.
+    const uint64_t planCacheGeneration;
+
+    // If the plan was built from a classic plan cache entry, holds the 'works' value of that entry.
+    // A different value means that the query has been replanned since, and the plan is stale.
+    const boost::optional<size_t> decisionWorks;
+};
+
+/**
+ * A process-wide cache of fully built SBE execution trees. Building an SBE plan from a
+ * QuerySolution (even one retrieved from the classic plan cache) is a significant fraction of the
+ * latency of a cheap query, so the trees built for cached solutions and for idhack queries are
+ * kept here and cloned on subsequent executions of a query of the same shape.
+ *
+ * The constants of the query which were marked as input parameters by
+ * MatchExpression::parameterize() are read by the trees from the runtime environment, so a tree
+ * can be shared by all the queries which differ only in the values of their parameters. On every
+ * cache hit the parameters, the bounds of the index scans and the other per-query values
+ * registered in the runtime environment, such as $$NOW or the values of the 'let' variables, are
+ * rebound to the values of the query being executed. Any other constants are baked into the tree.
+ *
+ * The cache is keyed on the collection UUID and is invalidated lazily: each entry remembers the
+ * generation of the collection's classic plan cache it was built against, and is discarded on
+ * lookup if the collection's indexes or cached plans have changed since.
+ *
+ * This class is thread-safe.
+ */
+class PlanCache {
+public:
+    PlanCache(const PlanCache&) = delete;
+    PlanCache& operator=(const PlanCache&) = delete;
+
+    static PlanCache& get(ServiceContext* serviceCtx);
+
+    /**
+     * Returns true if the execution tree for the given query can be stored in this cache.
+     */
+    static bool shouldCacheQuery(const CanonicalQuery& cq);
+
+    /**
+     * Returns true if the execution tree built from the 'solution' for the query 'cq' can be
+     * stored in this cache.
+     */
+    static bool shouldCachePlan(const CanonicalQuery& cq,
+                                const QuerySolution& solution,
+                                const stage_builder::PlanStageData& data);
+
+    /**
+     * Computes the key under which the execution tree for the query 'cq' over the 'collection' is
+     * stored in this cache. If the tree is built from a classic plan cache entry, 'planCacheKey'
+     * must hold the key of that entry. Otherwise it must be nullptr.
+     *
+     * The values of the input parameters of 'cq' are not included into the key.
+     */
+    static std::string computeKey(const CollectionPtr& collection,
+                                  const CanonicalQuery& cq,
+                                  size_t plannerOptions,
+                                  const PlanCacheKey* planCacheKey);
+
+    PlanCache();
+
+    explicit PlanCache(size_t size);
+
+    /**
+     * Returns a clone of the plan cached under the given 'key', provided that the plan was built
+     * against the given classic plan cache 'generation' and from a plan cache entry with the given
+     * 'decisionWorks'. A stale plan is evicted and nullptr is returned instead.
+     */
+    std::unique_ptr<CachedSbePlan> get(const std::string& key,
+                                       uint64_t planCacheGeneration,
+                                       boost::optional<size_t> decisionWorks);
+
+    /**
+     * Stores the 'plan' under the given 'key', replacing any existing entry for that key.
+     */
+    void set(const std::string& key, std::unique_ptr<CachedSbePlan> plan);
+
+    /**
+     * Removes all the entries from this cache.
+     */
+    void clear();
+
+    /**
+     * Returns the number of entries in this cache.
+     */
+    size_t size() const;
+
+private:
+    // Cached plans are shared, so that they can be cloned without holding the cache mutex.
+    LRUKeyValue<std::string, std::shared_ptr<const CachedSbePlan>> _cache;
+
+    // Protects '_cache'.
+    mutable Mutex _cacheMutex = MONGO_MAKE_LATCH("sbe::PlanCache::_cacheMutex");
+};
+}  // namespace sbe
+}  // namespace mongo
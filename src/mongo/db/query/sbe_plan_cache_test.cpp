@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shard_filterer_mock.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/sbe_plan_cache.h"
+#include "mongo/db/query/sbe_stage_builder_test_fixture.h"
+#include "mongo/db/query/shard_filterer_factory_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+class SbePlanCacheTest : public SbeStageBuilderTestFixture {
+protected:
+    static constexpr auto kKey = "key"_sd;
+    const NamespaceString kNss{"testdb.sbe_plan_cache"};
+
+    std::unique_ptr<QuerySolution> makeVirtualScanSolution() {
+        auto docs = std::vector<BSONArray>{BSON_ARRAY(BSON("a" << 1)),
+                                           BSON_ARRAY(BSON("a" << 2)),
+                                           BSON_ARRAY(BSON("a" << 3))};
+        return makeQuerySolution(
+            std::make_unique<VirtualScanNode>(docs, VirtualScanNode::ScanType::kCollScan, false));
+    }
+
+    /**
+     * Builds an SBE plan over a virtual scan of three documents and stores it in the 'cache' under
+     * 'kKey'. Returns the result slot of the plan.
+     */
+    sbe::value::SlotId cacheVirtualScanPlan(sbe::PlanCache* cache,
+                                            uint64_t planCacheGeneration,
+                                            boost::optional<size_t> decisionWorks) {
+        auto [resultSlots, stage, data] = buildPlanStage(
+            makeVirtualScanSolution(),
+            false,
+            std::make_unique<ShardFiltererFactoryMock>(
+                std::make_unique<ConstantFilterMock>(true, BSONObj{})));
+        cache->set(kKey.toString(),
+                   sbe::CachedSbePlan::create(*stage, data, planCacheGeneration, decisionWorks));
+        return resultSlots[0];
+    }
+
+    size_t countResults(sbe::CachedSbePlan* plan, sbe::value::SlotId resultSlot) {
+        prepareTree(&plan->planStageData.ctx, plan->root.get(), resultSlot);
+
+        size_t count = 0;
+        for (auto st = plan->root->getNext(); st == sbe::PlanState::ADVANCED;
+             st = plan->root->getNext()) {
+            ++count;
+        }
+        plan->root->close();
+        return count;
+    }
+};
+
+TEST_F(SbePlanCacheTest, CachedPlanCanBeClonedAndExecutedRepeatedly) {
+    sbe::PlanCache cache{10};
+    auto resultSlot = cacheVirtualScanPlan(&cache, 1, boost::none);
+    ASSERT_EQ(cache.size(), 1U);
+
+    for (size_t i = 0; i < 2; ++i) {
+        auto plan = cache.get(kKey.toString(), 1, boost::none);
+        ASSERT(plan);
+        ASSERT_EQ(countResults(plan.get(), resultSlot), 3U);
+    }
+    ASSERT_EQ(cache.size(), 1U);
+}
+
+TEST_F(SbePlanCacheTest, LookupOfMissingKeyReturnsNothing) {
+    sbe::PlanCache cache{10};
+    cacheVirtualScanPlan(&cache, 1, boost::none);
+    ASSERT_FALSE(cache.get("otherKey", 1, boost::none));
+}
+
+TEST_F(SbePlanCacheTest, PlanFromOlderPlanCacheGenerationIsEvicted) {
+    sbe::PlanCache cache{10};
+    cacheVirtualScanPlan(&cache, 1, boost::none);
+    ASSERT_FALSE(cache.get(kKey.toString(), 2, boost::none));
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST_F(SbePlanCacheTest, PlanBuiltBeforeReplanningIsEvicted) {
+    sbe::PlanCache cache{10};
+    cacheVirtualScanPlan(&cache, 1, size_t{10});
+    ASSERT_FALSE(cache.get(kKey.toString(), 1, size_t{20}));
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST_F(SbePlanCacheTest, LeastRecentlyUsedPlanIsEvictedWhenCacheIsFull) {
+    sbe::PlanCache cache{1};
+    cacheVirtualScanPlan(&cache, 1, boost::none);
+    cache.set("otherKey", cache.get(kKey.toString(), 1, boost::none));
+    ASSERT_EQ(cache.size(), 1U);
+    ASSERT_FALSE(cache.get(kKey.toString(), 1, boost::none));
+    ASSERT(cache.get("otherKey", 1, boost::none));
+}
+
+TEST_F(SbePlanCacheTest, CachedPlanCanBeBoundToQueryWithDifferentInputParams) {
+    auto makeQuery = [&](BSONObj filter) {
+        auto findCommand = std::make_unique<FindCommandRequest>(kNss);
+        findCommand->setFilter(filter);
+        auto cq =
+            unittest::assertGet(CanonicalQuery::canonicalize(opCtx(), std::move(findCommand)));
+        cq->setInputParamIdToExpressionMap(MatchExpression::parameterize(cq->root()));
+        return cq;
+    };
+    auto makeSolution = [&](const CanonicalQuery& cq) {
+        auto orNode = std::make_unique<OrNode>();
+        orNode->dedup = false;
+        orNode->children.push_back(makeVirtualScanSolution()->root()->clone());
+        orNode->filter = cq.root()->shallowClone();
+        return makeQuerySolution(std::move(orNode));
+    };
+
+    auto cq = makeQuery(BSON("a" << BSON("$gt" << 1)));
+    auto [resultSlots, stage, data] = buildPlanStage(
+        makeSolution(*cq),
+        false,
+        std::make_unique<ShardFiltererFactoryMock>(
+            std::make_unique<ConstantFilterMock>(true, BSONObj{})));
+    ASSERT_EQ(data.inputParamToSlotMap.size(), 1U);
+
+    sbe::PlanCache cache{10};
+    cache.set(kKey.toString(), sbe::CachedSbePlan::create(*stage, data, 1, boost::none));
+
+    auto plan = cache.get(kKey.toString(), 1, boost::none);
+    ASSERT(plan);
+    ASSERT_EQ(countResults(plan.get(), resultSlots[0]), 2U);
+
+    auto otherCq = makeQuery(BSON("a" << BSON("$gt" << 2)));
+    plan = cache.get(kKey.toString(), 1, boost::none);
+    ASSERT(plan);
+    ASSERT_TRUE(stage_builder::bindRuntimeEnvironment(
+        *otherCq, opCtx(), CollectionPtr::null, *makeSolution(*otherCq), &plan->planStageData));
+    ASSERT_EQ(countResults(plan.get(), resultSlots[0]), 1U);
+}
+
+TEST_F(SbePlanCacheTest, DeepCopyOfRuntimeEnvironmentDoesNotShareValues) {
+    sbe::value::SlotIdGenerator slotIdGenerator;
+    sbe::RuntimeEnvironment env;
+    auto [tag, val] = sbe::value::makeNewString("a string which is too long to be inlined");
+    auto slot = env.registerSlot("str"_sd, tag, val, true, &slotIdGenerator);
+
+    auto copy = env.makeDeepCopy();
+    ASSERT_EQ(copy->getSlot("str"_sd), slot);
+
+    env.resetSlot(slot, sbe::value::TypeTags::NumberInt32, 1, false);
+    auto [copyTag, copyVal] = copy->getAccessor(slot)->getViewOfValue();
+    ASSERT_TRUE(sbe::value::isString(copyTag));
+    ASSERT_EQ(sbe::value::getStringView(copyTag, copyVal),
+              "a string which is too long to be inlined"_sd);
+}
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/filter.h"
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 #include "mongo/db/exec/sbe/stages/hash_join.h"
@@ -49,19 +50,28 @@
 #include "mongo/db/exec/sbe/stages/traverse.h"
 #include "mongo/db/exec/sbe/stages/union.h"
 #include "mongo/db/exec/sbe/stages/unique.h"
+#include "mongo/db/exec/sbe/stages/unwind.h"
+#include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
 #include "mongo/db/exec/shard_filterer.h"
 #include "mongo/db/fts/fts_index_format.h"
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/fts_access_method.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/sbe_stage_builder_accumulator.h"
 #include "mongo/db/query/sbe_stage_builder_coll_scan.h"
+#include "mongo/db/query/sbe_stage_builder_expression.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/sbe_stage_builder_index_scan.h"
 #include "mongo/db/query/sbe_stage_builder_projection.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/storage/execution_context.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/logv2/log.h"
 
 namespace mongo::stage_builder {
@@ -243,6 +253,123 @@ std::unique_ptr<sbe::RuntimeEnvironment> makeRuntimeEnvironment(
     return env;
 }
 
+namespace {
+void collectIndexScanNodes(const QuerySolutionNode* node,
+                          std::vector<const IndexScanNode*>* ixscans) {
+    if (node->getType() == STAGE_IXSCAN) {
+        ixscans->push_back(static_cast<const IndexScanNode*>(node));
+    }
+    for (auto&& child : node->children) {
+        collectIndexScanNodes(child, ixscans);
+    }
+}
+
+/**
+ * Recomputes the low and high keys of the single-interval index scan built for 'ixn' and stores
+ * them into the given runtime environment slots. Returns false if the bounds of 'ixn' cannot be
+ * represented as a single interval.
+ */
+bool bindIndexBounds(OperationContext* opCtx,
+                     const CollectionPtr& collection,
+                     const IndexScanNode* ixn,
+                     std::pair<sbe::value::SlotId, sbe::value::SlotId> slots,
+                     sbe::RuntimeEnvironment* env) {
+    auto descriptor =
+        collection->getIndexCatalog()->findIndexByName(opCtx, ixn->index.identifier.catalogName);
+    if (!descriptor) {
+        return false;
+    }
+
+    auto sdi = collection->getIndexCatalog()
+                   ->getEntry(descriptor)
+                   ->accessMethod()
+                   ->getSortedDataInterface();
+    auto intervals = makeIntervalsFromIndexBounds(
+        ixn->bounds, ixn->direction == 1, sdi->getKeyStringVersion(), sdi->getOrdering());
+    if (intervals.size() != 1) {
+        return false;
+    }
+
+    auto&& [lowKey, highKey] = intervals[0];
+    env->resetSlot(slots.first,
+                   sbe::value::TypeTags::ksValue,
+                   sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()),
+                   true);
+    env->resetSlot(slots.second,
+                   sbe::value::TypeTags::ksValue,
+                   sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()),
+                   true);
+    return true;
+}
+}  // namespace
+
+bool bindRuntimeEnvironment(const CanonicalQuery& cq,
+                            OperationContext* opCtx,
+                            const CollectionPtr& collection,
+                            const QuerySolution& solution,
+                            PlanStageData* data) {
+    invariant(data);
+    auto env = data->env;
+    auto& variables = cq.getExpCtx()->variables;
+
+    if (auto slot = env->getSlotIfExists("timeZoneDB"_sd); slot) {
+        env->resetSlot(
+            *slot,
+            sbe::value::TypeTags::timeZoneDB,
+            sbe::value::bitcastFrom<const TimeZoneDatabase*>(getTimeZoneDatabase(opCtx)),
+            false);
+    }
+
+    for (auto&& [id, name] : Variables::kIdToBuiltinVarName) {
+        if (auto slot = env->getSlotIfExists(name); slot) {
+            if (variables.hasValue(id)) {
+                auto [tag, val] = makeValue(variables.getValue(id));
+                env->resetSlot(*slot, tag, val, true);
+            } else {
+                env->resetSlot(*slot, sbe::value::TypeTags::Nothing, 0, false);
+            }
+        }
+    }
+
+    for (auto&& [id, slot] : data->variableIdToSlotMap) {
+        auto [tag, val] = makeValue(variables.getValue(id));
+        env->resetSlot(slot, tag, val, true);
+    }
+
+    auto& inputParams = cq.getInputParamIdToExpressionMap();
+    for (auto&& [paramId, slot] : data->inputParamToSlotMap) {
+        if (static_cast<size_t>(paramId) >= inputParams.size()) {
+            return false;
+        }
+
+        auto expr = static_cast<const ComparisonMatchExpressionBase*>(inputParams[paramId]);
+        auto&& rhs = expr->getData();
+        auto [tag, val] = sbe::bson::convertFrom<false>(
+            rhs.rawdata(), rhs.rawdata() + rhs.size(), rhs.fieldNameSize() - 1);
+        env->resetSlot(slot, tag, val, true);
+    }
+
+    std::vector<const IndexScanNode*> ixscans;
+    collectIndexScanNodes(solution.root(), &ixscans);
+    for (auto&& ixn : ixscans) {
+        auto it = data->indexBoundsSlots.find(ixn->nodeId());
+        if (it == data->indexBoundsSlots.end()) {
+            // The bounds of this scan are baked into the plan, which is only allowed to be reused
+            // if it was built for a query with the same bounds.
+            if (!data->hasStaticScanBounds) {
+                return false;
+            }
+            continue;
+        }
+
+        if (!bindIndexBounds(opCtx, collection, ixn, it->second, env)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 PlanStageSlots::PlanStageSlots(const PlanStageReqs& reqs,
                                sbe::value::SlotIdGenerator* slotIdGenerator) {
     for (auto&& [slotName, isRequired] : reqs._slots) {
@@ -293,6 +420,59 @@ sbe::LockAcquisitionCallback makeLockAcquisitionCallback(bool checkNodeCanServeR
     };
 }
 
+/**
+ * Returns the number of threads the given collection scan should be split across, or 1 if the scan
+ * must run serially. The producer threads read from their own storage snapshots, do not yield and
+ * return the documents in no particular order, so only plain forward scans of large collections
+ * under a "local" or "available" read concern outside of a multi-document transaction qualify.
+ */
+size_t getCollScanParallelism(OperationContext* opCtx,
+                              const CanonicalQuery& cq,
+                              const CollectionPtr& collection,
+                              const CollectionScanNode* csn,
+                              bool isTailableResumeBranch) {
+    const size_t degree = internalQuerySlotBasedExecutionParallelScanDegree.load();
+    if (degree <= 1) {
+        return 1;
+    }
+
+    if (isTailableResumeBranch || csn->tailable || csn->resumeAfterRecordId ||
+        csn->shouldTrackLatestOplogTimestamp || csn->requestResumeToken || csn->minRecord ||
+        csn->maxRecord || csn->stopApplyingFilterAfterFirstMatch || csn->direction != 1) {
+        return 1;
+    }
+
+    // A $natural sort or hint asks for the documents in the storage order, which the exchange does
+    // not preserve. Explain is allowed, the exchange reports the stats of every producer.
+    const auto& findCommand = cq.getFindCommandRequest();
+    if (findCommand.getSort().hasField("$natural") || findCommand.getHint().hasField("$natural")) {
+        return 1;
+    }
+
+    // $where runs JavaScript, which is bound to the operation's own thread.
+    if (csn->filter && CanonicalQuery::countNodes(csn->filter.get(), MatchExpression::WHERE) > 0) {
+        return 1;
+    }
+
+    // The producers open their own snapshots, which is only correct when the query does not need
+    // to observe a particular point in time or its own uncommitted writes.
+    const auto& readConcern = repl::ReadConcernArgs::get(opCtx);
+    const auto level = readConcern.getLevel();
+    if (opCtx->inMultiDocumentTransaction() || readConcern.getArgsAtClusterTime() ||
+        (level != repl::ReadConcernLevel::kLocalReadConcern &&
+         level != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        storageGlobalParams.disableLockFreeReads) {
+        return 1;
+    }
+
+    const auto minRecords = internalQuerySlotBasedExecutionParallelScanMinRecords.load();
+    if (collection->numRecords(opCtx) < minRecords) {
+        return 1;
+    }
+
+    return degree;
+}
+
 /**
  * Callback function that logs a message and uasserts if it detects a corrupt index key. An index
  * key is considered corrupt if it has no corresponding Record.
@@ -492,6 +672,14 @@ SlotBasedStageBuilder::SlotBasedStageBuilder(OperationContext* opCtx,
         auto vsn = static_cast<const VirtualScanNode*>(node);
         _shouldProduceRecordIdSlot = vsn->hasRecordId;
     }
+
+    // A plan with a pushed down $group or $unwind stage outputs the groups or the unwound copies
+    // of the documents rather than the documents from the collection, so there is no record id to
+    // return.
+    if (getNodeByType(solution.root(), STAGE_GROUP) ||
+        getNodeByType(solution.root(), STAGE_UNWIND)) {
+        _shouldProduceRecordIdSlot = false;
+    }
 }
 
 std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::build(const QuerySolutionNode* root) {
@@ -515,6 +703,11 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::build(const QuerySolution
     invariant(!_shouldProduceRecordIdSlot || outputs.has(kRecordId));
 
     _data.outputs = std::move(outputs);
+    _data.variableIdToSlotMap = _state.globalVariables;
+    _data.inputParamToSlotMap = _state.inputParamToSlotMap;
+    _data.indexBoundsSlots = _state.indexBoundsSlots;
+    _data.hasStaticScanBounds = _state.hasStaticScanBounds;
+    _data.hasExchange = _state.hasExchange;
 
     return std::move(stage);
 }
@@ -530,7 +723,13 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                              csn,
                                              _yieldPolicy,
                                              reqs.getIsTailableCollScanResumeBranch(),
-                                             _lockAcquisitionCallback);
+                                             _lockAcquisitionCallback,
+                                             getCollScanParallelism(
+                                                 _opCtx,
+                                                 _cq,
+                                                 _collection,
+                                                 csn,
+                                                 reqs.getIsTailableCollScanResumeBranch()));
 
     if (reqs.has(kReturnKey)) {
         // Assign the 'returnKeySlot' to be the empty object.
@@ -1673,14 +1872,17 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
         outputs.set(kIndexKeyPattern, slot);
     }
 
-    auto hashJoinStage = sbe::makeS<sbe::HashJoinStage>(std::move(outerStage),
-                                                        std::move(innerStage),
-                                                        outerCondSlots,
-                                                        outerProjectSlots,
-                                                        innerCondSlots,
-                                                        innerProjectSlots,
-                                                        collatorSlot,
-                                                        root->nodeId());
+    auto hashJoinStage = sbe::makeS<sbe::HashJoinStage>(
+        std::move(outerStage),
+        std::move(innerStage),
+        outerCondSlots,
+        outerProjectSlots,
+        innerCondSlots,
+        innerProjectSlots,
+        collatorSlot,
+        static_cast<size_t>(internalQuerySlotBasedExecutionHashJoinMaxMemoryBytes.load()),
+        _cq.getExpCtx()->allowDiskUse,
+        root->nodeId());
 
     // If there are more than 2 children, iterate all remaining children and hash
     // join together.
@@ -1695,14 +1897,17 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
 
         // The previous HashJoinStage is always set as the inner stage, so that we can reuse the
         // innerIdSlot and innerResultSlot that have been designated as outputs.
-        hashJoinStage = sbe::makeS<sbe::HashJoinStage>(std::move(stage),
-                                                       std::move(hashJoinStage),
-                                                       condSlots,
-                                                       projectSlots,
-                                                       innerCondSlots,
-                                                       innerProjectSlots,
-                                                       collatorSlot,
-                                                       root->nodeId());
+        hashJoinStage = sbe::makeS<sbe::HashJoinStage>(
+            std::move(stage),
+            std::move(hashJoinStage),
+            condSlots,
+            projectSlots,
+            innerCondSlots,
+            innerProjectSlots,
+            collatorSlot,
+            static_cast<size_t>(internalQuerySlotBasedExecutionHashJoinMaxMemoryBytes.load()),
+            _cq.getExpCtx()->allowDiskUse,
+            root->nodeId());
     }
 
     return {std::move(hashJoinStage), std::move(outputs)};
@@ -2148,6 +2353,214 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
             std::move(outputs)};
 }
 
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::buildGroup(
+    const QuerySolutionNode* root, const PlanStageReqs& reqs) {
+    invariant(!reqs.getIndexKeyBitset());
+    tassert(5754701, "GROUP cannot produce a record id", !reqs.has(kRecordId));
+
+    auto groupNode = static_cast<const GroupNode*>(root);
+    auto nodeId = root->nodeId();
+
+    // If the group is computed directly over a collection scan which can be split across threads,
+    // and all of the accumulators can be merged, each thread aggregates its share of the documents
+    // and the partial results are merged above the exchange:
+    //
+    //     mkbson, project (finalize)
+    //     group [key] [merged = merge(partial), ...]
+    //     exchange [key, partial, ...]
+    //     group [key] [partial = acc(arg), ...]
+    //     project (key and args)
+    //     filter, pscan
+    size_t parallelism = 1;
+    auto childNode = groupNode->children[0];
+    if (childNode->getType() == STAGE_COLLSCAN &&
+        std::all_of(groupNode->accumulators.begin(),
+                    groupNode->accumulators.end(),
+                    [](auto&& acc) { return isAccumulatorMergeable(acc.opName); })) {
+        parallelism = getCollScanParallelism(_opCtx,
+                                             _cq,
+                                             _collection,
+                                             static_cast<const CollectionScanNode*>(childNode),
+                                             false /* isTailableResumeBranch */);
+    }
+
+    // The child only needs to produce the documents to be grouped, regardless of what the parent
+    // of this GroupNode requires.
+    std::unique_ptr<sbe::PlanStage> childStage;
+    PlanStageSlots childOutputs;
+    if (parallelism > 1) {
+        std::tie(childStage, childOutputs) =
+            generateParallelCollScan(_state,
+                                     _collection,
+                                     static_cast<const CollectionScanNode*>(childNode),
+                                     _lockAcquisitionCallback);
+    } else {
+        PlanStageReqs childReqs;
+        childReqs.set(kResult);
+        std::tie(childStage, childOutputs) = build(childNode, childReqs);
+    }
+    auto childResultSlot = childOutputs.get(kResult);
+
+    // Evaluate the group key and the inputs of all accumulators for each of the input documents.
+    // A missing group key is treated as null, just like in the $group stage.
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> projects;
+    EvalStage evalStage{std::move(childStage), sbe::makeSV(childResultSlot)};
+
+    auto [keySlot, keyExpr, keyStage] = generateExpression(
+        _state, groupNode->groupByExpression.get(), std::move(evalStage), childResultSlot, nodeId);
+    evalStage = std::move(keyStage);
+    projects.emplace(keySlot, makeFillEmptyNull(std::move(keyExpr)));
+
+    sbe::value::SlotVector argSlots;
+    for (auto&& acc : groupNode->accumulators) {
+        auto [argSlot, argExpr, argStage] = generateExpression(
+            _state, acc.argument.get(), std::move(evalStage), childResultSlot, nodeId);
+        evalStage = std::move(argStage);
+        projects.emplace(argSlot, std::move(argExpr));
+        argSlots.push_back(argSlot);
+    }
+    evalStage = makeProject(std::move(evalStage), std::move(projects), nodeId);
+
+    // Group the documents by the key and compute the accumulated values for each group. With a
+    // parallel scan, every producer aggregates its share of the documents in a copy of this
+    // HashAggStage, and one more HashAggStage merges their results, so the memory limit of the
+    // $group is split evenly between all of them.
+    const size_t memoryLimit = parallelism > 1
+        ? groupNode->maxMemoryUsageBytes / (parallelism + 1)
+        : groupNode->maxMemoryUsageBytes;
+    auto collatorSlot = _data.env->getSlotIfExists("collator"_sd);
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> aggs;
+    sbe::value::SlotVector accSlots;
+    for (size_t idx = 0; idx < groupNode->accumulators.size(); ++idx) {
+        auto accSlot = _slotIdGenerator.generate();
+        aggs.emplace(accSlot,
+                     buildAccumulator(
+                         groupNode->accumulators[idx].opName, argSlots[idx], collatorSlot));
+        accSlots.push_back(accSlot);
+    }
+    evalStage = makeHashAgg(std::move(evalStage),
+                            sbe::makeSV(keySlot),
+                            std::move(aggs),
+                            collatorSlot,
+                            memoryLimit,
+                            _cq.getExpCtx()->allowDiskUse,
+                            nodeId);
+
+    if (parallelism > 1) {
+        auto exchangeSlots = sbe::makeSV(keySlot);
+        exchangeSlots.insert(exchangeSlots.end(), accSlots.begin(), accSlots.end());
+        evalStage = {sbe::makeS<sbe::ExchangeConsumer>(std::move(evalStage.stage),
+                                                       parallelism,
+                                                       exchangeSlots,
+                                                       sbe::ExchangePolicy::roundrobin,
+                                                       nullptr /* partition */,
+                                                       nullptr /* orderLess */,
+                                                       nodeId),
+                     exchangeSlots};
+        _state.hasExchange = true;
+
+        sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> mergeAggs;
+        sbe::value::SlotVector mergeSlots;
+        for (size_t idx = 0; idx < groupNode->accumulators.size(); ++idx) {
+            auto mergeSlot = _slotIdGenerator.generate();
+            auto&& opName = groupNode->accumulators[idx].opName;
+            mergeAggs.emplace(mergeSlot,
+                              buildMergeAccumulator(opName, accSlots[idx], collatorSlot));
+            mergeSlots.push_back(mergeSlot);
+        }
+        evalStage = makeHashAgg(std::move(evalStage),
+                                sbe::makeSV(keySlot),
+                                std::move(mergeAggs),
+                                collatorSlot,
+                                memoryLimit,
+                                _cq.getExpCtx()->allowDiskUse,
+                                nodeId);
+        accSlots = std::move(mergeSlots);
+    }
+
+    // Convert the accumulated values into the final values of the accumulators and assemble the
+    // output document of the form {_id: <key>, <field1>: <value1>, ...}.
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> finalProjects;
+    std::vector<std::string> fieldNames{"_id"};
+    auto fieldSlots = sbe::makeSV(keySlot);
+    for (size_t idx = 0; idx < groupNode->accumulators.size(); ++idx) {
+        auto&& acc = groupNode->accumulators[idx];
+        auto finalSlot = _slotIdGenerator.generate();
+        finalProjects.emplace(finalSlot, buildFinalize(acc.opName, accSlots[idx]));
+        fieldNames.push_back(acc.fieldName);
+        fieldSlots.push_back(finalSlot);
+    }
+    if (!finalProjects.empty()) {
+        evalStage = makeProject(std::move(evalStage), std::move(finalProjects), nodeId);
+    }
+
+    auto resultSlot = _slotIdGenerator.generate();
+    evalStage = makeMkBsonObj(std::move(evalStage),
+                              resultSlot,
+                              boost::none,
+                              boost::none,
+                              std::vector<std::string>{},
+                              std::move(fieldNames),
+                              std::move(fieldSlots),
+                              true,
+                              false,
+                              nodeId);
+
+    PlanStageSlots outputs;
+    outputs.set(kResult, resultSlot);
+    return {std::move(evalStage.stage), std::move(outputs)};
+}
+
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::buildUnwind(
+    const QuerySolutionNode* root, const PlanStageReqs& reqs) {
+    invariant(!reqs.getIndexKeyBitset());
+    tassert(5754754, "UNWIND cannot produce a record id", !reqs.has(kRecordId));
+
+    auto unwindNode = static_cast<const UnwindNode*>(root);
+    auto nodeId = root->nodeId();
+
+    PlanStageReqs childReqs;
+    childReqs.set(kResult);
+    auto [stage, childOutputs] = build(unwindNode->children[0], childReqs);
+    auto childResultSlot = childOutputs.get(kResult);
+
+    auto arraySlot = _slotIdGenerator.generate();
+    stage = sbe::makeProjectStage(std::move(stage),
+                                  nodeId,
+                                  arraySlot,
+                                  makeFunction("getField"_sd,
+                                               makeVariable(childResultSlot),
+                                               makeConstant(unwindNode->fieldName)));
+
+    // The UnwindStage passes a value which is not an array through as it is. With
+    // 'preserveNullAndEmptyArrays', it produces Nothing for a missing field or an empty array,
+    // which removes the field from the output document, just like the $unwind stage does.
+    auto elementSlot = _slotIdGenerator.generate();
+    stage = sbe::makeS<sbe::UnwindStage>(std::move(stage),
+                                         arraySlot,
+                                         elementSlot,
+                                         _slotIdGenerator.generate(),
+                                         unwindNode->preserveNullAndEmptyArrays,
+                                         nodeId);
+
+    // Replace the array with the current element, keeping the field in its place in the document.
+    auto resultSlot = _slotIdGenerator.generate();
+    stage = sbe::makeS<sbe::MakeBsonObjStage>(std::move(stage),
+                                              resultSlot,
+                                              childResultSlot,
+                                              sbe::MakeBsonObjStage::FieldBehavior::drop,
+                                              std::vector<std::string>{},
+                                              std::vector<std::string>{unwindNode->fieldName},
+                                              sbe::makeSV(elementSlot),
+                                              true,
+                                              false,
+                                              nodeId);
+
+    PlanStageSlots outputs;
+    outputs.set(kResult, resultSlot);
+    return {std::move(stage), std::move(outputs)};
+}
+
 // Returns a non-null pointer to the root of a plan tree, or a non-OK status if the PlanStage tree
 // could not be constructed.
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::build(
@@ -2179,7 +2592,9 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
             {STAGE_AND_HASH, &SlotBasedStageBuilder::buildAndHash},
             {STAGE_AND_SORTED, &SlotBasedStageBuilder::buildAndSorted},
             {STAGE_SORT_MERGE, &SlotBasedStageBuilder::buildSortMerge},
-            {STAGE_SHARDING_FILTER, &SlotBasedStageBuilder::buildShardFilter}};
+            {STAGE_SHARDING_FILTER, &SlotBasedStageBuilder::buildShardFilter},
+            {STAGE_GROUP, &SlotBasedStageBuilder::buildGroup},
+            {STAGE_UNWIND, &SlotBasedStageBuilder::buildUnwind}};
 
     tassert(4822884,
             str::stream() << "Unsupported QSN in SBE stage builder: " << root->toString(),
@@ -240,6 +240,27 @@ struct PlanStageData {
     sbe::RuntimeEnvironment* env{nullptr};
     sbe::CompileCtx ctx;
 
+    // Maps the ids of the global variables referenced by the plan to the runtime environment slots
+    // holding their values.
+    stdx::unordered_map<Variables::Id, sbe::value::SlotId> variableIdToSlotMap;
+
+    // Maps the input parameters of the query to the runtime environment slots holding their
+    // values. See MatchExpression::parameterize().
+    stdx::unordered_map<MatchExpression::InputParamId, sbe::value::SlotId> inputParamToSlotMap;
+
+    // Maps the node ids of single-interval index scans to the runtime environment slots holding
+    // their low and high keys.
+    stdx::unordered_map<PlanNodeId, std::pair<sbe::value::SlotId, sbe::value::SlotId>>
+        indexBoundsSlots;
+
+    // Set if some scan bounds of the plan are baked into the plan as constants and so cannot be
+    // rebound to the bounds of another query.
+    bool hasStaticScanBounds{false};
+
+    // Set if parts of the plan are executed by other threads via an exchange. Such plans share the
+    // exchange state among their clones, and so cannot be cloned for reuse.
+    bool hasExchange{false};
+
     bool shouldTrackLatestOplogTimestamp{false};
     bool shouldTrackResumeToken{false};
     bool shouldUseTailableScan{false};
@@ -249,6 +270,23 @@ struct PlanStageData {
     std::optional<std::string> replanReason;
 };
 
+/**
+ * Rebinds the per-query global values registered within the runtime environment of 'data' by
+ * 'makeRuntimeEnvironment()' and by the stage builder to the values taken from the given query.
+ * Used when an SBE plan built for one query is reused to execute another query with the same
+ * shape, e.g. when the plan was retrieved from the SBE plan cache.
+ *
+ * The input parameters of the query are bound to the values held by 'cq', and the bounds of the
+ * single-interval index scans are recomputed from the matching IXSCAN nodes of 'solution', which
+ * must have been planned for 'cq'. Returns false if the plan cannot be bound to the given query,
+ * in which case the plan must not be executed.
+ */
+bool bindRuntimeEnvironment(const CanonicalQuery& cq,
+                            OperationContext* opCtx,
+                            const CollectionPtr& collection,
+                            const QuerySolution& solution,
+                            PlanStageData* data);
+
 /**
  * A stage builder which builds an executable tree using slot-based PlanStages.
  */
@@ -350,6 +388,12 @@ private:
     std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> buildShardFilter(
         const QuerySolutionNode* root, const PlanStageReqs& reqs);
 
+    std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> buildGroup(
+        const QuerySolutionNode* root, const PlanStageReqs& reqs);
+
+    std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> buildUnwind(
+        const QuerySolutionNode* root, const PlanStageReqs& reqs);
+
     /**
      * Constructs an optimized SBE plan for 'filterNode' in the case that the fields of the
      * 'shardKeyPattern' are provided by 'childIxscan'. In this case, the SBE plan for the child
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/sbe_stage_builder_accumulator.h"
+
+#include "mongo/db/query/sbe_stage_builder_helpers.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo::stage_builder {
+namespace {
+using namespace std::literals;
+
+/**
+ * $min and $max ignore null, undefined and missing inputs. Maps all such values to Nothing so that
+ * they are skipped by the aggregate functions.
+ */
+std::unique_ptr<sbe::EExpression> makeMinMaxArg(sbe::value::SlotId argSlot) {
+    sbe::EVariable var{argSlot};
+    return sbe::makeE<sbe::EIf>(generateNullOrMissing(var),
+                                makeConstant(sbe::value::TypeTags::Nothing, 0),
+                                var.clone());
+}
+
+std::unique_ptr<sbe::EExpression> buildMinMax(StringData fn,
+                                              StringData collFn,
+                                              sbe::value::SlotId argSlot,
+                                              boost::optional<sbe::value::SlotId> collatorSlot) {
+    if (collatorSlot) {
+        return makeFunction(collFn, makeVariable(*collatorSlot), makeMinMaxArg(argSlot));
+    }
+    return makeFunction(fn, makeMinMaxArg(argSlot));
+}
+}  // namespace
+
+bool isAccumulatorSupported(StringData opName) {
+    // $sum and $avg are not supported. The "sum" aggregate function of the VM starts from a long
+    // and drops its running sum on a non-numeric input, while $sum returns an int if all of its
+    // inputs were ints, ignores non-numeric inputs and sums doubles with double-double precision.
+    // Matching them needs new aggregate functions which carry that state.
+    return opName == "$min"_sd || opName == "$max"_sd || opName == "$first"_sd ||
+        opName == "$last"_sd || opName == "$push"_sd || opName == "$addToSet"_sd;
+}
+
+std::unique_ptr<sbe::EExpression> buildAccumulator(
+    StringData opName,
+    sbe::value::SlotId argSlot,
+    boost::optional<sbe::value::SlotId> collatorSlot) {
+    if (opName == "$min"_sd) {
+        return buildMinMax("min"_sd, "collMin"_sd, argSlot, collatorSlot);
+    } else if (opName == "$max"_sd) {
+        return buildMinMax("max"_sd, "collMax"_sd, argSlot, collatorSlot);
+    } else if (opName == "$first"_sd) {
+        // Unlike $min and $max, $first and $last retain a missing input as null.
+        return makeFunction("first"_sd, makeFillEmptyNull(makeVariable(argSlot)));
+    } else if (opName == "$last"_sd) {
+        return makeFunction("last"_sd, makeFillEmptyNull(makeVariable(argSlot)));
+    } else if (opName == "$push"_sd) {
+        return makeFunction("addToArray"_sd, makeVariable(argSlot));
+    } else if (opName == "$addToSet"_sd) {
+        if (collatorSlot) {
+            return makeFunction(
+                "collAddToSet"_sd, makeVariable(*collatorSlot), makeVariable(argSlot));
+        }
+        return makeFunction("addToSet"_sd, makeVariable(argSlot));
+    }
+
+    tasserted(5754700, str::stream() << "Unsupported accumulator in SBE: " << opName);
+}
+
+std::unique_ptr<sbe::EExpression> buildFinalize(StringData opName, sbe::value::SlotId accSlot) {
+    if (opName == "$push"_sd || opName == "$addToSet"_sd) {
+        // The array accumulators produce an empty array if no input values were seen.
+        return makeFunction("fillEmpty"_sd, makeVariable(accSlot), makeFunction("newArray"_sd));
+    }
+
+    // All other accumulators yield null if they did not accumulate any value.
+    return makeFillEmptyNull(makeVariable(accSlot));
+}
+
+bool isAccumulatorMergeable(StringData opName) {
+    // $first and $last depend on the order in which the partial values are merged.
+    return opName == "$min"_sd || opName == "$max"_sd || opName == "$push"_sd ||
+        opName == "$addToSet"_sd;
+}
+
+std::unique_ptr<sbe::EExpression> buildMergeAccumulator(
+    StringData opName,
+    sbe::value::SlotId partialSlot,
+    boost::optional<sbe::value::SlotId> collatorSlot) {
+    // A partial value is Nothing if the producer did not accumulate any value for the group, which
+    // all of the aggregate functions below skip.
+    if (opName == "$min"_sd) {
+        return buildMinMax("min"_sd, "collMin"_sd, partialSlot, collatorSlot);
+    } else if (opName == "$max"_sd) {
+        return buildMinMax("max"_sd, "collMax"_sd, partialSlot, collatorSlot);
+    } else if (opName == "$push"_sd) {
+        return makeFunction("aggConcatArrays"_sd, makeVariable(partialSlot));
+    } else if (opName == "$addToSet"_sd) {
+        if (collatorSlot) {
+            return makeFunction(
+                "aggCollSetUnion"_sd, makeVariable(*collatorSlot), makeVariable(partialSlot));
+        }
+        return makeFunction("aggSetUnion"_sd, makeVariable(partialSlot));
+    }
+
+    tasserted(5754709, str::stream() << "Unsupported merge accumulator in SBE: " << opName);
+}
+}  // namespace mongo::stage_builder
@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/values/value.h"
+
+namespace mongo::stage_builder {
+/**
+ * Returns true if the $group accumulator named 'opName' (e.g. "$min") can be translated into an
+ * SBE HashAggStage aggregate by the functions below.
+ */
+bool isAccumulatorSupported(StringData opName);
+
+/**
+ * Translates the $group accumulator 'opName' into an aggregate expression to be evaluated by a
+ * HashAggStage. The 'argSlot' holds the input of the accumulator for the current document. If
+ * 'collatorSlot' is set, collation-aware aggregate functions are used.
+ */
+std::unique_ptr<sbe::EExpression> buildAccumulator(
+    StringData opName,
+    sbe::value::SlotId argSlot,
+    boost::optional<sbe::value::SlotId> collatorSlot);
+
+/**
+ * Generates an expression which converts the accumulated value held in 'accSlot' into the final
+ * value of the accumulator 'opName', as it would be produced by the $group stage.
+ */
+std::unique_ptr<sbe::EExpression> buildFinalize(StringData opName, sbe::value::SlotId accSlot);
+
+/**
+ * Returns true if the values accumulated by buildAccumulator() for 'opName' over disjoint subsets
+ * of the input, in no particular order, can be combined by buildMergeAccumulator(). This allows a
+ * $group to be split into a partial aggregation in each producer of an exchange and a final merge
+ * aggregation above it.
+ */
+bool isAccumulatorMergeable(StringData opName);
+
+/**
+ * Translates the $group accumulator 'opName' into an aggregate expression which merges the
+ * partially accumulated values held in 'partialSlot' into a single accumulated value, which can
+ * then be passed to buildFinalize().
+ */
+std::unique_ptr<sbe::EExpression> buildMergeAccumulator(
+    StringData opName,
+    sbe::value::SlotId partialSlot,
+    boost::optional<sbe::value::SlotId> collatorSlot);
+}  // namespace mongo::stage_builder
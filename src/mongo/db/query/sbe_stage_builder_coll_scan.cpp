@@ -576,14 +576,77 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateGenericCollSc
 }
 }  // namespace
 
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateParallelCollScan(
+    StageBuilderState& state,
+    const CollectionPtr& collection,
+    const CollectionScanNode* csn,
+    sbe::LockAcquisitionCallback lockAcquisitionCallback) {
+    invariant(csn->direction == CollectionScanParams::FORWARD);
+
+    auto resultSlot = state.slotId();
+    auto recordIdSlot = state.slotId();
+
+    std::unique_ptr<sbe::PlanStage> stage =
+        sbe::makeS<sbe::ParallelScanStage>(collection->uuid(),
+                                           resultSlot,
+                                           recordIdSlot,
+                                           boost::none /* snapshotIdSlot */,
+                                           boost::none /* indexIdSlot */,
+                                           boost::none /* indexKeySlot */,
+                                           boost::none /* keyPatternSlot */,
+                                           std::vector<std::string>{},
+                                           sbe::makeSV(),
+                                           nullptr /* yieldPolicy */,
+                                           csn->nodeId(),
+                                           sbe::ScanCallbacks{std::move(lockAcquisitionCallback)});
+
+    if (csn->filter) {
+        auto relevantSlots = sbe::makeSV(resultSlot, recordIdSlot);
+
+        auto [_, outputStage] = generateFilter(state,
+                                               csn->filter.get(),
+                                               {std::move(stage), std::move(relevantSlots)},
+                                               resultSlot,
+                                               csn->nodeId());
+        stage = std::move(outputStage.stage);
+    }
+
+    PlanStageSlots outputs;
+    outputs.set(PlanStageSlots::kResult, resultSlot);
+    outputs.set(PlanStageSlots::kRecordId, recordIdSlot);
+
+    return {std::move(stage), std::move(outputs)};
+}
+
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
     StageBuilderState& state,
     const CollectionPtr& collection,
     const CollectionScanNode* csn,
     PlanYieldPolicy* yieldPolicy,
     bool isTailableResumeBranch,
-    sbe::LockAcquisitionCallback lockAcquisitionCallback) {
+    sbe::LockAcquisitionCallback lockAcquisitionCallback,
+    size_t parallelism) {
+    if (parallelism > 1) {
+        // Each producer runs its own copy of the scan and of the filter, and the exchange merges
+        // their results in no particular order.
+        auto [stage, outputs] =
+            generateParallelCollScan(state, collection, csn, std::move(lockAcquisitionCallback));
+        stage = sbe::makeS<sbe::ExchangeConsumer>(
+            std::move(stage),
+            parallelism,
+            sbe::makeSV(outputs.get(PlanStageSlots::kResult),
+                        outputs.get(PlanStageSlots::kRecordId)),
+            sbe::ExchangePolicy::roundrobin,
+            nullptr /* partition */,
+            nullptr /* orderLess */,
+            csn->nodeId());
+        state.hasExchange = true;
+        return {std::move(stage), std::move(outputs)};
+    }
+
     if (csn->minRecord || csn->maxRecord || csn->stopApplyingFilterAfterFirstMatch) {
+        // The scan bounds are derived from the query predicates and baked into the plan.
+        state.hasStaticScanBounds = state.hasStaticScanBounds || csn->minRecord || csn->maxRecord;
         return generateOptimizedOplogScan(state,
                                           collection,
                                           csn,
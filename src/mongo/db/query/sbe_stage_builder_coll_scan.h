@@ -50,6 +50,10 @@ class PlanStageSlots;
  *     were requested to track this data.
  *   * A generated PlanStage sub-tree.
  *
+ * If 'parallelism' is greater than one, the scan is split by RecordId ranges across that many
+ * threads, and the documents are returned in no particular order. The caller is responsible for
+ * checking that the scan can be executed in parallel.
+ *
  * In cases of an error, throws.
  */
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
@@ -58,6 +62,23 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
     const CollectionScanNode* csn,
     PlanYieldPolicy* yieldPolicy,
     bool isTailableResumeBranch,
+    sbe::LockAcquisitionCallback lockAcquisitionCallback,
+    size_t parallelism = 1);
+
+/**
+ * Generates the sub-tree of a collection scan to be executed by each of the producers of an
+ * exchange. The producers share the RecordId ranges to scan, so that every document is returned by
+ * exactly one of them, and apply the filter of 'csn', if any. They run with their own
+ * OperationContexts and never yield, so the sub-tree is built without a yield policy.
+ *
+ * Returns the sub-tree along with the slots holding the document and its recordId. The caller is
+ * responsible for placing the sub-tree under an sbe::ExchangeConsumer and for checking that the
+ * scan can be executed in parallel.
+ */
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateParallelCollScan(
+    StageBuilderState& state,
+    const CollectionPtr& collection,
+    const CollectionScanNode* csn,
     sbe::LockAcquisitionCallback lockAcquisitionCallback);
 
 }  // namespace mongo::stage_builder
@@ -1131,10 +1131,14 @@ public:
         auto addToArrayExpr =
             makeFunction("addToArray", sbe::makeE<sbe::EVariable>(unionWithNullSlot));
         auto groupSlot = _context->state.slotId();
+        // The groups built here hold the elements of a single document, so they are bounded by the
+        // maximum BSON object size and never need to be spilled.
         auto groupStage = makeHashAgg(std::move(limitNumChildren),
                                       sbe::makeSV(),
                                       sbe::makeEM(groupSlot, std::move(addToArrayExpr)),
                                       collatorSlot,
+                                      std::numeric_limits<size_t>::max(),
+                                      false,
                                       _context->planNodeId);
 
         // Build subtree to handle nulls. If an input is null, return null. Otherwise, unwind the
@@ -1163,6 +1167,8 @@ public:
                         sbe::makeSV(),
                         sbe::makeEM(finalGroupSlot, std::move(finalAddToArrayExpr)),
                         collatorSlot,
+                        std::numeric_limits<size_t>::max(),
+                        false,
                         _context->planNodeId);
 
         // Create a branch stage to select between the branch that produces one null if any elements
@@ -789,8 +789,17 @@ void generateComparison(MatchExpressionVisitorContext* context,
             }
         }
 
-        // SBE EConstant assumes ownership of the value so we have to make a copy here.
-        auto [tag, val] = sbe::value::copyValue(tagView, valView);
+        // If 'rhs' is an input parameter of the query, read it from the runtime environment so
+        // that the plan can be reused with a different value of the parameter.
+        auto rhsExpr = [&]() -> std::unique_ptr<sbe::EExpression> {
+            if (auto paramId = expr->getInputParamId()) {
+                return makeVariable(context->state.registerInputParamSlot(*paramId, rhs));
+            }
+
+            // SBE EConstant assumes ownership of the value so we have to make a copy here.
+            auto [tag, val] = sbe::value::copyValue(tagView, valView);
+            return makeConstant(tag, val);
+        }();
 
         // When 'rhs' is not NaN, return false if lhs is NaN. Otherwise, use usual comparison
         // semantics.
@@ -799,7 +808,7 @@ void generateComparison(MatchExpressionVisitorContext* context,
                     makeNot(makeFillEmptyFalse(makeFunction("isNaN", makeVariable(inputSlot)))),
                     makeFillEmptyFalse(makeBinaryOp(binaryOp,
                                                     makeVariable(inputSlot),
-                                                    makeConstant(tag, val),
+                                                    std::move(rhsExpr),
                                                     context->state.env))),
                 std::move(inputStage)};
     };
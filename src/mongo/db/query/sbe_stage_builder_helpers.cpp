@@ -432,13 +432,20 @@ EvalStage makeHashAgg(EvalStage stage,
                       sbe::value::SlotVector gbs,
                       sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> aggs,
                       boost::optional<sbe::value::SlotId> collatorSlot,
+                      size_t memoryLimit,
+                      bool allowDiskUse,
                       PlanNodeId planNodeId) {
     stage.outSlots = gbs;
     for (auto& [slot, _] : aggs) {
         stage.outSlots.push_back(slot);
     }
-    stage.stage = sbe::makeS<sbe::HashAggStage>(
-        std::move(stage.stage), std::move(gbs), std::move(aggs), collatorSlot, planNodeId);
+    stage.stage = sbe::makeS<sbe::HashAggStage>(std::move(stage.stage),
+                                                std::move(gbs),
+                                                std::move(aggs),
+                                                collatorSlot,
+                                                memoryLimit,
+                                                allowDiskUse,
+                                                planNodeId);
     return stage;
 }
 
@@ -753,4 +760,17 @@ sbe::value::SlotId StageBuilderState::getGlobalVariableSlot(Variables::Id variab
     globalVariables.emplace(variableId, slotId);
     return slotId;
 }
+
+sbe::value::SlotId StageBuilderState::registerInputParamSlot(MatchExpression::InputParamId paramId,
+                                                             const BSONElement& value) {
+    if (auto it = inputParamToSlotMap.find(paramId); it != inputParamToSlotMap.end()) {
+        return it->second;
+    }
+
+    auto [tag, val] = sbe::bson::convertFrom<false>(
+        value.rawdata(), value.rawdata() + value.size(), value.fieldNameSize() - 1);
+    auto slotId = env->registerSlot(tag, val, true, slotIdGenerator);
+    inputParamToSlotMap.emplace(paramId, slotId);
+    return slotId;
+}
 }  // namespace mongo::stage_builder
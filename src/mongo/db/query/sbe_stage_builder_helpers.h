@@ -38,6 +38,7 @@
 #include "mongo/db/exec/sbe/stages/filter.h"
 #include "mongo/db/exec/sbe/stages/makeobj.h"
 #include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/sbe_stage_builder_eval_frame.h"
 #include "mongo/db/query/stage_types.h"
 
@@ -335,6 +336,8 @@ EvalStage makeHashAgg(EvalStage stage,
                       sbe::value::SlotVector gbs,
                       sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> aggs,
                       boost::optional<sbe::value::SlotId> collatorSlot,
+                      size_t memoryLimit,
+                      bool allowDiskUse,
                       PlanNodeId planNodeId);
 
 EvalStage makeMkBsonObj(EvalStage stage,
@@ -804,6 +807,14 @@ struct StageBuilderState {
 
     sbe::value::SlotId getGlobalVariableSlot(Variables::Id variableId);
 
+    /**
+     * Registers a runtime environment slot holding a copy of 'value', the current value of the
+     * input parameter 'paramId'. Returns the existing slot if the parameter has been registered
+     * already.
+     */
+    sbe::value::SlotId registerInputParamSlot(MatchExpression::InputParamId paramId,
+                                              const BSONElement& value);
+
     sbe::value::SlotId slotId() {
         return slotIdGenerator->generate();
     }
@@ -825,6 +836,22 @@ struct StageBuilderState {
 
     const Variables& variables;
     stdx::unordered_map<Variables::Id, sbe::value::SlotId> globalVariables;
+
+    // Maps each input parameter of the query used by the plan to the runtime environment slot
+    // holding its value.
+    stdx::unordered_map<MatchExpression::InputParamId, sbe::value::SlotId> inputParamToSlotMap;
+
+    // Maps the node id of each single-interval index scan to the runtime environment slots holding
+    // the low and high KeyString bounds of the scan.
+    stdx::unordered_map<PlanNodeId, std::pair<sbe::value::SlotId, sbe::value::SlotId>>
+        indexBoundsSlots;
+
+    // Set if the plan contains scan bounds which were derived from the query and are baked into
+    // the plan as constants, and which therefore cannot be rebound when the plan is reused.
+    bool hasStaticScanBounds{false};
+
+    // Set if the plan contains an exchange, that is if parts of it are executed by other threads.
+    bool hasExchange{false};
 };
 
 }  // namespace mongo::stage_builder
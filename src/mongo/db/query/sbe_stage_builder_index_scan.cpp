@@ -193,12 +193,8 @@ std::vector<std::pair<BSONObj, BSONObj>> decomposeIntoSingleIntervals(
     // The 'keysQueue' contains all generated pairs of low/high keys.
     return {keysQueue.begin(), keysQueue.end()};
 }
+}  // namespace
 
-/**
- * Constructs low/high key values from the given index 'bounds' if they can be represented either as
- * a single interval between the low and high keys, or multiple single intervals. If index bounds
- * for some interval cannot be expressed as valid low/high keys, then an empty vector is returned.
- */
 std::vector<std::pair<std::unique_ptr<KeyString::Value>, std::unique_ptr<KeyString::Value>>>
 makeIntervalsFromIndexBounds(const IndexBounds& bounds,
                              bool forward,
@@ -250,6 +246,7 @@ makeIntervalsFromIndexBounds(const IndexBounds& bounds,
     return result;
 }
 
+namespace {
 /**
  * Constructs an optimized version of an index scan for multi-interval index bounds for the case
  * when the bounds can be decomposed in a number of single-interval bounds. In this case, instead
@@ -795,8 +792,8 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleInt
     const std::string& indexName,
     const BSONObj& keyPattern,
     bool forward,
-    std::unique_ptr<KeyString::Value> lowKey,
-    std::unique_ptr<KeyString::Value> highKey,
+    std::unique_ptr<sbe::EExpression> lowKeyExpr,
+    std::unique_ptr<sbe::EExpression> highKeyExpr,
     sbe::IndexKeysInclusionSet indexKeysToInclude,
     sbe::value::SlotVector indexKeySlots,
     boost::optional<sbe::value::SlotId> snapshotIdSlot,
@@ -814,12 +811,8 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleInt
     // Construct a constant table scan to deliver a single row with two fields 'lowKeySlot' and
     // 'highKeySlot', representing seek boundaries, into the index scan.
     sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> projects;
-    projects.emplace(lowKeySlot,
-                     makeConstant(sbe::value::TypeTags::ksValue,
-                                  sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release())));
-    projects.emplace(highKeySlot,
-                     makeConstant(sbe::value::TypeTags::ksValue,
-                                  sbe::value::bitcastFrom<KeyString::Value*>(highKey.release())));
+    projects.emplace(lowKeySlot, std::move(lowKeyExpr));
+    projects.emplace(highKeySlot, std::move(highKeyExpr));
     if (indexIdSlot) {
         // Construct a copy of 'indexName' to project for use in the index consistency check.
         projects.emplace(*indexIdSlot, makeConstant(indexName));
@@ -966,8 +959,28 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
     }
 
     if (intervals.size() == 1) {
-        // If we have just a single interval, we can construct a simplified sub-tree.
+        // If we have just a single interval, we can construct a simplified sub-tree. The low/high
+        // keys are stored in the runtime environment, so that the bounds can be recomputed when the
+        // plan is reused for a query with different input parameters.
         auto&& [lowKey, highKey] = intervals[0];
+        auto lowKeySlot = state.env->registerSlot(
+            sbe::value::TypeTags::ksValue,
+            sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()),
+            true,
+            state.slotIdGenerator);
+        auto highKeySlot = state.env->registerSlot(
+            sbe::value::TypeTags::ksValue,
+            sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()),
+            true,
+            state.slotIdGenerator);
+        auto inserted = state.indexBoundsSlots
+                            .emplace(ixn->nodeId(), std::make_pair(lowKeySlot, highKeySlot))
+                            .second;
+        if (!inserted) {
+            // The same scan was built more than once, so only the bounds of one of its copies
+            // could be rebound.
+            state.hasStaticScanBounds = true;
+        }
         sbe::value::SlotId recordIdSlot;
 
         std::tie(recordIdSlot, stage) =
@@ -975,8 +988,8 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
                                             indexName,
                                             keyPattern,
                                             ixn->direction == 1,
-                                            std::move(lowKey),
-                                            std::move(highKey),
+                                            makeVariable(lowKeySlot),
+                                            makeVariable(highKeySlot),
                                             indexKeyBitset,
                                             indexKeySlots,
                                             snapshotIdSlot,
@@ -992,6 +1005,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
     } else if (intervals.size() > 1) {
         // If we were able to decompose multi-interval index bounds into a number of single-interval
         // bounds, we can also built an optimized sub-tree to perform an index scan.
+        state.hasStaticScanBounds = true;
         sbe::value::SlotId recordIdSlot;
         std::tie(recordIdSlot, stage) =
             generateOptimizedMultiIntervalIndexScan(collection,
@@ -1013,6 +1027,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
         outputs.set(PlanStageSlots::kRecordId, recordIdSlot);
     } else {
         // Generate a generic index scan for multi-interval index bounds.
+        state.hasStaticScanBounds = true;
         sbe::value::SlotId recordIdSlot;
         std::tie(recordIdSlot, stage) = generateGenericMultiIntervalIndexScan(
             collection,
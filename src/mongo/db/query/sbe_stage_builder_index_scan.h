@@ -61,6 +61,17 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
     StringMap<const IndexAccessMethod*>* iamMap,
     bool needsCorruptionCheck);
 
+/**
+ * Constructs low/high key values from the given index 'bounds' if they can be represented either as
+ * a single interval between the low and high keys, or multiple single intervals. If index bounds
+ * for some interval cannot be expressed as valid low/high keys, then an empty vector is returned.
+ */
+std::vector<std::pair<std::unique_ptr<KeyString::Value>, std::unique_ptr<KeyString::Value>>>
+makeIntervalsFromIndexBounds(const IndexBounds& bounds,
+                             bool forward,
+                             KeyString::Version version,
+                             Ordering ordering);
+
 /**
  * Constructs the most simple version of an index scan from the single interval index bounds. The
  * generated subtree will have the following form:
@@ -68,14 +79,14 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateIndexScan(
  *         nlj [indexIdSlot, keyPatternSlot] [lowKeySlot, highKeySlot]
  *              left
  *                  project [indexIdSlot = <indexName>, keyPatternSlot = <index key pattern>,
- *                          lowKeySlot =  KS(...), highKeySlot = KS(...)]
+ *                          lowKeySlot = <lowKeyExpr>, highKeySlot = <highKeyExpr>]
  *                  limit 1
  *                  coscan
  *               right
  *                  ixseek lowKeySlot highKeySlot recordIdSlot [] @coll @index
  *
  * The inner branch of the nested loop join produces a single row with the low/high keys which is
- * fed to the ixscan.
+ * fed to the ixscan. 'lowKeyExpr' and 'highKeyExpr' must evaluate to KeyString values.
  *
  * If 'recordSlot' is provided, than the corresponding slot will be filled out with each KeyString
  * in the index.
@@ -85,8 +96,8 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleInt
     const std::string& indexName,
     const BSONObj& keyPattern,
     bool forward,
-    std::unique_ptr<KeyString::Value> lowKey,
-    std::unique_ptr<KeyString::Value> highKey,
+    std::unique_ptr<sbe::EExpression> lowKeyExpr,
+    std::unique_ptr<sbe::EExpression> highKeyExpr,
     sbe::IndexKeysInclusionSet indexKeysToInclude,
     sbe::value::SlotVector vars,
     boost::optional<sbe::value::SlotId> snapshotIdSlot,
@@ -30,6 +30,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/shard_filterer_mock.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/sbe_stage_builder_test_fixture.h"
 #include "mongo/db/query/shard_filterer_factory_mock.h"
@@ -216,4 +218,110 @@ TEST_F(SbeStageBuilderTest, VirtualIndexScanWithoutRecordId) {
     }
     ASSERT_EQ(index, 3);
 }
+
+TEST_F(SbeStageBuilderTest, GroupOverVirtualScan) {
+    auto docs = std::vector<BSONArray>{BSON_ARRAY(BSON("a" << 1 << "b" << 1)),
+                                       BSON_ARRAY(BSON("a" << 2 << "b" << 5)),
+                                       BSON_ARRAY(BSON("a" << 1 << "b" << BSONNULL)),
+                                       BSON_ARRAY(BSON("a" << 1 << "b" << 3)),
+                                       BSON_ARRAY(BSON("b" << 4))};
+
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto parseExpr = [&](StringData fieldPath) {
+        return Expression::parseOperand(
+            expCtx.get(), BSON("" << fieldPath).firstElement(), expCtx->variablesParseState);
+    };
+
+    // Construct a QuerySolution consisting of a GroupNode grouping the documents produced by a
+    // VirtualScanNode by the field 'a'.
+    auto virtScan =
+        std::make_unique<VirtualScanNode>(docs, VirtualScanNode::ScanType::kCollScan, false);
+    auto groupNode = std::make_unique<GroupNode>(
+        std::move(virtScan),
+        parseExpr("$a"),
+        std::vector<GroupNode::Accumulator>{{"min", "$min", parseExpr("$b")},
+                                            {"first", "$first", parseExpr("$b")},
+                                            {"all", "$push", parseExpr("$b")},
+                                            {"none", "$addToSet", parseExpr("$c")}});
+    auto querySolution = makeQuerySolution(std::move(groupNode));
+
+    // Translate the QuerySolution tree to an sbe::PlanStage.
+    auto shardFiltererInterface = makeAlwaysPassShardFiltererInterface();
+    auto [resultSlots, stage, data] =
+        buildPlanStage(std::move(querySolution), false, std::move(shardFiltererInterface));
+    auto resultAccessors = prepareTree(&data.ctx, stage.get(), resultSlots);
+
+    std::vector<BSONObj> results;
+    for (auto st = stage->getNext(); st == sbe::PlanState::ADVANCED; st = stage->getNext()) {
+        auto [tag, val] = resultAccessors[0]->getViewOfValue();
+        ASSERT_TRUE(tag == sbe::value::TypeTags::bsonObject);
+        results.push_back(BSONObj(sbe::value::bitcastTo<const char*>(val)).getOwned());
+    }
+
+    // The order of the groups is unspecified, so sort them by the group key.
+    std::sort(results.begin(), results.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs["_id"].woCompare(rhs["_id"], false) < 0;
+    });
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_BSONOBJ_EQ(results[0],
+                      BSON("_id" << BSONNULL << "min" << 4 << "first" << 4 << "all"
+                                 << BSON_ARRAY(4) << "none" << BSONArray()));
+    ASSERT_BSONOBJ_EQ(results[1],
+                      BSON("_id" << 1 << "min" << 1 << "first" << 1 << "all"
+                                 << BSON_ARRAY(1 << BSONNULL << 3) << "none" << BSONArray()));
+    ASSERT_BSONOBJ_EQ(results[2],
+                      BSON("_id" << 2 << "min" << 5 << "first" << 5 << "all" << BSON_ARRAY(5)
+                                 << "none" << BSONArray()));
+}
+
+TEST_F(SbeStageBuilderTest, UnwindOverVirtualScan) {
+    auto docs = std::vector<BSONArray>{
+        BSON_ARRAY(BSON("_id" << 0 << "a" << BSON_ARRAY(1 << 2) << "b" << 1)),
+        BSON_ARRAY(BSON("_id" << 1 << "a" << BSONArray())),
+        BSON_ARRAY(BSON("_id" << 2 << "a" << BSONNULL)),
+        BSON_ARRAY(BSON("_id" << 3 << "a" << 3)),
+        BSON_ARRAY(BSON("_id" << 4))};
+
+    for (bool preserveNullAndEmptyArrays : {false, true}) {
+        // Construct a QuerySolution consisting of an UnwindNode unwinding the field 'a' of the
+        // documents produced by a VirtualScanNode.
+        auto virtScan =
+            std::make_unique<VirtualScanNode>(docs, VirtualScanNode::ScanType::kCollScan, false);
+        auto unwindNode =
+            std::make_unique<UnwindNode>(std::move(virtScan), "a", preserveNullAndEmptyArrays);
+        auto querySolution = makeQuerySolution(std::move(unwindNode));
+
+        // Translate the QuerySolution tree to an sbe::PlanStage.
+        auto shardFiltererInterface = makeAlwaysPassShardFiltererInterface();
+        auto [resultSlots, stage, data] =
+            buildPlanStage(std::move(querySolution), false, std::move(shardFiltererInterface));
+        auto resultAccessors = prepareTree(&data.ctx, stage.get(), resultSlots);
+
+        std::vector<BSONObj> results;
+        for (auto st = stage->getNext(); st == sbe::PlanState::ADVANCED; st = stage->getNext()) {
+            auto [tag, val] = resultAccessors[0]->getViewOfValue();
+            ASSERT_TRUE(tag == sbe::value::TypeTags::bsonObject);
+            results.push_back(BSONObj(sbe::value::bitcastTo<const char*>(val)).getOwned());
+        }
+
+        // Every element replaces the array in its place, and a value which is not an array is
+        // passed through. Preserved documents lose a missing field or an empty array.
+        std::vector<BSONObj> expected{BSON("_id" << 0 << "a" << 1 << "b" << 1),
+                                      BSON("_id" << 0 << "a" << 2 << "b" << 1)};
+        if (preserveNullAndEmptyArrays) {
+            expected.push_back(BSON("_id" << 1));
+            expected.push_back(BSON("_id" << 2 << "a" << BSONNULL));
+        }
+        expected.push_back(BSON("_id" << 3 << "a" << 3));
+        if (preserveNullAndEmptyArrays) {
+            expected.push_back(BSON("_id" << 4));
+        }
+
+        ASSERT_EQ(results.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(results[i], expected[i]);
+        }
+    }
+}
 }  // namespace mongo
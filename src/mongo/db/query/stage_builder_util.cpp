@@ -76,6 +76,18 @@ buildSlotBasedExecutableTree(OperationContext* opCtx,
     auto root = builder->build(solution.root());
     auto data = builder->getPlanStageData();
 
+    prepareSlotBasedExecutableTree(opCtx, root.get(), cq, sbeYieldPolicy);
+
+    return {std::move(root), std::move(data)};
+}
+
+void prepareSlotBasedExecutableTree(OperationContext* opCtx,
+                                    sbe::PlanStage* root,
+                                    const CanonicalQuery& cq,
+                                    PlanYieldPolicySBE* yieldPolicy) {
+    invariant(root);
+    invariant(yieldPolicy);
+
     root->attachToOperationContext(opCtx);
 
     auto expCtx = cq.getExpCtxRaw();
@@ -85,8 +97,6 @@ buildSlotBasedExecutableTree(OperationContext* opCtx,
     }
 
     // Register this plan to yield according to the configured policy.
-    sbeYieldPolicy->registerPlan(root.get());
-
-    return {std::move(root), std::move(data)};
+    yieldPolicy->registerPlan(root);
 }
 }  // namespace mongo::stage_builder
@@ -57,4 +57,15 @@ buildSlotBasedExecutableTree(OperationContext* opCtx,
                              const QuerySolution& solution,
                              PlanYieldPolicy* yieldPolicy);
 
+/**
+ * Readies an SBE execution tree rooted at 'root' to be executed on behalf of the query 'cq':
+ * attaches the tree to the operation context, enables the collection of timing info if required,
+ * and registers the tree with the 'yieldPolicy'. Called on every freshly built tree, as well as on
+ * every tree cloned from the SBE plan cache.
+ */
+void prepareSlotBasedExecutableTree(OperationContext* opCtx,
+                                    sbe::PlanStage* root,
+                                    const CanonicalQuery& cq,
+                                    PlanYieldPolicySBE* yieldPolicy);
+
 }  // namespace mongo::stage_builder
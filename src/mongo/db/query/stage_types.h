@@ -81,6 +81,10 @@ enum StageType {
     STAGE_GEO_NEAR_2D,
     STAGE_GEO_NEAR_2DSPHERE,
 
+    // A $group pushed down from the aggregation pipeline into the query layer. Only implemented
+    // in SBE.
+    STAGE_GROUP,
+
     STAGE_IDHACK,
 
     STAGE_IXSCAN,
@@ -122,6 +126,10 @@ enum StageType {
 
     STAGE_UNKNOWN,
 
+    // An $unwind pushed down from the aggregation pipeline into the query layer. Only implemented
+    // in SBE.
+    STAGE_UNWIND,
+
     STAGE_UNPACK_TIMESERIES_BUCKET,
 
     STAGE_UPDATE,
@@ -31,7 +31,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/index_build_entry_helpers.h"
 #include "mongo/db/index_builds_coordinator.h"
@@ -39,11 +43,14 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/database_cloner_gen.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -56,6 +63,10 @@ MONGO_FAIL_POINT_DEFINE(initialSyncHangDuringCollectionClone);
 // DBClientConnection, optionally limited to a specific collection.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangCollectionClonerAfterHandlingBatchResponse);
 
+// Failpoint which causes an _id range query of the collection cloner to hang before it waits for
+// the buffered documents of the other range queries to be inserted.
+MONGO_FAIL_POINT_DEFINE(initialSyncHangCollectionClonerBeforeWaitingForRangeBuffer);
+
 CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
                                    const CollectionOptions& collectionOptions,
                                    InitialSyncSharedData* sharedData,
@@ -96,6 +107,8 @@ CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
           _dbWorkTaskRunner.schedule(std::move(task));
           return executor::TaskExecutor::CallbackHandle();
       }),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }),
       _dbWorkTaskRunner(dbPool) {
     invariant(sourceNss.isValid());
     invariant(collectionOptions.uuid);
@@ -236,7 +249,12 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
 }
 
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    chooseIdRanges();
+    if (_idRanges.empty()) {
+        runQuery();
+    } else {
+        runRangeQueries();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -371,17 +389,19 @@ void CollectionCloner::runQuery() {
     }
 }
 
-void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
-    {
-        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
-        if (!getSharedData()->getStatus(lk).isOK()) {
-            static constexpr char message[] =
-                "Collection cloning cancelled due to initial sync failure";
-            LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
-            uasserted(ErrorCodes::CallbackCanceled,
-                      str::stream() << message << ": " << getSharedData()->getStatus(lk));
-        }
+void CollectionCloner::uassertInitialSyncNotFailed() {
+    stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+    if (!getSharedData()->getStatus(lk).isOK()) {
+        static constexpr char message[] =
+            "Collection cloning cancelled due to initial sync failure";
+        LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
+        uasserted(ErrorCodes::CallbackCanceled,
+                  str::stream() << message << ": " << getSharedData()->getStatus(lk));
     }
+}
+
+void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
 
     // If this is 'true', it means that something happened to our remote cursor for a reason other
     // than the collection being dropped, all while we were running a non-resumable (4.2) clone.
@@ -421,6 +441,10 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
         _resumeToken = iter.getPostBatchResumeToken();
     }
 
+    hangAfterHandlingBatchResponseIfEnabled();
+}
+
+void CollectionCloner::hangAfterHandlingBatchResponseIfEnabled() {
     initialSyncHangCollectionClonerAfterHandlingBatchResponse.executeIf(
         [&](const BSONObj&) {
             while (MONGO_unlikely(
@@ -442,7 +466,275 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
         });
 }
 
+std::vector<CollectionCloner::IdRange> CollectionCloner::makeIdRanges(
+    std::vector<BSONObj> sampledIds, int numRanges) {
+    std::sort(sampledIds.begin(),
+              sampledIds.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    std::vector<IdRange> ranges(1);
+    for (int i = 1; i < numRanges; ++i) {
+        const size_t index = sampledIds.size() * i / numRanges;
+        if (index >= sampledIds.size()) {
+            break;
+        }
+        const auto& bound = sampledIds[index];
+        if (ranges.back().min &&
+            SimpleBSONObjComparator::kInstance.evaluate(*ranges.back().min == bound)) {
+            continue;
+        }
+        ranges.back().max = bound.getOwned();
+        ranges.emplace_back();
+        ranges.back().min = bound.getOwned();
+    }
+    return ranges;
+}
+
+void CollectionCloner::chooseIdRanges() {
+    if (_idRangesChosen) {
+        return;
+    }
+    _idRangesChosen = true;
+
+    // Ranges are only used where the _id index order is the order the sync source returns, and
+    // where a range query can resume on its own after an error.
+    const int numStreams = collectionClonerRangeStreams.load();
+    if (numStreams <= 1 || !_resumeSupported || _collectionOptions.capped ||
+        !_collectionOptions.collation.isEmpty() || _idIndexSpec.isEmpty()) {
+        return;
+    }
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_stats.bytesToCopy < collectionClonerRangeStreamsMinBytes.load()) {
+            return;
+        }
+    }
+
+    // The split points only affect how evenly the work is divided, not which documents are
+    // copied, so a failed or stale sample just falls back to a single query.
+    static constexpr int kSamplesPerRange = 10;
+    const int sampleSize = numStreams * kSamplesPerRange;
+    BSONObj res;
+    getClient()->runCommand(
+        _sourceNss.db().toString(),
+        BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                         << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                       << BSON("$project" << BSON("_id" << 1)))
+                         << "cursor" << BSON("batchSize" << sampleSize)),
+        res,
+        QueryOption_SecondaryOk);
+    if (auto status = getStatusFromCommandResult(res); !status.isOK()) {
+        LOGV2_DEBUG(5754731,
+                    1,
+                    "Cloning collection with a single query because sampling _id values failed",
+                    "namespace"_attr = _sourceNss,
+                    "error"_attr = status);
+        return;
+    }
+
+    std::vector<BSONObj> sampledIds;
+    for (auto&& elem : res["cursor"]["firstBatch"].Obj()) {
+        sampledIds.push_back(elem.Obj().getOwned());
+    }
+    auto ranges = makeIdRanges(std::move(sampledIds), numStreams);
+    if (ranges.size() <= 1) {
+        return;
+    }
+
+    LOGV2(5754732,
+          "Cloning collection with concurrent _id range queries",
+          "namespace"_attr = _sourceNss,
+          "uuid"_attr = getSourceUuid(),
+          "numRanges"_attr = ranges.size());
+    _idRanges = std::move(ranges);
+}
+
+void CollectionCloner::runRangeQueries() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stopRangeQueries.store(false);
+        _rangeQueriesStatus = Status::OK();
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "CollectionClonerRangeThreadPool";
+    options.threadNamePrefix = "CollectionClonerRange-";
+    options.minThreads = 0;
+    options.maxThreads = _idRanges.size();
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+    for (auto&& idRange : _idRanges) {
+        if (idRange.done) {
+            continue;
+        }
+        pool.schedule([this, range = &idRange](Status status) {
+            try {
+                uassertStatusOK(status);
+                runRangeQuery(range);
+            } catch (...) {
+                stopRangeQueries(exceptionToStatus());
+            }
+        });
+    }
+    pool.shutdown();
+    pool.join();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    uassertStatusOK(_rangeQueriesStatus);
+}
+
+void CollectionCloner::stopRangeQueries(Status status) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    // Only the first failure is reported, the others are most likely caused by stopping.
+    if (_stopRangeQueries.load()) {
+        return;
+    }
+    _stopRangeQueries.store(true);
+    _rangeQueriesStatus = std::move(status);
+    for (auto client : _rangeClients) {
+        client->shutdownAndDisallowReconnect();
+    }
+    _bufferedBytesCv.notify_all();
+}
+
+void CollectionCloner::runRangeQuery(IdRange* range) {
+    auto client = _createClientFn();
+
+    // Register the connection before using it, so that both a failure of another range query
+    // and the cancellation of the initial sync attempt interrupt it.
+    bool registered;
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        registered = getSharedData()->registerClient(lk, client.get());
+    }
+    if (!registered) {
+        uassertInitialSyncNotFailed();
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        getSharedData()->unregisterClient(lk, client.get());
+    });
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_stopRangeQueries.load()) {
+            uasserted(ErrorCodes::CallbackCanceled,
+                      "Collection cloning cancelled due to a failed _id range query");
+        }
+        _rangeClients.push_back(client.get());
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _rangeClients.erase(std::find(_rangeClients.begin(), _rangeClients.end(), client.get()));
+    });
+
+    uassertStatusOK(client->connect(getSource(), StringData(), boost::none));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << getSource()));
+
+    // When resuming, the last received document is the inclusive lower bound and is skipped.
+    bool resuming = bool(range->lastId);
+    Query query = QUERY("query" << BSONObj());
+    query.hint(BSON("_id" << 1));
+    if (resuming) {
+        query.minKey(*range->lastId);
+    } else if (range->min) {
+        query.minKey(*range->min);
+    }
+    if (range->max) {
+        query.maxKey(*range->max);
+    }
+
+    client->query(
+        [&](DBClientCursorBatchIterator& iter) { handleNextRangeBatch(range, &resuming, iter); },
+        _sourceDbAndUuid,
+        query,
+        nullptr /* fieldsToReturn */,
+        QueryOption_NoCursorTimeout | QueryOption_SecondaryOk |
+            (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+        _collectionClonerBatchSize,
+        ReadConcernArgs::kImplicitDefault);
+    range->done = true;
+}
+
+void CollectionCloner::handleNextRangeBatch(IdRange* range,
+                                            bool* resuming,
+                                            DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
+    if (_stopRangeQueries.load()) {
+        uasserted(ErrorCodes::CallbackCanceled,
+                  "Collection cloning cancelled due to a failed _id range query");
+    }
+
+    std::vector<BSONObj> docs;
+    long long bytes = 0;
+    while (iter.moreInCurrentBatch()) {
+        auto doc = iter.nextSafe();
+        if (*resuming) {
+            *resuming = false;
+            if (doc["_id"].woCompare(range->lastId->firstElement(), false) == 0) {
+                continue;
+            }
+        }
+        bytes += doc.objsize();
+        docs.push_back(std::move(doc));
+    }
+    if (docs.empty()) {
+        return;
+    }
+    auto lastId = BSON("_id" << docs.back()["_id"]);
+
+    {
+        stdx::unique_lock<Latch> lk(_mutex);
+        const long long limit = collectionClonerRangeStreamsBufferBytes.load();
+        auto canBuffer = [&] {
+            return _stopRangeQueries.load() || _bufferedBytes == 0 ||
+                _bufferedBytes + bytes <= limit;
+        };
+        if (!canBuffer() &&
+            MONGO_unlikely(
+                initialSyncHangCollectionClonerBeforeWaitingForRangeBuffer.shouldFail())) {
+            lk.unlock();
+            LOGV2(5754737,
+                  "initialSyncHangCollectionClonerBeforeWaitingForRangeBuffer fail point enabled. "
+                  "Blocking until fail point is disabled",
+                  "namespace"_attr = _sourceNss);
+            initialSyncHangCollectionClonerBeforeWaitingForRangeBuffer.pauseWhileSet();
+            lk.lock();
+        }
+        _bufferedBytesCv.wait(lk, canBuffer);
+        if (_stopRangeQueries.load()) {
+            uasserted(ErrorCodes::CallbackCanceled,
+                      "Collection cloning cancelled due to a failed _id range query");
+        }
+        _stats.receivedBatches++;
+        _bufferedBytes += bytes;
+        std::move(docs.begin(), docs.end(), std::back_inserter(_documentsToInsert));
+
+        // Only resume after this batch once it is going to be inserted. A batch dropped because
+        // the range queries were stopped is fetched again when the query stage is retried.
+        range->lastId = std::move(lastId);
+    }
+
+    auto&& scheduleResult = _scheduleDbWorkFn(
+        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
+    if (!scheduleResult.isOK()) {
+        uassertStatusOK(scheduleResult.getStatus().withContext(
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'"));
+    }
+
+    hangAfterHandlingBatchResponseIfEnabled();
+}
+
 void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd) {
+    if (!cbd.status.isOK()) {
+        // The buffered documents will never be inserted, so don't leave range queries waiting.
+        stdx::lock_guard<Latch> lk(_mutex);
+        _bufferedBytes = 0;
+        _bufferedBytesCv.notify_all();
+    }
     uassertStatusOK(cbd.status);
 
     {
@@ -459,6 +751,8 @@ void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::Cal
             return;
         }
         _documentsToInsert.swap(docs);
+        _bufferedBytes = 0;
+        _bufferedBytesCv.notify_all();
         _stats.documentsCopied += docs.size();
         _stats.approxBytesCopied = ((long)_stats.documentsCopied) * _stats.avgObjSize;
         _progressMeter.hit(int(docs.size()));
@@ -36,6 +36,8 @@
 #include "mongo/db/repl/initial_sync_base_cloner.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -77,6 +79,24 @@ public:
     using ScheduleDbWorkFn = unique_function<StatusWith<executor::TaskExecutor::CallbackHandle>(
         executor::TaskExecutor::CallbackFn)>;
 
+    /**
+     * Type of function to create the connections used by the _id range queries.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
+    /**
+     * A range of the _id index that is copied by its own query over its own connection.
+     */
+    struct IdRange {
+        // Inclusive lower bound of the form {_id: <value>}, unset for the first range.
+        boost::optional<BSONObj> min;
+        // Exclusive upper bound of the form {_id: <value>}, unset for the last range.
+        boost::optional<BSONObj> max;
+        // The _id of the last document received for this range, used to resume the range query.
+        boost::optional<BSONObj> lastId;
+        bool done = false;
+    };
+
     CollectionCloner(const NamespaceString& ns,
                      const CollectionOptions& collectionOptions,
                      InitialSyncSharedData* sharedData,
@@ -96,6 +116,13 @@ public:
 
     std::string toString() const;
 
+    /**
+     * Splits the _id index into at most 'numRanges' ranges whose bounds are evenly spaced among
+     * 'sampledIds', documents of the form {_id: <value>} sampled from the collection. Duplicate
+     * bounds are dropped, so fewer ranges may be returned. The ranges always cover every _id.
+     */
+    static std::vector<IdRange> makeIdRanges(std::vector<BSONObj> sampledIds, int numRanges);
+
     NamespaceString getSourceNss() const {
         return _sourceNss;
     }
@@ -122,6 +149,15 @@ public:
         _scheduleDbWorkFn = std::move(scheduleDbWorkFn);
     }
 
+    /**
+     * Overrides how the connections used by the _id range queries are created.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(const CreateClientFn& createClientFn) {
+        _createClientFn = createClientFn;
+    }
+
 protected:
     ClonerStages getStages() final;
 
@@ -201,6 +237,47 @@ private:
      */
     AfterStageBehavior queryStage();
 
+    /**
+     * Decides, once per clone, whether the query stage copies the collection with concurrent
+     * _id range queries, and if so samples the collection to fill in _idRanges.
+     */
+    void chooseIdRanges();
+
+    /**
+     * Copies every _id range in _idRanges that is not yet done, each on its own thread of a
+     * dedicated pool and its own connection, into the same bulk loader. Throws the first failure
+     * once all of them stopped.
+     */
+    void runRangeQueries();
+
+    /**
+     * Makes the running _id range queries stop because of 'status', shutting down their
+     * connections so that queries blocked on the network are interrupted too.
+     */
+    void stopRangeQueries(Status status);
+
+    /**
+     * Runs the query for a single _id range, resuming after its last received document.
+     */
+    void runRangeQuery(IdRange* range);
+
+    /**
+     * Like handleNextBatch, for a batch of an _id range query. Blocks while the documents waiting
+     * to be inserted exceed 'collectionClonerRangeStreamsBufferBytes'.
+     */
+    void handleNextRangeBatch(IdRange* range, bool* resuming, DBClientCursorBatchIterator& iter);
+
+    /**
+     * Blocks while the initialSyncHangCollectionClonerAfterHandlingBatchResponse fail point is
+     * enabled for this collection and the clone has not been canceled.
+     */
+    void hangAfterHandlingBatchResponseIfEnabled();
+
+    /**
+     * Throws if initial sync has failed, cancelling the query this is called from.
+     */
+    void uassertInitialSyncNotFailed();
+
     /**
      * Stage function that sets up index builders for any unfinished two-phase index builds.
      */
@@ -259,9 +336,14 @@ private:
     std::unique_ptr<CollectionBulkLoader> _collLoader;  // (X)
     //  Function for scheduling database work using the executor.
     ScheduleDbWorkFn _scheduleDbWorkFn;  // (R)
+    // Function for creating the connections used by the _id range queries.
+    CreateClientFn _createClientFn;  // (R)
     // Documents read from source to insert.
     std::vector<BSONObj> _documentsToInsert;  // (M)
     Stats _stats;                             // (M)
+    // Size of the documents received by the _id range queries that are not inserted yet.
+    long long _bufferedBytes = 0;               // (M)
+    stdx::condition_variable _bufferedBytesCv;  // (M)
     // Putting _dbWorkTaskRunner last ensures anything the database work threads depend on,
     // like _documentsToInsert, is destroyed after those threads exit.
     TaskRunner _dbWorkTaskRunner;  // (R)
@@ -282,6 +364,23 @@ private:
     // Signifies that there were changes to the collection on the sync source that resulted in
     // our remote cursor getting killed.
     bool _lostNonResumableCursor = false;  // (X)
+
+    // Whether chooseIdRanges() has run for this clone.
+    bool _idRangesChosen = false;  // (X)
+
+    // The _id ranges copied concurrently by the query stage. Empty if the collection is copied
+    // with a single query. Each range is only accessed by the thread running its query while
+    // runRangeQueries() waits for them.
+    std::vector<IdRange> _idRanges;  // (X)
+
+    // Set when one of the _id range queries fails, to stop the others.
+    AtomicWord<bool> _stopRangeQueries{false};  // (S)
+
+    // The connections of the running _id range queries, shut down by stopRangeQueries().
+    std::vector<DBClientConnection*> _rangeClients;  // (M)
+
+    // The failure that stopped the _id range queries.
+    Status _rangeQueriesStatus = Status::OK();  // (M)
 };
 
 }  // namespace repl
@@ -40,6 +40,7 @@
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
@@ -123,6 +124,36 @@ protected:
         return cloner->_idIndexSpec;
     }
 
+    /**
+     * Makes a cloner that copies the collection with 'numRanges' _id range queries, given that
+     * 'collectionClonerRangeStreams' is 'numRanges'. Each range holds 'docsPerRange' documents,
+     * and the range queries connect to their own server rather than the main connection.
+     */
+    std::unique_ptr<CollectionCloner> makeRangeCollectionCloner(int numRanges, int docsPerRange) {
+        _rangeServer = std::make_unique<MockRemoteDBServer>(_source.toString());
+        _rangeServer->assignCollectionUuid(_nss.ns(), _collUuid);
+        BSONArrayBuilder sampledIds;
+        for (int i = 0; i < numRanges * docsPerRange; ++i) {
+            auto doc = BSON("_id" << i);
+            _rangeServer->insert(_nss.ns(), doc);
+            sampledIds.append(doc);
+        }
+        setMockServerReplies(BSON("size" << 10),
+                             createCountResponse(numRanges * docsPerRange),
+                             createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+        _mockServer->setCommandReply("aggregate",
+                                     createCursorResponse(_nss.ns(), sampledIds.arr()));
+
+        auto cloner = makeCollectionCloner();
+        cloner->setCreateClientFn_forTest([this] {
+            stdx::lock_guard<Latch> lk(_rangeClientsMutex);
+            auto client = std::make_unique<MockDBClientConnection>(_rangeServer.get());
+            _rangeClients.push_back(client.get());
+            return std::unique_ptr<DBClientConnection>(std::move(client));
+        });
+        return cloner;
+    }
+
     std::shared_ptr<CollectionMockStats> _collectionStats;  // Used by the _loader.
     StorageInterfaceMock::CreateCollectionForBulkFn _standardCreateCollectionFn;
     CollectionBulkLoaderMock* _loader = nullptr;  // Owned by CollectionCloner.
@@ -137,6 +168,12 @@ protected:
                                                        << "a_1"),
                                               BSON("v" << 1 << "key" << BSON("b" << 1) << "name"
                                                        << "b_1")};
+
+    // Server and connections used by the cloners from makeRangeCollectionCloner(). A connection
+    // is only valid while it is registered with the shared data.
+    std::unique_ptr<MockRemoteDBServer> _rangeServer;
+    Mutex _rangeClientsMutex = MONGO_MAKE_LATCH("CollectionClonerTest::_rangeClientsMutex");
+    std::vector<DBClientConnection*> _rangeClients;
 };
 
 class CollectionClonerTestResumable : public CollectionClonerTest {
@@ -1229,5 +1266,201 @@ TEST_F(CollectionClonerTestNonResumable, NonResumableCursorErrorThenSuccessEqual
     clonerThread.join();
 }
 
+TEST_F(CollectionClonerTestResumable, MakeIdRangesSplitsAtEvenlySpacedSamples) {
+    std::vector<BSONObj> sampledIds;
+    for (int i = 7; i >= 0; --i) {
+        sampledIds.push_back(BSON("_id" << i * 10));
+    }
+
+    auto ranges = CollectionCloner::makeIdRanges(sampledIds, 4);
+    ASSERT_EQ(4U, ranges.size());
+    ASSERT_FALSE(ranges[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), *ranges[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), *ranges[1].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 40), *ranges[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 40), *ranges[2].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 60), *ranges[2].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 60), *ranges[3].min);
+    ASSERT_FALSE(ranges[3].max);
+    for (auto&& range : ranges) {
+        ASSERT_FALSE(range.lastId);
+        ASSERT_FALSE(range.done);
+    }
+}
+
+TEST_F(CollectionClonerTestResumable, MakeIdRangesDropsDuplicateBounds) {
+    std::vector<BSONObj> sampledIds(6, BSON("_id" << 1));
+    sampledIds.push_back(BSON("_id" << 2));
+    sampledIds.push_back(BSON("_id" << 2));
+
+    auto ranges = CollectionCloner::makeIdRanges(sampledIds, 4);
+    ASSERT_EQ(3U, ranges.size());
+    ASSERT_FALSE(ranges[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), *ranges[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), *ranges[1].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), *ranges[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), *ranges[2].min);
+    ASSERT_FALSE(ranges[2].max);
+
+    // Without samples the whole collection is a single range.
+    ranges = CollectionCloner::makeIdRanges({}, 4);
+    ASSERT_EQ(1U, ranges.size());
+    ASSERT_FALSE(ranges[0].min);
+    ASSERT_FALSE(ranges[0].max);
+}
+
+TEST_F(CollectionClonerTestResumable, RangeQueriesCopyEveryRangeConcurrently) {
+    const auto rangeStreamsDefault = collectionClonerRangeStreams.load();
+    const auto rangeStreamsMinBytesDefault = collectionClonerRangeStreamsMinBytes.load();
+    collectionClonerRangeStreams.store(3);
+    collectionClonerRangeStreamsMinBytes.store(0);
+    ON_BLOCK_EXIT([&] {
+        collectionClonerRangeStreams.store(rangeStreamsDefault);
+        collectionClonerRangeStreamsMinBytes.store(rangeStreamsMinBytesDefault);
+    });
+
+    auto cloner = makeRangeCollectionCloner(3, 5);
+    cloner->setBatchSize_forTest(2);
+    ASSERT_OK(cloner->run());
+
+    ASSERT_EQUALS(3U, _rangeClients.size());
+    ASSERT_EQUALS(15, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(15U, stats.documentsCopied);
+    ASSERT_EQUALS(9U, stats.receivedBatches);
+
+    // The range queries did not use the main connection.
+    ASSERT_EQUALS(0U, _mockServer->getQueryCount());
+}
+
+TEST_F(CollectionClonerTestResumable, RangeQueryFailureFailsQueryStage) {
+    const auto rangeStreamsDefault = collectionClonerRangeStreams.load();
+    const auto rangeStreamsMinBytesDefault = collectionClonerRangeStreamsMinBytes.load();
+    collectionClonerRangeStreams.store(2);
+    collectionClonerRangeStreamsMinBytes.store(0);
+    ON_BLOCK_EXIT([&] {
+        collectionClonerRangeStreams.store(rangeStreamsDefault);
+        collectionClonerRangeStreamsMinBytes.store(rangeStreamsMinBytesDefault);
+    });
+
+    auto cloner = makeRangeCollectionCloner(2, 3);
+    cloner->setBatchSize_forTest(1);
+
+    // Fail one of the range queries with a non-retryable error. The other one is either stopped
+    // or finishes, but the error of the failed range is what the query stage fails with.
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'OperationFailed'}"));
+    ASSERT_EQUALS(ErrorCodes::OperationFailed, cloner->run());
+    ASSERT_FALSE(_collectionStats->commitCalled);
+    failNextBatch->setMode(FailPoint::off, 0);
+}
+
+TEST_F(CollectionClonerTestResumable, RangeQueryStoppedWhileWaitingForBufferDoesNotLoseItsBatch) {
+    const auto rangeStreamsDefault = collectionClonerRangeStreams.load();
+    const auto rangeStreamsMinBytesDefault = collectionClonerRangeStreamsMinBytes.load();
+    const auto rangeStreamsBufferBytesDefault = collectionClonerRangeStreamsBufferBytes.load();
+    collectionClonerRangeStreams.store(2);
+    collectionClonerRangeStreamsMinBytes.store(0);
+    // Only a single batch can be buffered at a time.
+    collectionClonerRangeStreamsBufferBytes.store(1);
+    ON_BLOCK_EXIT([&] {
+        collectionClonerRangeStreams.store(rangeStreamsDefault);
+        collectionClonerRangeStreamsMinBytes.store(rangeStreamsMinBytesDefault);
+        collectionClonerRangeStreamsBufferBytes.store(rangeStreamsBufferBytesDefault);
+    });
+
+    auto cloner = makeRangeCollectionCloner(2, 3);
+    cloner->setBatchSize_forTest(1);
+
+    // Keep the buffered batch from being inserted by occupying the only db worker thread.
+    auto insertsBlocked = std::make_shared<Notification<void>>();
+    _dbWorkThreadPool->schedule([insertsBlocked](Status) { insertsBlocked->get(); });
+    ON_BLOCK_EXIT([&] {
+        if (!*insertsBlocked) {
+            insertsBlocked->set();
+        }
+    });
+
+    auto afterBatchFailpoint =
+        globalFailPointRegistry().find("initialSyncHangCollectionClonerAfterHandlingBatchResponse");
+    auto timesEnteredAfterBatch = afterBatchFailpoint->setMode(FailPoint::alwaysOn, 0);
+    auto beforeWaitingFailpoint = globalFailPointRegistry().find(
+        "initialSyncHangCollectionClonerBeforeWaitingForRangeBuffer");
+    auto timesEnteredBeforeWaiting = beforeWaitingFailpoint->setMode(FailPoint::alwaysOn, 0);
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+
+    // One range query has buffered its first batch, the other one holds its first batch and is
+    // about to wait for the buffer.
+    afterBatchFailpoint->waitForTimesEntered(timesEnteredAfterBatch + 1);
+    beforeWaitingFailpoint->waitForTimesEntered(timesEnteredBeforeWaiting + 1);
+
+    // Fail the next batch of the range query which buffered its batch with a retriable error,
+    // which stops the waiting range query before its batch is buffered.
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    auto timesEnteredFailNextBatch =
+        failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'HostUnreachable'}"));
+    afterBatchFailpoint->setMode(FailPoint::off, 0);
+    failNextBatch->waitForTimesEntered(timesEnteredFailNextBatch + 1);
+    beforeWaitingFailpoint->setMode(FailPoint::off, 0);
+
+    // The retried query stage resumes each range after the last batch that was buffered.
+    insertsBlocked->set();
+    clonerThread.join();
+
+    ASSERT_EQUALS(6, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(6U, cloner->getStats().documentsCopied);
+}
+
+TEST_F(CollectionClonerTestResumable, ShutdownDuringRangeQueriesInterruptsThem) {
+    const auto rangeStreamsDefault = collectionClonerRangeStreams.load();
+    const auto rangeStreamsMinBytesDefault = collectionClonerRangeStreamsMinBytes.load();
+    collectionClonerRangeStreams.store(2);
+    collectionClonerRangeStreamsMinBytes.store(0);
+    ON_BLOCK_EXIT([&] {
+        collectionClonerRangeStreams.store(rangeStreamsDefault);
+        collectionClonerRangeStreamsMinBytes.store(rangeStreamsMinBytesDefault);
+    });
+
+    auto cloner = makeRangeCollectionCloner(2, 3);
+    cloner->setBatchSize_forTest(1);
+
+    auto afterBatchFailpoint =
+        globalFailPointRegistry().find("initialSyncHangCollectionClonerAfterHandlingBatchResponse");
+    auto timesEnteredAfterBatch = afterBatchFailpoint->setMode(FailPoint::alwaysOn, 0);
+
+    // Run the cloner in a separate thread.
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_EQUALS(ErrorCodes::CallbackCanceled, cloner->run());
+    });
+
+    // Wait for both range queries to handle their first batch, then cancel the clone the way the
+    // InitialSyncer does. The range queries cannot unregister their connections while the shared
+    // data is locked.
+    afterBatchFailpoint->waitForTimesEntered(timesEnteredAfterBatch + 2);
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        getSharedData()->setStatusIfOK(
+            lk, Status{ErrorCodes::CallbackCanceled, "Initial sync attempt canceled"});
+        getSharedData()->shutdownClients(lk);
+
+        stdx::lock_guard<Latch> clientsLk(_rangeClientsMutex);
+        ASSERT_EQUALS(2U, _rangeClients.size());
+        for (auto client : _rangeClients) {
+            ASSERT_TRUE(client->isFailed());
+        }
+    }
+
+    afterBatchFailpoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+    ASSERT_FALSE(_collectionStats->commitCalled);
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -0,0 +1,273 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/repl/repl_set_command.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_engine_metadata.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// A backup which isn't read from for this long belongs to a node which stopped its initial sync
+// without ending the backup, and is replaced by the next backup opened.
+constexpr Minutes kAbandonedBackupTimeout{10};
+
+// The most bytes of a file returned by one _fileCopyBasedInitialSyncReadFile command, which keeps
+// its reply well below the maximum size of a BSON object.
+constexpr long long kMaxReadBytes = 8 * 1024 * 1024;
+
+// The number of files requested from the storage engine's backup cursor at a time.
+constexpr std::size_t kBackupCursorBatchSize = 100;
+
+/**
+ * The backup a file copy based initial sync copies the data files of. The storage engine only
+ * allows one backup to be open at a time.
+ */
+struct FileCopyBackup {
+    Mutex mutex = MONGO_MAKE_LATCH("FileCopyBackup::mutex");
+    boost::optional<UUID> backupId;
+    // The size of each file of the backup when it was opened, by its path relative to the dbpath.
+    // Only these files may be read, and only up to this size.
+    StringMap<long long> fileSizes;
+    Date_t lastRead;
+};
+
+const auto getFileCopyBackup = ServiceContext::declareDecoration<FileCopyBackup>();
+
+/**
+ * Returns the path of 'file', a file in the dbpath, relative to the dbpath.
+ */
+std::string relativeToDbpath(const std::string& file) {
+    const StringData dbpath(storageGlobalParams.dbpath);
+    StringData relative(file);
+    uassert(ErrorCodes::InternalError,
+            str::stream() << "Backup file " << file << " is not in the dbpath " << dbpath,
+            relative.startsWith(dbpath));
+    relative = relative.substr(dbpath.size());
+    while (relative.startsWith("/") || relative.startsWith("\\")) {
+        relative = relative.substr(1);
+    }
+    return boost::filesystem::path(relative.toString()).generic_string();
+}
+
+void endBackup(WithLock, OperationContext* opCtx, FileCopyBackup* backup) {
+    opCtx->getServiceContext()->getStorageEngine()->endNonBlockingBackup(opCtx);
+    backup->backupId = boost::none;
+    backup->fileSizes.clear();
+}
+
+/**
+ * Opens a backup of the data files for a file copy based initial sync, and returns its id along
+ * with the files to copy and their sizes. The data files aren't modified in place while the backup
+ * is open, so they can be copied while this node keeps accepting writes.
+ */
+class CmdFileCopyBasedInitialSyncBeginBackup : public ReplSetCommand {
+public:
+    CmdFileCopyBasedInitialSyncBeginBackup()
+        : ReplSetCommand("_fileCopyBasedInitialSyncBeginBackup") {}
+
+    std::string help() const override {
+        return "Internal command opening a backup of the data files for a file copy based "
+               "initial sync";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        auto service = opCtx->getServiceContext();
+        auto storageEngine = service->getStorageEngine();
+        auto& backup = getFileCopyBackup(service);
+        const auto now = service->getFastClockSource()->now();
+
+        stdx::lock_guard<Latch> lk(backup.mutex);
+        if (backup.backupId) {
+            uassert(ErrorCodes::CannotBackup,
+                    "The data files are already being copied by another initial sync",
+                    backup.lastRead + kAbandonedBackupTimeout <= now);
+            LOGV2(5754742,
+                  "Ending abandoned file copy based initial sync backup",
+                  "backupId"_attr = *backup.backupId,
+                  "lastRead"_attr = backup.lastRead);
+            endBackup(lk, opCtx, &backup);
+        }
+
+        auto cursor = uassertStatusOK(
+            storageEngine->beginNonBlockingBackup(opCtx, StorageEngine::BackupOptions()));
+        auto endBackupGuard = makeGuard([&] { storageEngine->endNonBlockingBackup(opCtx); });
+
+        StringMap<long long> fileSizes;
+        BSONArrayBuilder files;
+        while (true) {
+            auto blocks = uassertStatusOK(cursor->getNextBatch(kBackupCursorBatchSize));
+            if (blocks.empty()) {
+                break;
+            }
+            for (const auto& block : blocks) {
+                auto filename = relativeToDbpath(block.filename);
+                const auto fileSize = static_cast<long long>(block.fileSize);
+                files.append(BSON("filename" << filename << "fileSize" << fileSize));
+                fileSizes.emplace(std::move(filename), fileSize);
+            }
+        }
+
+        // The syncing node only replaces its data files with files of the same storage engine
+        // and layout.
+        auto metadata = StorageEngineMetadata::forPath(storageGlobalParams.dbpath);
+        result.append("storageEngine", storageGlobalParams.engine);
+        result.append("storageEngineOptions",
+                      metadata ? metadata->getStorageEngineOptions() : BSONObj());
+
+        endBackupGuard.dismiss();
+        backup.backupId = UUID::gen();
+        backup.fileSizes = std::move(fileSizes);
+        backup.lastRead = now;
+        backup.backupId->appendToBuilder(&result, "backupId");
+        result.append("files", files.arr());
+
+        LOGV2(5754743,
+              "Opened file copy based initial sync backup",
+              "backupId"_attr = *backup.backupId,
+              "numFiles"_attr = backup.fileSizes.size());
+        return true;
+    }
+} cmdFileCopyBasedInitialSyncBeginBackup;
+
+/**
+ * Returns up to 'length' bytes of a file of the open backup, starting at 'offset'. Fewer bytes are
+ * returned at the end of the file and when 'length' is too large for one reply.
+ */
+class CmdFileCopyBasedInitialSyncReadFile : public ReplSetCommand {
+public:
+    CmdFileCopyBasedInitialSyncReadFile() : ReplSetCommand("_fileCopyBasedInitialSyncReadFile") {}
+
+    std::string help() const override {
+        return "Internal command reading a data file of the backup opened for a file copy based "
+               "initial sync";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const auto backupId = uassertStatusOK(UUID::parse(cmdObj["backupId"]));
+        std::string filename;
+        uassertStatusOK(bsonExtractStringField(cmdObj, "filename", &filename));
+        long long offset;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "offset", &offset));
+        long long length;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "length", &length));
+        uassert(ErrorCodes::BadValue,
+                "'offset' and 'length' must not be negative",
+                offset >= 0 && length >= 0);
+
+        auto service = opCtx->getServiceContext();
+        auto& backup = getFileCopyBackup(service);
+        stdx::lock_guard<Latch> lk(backup.mutex);
+        uassert(ErrorCodes::CannotBackup,
+                str::stream() << "Backup " << backupId << " is not open",
+                backup.backupId == backupId);
+        auto fileSize = backup.fileSizes.find(filename);
+        uassert(ErrorCodes::BadValue,
+                str::stream() << filename << " is not a file of backup " << backupId,
+                fileSize != backup.fileSizes.end());
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "Offset " << offset << " is past the end of " << filename,
+                offset <= fileSize->second);
+        length = std::min({length, kMaxReadBytes, fileSize->second - offset});
+
+        std::string data(length, '\0');
+        boost::filesystem::ifstream file(
+            boost::filesystem::path(storageGlobalParams.dbpath) / filename, std::ios::binary);
+        file.seekg(offset);
+        file.read(&data[0], length);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read " << length << " bytes at offset " << offset
+                              << " of " << filename,
+                file && file.gcount() == length);
+
+        backup.lastRead = service->getFastClockSource()->now();
+        result.appendBinData("data", static_cast<int>(length), BinDataGeneral, data.data());
+        return true;
+    }
+} cmdFileCopyBasedInitialSyncReadFile;
+
+/**
+ * Ends the backup opened for a file copy based initial sync. Does nothing if the backup has already
+ * ended.
+ */
+class CmdFileCopyBasedInitialSyncEndBackup : public ReplSetCommand {
+public:
+    CmdFileCopyBasedInitialSyncEndBackup() : ReplSetCommand("_fileCopyBasedInitialSyncEndBackup") {}
+
+    std::string help() const override {
+        return "Internal command ending the backup opened for a file copy based initial sync";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string&,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const auto backupId = uassertStatusOK(UUID::parse(cmdObj["backupId"]));
+
+        auto& backup = getFileCopyBackup(opCtx->getServiceContext());
+        stdx::lock_guard<Latch> lk(backup.mutex);
+        if (backup.backupId == backupId) {
+            endBackup(lk, opCtx, &backup);
+            LOGV2(5754744, "Ended file copy based initial sync backup", "backupId"_attr = backupId);
+        }
+        return true;
+    }
+} cmdFileCopyBasedInitialSyncEndBackup;
+
+}  // namespace
+
+}  // namespace repl
+}  // namespace mongo
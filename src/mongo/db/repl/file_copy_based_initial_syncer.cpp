@@ -0,0 +1,441 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplicationInitialSync
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/data_replicator_external_state.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
+#include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/staged_data_files.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_engine_metadata.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+ServiceContext::ConstructorActionRegisterer fileCopyBasedInitialSyncerRegisterer(
+    "FileCopyBasedInitialSyncerRegisterer", [](ServiceContext* service) {
+        InitialSyncerFactory::get(service)->registerInitialSyncer(
+            FileCopyBasedInitialSyncer::kInitialSyncMethodName.toString(),
+            [](InitialSyncerOptions opts,
+               std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+               ThreadPool* writerPool,
+               StorageInterface* storage,
+               ReplicationProcess* replicationProcess,
+               const InitialSyncerInterface::OnCompletionFn& onCompletion) {
+                return std::make_shared<FileCopyBasedInitialSyncer>(std::move(opts),
+                                                                    onCompletion);
+            });
+    });
+
+}  // namespace
+
+FileCopyBasedInitialSyncer::FileCopyBasedInitialSyncer(InitialSyncerOptions opts,
+                                                       const OnCompletionFn& onCompletion)
+    : _opts(std::move(opts)), _onCompletion(onCompletion) {
+    uassert(ErrorCodes::BadValue, "sync source selector cannot be null", _opts.syncSourceSelector);
+    uassert(ErrorCodes::BadValue, "callback function cannot be null", _onCompletion);
+}
+
+FileCopyBasedInitialSyncer::~FileCopyBasedInitialSyncer() {
+    DESTRUCTOR_GUARD({
+        shutdown().transitional_ignore();
+        join();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    });
+}
+
+Status FileCopyBasedInitialSyncer::startup(OperationContext* opCtx,
+                                           std::uint32_t maxAttempts) noexcept {
+    invariant(opCtx);
+    invariant(maxAttempts >= 1U);
+
+    if (opCtx->getServiceContext()->getStorageEngine()->isEphemeral()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "File copy based initial sync requires a storage engine which keeps its "
+                      "data files on disk");
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            _state = State::kRunning;
+            break;
+        case State::kRunning:
+            return Status(ErrorCodes::IllegalOperation, "initial syncer already started");
+        case State::kShuttingDown:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer shutting down");
+        case State::kComplete:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer completed");
+    }
+
+    _maxAttempts = maxAttempts;
+    _initialSyncStart = opCtx->getServiceContext()->getFastClockSource()->now();
+    _thread = stdx::thread([this, maxAttempts] { _run(maxAttempts); });
+    return Status::OK();
+}
+
+Status FileCopyBasedInitialSyncer::shutdown() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            // Transition directly from PreStart to Complete if not started yet.
+            _state = State::kComplete;
+            _stateCondition.notify_all();
+            return Status::OK();
+        case State::kRunning:
+            _state = State::kShuttingDown;
+            break;
+        case State::kShuttingDown:
+        case State::kComplete:
+            // Nothing to do if we are already in ShuttingDown or Complete state.
+            return Status::OK();
+    }
+
+    _cancelAttempt_inlock();
+    return Status::OK();
+}
+
+void FileCopyBasedInitialSyncer::join() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _stateCondition.wait(
+        lk, [&] { return _state != State::kRunning && _state != State::kShuttingDown; });
+}
+
+BSONObj FileCopyBasedInitialSyncer::getInitialSyncProgress() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state != State::kRunning) {
+        return BSONObj();
+    }
+
+    BSONObjBuilder bob;
+    bob.append("method", kInitialSyncMethodName);
+    bob.append("failedInitialSyncAttempts", static_cast<int>(_failedAttempts));
+    bob.append("maxFailedInitialSyncAttempts", static_cast<int>(_maxAttempts));
+    bob.append("initialSyncStart", _initialSyncStart);
+    if (!_syncSource.empty()) {
+        bob.append("syncSource", _syncSource.toString());
+    }
+    bob.append("totalFiles", _totalFiles);
+    bob.append("copiedFiles", _copiedFiles);
+    bob.append("totalBytes", _totalBytes);
+    bob.append("copiedBytes", _copiedBytes);
+    return bob.obj();
+}
+
+void FileCopyBasedInitialSyncer::cancelCurrentAttempt() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state == State::kRunning) {
+        LOGV2_DEBUG(5754745,
+                    1,
+                    "Cancelling the current initial sync attempt.",
+                    "currentAttempt"_attr = _failedAttempts + 1);
+        _cancelAttempt_inlock();
+    }
+}
+
+std::string FileCopyBasedInitialSyncer::getInitialSyncMethod() const {
+    return kInitialSyncMethodName.toString();
+}
+
+void FileCopyBasedInitialSyncer::_run(std::uint32_t maxAttempts) {
+    Client::initThread("FileCopyBasedInitialSyncer");
+    StagedDataFiles stagedFiles(storageGlobalParams.dbpath);
+
+    Status status = Status::OK();
+    for (std::uint32_t attempt = 1;; ++attempt) {
+        try {
+            _runAttempt();
+            status = Status::OK();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        if (status.isOK() || _state != State::kRunning) {
+            break;
+        }
+
+        ++_failedAttempts;
+        LOGV2_ERROR(5754746,
+                    "File copy based initial sync attempt failed",
+                    "attemptsLeft"_attr = maxAttempts - attempt,
+                    "error"_attr = status);
+        if (attempt >= maxAttempts) {
+            break;
+        }
+
+        _stateCondition.wait_for(lk, _opts.initialSyncRetryWait.toSystemDuration(), [&] {
+            return _state != State::kRunning;
+        });
+        if (_state != State::kRunning) {
+            break;
+        }
+    }
+
+    if (status.isOK()) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        if (_state == State::kRunning) {
+            // Shutting down waits for this initial syncer, so it must be started by another
+            // thread.
+            LOGV2(5754747,
+                  "Copied the data files of the sync source. Shutting down, restart this node to "
+                  "replace its data files with the copies and complete initial sync",
+                  "syncSource"_attr = _syncSource,
+                  "copiedFiles"_attr = _copiedFiles,
+                  "copiedBytes"_attr = _copiedBytes);
+            stdx::thread([] {
+                Client::initThread("FileCopyBasedInitialSyncShutdown");
+                ::mongo::shutdown(EXIT_CLEAN);
+            })
+                .detach();
+        }
+        _stateCondition.wait(lk, [&] { return _state != State::kRunning; });
+        status = Status(ErrorCodes::CallbackCanceled,
+                        "Initial sync completes when this node restarts with the copied data "
+                        "files");
+    } else {
+        auto removeStatus = stagedFiles.remove();
+        if (!removeStatus.isOK()) {
+            LOGV2_WARNING(5754748,
+                          "Failed to remove the data files copied by initial sync",
+                          "error"_attr = removeStatus);
+        }
+    }
+
+    _onCompletion(status);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _state = State::kComplete;
+    _stateCondition.notify_all();
+}
+
+void FileCopyBasedInitialSyncer::_runAttempt() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _attemptCanceled = false;
+    }
+    const auto syncSource = _chooseSyncSource();
+
+    DBClientConnection* client;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        uassert(
+            ErrorCodes::CallbackCanceled, "Initial sync attempt canceled", !_isCanceled_inlock());
+        _client = std::make_unique<DBClientConnection>();
+        client = _client.get();
+        _syncSource = syncSource;
+        _totalFiles = _copiedFiles = _totalBytes = _copiedBytes = 0;
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _client.reset();
+    });
+
+    uassertStatusOK(client->connect(syncSource, "FileCopyBasedInitialSyncer"_sd, boost::none));
+    uassertStatusOK(replAuthenticate(client).withContext(str::stream()
+                                                         << "Failed to authenticate to "
+                                                         << syncSource));
+
+    auto backup = _runCommand(client, BSON("_fileCopyBasedInitialSyncBeginBackup" << 1));
+    const auto backupId = uassertStatusOK(UUID::parse(backup["backupId"]));
+    auto endBackup = makeGuard([&] {
+        try {
+            _runCommand(client, BSON("_fileCopyBasedInitialSyncEndBackup" << 1 << "backupId"
+                                                                          << backupId));
+        } catch (const DBException& ex) {
+            // The sync source replaces the backup once it is abandoned.
+            LOGV2_DEBUG(5754749,
+                        1,
+                        "Failed to end the backup of the sync source",
+                        "syncSource"_attr = syncSource,
+                        "error"_attr = ex.toStatus());
+        }
+    });
+
+    auto metadata = StorageEngineMetadata::forPath(storageGlobalParams.dbpath);
+    uassert(ErrorCodes::InvalidSyncSource,
+            str::stream() << "Sync source " << syncSource << " uses the "
+                          << backup["storageEngine"].str() << " storage engine with options "
+                          << backup["storageEngineOptions"].Obj()
+                          << ", the data files of which can't replace those of this node",
+            backup["storageEngine"].str() == storageGlobalParams.engine &&
+                SimpleBSONObjComparator::kInstance.evaluate(
+                    backup["storageEngineOptions"].Obj() ==
+                    (metadata ? metadata->getStorageEngineOptions() : BSONObj())));
+
+    const auto files = backup["files"].Array();
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _totalFiles = files.size();
+        for (const auto& file : files) {
+            _totalBytes += file["fileSize"].safeNumberLong();
+        }
+    }
+    LOGV2(5754750,
+          "Copying the data files of the sync source",
+          "syncSource"_attr = syncSource,
+          "backupId"_attr = backupId,
+          "totalFiles"_attr = files.size());
+
+    StagedDataFiles stagedFiles(storageGlobalParams.dbpath);
+    uassertStatusOK(stagedFiles.reset());
+    for (const auto& file : files) {
+        _copyFile(client,
+                  backupId,
+                  file["filename"].str(),
+                  file["fileSize"].safeNumberLong(),
+                  stagedFiles);
+    }
+
+    endBackup.dismiss();
+    _runCommand(client, BSON("_fileCopyBasedInitialSyncEndBackup" << 1 << "backupId" << backupId));
+    uassertStatusOK(stagedFiles.markComplete());
+}
+
+HostAndPort FileCopyBasedInitialSyncer::_chooseSyncSource() {
+    const int maxAttempts = numInitialSyncConnectAttempts.load();
+    for (int attempt = 1;; ++attempt) {
+        auto syncSource = _opts.syncSourceSelector->chooseNewSyncSource(OpTime());
+        if (!syncSource.empty()) {
+            return syncSource;
+        }
+        uassert(ErrorCodes::InitialSyncOplogSourceMissing,
+                "No valid sync source found in current replica set to do an initial sync.",
+                attempt < maxAttempts);
+
+        LOGV2_DEBUG(5754751,
+                    1,
+                    "No sync source available. Waiting to retry",
+                    "syncSourceRetryWait"_attr = _opts.syncSourceRetryWait,
+                    "chooseSyncSourceAttempt"_attr = attempt,
+                    "numInitialSyncConnectAttempts"_attr = maxAttempts);
+        stdx::unique_lock<Latch> lk(_mutex);
+        _stateCondition.wait_for(lk, _opts.syncSourceRetryWait.toSystemDuration(), [&] {
+            return _isCanceled_inlock();
+        });
+        uassert(
+            ErrorCodes::CallbackCanceled, "Initial sync attempt canceled", !_isCanceled_inlock());
+    }
+}
+
+BSONObj FileCopyBasedInitialSyncer::_runCommand(DBClientConnection* client, const BSONObj& cmd) {
+    BSONObj reply;
+    client->runCommand("admin", cmd, reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    return reply;
+}
+
+void FileCopyBasedInitialSyncer::_copyFile(DBClientConnection* client,
+                                           const UUID& backupId,
+                                           const std::string& filename,
+                                           long long fileSize,
+                                           const StagedDataFiles& stagedFiles) {
+    const auto path = uassertStatusOK(stagedFiles.prepareFile(filename));
+    boost::filesystem::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+    // The sync source returns as much of the rest of the file as fits in one reply.
+    long long offset = 0;
+    while (offset < fileSize) {
+        _checkForCancellation();
+        auto reply = _runCommand(client,
+                                 BSON("_fileCopyBasedInitialSyncReadFile"
+                                      << 1 << "backupId" << backupId << "filename" << filename
+                                      << "offset" << offset << "length" << fileSize - offset));
+        int length;
+        const char* data = reply["data"].binData(length);
+        uassert(ErrorCodes::InternalError,
+                str::stream() << "Sync source returned no data for " << filename << " at offset "
+                              << offset,
+                length > 0);
+
+        out.write(data, length);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write to " << path.generic_string(),
+                out.good());
+        offset += length;
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _copiedBytes += length;
+    }
+
+    out.close();
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to write to " << path.generic_string(),
+            !out.fail());
+    uassertStatusOK(fsyncFile(path));
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_copiedFiles;
+}
+
+void FileCopyBasedInitialSyncer::_checkForCancellation() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    uassert(ErrorCodes::CallbackCanceled, "Initial sync attempt canceled", !_isCanceled_inlock());
+}
+
+bool FileCopyBasedInitialSyncer::_isCanceled_inlock() const {
+    return _state != State::kRunning || _attemptCanceled;
+}
+
+void FileCopyBasedInitialSyncer::_cancelAttempt_inlock() {
+    _attemptCanceled = true;
+    if (_client) {
+        _client->shutdownAndDisallowReconnect();
+    }
+    _stateCondition.notify_all();
+}
+
+}  // namespace repl
+}  // namespace mongo
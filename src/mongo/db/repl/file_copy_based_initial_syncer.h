@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class DBClientConnection;
+class StagedDataFiles;
+
+namespace repl {
+
+/**
+ * Initial syncer which copies the data files of its sync source instead of cloning every
+ * collection and rebuilding its indexes. It opens a backup on the sync source, which keeps the
+ * files of a checkpoint unmodified while it copies them, and stages the copies in the dbpath.
+ *
+ * The copied files can't replace the data files of the running storage engine, so once they are
+ * staged this node shuts down cleanly. When it is restarted, the staged files replace its data
+ * files before the storage engine opens them; startup recovery then brings the node up to the end
+ * of the copied oplog, from which it replicates like any other secondary.
+ */
+class FileCopyBasedInitialSyncer : public InitialSyncerInterface {
+    FileCopyBasedInitialSyncer(const FileCopyBasedInitialSyncer&) = delete;
+    FileCopyBasedInitialSyncer& operator=(const FileCopyBasedInitialSyncer&) = delete;
+
+public:
+    /**
+     * Name of this initial sync method, as accepted by 'initialSyncMethod'.
+     */
+    static constexpr StringData kInitialSyncMethodName = "fileCopyBased"_sd;
+
+    FileCopyBasedInitialSyncer(InitialSyncerOptions opts, const OnCompletionFn& onCompletion);
+
+    ~FileCopyBasedInitialSyncer() override;
+
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept override;
+
+    Status shutdown() override;
+
+    void join() override;
+
+    BSONObj getInitialSyncProgress() const override;
+
+    void cancelCurrentAttempt() override;
+
+    std::string getInitialSyncMethod() const override;
+
+private:
+    enum class State { kPreStart, kRunning, kShuttingDown, kComplete };
+
+    /**
+     * Runs up to 'maxAttempts' initial sync attempts on '_thread' and reports the outcome to
+     * '_onCompletion'.
+     */
+    void _run(std::uint32_t maxAttempts);
+
+    /**
+     * Copies the data files of a sync source into the staging directory and marks them complete.
+     * Throws if the attempt fails or is canceled.
+     */
+    void _runAttempt();
+
+    HostAndPort _chooseSyncSource();
+
+    BSONObj _runCommand(DBClientConnection* client, const BSONObj& cmd);
+
+    void _copyFile(DBClientConnection* client,
+                   const UUID& backupId,
+                   const std::string& filename,
+                   long long fileSize,
+                   const StagedDataFiles& stagedFiles);
+
+    /**
+     * Throws CallbackCanceled if the current attempt has been canceled.
+     */
+    void _checkForCancellation() const;
+
+    bool _isCanceled_inlock() const;
+
+    void _cancelAttempt_inlock();
+
+    const InitialSyncerOptions _opts;
+    const OnCompletionFn _onCompletion;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("FileCopyBasedInitialSyncer::_mutex");
+
+    // Notified when '_state' changes and when the current attempt is canceled.
+    stdx::condition_variable _stateCondition;
+
+    State _state = State::kPreStart;
+    bool _attemptCanceled = false;
+    stdx::thread _thread;
+
+    // The connection to the sync source of the current attempt, which is shut down to interrupt
+    // the attempt.
+    std::unique_ptr<DBClientConnection> _client;
+
+    // Progress of the initial sync, reported by getInitialSyncProgress().
+    std::uint32_t _maxAttempts = 0;
+    std::uint32_t _failedAttempts = 0;
+    Date_t _initialSyncStart;
+    HostAndPort _syncSource;
+    long long _totalFiles = 0;
+    long long _copiedFiles = 0;
+    long long _totalBytes = 0;
+    long long _copiedBytes = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
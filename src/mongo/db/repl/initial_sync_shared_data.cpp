@@ -31,6 +31,10 @@
 
 #include "mongo/db/repl/initial_sync_shared_data.h"
 
+#include <algorithm>
+
+#include "mongo/client/dbclient_connection.h"
+
 namespace mongo {
 namespace repl {
 int InitialSyncSharedData::incrementRetryingOperations(WithLock lk) {
@@ -76,5 +80,26 @@ Milliseconds InitialSyncSharedData::getCurrentOutageDuration(WithLock lk) {
                                            : Milliseconds::min());
 }
 
+bool InitialSyncSharedData::registerClient(WithLock lk, DBClientConnection* client) {
+    if (!getStatus(lk).isOK()) {
+        return false;
+    }
+    _clients.push_back(client);
+    return true;
+}
+
+void InitialSyncSharedData::unregisterClient(WithLock lk, DBClientConnection* client) {
+    auto it = std::find(_clients.begin(), _clients.end(), client);
+    if (it != _clients.end()) {
+        _clients.erase(it);
+    }
+}
+
+void InitialSyncSharedData::shutdownClients(WithLock lk) {
+    for (auto client : _clients) {
+        client->shutdownAndDisallowReconnect();
+    }
+}
+
 }  // namespace repl
 }  // namespace mongo
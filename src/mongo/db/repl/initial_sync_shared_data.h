@@ -30,11 +30,15 @@
 #pragma once
 
 #include <mutex>
+#include <vector>
 
 #include "mongo/db/repl/repl_sync_shared_data.h"
 #include "mongo/db/server_options.h"
 
 namespace mongo {
+
+class DBClientConnection;
+
 namespace repl {
 class InitialSyncSharedData final : public ReplSyncSharedData {
 private:
@@ -128,6 +132,25 @@ public:
         _allowedOutageDuration = allowedOutageDuration;
     }
 
+    /**
+     * Registers a connection to the sync source opened by a cloner in addition to the initial
+     * syncer's own client, so that shutdownClients() interrupts it. Returns false without
+     * registering the connection if the attempt has already failed or been canceled.
+     */
+    bool registerClient(WithLock lk, DBClientConnection* client);
+
+    /**
+     * Unregisters a connection added by registerClient(). Must be called before the connection is
+     * destroyed.
+     */
+    void unregisterClient(WithLock lk, DBClientConnection* client);
+
+    /**
+     * Shuts down every registered connection and prevents it from reconnecting. Used when the
+     * initial sync attempt is canceled.
+     */
+    void shutdownClients(WithLock lk);
+
 private:
     class RetryingOperation {
     public:
@@ -214,6 +237,9 @@ private:
 
     // The initial sync ID on the source at the start of data cloning.
     boost::optional<UUID> _initialSyncSourceId;
+
+    // Connections registered by cloners, shut down when the initial sync attempt is canceled.
+    std::vector<DBClientConnection*> _clients;
 };
 }  // namespace repl
 }  // namespace mongo
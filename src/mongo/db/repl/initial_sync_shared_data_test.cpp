@@ -30,6 +30,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/repl/initial_sync_shared_data.h"
+#include "mongo/dbtests/mock/mock_dbclient_connection.h"
+#include "mongo/dbtests/mock/mock_remote_db_server.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -231,5 +233,30 @@ TEST(InitialSyncSharedDataTest, OperationTimesOut) {
     ASSERT_EQ(Milliseconds::min(), data.getCurrentOutageDuration(lk));
 }
 
+TEST(InitialSyncSharedDataTest, ShutdownClientsShutsDownRegisteredClients) {
+    Days timeout(1);
+    ClockSourceMock clock;
+    InitialSyncSharedData data(1 /* rollBackId */, timeout, &clock);
+    MockRemoteDBServer server("local:1234");
+    MockDBClientConnection registered(&server);
+    MockDBClientConnection unregistered(&server);
+    MockDBClientConnection notRegistered(&server);
+
+    stdx::unique_lock<InitialSyncSharedData> lk(data);
+    ASSERT_TRUE(data.registerClient(lk, &registered));
+    ASSERT_TRUE(data.registerClient(lk, &unregistered));
+    data.unregisterClient(lk, &unregistered);
+
+    data.setStatusIfOK(lk, Status{ErrorCodes::CallbackCanceled, "Initial sync attempt canceled"});
+    data.shutdownClients(lk);
+    ASSERT_TRUE(registered.isFailed());
+    ASSERT_FALSE(unregistered.isFailed());
+
+    // Once the attempt is canceled, new connections are refused.
+    ASSERT_FALSE(data.registerClient(lk, &notRegistered));
+    data.shutdownClients(lk);
+    ASSERT_FALSE(notRegistered.isFailed());
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -51,6 +51,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/all_database_cloner.h"
 #include "mongo/db/repl/initial_sync_state.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_fetcher.h"
@@ -62,6 +63,7 @@
 #include "mongo/db/repl/sync_source_selector.h"
 #include "mongo/db/repl/tenant_migration_access_blocker_util.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/executor/thread_pool_task_executor.h"
@@ -198,6 +200,25 @@ void pauseAtInitialSyncFuzzerSyncronizationPoints(std::string msg) {
     }
 }
 
+ServiceContext::ConstructorActionRegisterer initialSyncerRegisterer(
+    "InitialSyncerRegisterer", [](ServiceContext* service) {
+        InitialSyncerFactory::get(service)->registerInitialSyncer(
+            InitialSyncer::kInitialSyncMethodName.toString(),
+            [](InitialSyncerOptions opts,
+               std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+               ThreadPool* writerPool,
+               StorageInterface* storage,
+               ReplicationProcess* replicationProcess,
+               const InitialSyncerInterface::OnCompletionFn& onCompletion) {
+                return std::make_shared<InitialSyncer>(std::move(opts),
+                                                       std::move(dataReplicatorExternalState),
+                                                       writerPool,
+                                                       storage,
+                                                       replicationProcess,
+                                                       onCompletion);
+            });
+    });
+
 }  // namespace
 
 InitialSyncer::InitialSyncer(
@@ -337,6 +358,8 @@ void InitialSyncer::_cancelRemainingWork_inlock() {
         stdx::lock_guard<InitialSyncSharedData> lock(*_sharedData);
         _sharedData->setStatusIfOK(
             lock, Status{ErrorCodes::CallbackCanceled, "Initial sync attempt canceled"});
+        // Interrupt the connections the cloners opened in addition to '_client'.
+        _sharedData->shutdownClients(lock);
     }
     if (_client) {
         _client->shutdownAndDisallowReconnect();
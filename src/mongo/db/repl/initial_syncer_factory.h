@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class ServiceContext;
+class ThreadPool;
+
+namespace repl {
+
+class DataReplicatorExternalState;
+class ReplicationProcess;
+class StorageInterface;
+
+/**
+ * Creates the initial syncer for an initial sync method. Every method registers itself under the
+ * name used by the 'initialSyncMethod' server parameter, so builds may provide methods beyond the
+ * logical one.
+ */
+class InitialSyncerFactory {
+public:
+    using CreateInitialSyncerFunction = std::function<std::shared_ptr<InitialSyncerInterface>(
+        InitialSyncerOptions opts,
+        std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+        ThreadPool* writerPool,
+        StorageInterface* storage,
+        ReplicationProcess* replicationProcess,
+        const InitialSyncerInterface::OnCompletionFn& onCompletion)>;
+
+    static InitialSyncerFactory* get(ServiceContext* svcCtx);
+
+    /**
+     * Registers the function creating initial syncers for 'initialSyncMethod'. Each method may
+     * only be registered once.
+     */
+    void registerInitialSyncer(const std::string& initialSyncMethod,
+                               CreateInitialSyncerFunction createInitialSyncerFunction);
+
+    /**
+     * Returns true if an initial syncer is registered for 'initialSyncMethod'.
+     */
+    bool isRegistered(const std::string& initialSyncMethod) const;
+
+    /**
+     * Creates an initial syncer for 'initialSyncMethod'. Returns InvalidOptions if no initial
+     * syncer is registered for that method.
+     */
+    StatusWith<std::shared_ptr<InitialSyncerInterface>> createInitialSyncer(
+        const std::string& initialSyncMethod,
+        InitialSyncerOptions opts,
+        std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+        ThreadPool* writerPool,
+        StorageInterface* storage,
+        ReplicationProcess* replicationProcess,
+        const InitialSyncerInterface::OnCompletionFn& onCompletion);
+
+private:
+    StringMap<CreateInitialSyncerFunction> _createInitialSyncerFunctionMap;
+};
+
+}  // namespace repl
+}  // namespace mongo
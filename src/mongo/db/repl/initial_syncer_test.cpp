@@ -45,6 +45,7 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/data_replicator_external_state_mock.h"
 #include "mongo/db/repl/initial_syncer.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_fetcher.h"
@@ -725,6 +726,39 @@ TEST_F(InitialSyncerTest, InvalidConstruction) {
 
 TEST_F(InitialSyncerTest, CreateDestroy) {}
 
+TEST_F(InitialSyncerTest, InitialSyncerFactoryCreatesOnlyRegisteredInitialSyncMethods) {
+    auto factory = InitialSyncerFactory::get(getGlobalServiceContext());
+    auto callback = [](const StatusWith<OpTimeAndWallTime>&) {};
+    auto makeExternalState = [this] {
+        auto dataReplicatorExternalState = std::make_unique<DataReplicatorExternalStateMock>();
+        dataReplicatorExternalState->taskExecutor = _executorProxy;
+        return dataReplicatorExternalState;
+    };
+
+    ASSERT_TRUE(factory->isRegistered("logical"));
+    auto initialSyncer = unittest::assertGet(factory->createInitialSyncer("logical",
+                                                                          _options,
+                                                                          makeExternalState(),
+                                                                          _dbWorkThreadPool.get(),
+                                                                          _storageInterface.get(),
+                                                                          _replicationProcess.get(),
+                                                                          callback));
+    ASSERT_EQUALS("logical", initialSyncer->getInitialSyncMethod());
+
+    // No initial syncer is registered for file copy based initial sync in this build.
+    ASSERT_FALSE(factory->isRegistered("fileCopyBased"));
+    ASSERT_EQUALS(ErrorCodes::InvalidOptions,
+                  factory
+                      ->createInitialSyncer("fileCopyBased",
+                                            _options,
+                                            makeExternalState(),
+                                            _dbWorkThreadPool.get(),
+                                            _storageInterface.get(),
+                                            _replicationProcess.get(),
+                                            callback)
+                      .getStatus());
+}
+
 const std::uint32_t maxAttempts = 1U;
 
 TEST_F(InitialSyncerTest, StartupReturnsIllegalOperationIfAlreadyActive) {
@@ -73,6 +73,25 @@ ServerStatusMetricField<Counter64> displayOplogApplicationBatchSize("repl.apply.
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Number and time of each stage of batch application on secondaries.
+TimerStats partitionStageStats;
+ServerStatusMetricField<TimerStats> displayPartitionStage("repl.apply.stages.partition",
+                                                          &partitionStageStats);
+TimerStats writeOplogStageStats;
+ServerStatusMetricField<TimerStats> displayWriteOplogStage("repl.apply.stages.writeOplog",
+                                                           &writeOplogStageStats);
+TimerStats applyStageStats;
+ServerStatusMetricField<TimerStats> displayApplyStage("repl.apply.stages.apply",
+                                                      &applyStageStats);
+TimerStats finalizeStageStats;
+ServerStatusMetricField<TimerStats> displayFinalizeStage("repl.apply.stages.finalize",
+                                                         &finalizeStageStats);
+
+// Number of batches assigned to writer threads while the previous batch was still being applied.
+Counter64 pipelinedBatches;
+ServerStatusMetricField<Counter64> displayPipelinedBatches("repl.apply.pipelinedBatches",
+                                                           &pipelinedBatches);
+
 /**
  * Used for logging a report of ops that take longer than "slowMS" to apply. This is called
  * right before returning from applyOplogEntryOrGroupedInserts, and it returns the same status.
@@ -110,11 +129,22 @@ Status finishAndLogApply(OperationContext* opCtx,
     return finalStatus;
 }
 
+/**
+ * Returns true if 'ops' contains no commands. Only batches like this may be assigned to writer
+ * threads ahead of time, since commands can change the collection properties used to assign
+ * operations to writers.
+ */
+bool containsNoCommands(const std::vector<OplogEntry>& ops) {
+    return std::none_of(
+        ops.begin(), ops.end(), [](const OplogEntry& op) { return op.isCommand(); });
+}
+
 void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
                                       std::vector<OplogEntry*>* partialTxnList,
                                       std::vector<std::vector<OplogEntry>>* derivedOps,
                                       OplogEntry* op,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors) {
     std::vector<OplogEntry> txnOps;
     bool shouldSerialize = false;
@@ -124,8 +154,12 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
     partialTxnList->clear();
 
     // Transaction entries cannot have different session updates.
-    OplogApplierUtils::addDerivedOps(
-        opCtx, &derivedOps->back(), writerVectors, collPropertiesCache, shouldSerialize);
+    OplogApplierUtils::addDerivedOps(opCtx,
+                                     &derivedOps->back(),
+                                     writerVectors,
+                                     collPropertiesCache,
+                                     writerAssignments,
+                                     shouldSerialize);
 }
 
 }  // namespace
@@ -265,6 +299,10 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
             ? new ApplyBatchFinalizerForJournal(_replCoord)
             : new ApplyBatchFinalizer(_replCoord)};
 
+    // A batch taken from the batcher, and possibly assigned to writer threads, while the previous
+    // batch was being applied.
+    std::unique_ptr<PartitionedBatch> nextBatch;
+
     while (true) {  // Exits on message from OplogBatcher.
         // Use a new operation context each iteration, as otherwise we may appear to use a single
         // collection name to refer to collections with different UUIDs.
@@ -276,6 +314,10 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // path only gets used on secondaries or on a node transitioning to primary.
         opCtx.setShouldParticipateInFlowControl(false);
 
+        // Oplog application is prioritized over user operations when queueing for tickets, so
+        // that secondaries keep up under load.
+        opCtx.lockState()->setTicketLane(TicketLane::kReplication);
+
         // For pausing replication in tests.
         if (MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
             LOGV2(21229,
@@ -287,29 +329,34 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // Transition to SECONDARY state, if possible.
         _replCoord->finishRecoveryIfEligible(&opCtx);
 
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OplogBatch ops = _oplogBatcher->getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
-                // Shut down and exit oplog application loop.
-                return;
-            }
-            if (MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
-                continue;
-            }
-            if (ops.termWhenExhausted()) {
-                // Signal drain complete if we're in Draining state and the buffer is empty.
-                // Since we check the states of batcher and oplog buffer without synchronization,
-                // they can be stale. We make sure the applier is still draining in the given term
-                // before and after the check, so that if the oplog buffer was exhausted, then
-                // it still will be.
-                _replCoord->signalDrainComplete(&opCtx, *ops.termWhenExhausted());
+        auto batch = std::move(nextBatch);
+        if (!batch) {
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't
+            // become ready in time, we'll loop again so we can do the above checks periodically.
+            OplogBatch ops = _oplogBatcher->getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    // Shut down and exit oplog application loop.
+                    return;
+                }
+                if (MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
+                    continue;
+                }
+                if (ops.termWhenExhausted()) {
+                    // Signal drain complete if we're in Draining state and the buffer is empty.
+                    // Since we check the states of batcher and oplog buffer without
+                    // synchronization, they can be stale. We make sure the applier is still
+                    // draining in the given term before and after the check, so that if the oplog
+                    // buffer was exhausted, then it still will be.
+                    _replCoord->signalDrainComplete(&opCtx, *ops.termWhenExhausted());
+                }
+                continue;  // Try again.
             }
-            continue;  // Try again.
+            batch = std::make_unique<PartitionedBatch>(ops.releaseBatch());
         }
 
-        // Extract some info from ops that we'll need after releasing the batch below.
+        // Extract some info from the batch that we'll need after applying it below.
+        const auto& ops = batch->ops;
         const auto firstOpTimeInBatch = ops.front().getOpTime();
         const auto lastOpInBatch = ops.back();
         const auto lastOpTimeInBatch = lastOpInBatch.getOpTime();
@@ -329,9 +376,19 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
-        // Apply the operations in this batch. '_applyOplogBatch' returns the optime of the
+        // While the writer threads apply a batch without commands, take the next batch and assign
+        // its operations to writers so that it is ready as soon as this one completes.
+        std::function<void(OperationContext*)> whileApplying;
+        if (oplogApplicationPipelineBatches.load() && containsNoCommands(ops)) {
+            whileApplying = [&](OperationContext* applierOpCtx) {
+                nextBatch = _takeAndPartitionNextBatch(applierOpCtx);
+            };
+        }
+
+        // Apply the operations in this batch. '_applyPartitionedBatch' returns the optime of the
         // last op that was applied, which should be the last optime in the batch.
-        auto swLastOpTimeAppliedInBatch = _applyOplogBatch(&opCtx, ops.releaseBatch());
+        auto swLastOpTimeAppliedInBatch =
+            _applyPartitionedBatch(&opCtx, batch.get(), whileApplying);
         if (swLastOpTimeAppliedInBatch.getStatus().code() == ErrorCodes::InterruptedAtShutdown) {
             // If an operation was interrupted at shutdown, fail the batch without advancing
             // appliedThrough as if this were an unclean shutdown. This ensures the stable timestamp
@@ -343,6 +400,8 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         fassertNoTrace(34437, swLastOpTimeAppliedInBatch);
         invariant(swLastOpTimeAppliedInBatch.getValue() == lastOpTimeInBatch);
 
+        TimerHolder finalizeTimer(&finalizeStageStats);
+
         // Update various things that care about our last applied optime. Tests rely on 1 happening
         // before 2 even though it isn't strictly necessary.
 
@@ -368,17 +427,48 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
 }
 
 
+/**
+ * Records the time from when the oplog writes of a batch are scheduled until the last of them has
+ * finished in the writeOplog stage stats. The batch may be partitioned on the applier thread while
+ * the writes are in progress, so they are timed by the writer threads instead.
+ */
+class OplogWritesTimer {
+public:
+    explicit OplogWritesTimer(size_t numWriters) : _numWritersLeft(numWriters) {}
+
+    void onWriterDone() {
+        if (_numWritersLeft.subtractAndFetch(1) == 0) {
+            writeOplogStageStats.record(_timer);
+        }
+    }
+
+private:
+    Timer _timer;
+    AtomicWord<size_t> _numWritersLeft;
+};
+
 // Schedules the writes to the oplog for 'ops' into threadPool. The caller must guarantee that
 // 'ops' stays valid until all scheduled work in the thread pool completes.
 void scheduleWritesToOplog(OperationContext* opCtx,
                            StorageInterface* storageInterface,
                            ThreadPool* writerPool,
                            const std::vector<OplogEntry>& ops) {
-    auto makeOplogWriterForRange = [storageInterface, &ops](size_t begin, size_t end) {
+    // We want to be able to take advantage of bulk inserts so we don't use multiple threads if it
+    // would result too little work per thread. This also ensures that we can amortize the
+    // setup/teardown overhead across many writes.
+    const size_t kMinOplogEntriesPerThread = 16;
+    const bool enoughToMultiThread =
+        ops.size() >= kMinOplogEntriesPerThread * writerPool->getStats().options.maxThreads;
+    const size_t numOplogThreads =
+        enoughToMultiThread ? writerPool->getStats().options.maxThreads : 1;
+    auto writesTimer = std::make_shared<OplogWritesTimer>(numOplogThreads);
+
+    auto makeOplogWriterForRange = [storageInterface, &ops, writesTimer](size_t begin,
+                                                                         size_t end) {
         // The returned function will be run in a separate thread after this returns. Therefore all
         // captures other than 'ops' must be by value since they will not be available. The caller
         // guarantees that 'ops' will stay in scope until the spawned threads complete.
-        return [storageInterface, &ops, begin, end](auto status) {
+        return [storageInterface, &ops, writesTimer, begin, end](auto status) {
             invariant(status);
 
             auto opCtx = cc().makeOperationContext();
@@ -386,6 +476,7 @@ void scheduleWritesToOplog(OperationContext* opCtx,
             // This code path is only executed on secondaries and initial syncing nodes, so it is
             // safe to exclude any writes from Flow Control.
             opCtx->setShouldParticipateInFlowControl(false);
+            opCtx->lockState()->setTicketLane(TicketLane::kReplication);
 
             UnreplicatedWritesBlock uwb(opCtx.get());
             ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
@@ -402,16 +493,10 @@ void scheduleWritesToOplog(OperationContext* opCtx,
             fassert(40141,
                     storageInterface->insertDocuments(
                         opCtx.get(), NamespaceString::kRsOplogNamespace, docs));
+            writesTimer->onWriterDone();
         };
     };
 
-    // We want to be able to take advantage of bulk inserts so we don't use multiple threads if it
-    // would result too little work per thread. This also ensures that we can amortize the
-    // setup/teardown overhead across many writes.
-    const size_t kMinOplogEntriesPerThread = 16;
-    const bool enoughToMultiThread =
-        ops.size() >= kMinOplogEntriesPerThread * writerPool->getStats().options.maxThreads;
-
     // Storage engines support parallel writes to the oplog because they are required to ensure that
     // oplog entries are ordered correctly, even if inserted out-of-order.
     if (!enoughToMultiThread) {
@@ -419,8 +504,6 @@ void scheduleWritesToOplog(OperationContext* opCtx,
         return;
     }
 
-
-    const size_t numOplogThreads = writerPool->getStats().options.maxThreads;
     const size_t numOpsPerThread = ops.size() / numOplogThreads;
     for (size_t thread = 0; thread < numOplogThreads; thread++) {
         size_t begin = thread * numOpsPerThread;
@@ -431,6 +514,62 @@ void scheduleWritesToOplog(OperationContext* opCtx,
 
 StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                                                       std::vector<OplogEntry> ops) {
+    PartitionedBatch batch(std::move(ops));
+    return _applyPartitionedBatch(opCtx, &batch, nullptr);
+}
+
+StatusWith<OpTime> OplogApplierImpl::applyOplogBatchPipelined_forTest(
+    OperationContext* opCtx,
+    std::vector<OplogEntry> ops,
+    std::vector<OplogEntry> nextOps,
+    bool* nextBatchPartitionedAhead) {
+    if (!nextOps.empty()) {
+        _oplogBatcher->setNextBatch_forTest(std::move(nextOps));
+    }
+
+    PartitionedBatch batch(std::move(ops));
+    std::unique_ptr<PartitionedBatch> nextBatch;
+    auto swLastOpTime = _applyPartitionedBatch(opCtx, &batch, [&](OperationContext* applierOpCtx) {
+        nextBatch = _takeAndPartitionNextBatch(applierOpCtx);
+    });
+    *nextBatchPartitionedAhead = nextBatch && nextBatch->partitioned;
+    if (!swLastOpTime.isOK() || !nextBatch) {
+        return swLastOpTime;
+    }
+    return _applyPartitionedBatch(opCtx, nextBatch.get(), nullptr);
+}
+
+std::unique_ptr<OplogApplierImpl::PartitionedBatch> OplogApplierImpl::_takeAndPartitionNextBatch(
+    OperationContext* opCtx) {
+    OplogBatch ops = _oplogBatcher->getNextBatchIfReady();
+    if (ops.empty()) {
+        return nullptr;
+    }
+
+    auto batch = std::make_unique<PartitionedBatch>(ops.releaseBatch());
+    if (containsNoCommands(batch->ops)) {
+        // None of the operations in the batch being applied are commands, so the collection
+        // properties consulted here cannot change before this batch is applied.
+        _partitionBatch(opCtx, batch.get());
+        pipelinedBatches.increment();
+    }
+    return batch;
+}
+
+void OplogApplierImpl::_partitionBatch(OperationContext* opCtx,
+                                       PartitionedBatch* batch) noexcept {
+    invariant(!batch->partitioned);
+    TimerHolder timer(&partitionStageStats);
+    batch->writerVectors.resize(_writerPool->getStats().options.maxThreads);
+    fillWriterVectors(opCtx, &batch->ops, &batch->writerVectors, &batch->derivedOps);
+    batch->partitioned = true;
+}
+
+StatusWith<OpTime> OplogApplierImpl::_applyPartitionedBatch(
+    OperationContext* opCtx,
+    PartitionedBatch* batch,
+    const std::function<void(OperationContext*)>& whileApplying) {
+    auto& ops = batch->ops;
     invariant(!ops.empty());
 
     LOGV2_DEBUG(21230,
@@ -469,18 +608,17 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
             scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
         }
 
-        // Holds 'pseudo operations' generated by secondaries to aid in replication.
-        // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
-        // Pseudo operations include:
+        // Assign the ops to writer threads while the oplog is being written, unless that was
+        // already done while the previous batch was being applied. This generates 'pseudo
+        // operations' to aid in replication, which include:
         // - applyOps operations expanded to individual ops.
         // - ops to update config.transactions. Normal writes to config.transactions in the
         //   primary don't create an oplog entry, so extract info from writes with transactions
         //   and create a pseudo oplog.
-        std::vector<std::vector<OplogEntry>> derivedOps;
-
-        std::vector<std::vector<const OplogEntry*>> writerVectors(
-            _writerPool->getStats().options.maxThreads);
-        fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        if (!batch->partitioned) {
+            _partitionBatch(opCtx, batch);
+        }
+        auto& writerVectors = batch->writerVectors;
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
@@ -501,6 +639,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         }
 
         {
+            TimerHolder applyTimer(&applyStageStats);
             std::vector<Status> statusVector(_writerPool->getStats().options.maxThreads,
                                              Status::OK());
 
@@ -531,6 +670,10 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                     });
             }
 
+            if (whileApplying) {
+                whileApplying(opCtx);
+            }
+
             _writerPool->waitForIdle();
 
             // If any of the statuses is not ok, return error.
@@ -606,6 +749,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.  Required if processing oplogs
  *      with transactions.
+ * writerAssignments - Tracks which writer each document's operations were assigned to.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
  */
 void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
@@ -613,6 +757,7 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
     std::vector<OplogEntry>* ops,
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     std::vector<std::vector<OplogEntry>>* derivedOps,
+    WriterAssignments* writerAssignments,
     SessionUpdateTracker* sessionUpdateTracker) noexcept {
 
     LogicalSessionIdMap<std::vector<OplogEntry*>> partialTxnOps;
@@ -636,6 +781,7 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                                                  &derivedOps->back(),
                                                  writerVectors,
                                                  &collPropertiesCache,
+                                                 writerAssignments,
                                                  false /*serial*/);
             }
         }
@@ -672,8 +818,13 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 // oplog and fill writers with those operations.
                 // Flush partialTxnList operations for current transaction.
                 auto& partialTxnList = partialTxnOps[*logicalSessionId];
-                _addOplogChainOpsToWriterVectors(
-                    opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+                _addOplogChainOpsToWriterVectors(opCtx,
+                                                 &partialTxnList,
+                                                 derivedOps,
+                                                 &op,
+                                                 &collPropertiesCache,
+                                                 writerAssignments,
+                                                 writerVectors);
             } else {
                 // The applyOps entry was not generated as part of a transaction.
                 invariant(!op.getPrevWriteOpTimeInTransaction());
@@ -685,6 +836,7 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                                                  &derivedOps->back(),
                                                  writerVectors,
                                                  &collPropertiesCache,
+                                                 writerAssignments,
                                                  false /*serial*/);
             }
             continue;
@@ -696,8 +848,13 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
         if (op.isPreparedCommit() && (getOptions().mode == OplogApplication::Mode::kInitialSync)) {
             auto logicalSessionId = op.getSessionId();
             auto& partialTxnList = partialTxnOps[*logicalSessionId];
-            _addOplogChainOpsToWriterVectors(
-                opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+            _addOplogChainOpsToWriterVectors(opCtx,
+                                             &partialTxnList,
+                                             derivedOps,
+                                             &op,
+                                             &collPropertiesCache,
+                                             writerAssignments,
+                                             writerVectors);
             continue;
         }
 
@@ -705,8 +862,12 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
         // migration and access blocker states.
         if (op.getNss() == NamespaceString::kTenantMigrationDonorsNamespace ||
             op.getNss() == NamespaceString::kTenantMigrationRecipientsNamespace) {
-            auto writerId = OplogApplierUtils::addToWriterVector(
-                opCtx, &op, writerVectors, &collPropertiesCache, tenantMigrationsWriterId);
+            auto writerId = OplogApplierUtils::addToWriterVector(opCtx,
+                                                                 &op,
+                                                                 writerVectors,
+                                                                 &collPropertiesCache,
+                                                                 writerAssignments,
+                                                                 tenantMigrationsWriterId);
             if (!tenantMigrationsWriterId) {
                 tenantMigrationsWriterId.emplace(writerId);
             } else {
@@ -714,7 +875,8 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
             }
             continue;
         }
-        OplogApplierUtils::addToWriterVector(opCtx, &op, writerVectors, &collPropertiesCache);
+        OplogApplierUtils::addToWriterVector(
+            opCtx, &op, writerVectors, &collPropertiesCache, writerAssignments);
     }
 }
 
@@ -725,13 +887,17 @@ void OplogApplierImpl::fillWriterVectors(
     std::vector<std::vector<OplogEntry>>* derivedOps) noexcept {
 
     SessionUpdateTracker sessionUpdateTracker;
-    _deriveOpsAndFillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    // Shared by both passes below, since the session updates flushed at the end of the batch may
+    // touch the same config.transactions documents as the ones generated along the way.
+    WriterAssignments writerAssignments;
+    _deriveOpsAndFillWriterVectors(
+        opCtx, ops, writerVectors, derivedOps, &writerAssignments, &sessionUpdateTracker);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
         _deriveOpsAndFillWriterVectors(
-            opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+            opCtx, &derivedOps->back(), writerVectors, derivedOps, &writerAssignments, nullptr);
     }
 }
 
@@ -799,6 +965,7 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
     // ShouldNotConflictWithSecondaryBatchApplicationBlock will touch the locker that has been
     // destroyed by unstash in its destructor. Thus we set the flag explicitly.
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    opCtx->lockState()->setTicketLane(TicketLane::kReplication);
 
     // Ensure future transactions read without a timestamp.
     invariant(RecoveryUnit::ReadSource::kNoTimestamp ==
@@ -44,6 +44,8 @@
 namespace mongo {
 namespace repl {
 
+class WriterAssignments;
+
 /**
  * Applies oplog entries.
  * Primarily used to apply batches of operations fetched from a sync source during steady state
@@ -79,7 +81,37 @@ public:
                                    std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                    std::vector<std::vector<OplogEntry>>* derivedOps) noexcept;
 
+    /**
+     * Applies 'ops' the way the applier loop does when batches are pipelined, with 'nextOps'
+     * waiting in the batcher unless it is empty. While the writer threads apply 'ops', the next
+     * batch is taken from the batcher and assigned to writer threads unless it contains commands.
+     * That batch is then applied as well. Sets 'nextBatchPartitionedAhead' to whether there was a
+     * next batch and it was assigned to writer threads ahead of time. Returns the optime of the
+     * last operation applied.
+     */
+    StatusWith<OpTime> applyOplogBatchPipelined_forTest(OperationContext* opCtx,
+                                                        std::vector<OplogEntry> ops,
+                                                        std::vector<OplogEntry> nextOps,
+                                                        bool* nextBatchPartitionedAhead);
+
 private:
+    /**
+     * A batch of operations together with their assignment to writer threads.
+     */
+    struct PartitionedBatch {
+        explicit PartitionedBatch(std::vector<OplogEntry> batchOps) : ops(std::move(batchOps)) {}
+
+        std::vector<OplogEntry> ops;
+
+        // Holds 'pseudo operations' generated by secondaries to aid in replication. Must stay in
+        // scope until all operations in 'ops' and 'derivedOps' have been applied.
+        std::vector<std::vector<OplogEntry>> derivedOps;
+
+        // Operations for each writer thread to apply. Empty until the batch is partitioned.
+        std::vector<std::vector<const OplogEntry*>> writerVectors;
+        bool partitioned = false;
+    };
+
     /**
      * Runs oplog application in a loop until shutdown() is called.
      * Retrieves operations from the OplogBuffer in batches that will be applied in parallel using
@@ -102,10 +134,29 @@ private:
      */
     StatusWith<OpTime> _applyOplogBatch(OperationContext* opCtx, std::vector<OplogEntry> ops);
 
+    /**
+     * Same as _applyOplogBatch(), but skips assigning operations to writer threads if 'batch' was
+     * already partitioned. If 'whileApplying' is provided, it is run on this thread while the
+     * writer threads apply the batch.
+     */
+    StatusWith<OpTime> _applyPartitionedBatch(
+        OperationContext* opCtx,
+        PartitionedBatch* batch,
+        const std::function<void(OperationContext*)>& whileApplying);
+
+    /**
+     * Takes the next batch from the batcher if one is ready and, if it contains no commands,
+     * assigns its operations to writer threads. Returns nullptr if no batch was ready.
+     */
+    std::unique_ptr<PartitionedBatch> _takeAndPartitionNextBatch(OperationContext* opCtx);
+
+    void _partitionBatch(OperationContext* opCtx, PartitionedBatch* batch) noexcept;
+
     void _deriveOpsAndFillWriterVectors(OperationContext* opCtx,
                                         std::vector<OplogEntry>* ops,
                                         std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                         std::vector<std::vector<OplogEntry>>* derivedOps,
+                                        WriterAssignments* writerAssignments,
                                         SessionUpdateTracker* sessionUpdateTracker) noexcept;
 
     // Not owned by us.
@@ -535,6 +535,115 @@ TEST_F(OplogApplierImplTest,
                   secondDerivedOp.getObject()["lastWriteOpTime"]["ts"].timestamp());
 }
 
+TEST_F(OplogApplierImplTest, FillWriterVectorsBalancesDocumentsAndKeepsEachDocumentOnOneWriter) {
+    const NamespaceString nss{"test", "foo"};
+    auto writerPool = makeReplWriterPool();
+    const size_t numWriters = writerPool->getStats().options.maxThreads;
+    const size_t opsPerWriter = 4;
+
+    std::vector<OplogEntry> ops;
+    for (int i = 0; i < int(numWriters * opsPerWriter); ++i) {
+        ops.push_back(
+            makeInsertDocumentOplogEntry({Timestamp(Seconds(1), i), 1LL}, nss, BSON("_id" << i)));
+    }
+    ops.push_back(makeDeleteDocumentOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 0)));
+
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    std::vector<std::vector<const OplogEntry*>> writerVectors(numWriters);
+    std::vector<std::vector<OplogEntry>> derivedOps;
+    oplogApplier.fillWriterVectors_forTest(_opCtx.get(), &ops, &writerVectors, &derivedOps);
+
+    // Every writer gets the same share of documents, and the delete follows the insert of the
+    // same document on its writer.
+    for (auto&& writer : writerVectors) {
+        if (std::find(writer.begin(), writer.end(), &ops.front()) == writer.end()) {
+            ASSERT_EQUALS(opsPerWriter, writer.size());
+            continue;
+        }
+        ASSERT_EQUALS(opsPerWriter + 1, writer.size());
+        ASSERT_EQUALS(&ops.front(), writer.front());
+        ASSERT_EQUALS(&ops.back(), writer.back());
+    }
+}
+
+TEST_F(OplogApplierImplTest, PipelinedBatchIsPartitionedWhileThePreviousOneIsApplied) {
+    const NamespaceString nss{"test", "foo"};
+    auto writerPool = makeReplWriterPool();
+    NoopOplogApplierObserver observer;
+    TrackOpsAppliedApplier oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    std::vector<OplogEntry> ops;
+    std::vector<OplogEntry> nextOps;
+    for (int i = 0; i < 4; ++i) {
+        ops.push_back(
+            makeInsertDocumentOplogEntry({Timestamp(Seconds(1), i), 1LL}, nss, BSON("_id" << i)));
+        nextOps.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(2), i), 1LL}, nss, BSON("_id" << 4 + i)));
+    }
+
+    bool nextBatchPartitionedAhead = false;
+    auto lastOpTime = unittest::assertGet(oplogApplier.applyOplogBatchPipelined_forTest(
+        _opCtx.get(), ops, nextOps, &nextBatchPartitionedAhead));
+    ASSERT_TRUE(nextBatchPartitionedAhead);
+    ASSERT_EQUALS(nextOps.back().getOpTime(), lastOpTime);
+
+    // Both batches are applied in full, one after the other.
+    const auto applied = oplogApplier.getOperationsApplied();
+    ASSERT_EQUALS(ops.size() + nextOps.size(), applied.size());
+    for (size_t i = 0; i < applied.size(); ++i) {
+        auto expectedSecs = i < ops.size() ? 1U : 2U;
+        ASSERT_EQUALS(expectedSecs, applied[i].getTimestamp().getSecs());
+    }
+}
+
+TEST_F(OplogApplierImplTest, PipelinedBatchWithCommandIsNotPartitionedAhead) {
+    const NamespaceString nss{"test", "foo"};
+    auto writerPool = makeReplWriterPool();
+    NoopOplogApplierObserver observer;
+    TrackOpsAppliedApplier oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    std::vector<OplogEntry> ops{
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 0))};
+    std::vector<OplogEntry> nextOps{makeCreateCollectionOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, NamespaceString("test", "bar"))};
+
+    // The command may change the collection properties used to pick writers, so its batch is only
+    // partitioned once the previous batch has been applied.
+    bool nextBatchPartitionedAhead = true;
+    auto lastOpTime = unittest::assertGet(oplogApplier.applyOplogBatchPipelined_forTest(
+        _opCtx.get(), ops, nextOps, &nextBatchPartitionedAhead));
+    ASSERT_FALSE(nextBatchPartitionedAhead);
+    ASSERT_EQUALS(nextOps.back().getOpTime(), lastOpTime);
+    ASSERT_EQUALS(2U, oplogApplier.getOperationsApplied().size());
+}
+
 class MultiOplogEntryOplogApplierImplTest : public OplogApplierImplTest {
 public:
     MultiOplogEntryOplogApplierImplTest()
@@ -1952,6 +2061,49 @@ TEST_F(OplogApplierImplTest,
     ASSERT_EQUALS(1U, numFailedGroupedInserts);
 }
 
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncAppliesUpdatesAndDeletesOnSameCollectionInOneTransaction) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollectionWithUuid(_opCtx.get(), nss);
+    ASSERT_OK(runOpsSteadyState(
+        {makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1)),
+         makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2))}));
+
+    // Records, for each update and delete, how many of them had been applied by the time its
+    // storage transaction committed.
+    int numWrites = 0;
+    std::vector<int> numWritesAtCommit;
+    auto recordWrite = [&](OperationContext* opCtx) {
+        ++numWrites;
+        opCtx->recoveryUnit()->onCommit(
+            [&](boost::optional<Timestamp>) { numWritesAtCommit.push_back(numWrites); });
+    };
+    _opObserver->onUpdateFn = [&](OperationContext* opCtx, const OplogUpdateEntryArgs&) {
+        recordWrite(opCtx);
+    };
+    _opObserver->onDeleteFn = [&](OperationContext* opCtx,
+                                  const NamespaceString&,
+                                  OptionalCollectionUUID,
+                                  StmtId,
+                                  const OpObserver::OplogDeleteEntryArgs&) { recordWrite(opCtx); };
+
+    ASSERT_OK(runOpsSteadyState(
+        {makeUpdateDocumentOplogEntry(
+             {Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1)),
+         makeUpdateDocumentOplogEntry(
+             {Timestamp(Seconds(4), 0), 1LL}, nss, BSON("_id" << 2), BSON("_id" << 2 << "x" << 2)),
+         makeDeleteDocumentOplogEntry({Timestamp(Seconds(5), 0), 1LL}, nss, BSON("_id" << 1))}));
+
+    ASSERT_EQUALS(3U, numWritesAtCommit.size());
+    for (auto numWritesBeforeCommit : numWritesAtCommit) {
+        ASSERT_EQUALS(3, numWritesBeforeCommit);
+    }
+
+    CollectionReader collectionReader(_opCtx.get(), nss);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2 << "x" << 2), unittest::assertGet(collectionReader.next()));
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, collectionReader.next().getStatus());
+}
+
 TEST_F(OplogApplierImplTest, ApplyGroupIgnoresUpdateOperationIfDocumentIsMissingFromSyncSource) {
     TestApplyOplogGroupApplier oplogApplier(
         nullptr, nullptr, OplogApplier::Options(OplogApplication::Mode::kInitialSync));
@@ -39,6 +39,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/repl/oplog_applier_utils.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/update_delete_group.h"
 #include "mongo/db/stats/counters.h"
 
 #include "mongo/logv2/log.h"
@@ -74,6 +75,32 @@ CachedCollectionProperties::getCollectionPropertiesImpl(OperationContext* opCtx,
     return collProperties;
 }
 
+uint32_t WriterAssignments::getWriterId(
+    uint32_t dependencyKey,
+    const std::vector<std::vector<const OplogEntry*>>& writerVectors,
+    boost::optional<uint32_t> forceWriterId) {
+    if (forceWriterId) {
+        // Later operations with this key follow the forced one, unless an earlier operation
+        // already placed the key elsewhere.
+        _writerIds.emplace(dependencyKey, *forceWriterId);
+        return *forceWriterId;
+    }
+
+    auto it = _writerIds.find(dependencyKey);
+    if (it != _writerIds.end()) {
+        return it->second;
+    }
+
+    uint32_t writerId = 0;
+    for (uint32_t i = 1; i < writerVectors.size(); ++i) {
+        if (writerVectors[i].size() < writerVectors[writerId].size()) {
+            writerId = i;
+        }
+    }
+    _writerIds.emplace(dependencyKey, writerId);
+    return writerId;
+}
+
 void OplogApplierUtils::processCrudOp(OperationContext* opCtx,
                                       OplogEntry* op,
                                       uint32_t* hash,
@@ -106,6 +133,7 @@ uint32_t OplogApplierUtils::addToWriterVector(
     OplogEntry* op,
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     CachedCollectionProperties* collPropertiesCache,
+    WriterAssignments* writerAssignments,
     boost::optional<uint32_t> forceWriterId) {
     auto hashedNs = StringMapHasher().hashed_key(op->getNss().ns());
 
@@ -118,7 +146,14 @@ uint32_t OplogApplierUtils::addToWriterVector(
         processCrudOp(opCtx, op, &hash, &hashedNs, collPropertiesCache);
 
     const uint32_t numWriters = writerVectors->size();
-    auto writerId = (forceWriterId ? *forceWriterId : hash) % numWriters;
+    uint32_t writerId;
+    if (writerAssignments) {
+        // The hash identifies the document, or the whole collection if it is capped, so it is
+        // exactly the set of operations that must be applied in order.
+        writerId = writerAssignments->getWriterId(hash, *writerVectors, forceWriterId);
+    } else {
+        writerId = (forceWriterId ? *forceWriterId : hash) % numWriters;
+    }
     auto& writer = (*writerVectors)[writerId];
     if (writer.empty()) {
         writer.reserve(8);  // Skip a few growth rounds
@@ -148,13 +183,14 @@ void OplogApplierUtils::addDerivedOps(OperationContext* opCtx,
                                       std::vector<OplogEntry>* derivedOps,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       bool serial) {
     boost::optional<uint32_t>
         serialWriterId;  // Used to determine which writer vector to assign serial ops.
 
     for (auto&& op : *derivedOps) {
-        auto writerId =
-            addToWriterVector(opCtx, &op, writerVectors, collPropertiesCache, serialWriterId);
+        auto writerId = addToWriterVector(
+            opCtx, &op, writerVectors, collPropertiesCache, writerAssignments, serialWriterId);
         if (serial && !serialWriterId) {
             serialWriterId.emplace(writerId);
         }
@@ -285,6 +321,8 @@ Status OplogApplierUtils::applyOplogBatchCommon(
     // mix up the current order of oplog entries within the same namespace (thus *stable* sort).
     stableSortByNamespace(ops);
     InsertGroup insertGroup(ops, opCtx, oplogApplicationMode, applyOplogEntryOrGroupedInserts);
+    UpdateDeleteGroup updateDeleteGroup(
+        ops, opCtx, oplogApplicationMode, applyOplogEntryOrGroupedInserts);
 
     for (auto it = ops->cbegin(); it != ops->cend(); ++it) {
         const OplogEntry& entry = **it;
@@ -297,6 +335,13 @@ Status OplogApplierUtils::applyOplogBatchCommon(
             continue;
         }
 
+        // Likewise for a group of updates and deletes applied in a single storage transaction.
+        groupResult = updateDeleteGroup.groupAndApplyUpdatesAndDeletes(it);
+        if (groupResult.isOK()) {
+            it = groupResult.getValue();
+            continue;
+        }
+
         // If we didn't create a group, try to apply the op individually.
         try {
             const Status status =
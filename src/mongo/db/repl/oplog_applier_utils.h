@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/repl/insert_group.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class CollatorInterface;
@@ -58,6 +59,28 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Tracks which writer each group of dependent operations in a batch has been assigned to.
+ * Operations with the same dependency key, i.e. those on the same document or on the same capped
+ * collection, must be applied in order by a single writer. Every other group goes to whichever
+ * writer has the fewest operations so far, so that a few busy documents or capped collections do
+ * not share a writer with unrelated work just because their hashes collide.
+ */
+class WriterAssignments {
+public:
+    /**
+     * Returns the writer for an operation with 'dependencyKey': 'forceWriterId' if provided,
+     * otherwise the writer of an earlier operation with the same key, otherwise the least loaded
+     * writer.
+     */
+    uint32_t getWriterId(uint32_t dependencyKey,
+                         const std::vector<std::vector<const OplogEntry*>>& writerVectors,
+                         boost::optional<uint32_t> forceWriterId);
+
+private:
+    stdx::unordered_map<uint32_t, uint32_t> _writerIds;
+};
+
 /**
  * This class contains some static methods common to ordinary oplog application and oplog
  * application as part of tenant migration.
@@ -85,22 +108,25 @@ public:
 
     /**
      * Adds a single oplog entry to the appropriate writer vector.  Returns the index of the
-     * writer vector the entry was written to.
+     * writer vector the entry was written to. If 'writerAssignments' is provided, the entry is
+     * placed according to the dependencies tracked there rather than purely by its hash.
      */
     static uint32_t addToWriterVector(OperationContext* opCtx,
                                       OplogEntry* op,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       boost::optional<uint32_t> forceWriterId = boost::none);
     /**
      * Adds a set of derivedOps to writerVectors.
-     * If `serial` is true, assign all derived operations to the writer vector corresponding to the
-     * hash of the first operation in `derivedOps`.
+     * If `serial` is true, assign all derived operations to the writer vector the first operation
+     * in `derivedOps` was assigned to.
      */
     static void addDerivedOps(OperationContext* opCtx,
                               std::vector<OplogEntry>* derivedOps,
                               std::vector<std::vector<const OplogEntry*>>* writerVectors,
                               CachedCollectionProperties* collPropertiesCache,
+                              WriterAssignments* writerAssignments,
                               bool serial);
 
     /**
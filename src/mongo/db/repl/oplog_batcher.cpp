@@ -70,6 +70,29 @@ OplogBatch OplogBatcher::getNextBatch(Seconds maxWaitTime) {
     return ops;
 }
 
+OplogBatch OplogBatcher::getNextBatchIfReady() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    // Shutdown and drain signals are only ever carried by empty batches.
+    if (_ops.empty()) {
+        return OplogBatch(0);
+    }
+
+    OplogBatch ops = std::move(_ops);
+    _ops = OplogBatch(0);
+    _cv.notify_all();
+    return ops;
+}
+
+void OplogBatcher::setNextBatch_forTest(std::vector<OplogEntry> ops) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_ops.empty());
+    _ops = OplogBatch(ops.size());
+    for (auto&& op : ops) {
+        _ops.emplace_back(std::move(op));
+    }
+    _cv.notify_all();
+}
+
 void OplogBatcher::startup(StorageInterface* storageInterface) {
     _thread = std::make_unique<stdx::thread>([this, storageInterface] { _run(storageInterface); });
 }
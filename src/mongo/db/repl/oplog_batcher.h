@@ -151,6 +151,19 @@ public:
      */
     OplogBatch getNextBatch(Seconds maxWaitTime);
 
+    /**
+     * Returns the next batch of oplog entries if one is already waiting, without blocking.
+     * Otherwise returns an empty batch and leaves any shutdown or drain signal in place for the
+     * next call to getNextBatch().
+     */
+    OplogBatch getNextBatchIfReady();
+
+    /**
+     * Makes 'ops' the batch waiting for the applier, as if the batcher thread had just produced it.
+     * No other batch may be waiting.
+     */
+    void setNextBatch_forTest(std::vector<OplogEntry> ops);
+
     /**
      * Starts up a thread to continuously pull from the OplogBuffer into the OplogBatcher's oplog
      * batch.
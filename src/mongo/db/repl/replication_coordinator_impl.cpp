@@ -69,6 +69,8 @@
 #include "mongo/db/repl/check_quorum_for_config_change.h"
 #include "mongo/db/repl/data_replicator_external_state_initial_sync.h"
 #include "mongo/db/repl/hello_response.h"
+#include "mongo/db/repl/initial_syncer.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
 #include "mongo/db/repl/isself.h"
 #include "mongo/db/repl/last_vote.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -776,7 +778,7 @@ void ReplicationCoordinatorImpl::_startDataReplication(OperationContext* opCtx,
         LOGV2_DEBUG(4853000, 1, "initial sync complete.");
     };
 
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     try {
         {
             // Must take the lock to set _initialSyncer, but not call it.
@@ -785,20 +787,25 @@ void ReplicationCoordinatorImpl::_startDataReplication(OperationContext* opCtx,
                 LOGV2(21326, "Initial Sync not starting because replication is shutting down");
                 return;
             }
-            initialSyncerCopy = std::make_shared<InitialSyncer>(
-                createInitialSyncerOptions(this, _externalState.get()),
-                std::make_unique<DataReplicatorExternalStateInitialSync>(this,
-                                                                         _externalState.get()),
-                _externalState->getDbWorkThreadPool(),
-                _storage,
-                _replicationProcess,
-                onCompletion);
+            initialSyncerCopy =
+                uassertStatusOK(InitialSyncerFactory::get(_service)->createInitialSyncer(
+                    initialSyncMethod,
+                    createInitialSyncerOptions(this, _externalState.get()),
+                    std::make_unique<DataReplicatorExternalStateInitialSync>(this,
+                                                                             _externalState.get()),
+                    _externalState->getDbWorkThreadPool(),
+                    _storage,
+                    _replicationProcess,
+                    onCompletion));
             _initialSyncer = initialSyncerCopy;
         }
         // InitialSyncer::startup() must be called outside lock because it uses features (eg.
         // setting the initial sync flag) which depend on the ReplicationCoordinatorImpl.
         uassertStatusOK(initialSyncerCopy->startup(opCtx, numInitialSyncAttempts.load()));
-        LOGV2_DEBUG(4280514, 1, "Initial sync started");
+        LOGV2_DEBUG(4280514,
+                    1,
+                    "Initial sync started",
+                    "initialSyncMethod"_attr = initialSyncerCopy->getInitialSyncMethod());
     } catch (const DBException& e) {
         auto status = e.toStatus();
         LOGV2(21327,
@@ -857,6 +864,11 @@ void ReplicationCoordinatorImpl::startup(OperationContext* opCtx,
     invariant(_settings.usingReplSets());
     invariant(!ReplSettings::shouldRecoverFromOplogAsStandalone());
 
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "Initial sync method '" << initialSyncMethod
+                          << "' set by 'initialSyncMethod' is not available in this build",
+            InitialSyncerFactory::get(_service)->isRegistered(initialSyncMethod));
+
     _storage->initializeStorageControlsForReplication(opCtx->getServiceContext());
 
     {
@@ -935,7 +947,7 @@ void ReplicationCoordinatorImpl::shutdown(OperationContext* opCtx) {
     LOGV2(21328, "Shutting down replication subsystems");
 
     // Used to shut down outside of the lock.
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     {
         stdx::unique_lock<Latch> lk(_mutex);
         fassert(28533, !_inShutdown);
@@ -2991,7 +3003,7 @@ Status ReplicationCoordinatorImpl::processReplSetGetStatus(
 
     BSONObj initialSyncProgress;
     if (responseStyle == ReplSetGetStatusResponseStyle::kInitialSync) {
-        std::shared_ptr<InitialSyncer> initialSyncerCopy;
+        std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
         {
             stdx::lock_guard<Latch> lk(_mutex);
             initialSyncerCopy = _initialSyncer;
@@ -3161,7 +3173,7 @@ Status ReplicationCoordinatorImpl::processReplSetSyncFrom(OperationContext* opCt
                                                           const HostAndPort& target,
                                                           BSONObjBuilder* resultObj) {
     Status result(ErrorCodes::InternalError, "didn't set status in prepareSyncFromResponse");
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _topCoord->prepareSyncFromResponse(target, resultObj, &result);
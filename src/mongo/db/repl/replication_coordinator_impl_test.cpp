@@ -46,9 +46,11 @@
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/repl/data_replicator_external_state_impl.h"
 #include "mongo/db/repl/hello_response.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/repl_set_heartbeat_args_v1.h"
 #include "mongo/db/repl/repl_set_request_votes_args.h"
@@ -239,6 +241,24 @@ TEST_F(ReplCoordTest, NodeEntersStartupStateWhenStartingUpWithNoLocalConfig) {
     ASSERT_EQUALS(MemberState::RS_STARTUP, getReplCoord()->getMemberState().s);
 }
 
+TEST_F(ReplCoordTest, NodeFailsToStartWithAnInitialSyncMethodThatIsNotAvailable) {
+    const auto originalInitialSyncMethod = initialSyncMethod;
+    ON_BLOCK_EXIT([&] { initialSyncMethod = originalInitialSyncMethod; });
+
+    initialSyncMethod = "notAnInitialSyncMethod";
+    ASSERT_THROWS_CODE(start(), AssertionException, ErrorCodes::InvalidOptions);
+}
+
+TEST_F(ReplCoordTest, NodeStartsWithTheFileCopyBasedInitialSyncMethod) {
+    const auto originalInitialSyncMethod = initialSyncMethod;
+    ON_BLOCK_EXIT([&] { initialSyncMethod = originalInitialSyncMethod; });
+
+    initialSyncMethod = "fileCopyBased";
+    ASSERT_TRUE(InitialSyncerFactory::get(getServiceContext())->isRegistered(initialSyncMethod));
+    start();
+    ASSERT_EQUALS(MemberState::RS_STARTUP, getReplCoord()->getMemberState().s);
+}
+
 TEST_F(ReplCoordTest, NodeReturnsInvalidReplicaSetConfigWhenInitiatedWithAnEmptyConfig) {
     init("mySet");
     start(HostAndPort("node1", 12345));
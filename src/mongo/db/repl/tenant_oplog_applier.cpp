@@ -879,6 +879,7 @@ std::vector<std::vector<const OplogEntry*>> TenantOplogApplier::_fillWriterVecto
     std::vector<std::vector<const OplogEntry*>> writerVectors(
         _writerPool->getStats().options.maxThreads);
     CachedCollectionProperties collPropertiesCache;
+    WriterAssignments writerAssignments;
 
     for (auto&& op : batch->ops) {
         // If the operation's optime is before or the same as the beginApplyingAfterOpTime we don't
@@ -913,11 +914,12 @@ std::vector<std::vector<const OplogEntry*>> TenantOplogApplier::_fillWriterVecto
                                              expansions,
                                              &writerVectors,
                                              &collPropertiesCache,
+                                             &writerAssignments,
                                              isTransactionWithCommand /* serial */);
         } else {
             // Add a single op to the writer vectors.
             OplogApplierUtils::addToWriterVector(
-                opCtx, &op.entry, &writerVectors, &collPropertiesCache);
+                opCtx, &op.entry, &writerVectors, &collPropertiesCache, &writerAssignments);
         }
     }
     return writerVectors;
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/update_delete_group.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/repl/oplog_applier_utils.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Must not let a single storage transaction grow too large.
+const auto kUpdateDeleteGroupMaxGroupSize = write_ops::insertVectorMaxBytes;
+
+// Limit number of ops in a single group.
+constexpr auto kUpdateDeleteGroupMaxOpCount = 64;
+
+/**
+ * Updates and deletes that write a retryable findAndModify image also write to
+ * config.image_collection, so they are always applied on their own.
+ */
+bool isGroupable(const OplogEntry& entry) {
+    auto opType = entry.getOpType();
+    return (opType == OpTypeEnum::kUpdate || opType == OpTypeEnum::kDelete) &&
+        !entry.getNeedsRetryImage();
+}
+
+size_t entrySize(const OplogEntry& entry) {
+    const auto& o2 = entry.getObject2();
+    return entry.getObject().objsize() + (o2 ? o2->objsize() : 0);
+}
+
+}  // namespace
+
+UpdateDeleteGroup::UpdateDeleteGroup(std::vector<const OplogEntry*>* ops,
+                                     OperationContext* opCtx,
+                                     UpdateDeleteGroup::Mode mode,
+                                     ApplyFunc applyOplogEntryOrGroupedInserts)
+    : _doNotGroupBeforePoint(ops->cbegin()),
+      _end(ops->cend()),
+      _opCtx(opCtx),
+      _mode(mode),
+      _applyOplogEntryOrGroupedInserts(applyOplogEntryOrGroupedInserts) {}
+
+StatusWith<UpdateDeleteGroup::ConstIterator> UpdateDeleteGroup::groupAndApplyUpdatesAndDeletes(
+    ConstIterator it) noexcept {
+    const auto& entry = **it;
+
+    // The following conditions must be met before attempting to group the oplog entries starting
+    // at 'it':
+    // 1) The CRUD operation must be an update or a delete that does not write an image;
+    // 2) We are in steady state replication, where every write is timestamped with the timestamp
+    //    of its oplog entry;
+    // 3) We have not attempted to group this operation during a previous call to this function.
+    if (!isGroupable(entry)) {
+        return Status(ErrorCodes::TypeMismatch, "Can only group update and delete operations.");
+    }
+    if (_mode != Mode::kSecondary || !oplogApplicationGroupUpdatesAndDeletes.load()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "Grouping update and delete operations is not enabled.");
+    }
+    if (it <= _doNotGroupBeforePoint) {
+        return Status(ErrorCodes::InvalidPath,
+                      "Cannot group an operation that we previously attempted to group.");
+    }
+
+    size_t groupSize = entrySize(entry);
+    auto opCount = std::vector<const OplogEntry*>::size_type(1);
+    const auto& groupNamespace = entry.getNss();
+    const auto& groupUuid = entry.getUuid();
+
+    // Find the first op that can't be added to the current group.
+    auto endOfGroupableOpsIterator =
+        std::find_if(it + 1, _end, [&](const OplogEntry* nextEntry) -> bool {
+            groupSize += entrySize(*nextEntry);
+            opCount += 1;
+
+            return !isGroupable(*nextEntry) || nextEntry->getNss() != groupNamespace ||
+                nextEntry->getUuid() != groupUuid || groupSize > kUpdateDeleteGroupMaxGroupSize ||
+                opCount > kUpdateDeleteGroupMaxOpCount;
+        });
+
+    // See if we were able to create a group that contains more than a single op.
+    if (std::distance(it, endOfGroupableOpsIterator) == 1) {
+        return Status(ErrorCodes::NoSuchKey,
+                      "Not able to create a group with more than a single operation");
+    }
+
+    try {
+        writeConflictRetry(_opCtx, "applyGroupedUpdatesAndDeletes", groupNamespace.ns(), [&] {
+            // Take the collection lock up front so that it is held for the whole transaction.
+            AutoGetCollection autoColl(
+                _opCtx,
+                OplogApplierUtils::getNsOrUUID(groupNamespace, entry),
+                fixLockModeForSystemDotViewsChanges(groupNamespace, MODE_IX));
+
+            // Operations applied inside a wrapping WriteUnitOfWork do not timestamp their own
+            // writes, so give each one the timestamp of its oplog entry here.
+            WriteUnitOfWork wuow(_opCtx);
+            for (auto groupIt = it; groupIt != endOfGroupableOpsIterator; ++groupIt) {
+                const OplogEntry* op = *groupIt;
+                uassertStatusOK(_opCtx->recoveryUnit()->setTimestamp(op->getTimestamp()));
+                uassertStatusOK(_applyOplogEntryOrGroupedInserts(_opCtx, op, _mode));
+            }
+            wuow.commit();
+        });
+        return endOfGroupableOpsIterator - 1;
+    } catch (...) {
+        // Fall through to the application of individual ops, which reports any error that
+        // persists.
+        auto status = exceptionToStatus();
+        LOGV2_DEBUG(5754730,
+                    2,
+                    "Error applying updates and deletes as a group. Applying them individually",
+                    "firstOperation"_attr = redact(entry.toBSONForLogging()),
+                    "numOperations"_attr = std::distance(it, endOfGroupableOpsIterator),
+                    "error"_attr = redact(status));
+
+        // Avoid quadratic run time by not retrying until we are beyond this group of ops.
+        _doNotGroupBeforePoint = endOfGroupableOpsIterator - 1;
+
+        return status;
+    }
+
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/repl/insert_group.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Groups consecutive update and delete operations on the same collection and applies them in a
+ * single storage transaction, with each write timestamped with its own oplog entry's timestamp.
+ * Only used in steady state replication. If any operation in a group fails, the whole group is
+ * rolled back and its operations are left to be applied individually.
+ */
+class UpdateDeleteGroup {
+    UpdateDeleteGroup(const UpdateDeleteGroup&) = delete;
+    UpdateDeleteGroup& operator=(const UpdateDeleteGroup&) = delete;
+
+public:
+    using ConstIterator = InsertGroup::ConstIterator;
+    using Mode = OplogApplication::Mode;
+    using ApplyFunc = InsertGroup::ApplyFunc;
+
+    UpdateDeleteGroup(std::vector<const OplogEntry*>* ops,
+                      OperationContext* opCtx,
+                      Mode mode,
+                      ApplyFunc applyOplogEntryOrGroupedInserts);
+
+    /**
+     * Attempts to group update and delete operations starting at 'iter'.
+     * If the group is applied successfully, returns the iterator to the last operation included
+     * in the group.
+     */
+    StatusWith<ConstIterator> groupAndApplyUpdatesAndDeletes(ConstIterator iter) noexcept;
+
+private:
+    // Marks the final op of a failed group so that we do not retry grouping any op before it.
+    ConstIterator _doNotGroupBeforePoint;
+
+    // Used for constructing search bounds when grouping operations.
+    ConstIterator _end;
+
+    // Passed to _applyOplogEntryOrGroupedInserts when applying each operation in a group.
+    OperationContext* _opCtx;
+    Mode _mode;
+
+    // The function that does the actual oplog application.
+    ApplyFunc _applyOplogEntryOrGroupedInserts;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -113,6 +113,28 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Moves forward over up to 'maxRecords' records and replaces the contents of 'out' with them,
+     * in the same order in which next() would have returned them. Fewer records, possibly none,
+     * are returned only if EOF is reached, except that the default implementation returns at most
+     * one record per call. Engines which can amortize the per-record cost of a scan should
+     * override it.
+     *
+     * Unowned data of the returned records is valid until the next call to any method on this
+     * interface, just like the data returned by next(). If nextBatch() throws a
+     * WriteConflictException, none of the records it read are considered returned and the
+     * cursor's position is the same as before the call.
+     */
+    virtual void nextBatch(std::vector<Record>* out, size_t maxRecords) {
+        out->clear();
+        if (maxRecords == 0) {
+            return;
+        }
+        if (auto record = next()) {
+            out->push_back(std::move(*record));
+        }
+    }
+
     //
     // Saving and restoring state
     //
@@ -0,0 +1,235 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/staged_data_files.h"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <vector>
+
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+using boost::filesystem::path;
+
+// Created in the staging directory once every file has been staged.
+const std::string kCompleteMarkerName = "_staging_complete";
+
+// Created in the staging directory once the files the staged files replace have been removed.
+const std::string kApplyingMarkerName = "_staging_applying";
+
+bool isMarker(const path& relativePath) {
+    return relativePath == kCompleteMarkerName || relativePath == kApplyingMarkerName;
+}
+
+/**
+ * Returns true for the files the storage engine keeps its metadata, log and tables in, which are
+ * the files that staged files replace.
+ */
+bool isStorageEngineFile(const path& file) {
+    return StringData(file.filename().string()).startsWith("WiredTiger") ||
+        file.extension() == ".wt";
+}
+
+/**
+ * Removes the storage engine files in 'dir' and its subdirectories, except for those in 'skip',
+ * along with the subdirectories this leaves empty. Returns true if anything was removed.
+ */
+bool removeStorageEngineFiles(const path& dir, const path& skip) {
+    // Removing entries while iterating a directory is unspecified, so list it first.
+    std::vector<path> entries{boost::filesystem::directory_iterator(dir),
+                              boost::filesystem::directory_iterator()};
+    bool removedAny = false;
+    for (const auto& entry : entries) {
+        if (entry == skip) {
+            continue;
+        }
+        if (boost::filesystem::is_directory(entry)) {
+            if (removeStorageEngineFiles(entry, skip) && boost::filesystem::is_empty(entry)) {
+                boost::filesystem::remove(entry);
+                removedAny = true;
+            }
+        } else if (isStorageEngineFile(entry)) {
+            LOGV2_DEBUG(5754738,
+                        1,
+                        "Removing data file replaced by staged data files",
+                        "file"_attr = entry.generic_string());
+            boost::filesystem::remove(entry);
+            removedAny = true;
+        }
+    }
+    return removedAny;
+}
+
+/**
+ * Appends the paths, relative to the staging directory, of the staged files in 'dir' to 'files'.
+ */
+void listStagedFiles(const path& stagingDir, const path& dir, std::vector<path>* files) {
+    for (boost::filesystem::directory_iterator it(stagingDir / dir), end; it != end; ++it) {
+        const auto relativePath = dir / it->path().filename();
+        if (boost::filesystem::is_directory(it->path())) {
+            listStagedFiles(stagingDir, relativePath, files);
+        } else if (!isMarker(relativePath)) {
+            files->push_back(relativePath);
+        }
+    }
+}
+
+}  // namespace
+
+StagedDataFiles::StagedDataFiles(const std::string& dbpath)
+    : _dbpath(dbpath), _stagingDir(_dbpath / kStagingDirName.toString()) {}
+
+Status StagedDataFiles::reset() const {
+    auto status = remove();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directory(_stagingDir, ec);
+    if (ec) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to create directory " << _stagingDir.generic_string()
+                              << ": " << ec.message()};
+    }
+    return fsyncParentDirectory(_stagingDir);
+}
+
+StatusWith<path> StagedDataFiles::prepareFile(StringData relativePath) const {
+    const path relative(relativePath.toString());
+    bool leavesDbpath = relative.empty() || relative.has_root_path() || isMarker(relative);
+    for (const auto& part : relative) {
+        leavesDbpath = leavesDbpath || part == "..";
+    }
+    if (leavesDbpath) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Cannot stage a data file at '" << relativePath
+                              << "', which is not a file path relative to the dbpath"};
+    }
+
+    const auto file = _stagingDir / relative;
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(file.parent_path(), ec);
+    if (ec) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to create directory "
+                              << file.parent_path().generic_string() << ": " << ec.message()};
+    }
+    return file;
+}
+
+Status StagedDataFiles::markComplete() const {
+    return _writeMarker(_stagingDir / kCompleteMarkerName);
+}
+
+Status StagedDataFiles::remove() const {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(_stagingDir, ec);
+    if (ec) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to remove staged data files in "
+                              << _stagingDir.generic_string() << ": " << ec.message()};
+    }
+    return fsyncParentDirectory(_stagingDir);
+}
+
+bool StagedDataFiles::applyAtStartup() const {
+    if (!boost::filesystem::exists(_stagingDir)) {
+        return false;
+    }
+
+    const auto completeMarker = _stagingDir / kCompleteMarkerName;
+    const auto applyingMarker = _stagingDir / kApplyingMarkerName;
+    if (!boost::filesystem::exists(completeMarker) && !boost::filesystem::exists(applyingMarker)) {
+        LOGV2(5754739,
+              "Removing incomplete staged data files",
+              "stagingDir"_attr = _stagingDir.generic_string());
+        uassertStatusOK(remove());
+        return false;
+    }
+
+    LOGV2(5754740,
+          "Replacing the data files of the dbpath with staged data files",
+          "stagingDir"_attr = _stagingDir.generic_string());
+    try {
+        if (!boost::filesystem::exists(applyingMarker)) {
+            removeStorageEngineFiles(_dbpath, _stagingDir);
+            uassertStatusOK(_writeMarker(applyingMarker));
+        }
+
+        std::vector<path> files;
+        listStagedFiles(_stagingDir, path(), &files);
+        for (const auto& file : files) {
+            const auto target = _dbpath / file;
+            boost::filesystem::create_directories(target.parent_path());
+            uassertStatusOK(fsyncRename(_stagingDir / file, target));
+        }
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        uasserted(ErrorCodes::FileStreamFailed,
+                  str::stream() << "Failed to replace the data files of "
+                                << _dbpath.generic_string()
+                                << " with staged data files: " << ex.what());
+    }
+    uassertStatusOK(remove());
+
+    LOGV2(5754741, "Replaced the data files of the dbpath with staged data files");
+    return true;
+}
+
+Status StagedDataFiles::_writeMarker(const path& marker) const {
+    boost::filesystem::ofstream fileStream(marker);
+    fileStream << "This file indicates the state of the data files staged in this directory.";
+    fileStream.close();
+    if (fileStream.fail()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write to file " << marker.generic_string() << ": "
+                              << errnoWithDescription()};
+    }
+
+    auto status = fsyncFile(marker);
+    if (!status.isOK()) {
+        return status;
+    }
+    return fsyncParentDirectory(marker);
+}
+
+}  // namespace mongo
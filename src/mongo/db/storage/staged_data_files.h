@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * Data files staged in a directory of the dbpath to replace the data files of the storage engine
+ * the next time it starts. File copy based initial sync stages the files it copies from its sync
+ * source this way, because they can't replace the files of the storage engine while it runs.
+ *
+ * Staged files are only applied once they are marked complete. Applying them first removes the
+ * storage engine's files from the dbpath and then moves the staged files into their place; a
+ * second marker records that the old files are gone, so that a node which stops part way through
+ * finishes moving the staged files on its next startup rather than removing the ones already moved.
+ */
+class StagedDataFiles {
+public:
+    static constexpr StringData kStagingDirName = "_staged_data_files"_sd;
+
+    explicit StagedDataFiles(const std::string& dbpath);
+
+    const boost::filesystem::path& getStagingDir() const {
+        return _stagingDir;
+    }
+
+    /**
+     * Removes any files staged before and creates an empty staging directory.
+     */
+    Status reset() const;
+
+    /**
+     * Returns the path to stage the file at 'relativePath' in the dbpath at, creating its parent
+     * directories. Fails with BadValue if 'relativePath' is absolute or leaves the dbpath.
+     */
+    StatusWith<boost::filesystem::path> prepareFile(StringData relativePath) const;
+
+    /**
+     * Marks the staged files complete, so that the next startup applies them. The staged files
+     * must already have been flushed to disk.
+     */
+    Status markComplete() const;
+
+    /**
+     * Removes the staging directory and everything in it.
+     */
+    Status remove() const;
+
+    /**
+     * Applies complete staged files, and removes incomplete ones. Must be called with the lock file
+     * of the dbpath held, before the storage engine opens its files. Returns true if staged files
+     * replaced the data files of the dbpath.
+     */
+    bool applyAtStartup() const;
+
+private:
+    Status _writeMarker(const boost::filesystem::path& marker) const;
+
+    boost::filesystem::path _dbpath;
+    boost::filesystem::path _stagingDir;
+};
+
+}  // namespace mongo
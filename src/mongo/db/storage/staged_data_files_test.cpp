@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <string>
+
+#include "mongo/db/storage/staged_data_files.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::filesystem::exists;
+using boost::filesystem::path;
+using unittest::TempDir;
+
+void writeFile(const path& file, const std::string& contents) {
+    boost::filesystem::create_directories(file.parent_path());
+    boost::filesystem::ofstream(file) << contents;
+}
+
+std::string readFile(const path& file) {
+    std::string contents;
+    boost::filesystem::ifstream(file) >> contents;
+    return contents;
+}
+
+void stageFile(const StagedDataFiles& stagedFiles,
+               const std::string& relativePath,
+               const std::string& contents) {
+    writeFile(unittest::assertGet(stagedFiles.prepareFile(relativePath)), contents);
+}
+
+TEST(StagedDataFilesTest, NothingIsAppliedWithoutStagedFiles) {
+    TempDir tempDir("StagedDataFilesTest_NothingIsAppliedWithoutStagedFiles");
+    const path dbpath(tempDir.path());
+    writeFile(dbpath / "collection-1.wt", "old");
+
+    ASSERT_FALSE(StagedDataFiles(tempDir.path()).applyAtStartup());
+    ASSERT_EQ("old", readFile(dbpath / "collection-1.wt"));
+}
+
+TEST(StagedDataFilesTest, IncompleteStagedFilesAreRemoved) {
+    TempDir tempDir("StagedDataFilesTest_IncompleteStagedFilesAreRemoved");
+    const path dbpath(tempDir.path());
+    writeFile(dbpath / "collection-1.wt", "old");
+
+    StagedDataFiles stagedFiles(tempDir.path());
+    ASSERT_OK(stagedFiles.reset());
+    stageFile(stagedFiles, "collection-1.wt", "new");
+
+    ASSERT_FALSE(stagedFiles.applyAtStartup());
+    ASSERT_FALSE(exists(stagedFiles.getStagingDir()));
+    ASSERT_EQ("old", readFile(dbpath / "collection-1.wt"));
+}
+
+TEST(StagedDataFilesTest, CompleteStagedFilesReplaceTheStorageEngineFiles) {
+    TempDir tempDir("StagedDataFilesTest_CompleteStagedFilesReplaceTheStorageEngineFiles");
+    const path dbpath(tempDir.path());
+    writeFile(dbpath / "WiredTiger.wt", "old");
+    writeFile(dbpath / "WiredTiger.turtle", "old");
+    writeFile(dbpath / "collection-1.wt", "old");
+    writeFile(dbpath / "db" / "index-2.wt", "old");
+    writeFile(dbpath / "journal" / "WiredTigerLog.0000000001", "old");
+    writeFile(dbpath / "mongod.lock", "kept");
+    writeFile(dbpath / "storage.bson", "kept");
+    writeFile(dbpath / "diagnostic.data" / "metrics.interim", "kept");
+
+    StagedDataFiles stagedFiles(tempDir.path());
+    ASSERT_OK(stagedFiles.reset());
+    stageFile(stagedFiles, "WiredTiger.backup", "new");
+    stageFile(stagedFiles, "collection-3.wt", "new");
+    stageFile(stagedFiles, "journal/WiredTigerLog.0000000004", "new");
+    ASSERT_OK(stagedFiles.markComplete());
+
+    ASSERT_TRUE(stagedFiles.applyAtStartup());
+    ASSERT_FALSE(exists(stagedFiles.getStagingDir()));
+
+    ASSERT_FALSE(exists(dbpath / "WiredTiger.wt"));
+    ASSERT_FALSE(exists(dbpath / "WiredTiger.turtle"));
+    ASSERT_FALSE(exists(dbpath / "collection-1.wt"));
+    ASSERT_FALSE(exists(dbpath / "db"));
+    ASSERT_FALSE(exists(dbpath / "journal" / "WiredTigerLog.0000000001"));
+
+    ASSERT_EQ("new", readFile(dbpath / "WiredTiger.backup"));
+    ASSERT_EQ("new", readFile(dbpath / "collection-3.wt"));
+    ASSERT_EQ("new", readFile(dbpath / "journal" / "WiredTigerLog.0000000004"));
+
+    ASSERT_EQ("kept", readFile(dbpath / "mongod.lock"));
+    ASSERT_EQ("kept", readFile(dbpath / "storage.bson"));
+    ASSERT_EQ("kept", readFile(dbpath / "diagnostic.data" / "metrics.interim"));
+}
+
+TEST(StagedDataFilesTest, ResetRemovesPreviouslyStagedFiles) {
+    TempDir tempDir("StagedDataFilesTest_ResetRemovesPreviouslyStagedFiles");
+    StagedDataFiles stagedFiles(tempDir.path());
+    ASSERT_OK(stagedFiles.reset());
+    stageFile(stagedFiles, "collection-1.wt", "new");
+    ASSERT_OK(stagedFiles.markComplete());
+
+    ASSERT_OK(stagedFiles.reset());
+    ASSERT_TRUE(exists(stagedFiles.getStagingDir()));
+    ASSERT_TRUE(boost::filesystem::is_empty(stagedFiles.getStagingDir()));
+    ASSERT_FALSE(stagedFiles.applyAtStartup());
+}
+
+TEST(StagedDataFilesTest, FilesOutsideTheDbpathCannotBeStaged) {
+    TempDir tempDir("StagedDataFilesTest_FilesOutsideTheDbpathCannotBeStaged");
+    StagedDataFiles stagedFiles(tempDir.path());
+    ASSERT_OK(stagedFiles.reset());
+
+    ASSERT_EQ(ErrorCodes::BadValue, stagedFiles.prepareFile("").getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, stagedFiles.prepareFile("/etc/passwd").getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, stagedFiles.prepareFile("../collection-1.wt").getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, stagedFiles.prepareFile("db/../../x.wt").getStatus());
+    ASSERT_OK(stagedFiles.prepareFile("db/collection-1.wt").getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/control/storage_control.h"
+#include "mongo/db/storage/staged_data_files.h"
 #include "mongo/db/storage/storage_engine_lock_file.h"
 #include "mongo/db/storage/storage_engine_metadata.h"
 #include "mongo/db/storage/storage_options.h"
@@ -72,6 +73,13 @@ StorageEngine::LastShutdownState initializeStorageEngine(OperationContext* opCtx
 
     const std::string dbpath = storageGlobalParams.dbpath;
 
+    // Data files staged by a file copy based initial sync replace the data files of the dbpath
+    // before the storage engine opens them, which is only safe with the lock file held.
+    if (!storageGlobalParams.readOnly &&
+        0 == (initFlags & StorageEngineInitFlags::kAllowNoLockFile)) {
+        StagedDataFiles(dbpath).applyAtStartup();
+    }
+
     if (!storageGlobalParams.readOnly) {
         StorageRepairObserver::set(service, std::make_unique<StorageRepairObserver>(dbpath));
         auto repairObserver = StorageRepairObserver::get(service);
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <deque>
+
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+const int kNumKeys = 100 * 1000;
+
+class WiredTigerIndexBulkLoadHelper {
+public:
+    WiredTigerIndexBulkLoadHelper() : _dbpath("wt_test") {
+        invariantWTOK(
+            wiredtiger_open(_dbpath.path().c_str(), nullptr, "create,cache_size=1G,", &_conn));
+        _sessionCache = std::make_unique<WiredTigerSessionCache>(_conn, &_clockSource);
+
+        WiredTigerUtil::notifyStartupComplete();
+    }
+
+    ~WiredTigerIndexBulkLoadHelper() {
+        _indexes.clear();
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+
+        WiredTigerUtil::resetTableLoggingInfo();
+    }
+
+    std::unique_ptr<OperationContext> newOperationContext() {
+        return std::make_unique<OperationContextNoop>(
+            new WiredTigerRecoveryUnit(_sessionCache.get(), &_oplogManager));
+    }
+
+    /**
+     * Creates a new, empty index on { a: 1 }. Bulk cursors can only be opened on empty tables, so
+     * every iteration of a benchmark loads into new indexes.
+     */
+    SortedDataInterface* createIndex() {
+        auto opCtx = newOperationContext();
+        const auto name = "test.wt" + std::to_string(_indexes.size());
+
+        BSONObj spec = BSON("key" << BSON("a" << 1) << "name"
+                                  << "a_1"
+                                  << "v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+        IndexDescriptor& desc = _descriptors.emplace_back("", spec);
+
+        auto config = WiredTigerIndex::generateCreateString(
+            kWiredTigerEngineName, "", "", NamespaceString(name), desc);
+        invariant(config.isOK());
+
+        const std::string uri = "table:" + name;
+        invariantWTOK(WiredTigerIndex::Create(opCtx.get(), uri, config.getValue()));
+
+        _indexes.push_back(std::make_unique<WiredTigerIndexStandard>(
+            opCtx.get(), uri, "" /* ident */, KeyFormat::Long, &desc));
+        return _indexes.back().get();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    ClockSourceMock _clockSource;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+    WiredTigerOplogManager _oplogManager;
+    std::deque<IndexDescriptor> _descriptors;
+    std::vector<std::unique_ptr<SortedDataInterface>> _indexes;
+};
+
+/**
+ * Inserts 'keys' into 'index' through a bulk cursor, the same way the bulk load phase of an index
+ * build does.
+ */
+void bulkLoad(WiredTigerIndexBulkLoadHelper& helper,
+              SortedDataInterface* index,
+              const std::vector<KeyString::Value>& keys) {
+    auto opCtx = helper.newOperationContext();
+    auto builder = index->makeBulkBuilder(opCtx.get(), true /* dupsAllowed */);
+    for (const auto& key : keys) {
+        WriteUnitOfWork wuow(opCtx.get());
+        invariant(builder->addKey(key).isOK());
+        wuow.commit();
+    }
+}
+
+/**
+ * Bulk loads state.range(0) indexes of kNumKeys keys each, split across state.range(1) threads.
+ */
+void BM_WiredTigerIndexBulkLoad(benchmark::State& state) {
+    const auto numIndexes = static_cast<size_t>(state.range(0));
+    const auto numThreads = static_cast<size_t>(state.range(1));
+
+    WiredTigerIndexBulkLoadHelper helper;
+
+    std::vector<KeyString::Value> keys;
+    keys.reserve(kNumKeys);
+    for (int i = 0; i < kNumKeys; ++i) {
+        KeyString::Builder builder(
+            KeyString::Version::kLatestVersion, BSON("" << i), Ordering::make(BSON("a" << 1)));
+        builder.appendRecordId(RecordId(i + 1));
+        keys.push_back(builder.getValueCopy());
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<SortedDataInterface*> indexes;
+        for (size_t i = 0; i < numIndexes; ++i) {
+            indexes.push_back(helper.createIndex());
+        }
+        state.ResumeTiming();
+
+        std::vector<stdx::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = t; i < numIndexes; i += numThreads) {
+                    bulkLoad(helper, indexes[i], keys);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numIndexes * kNumKeys);
+}
+
+BENCHMARK(BM_WiredTigerIndexBulkLoad)
+    ->ArgNames({"indexes", "threads"})
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({4, 2})
+    ->Args({4, 4})
+    ->Args({8, 1})
+    ->Args({8, 4})
+    ->Args({8, 8})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
@@ -87,6 +87,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
@@ -260,8 +261,94 @@ std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult
 namespace {
 TicketHolder openWriteTransaction(128);
 TicketHolder openReadTransaction(128);
+
+WiredTigerTicketController writeTicketController(&openWriteTransaction);
+WiredTigerTicketController readTicketController(&openReadTransaction);
 }  // namespace
 
+/**
+ * Periodically samples the eviction pressure on the WiredTiger cache and resizes the read and write
+ * ticket pools with their WiredTigerTicketControllers, while
+ * wiredTigerConcurrentTransactionsAdaptive is enabled.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(5754715, 1, "starting {name} thread", "name"_attr = name());
+
+        Date_t lastAdjustment = Date_t::now();
+        long long lastApplicationEvictions = 0;
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock,
+                    Milliseconds(gWiredTigerConcurrentTransactionsAdaptiveIntervalMillis.load())
+                        .toSystemDuration());
+            }
+
+            if (_shuttingDown.load() || !gWiredTigerConcurrentTransactionsAdaptive.load()) {
+                continue;
+            }
+
+            WiredTigerTicketController::CacheState cache;
+            try {
+                auto session = _sessionCache->getSession();
+                auto statistic = [&](int key) {
+                    return uassertStatusOK(WiredTigerUtil::getStatisticsValue(
+                        session->getSession(), "statistics:", "statistics=(fast)", key));
+                };
+                const auto bytesMax = statistic(WT_STAT_CONN_CACHE_BYTES_MAX);
+                const auto bytesDirty = statistic(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+                const auto applicationEvictions = statistic(WT_STAT_CONN_CACHE_EVICTION_APP);
+
+                cache.dirtyRatio = bytesMax > 0 ? static_cast<double>(bytesDirty) / bytesMax : 0.0;
+                cache.applicationEvictions = lastApplicationEvictions > 0
+                    ? applicationEvictions - lastApplicationEvictions
+                    : 0;
+                lastApplicationEvictions = applicationEvictions;
+            } catch (const DBException& ex) {
+                LOGV2_DEBUG(5754716,
+                            1,
+                            "Failed to sample the WiredTiger cache statistics",
+                            "error"_attr = ex.toStatus());
+                continue;
+            }
+
+            const auto now = Date_t::now();
+            writeTicketController.adjust(now - lastAdjustment, cache);
+            readTicketController.adjust(now - lastAdjustment, cache);
+            lastAdjustment = now;
+        }
+        LOGV2_DEBUG(5754717, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    WiredTigerSessionCache* _sessionCache;
+    AtomicWord<bool> _shuttingDown{false};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketAdjuster::_mutex");  // protects _condvar
+    stdx::condition_variable _condvar;
+};
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
@@ -514,6 +601,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    _ticketAdjuster = std::make_unique<WiredTigerTicketAdjuster>(_sessionCache.get());
+    _ticketAdjuster->go();
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -602,6 +692,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        {
+            BSONObjBuilder lanes(bbb.subobjStart("lanes"));
+            openWriteTransaction.appendLaneStats(&lanes);
+        }
         bbb.done();
     }
     {
@@ -609,6 +703,23 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        {
+            BSONObjBuilder lanes(bbb.subobjStart("lanes"));
+            openReadTransaction.appendLaneStats(&lanes);
+        }
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("adaptive"));
+        bbb.append("enabled", gWiredTigerConcurrentTransactionsAdaptive.load());
+        {
+            BSONObjBuilder bbbb(bbb.subobjStart("write"));
+            writeTicketController.appendStats(&bbbb);
+        }
+        {
+            BSONObjBuilder bbbb(bbb.subobjStart("read"));
+            readTicketController.appendStats(&bbbb);
+        }
         bbb.done();
     }
     bb.done();
@@ -721,6 +832,9 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_ticketAdjuster) {
+        _ticketAdjuster->shutdown();
+    }
     LOGV2_FOR_RECOVERY(23988,
                        2,
                        "Shutdown timestamps.",
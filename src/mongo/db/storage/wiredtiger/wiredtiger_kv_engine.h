@@ -366,6 +366,7 @@ public:
 
 private:
     class WiredTigerSessionSweeper;
+    class WiredTigerTicketAdjuster;
 
     struct IdentToDrop {
         std::string uri;
@@ -459,6 +460,7 @@ private:
     const bool _keepDataHistory = true;
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -2058,6 +2058,45 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::nextBatch(std::vector<Record>* out, size_t maxRecords) {
+    out->clear();
+    _batchBuffer.reset();
+    _batchOffsets.clear();
+
+    // If a WriteConflictException is thrown part way through the batch, act as if none of the
+    // records were returned. The WiredTiger cursor gets repositioned on '_lastReturnedId' when the
+    // caller restores this cursor after abandoning its snapshot.
+    auto rollback = makeGuard([this,
+                               out,
+                               lastReturnedId = _lastReturnedId,
+                               skipNextAdvance = _skipNextAdvance,
+                               eof = _eof] {
+        _lastReturnedId = lastReturnedId;
+        _skipNextAdvance = skipNextAdvance;
+        _eof = eof;
+        out->clear();
+    });
+
+    while (out->size() < maxRecords) {
+        auto record = WiredTigerRecordStoreCursorBase::next();
+        if (!record) {
+            break;
+        }
+
+        _batchOffsets.push_back(_batchBuffer.len());
+        _batchBuffer.appendBuf(record->data.data(), record->data.size());
+        out->push_back(std::move(*record));
+    }
+    rollback.dismiss();
+
+    // The buffer may have been reallocated while it was being filled, so the data of the records
+    // is only pointed at the copies once all of them have been made.
+    for (size_t i = 0; i < out->size(); ++i) {
+        auto& record = (*out)[i];
+        record.data = RecordData(_batchBuffer.buf() + _batchOffsets[i], record.data.size());
+    }
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
     if (_forward && _oplogVisibleTs && id.getLong() > *_oplogVisibleTs) {
@@ -32,8 +32,10 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 #include <wiredtiger.h>
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
@@ -390,6 +392,13 @@ public:
 
     boost::optional<Record> next();
 
+    /**
+     * WiredTiger only guarantees that a value is valid until its cursor moves, so the values of
+     * the returned records are copied into a buffer owned by this cursor, which is reused by the
+     * next call to nextBatch().
+     */
+    void nextBatch(std::vector<Record>* out, size_t maxRecords);
+
     boost::optional<Record> seekExact(const RecordId& id);
 
     boost::optional<Record> seekNear(const RecordId& start);
@@ -432,6 +441,11 @@ private:
      * established.
      */
     boost::optional<std::int64_t> _oplogVisibleTs = boost::none;
+
+    // Holds copies of the values of the records returned by the last call to nextBatch(), along
+    // with the offset of each value in the buffer.
+    BufBuilder _batchBuffer;
+    std::vector<size_t> _batchOffsets;
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_test_harness.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+
+namespace mongo {
+namespace {
+
+const int kNumRecords = 100 * 1000;
+const int kRecordSize = 100;
+const int kRecordsPerInsert = 1000;
+
+/**
+ * Fills a new record store with kNumRecords records of kRecordSize bytes each.
+ */
+std::unique_ptr<RecordStore> makeRecordStore(WiredTigerHarnessHelper& helper) {
+    auto rs = helper.newNonCappedRecordStore();
+    auto opCtx = helper.newOperationContext();
+    const std::string data(kRecordSize, 'x');
+    for (int i = 0; i < kNumRecords; i += kRecordsPerInsert) {
+        WriteUnitOfWork wuow(opCtx.get());
+        for (int j = 0; j < kRecordsPerInsert; ++j) {
+            invariant(rs->insertRecord(opCtx.get(), data.c_str(), kRecordSize, Timestamp())
+                          .getStatus());
+        }
+        wuow.commit();
+    }
+    return rs;
+}
+
+/**
+ * Reads the first state.range(1) records of a record store with a fresh cursor, the way a
+ * collection scan with that limit does. A batch size of 0, in state.range(0), reads the records
+ * one at a time with next(), as collection scans do by default. Any other batch size reads them
+ * with nextBatch(), which copies every record of a batch out of the WiredTiger cursor.
+ */
+void BM_WiredTigerRecordStoreScan(benchmark::State& state) {
+    const auto batchSize = static_cast<size_t>(state.range(0));
+    const auto numToRead = static_cast<size_t>(state.range(1));
+
+    WiredTigerHarnessHelper helper;
+    auto rs = makeRecordStore(helper);
+    auto opCtx = helper.newOperationContext();
+
+    std::vector<Record> batch;
+    size_t bytesRead = 0;
+    for (auto _ : state) {
+        auto cursor = rs->getCursor(opCtx.get());
+        size_t numRead = 0;
+        if (batchSize == 0) {
+            while (numRead < numToRead) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                bytesRead += record->data.size();
+                ++numRead;
+            }
+        } else {
+            while (numRead < numToRead) {
+                cursor->nextBatch(&batch, batchSize);
+                if (batch.empty()) {
+                    break;
+                }
+                for (size_t i = 0; i < batch.size() && numRead < numToRead; ++i, ++numRead) {
+                    bytesRead += batch[i].data.size();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(numRead);
+
+        cursor.reset();
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+
+    state.SetBytesProcessed(bytesRead);
+    state.SetItemsProcessed(state.iterations() * std::min<size_t>(numToRead, kNumRecords));
+}
+
+BENCHMARK(BM_WiredTigerRecordStoreScan)
+    ->ArgNames({"batchSize", "records"})
+    ->ArgsProduct({{0, 1, 16, 64, 256}, {1, kNumRecords}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace mongo
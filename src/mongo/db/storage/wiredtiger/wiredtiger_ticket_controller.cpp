@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+
+#include <algorithm>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+// The factor by which the best throughput per ticket decays on every adjustment.
+const double kBestThroughputDecay = 0.95;
+
+// The pool is grown while the throughput per ticket stays within this fraction of the best one,
+// and shrunk once it falls further behind than 'kShrinkThreshold'. In between, the pool holds
+// roughly as many tickets as WiredTiger can make progress on.
+const double kGrowThreshold = 0.1;
+const double kShrinkThreshold = 0.3;
+
+// The fraction of the pool added or removed by an adjustment based on throughput, and removed by
+// an adjustment based on cache pressure.
+const int kStepDivisor = 16;
+const int kCachePressureDivisor = 4;
+
+}  // namespace
+
+WiredTigerTicketController::WiredTigerTicketController(TicketHolder* holder)
+    : _holder(holder), _lastReleased(holder->totalReleased()), _lastWaits(holder->totalWaits()) {}
+
+void WiredTigerTicketController::adjust(Milliseconds elapsed, const CacheState& cache) {
+    const auto released = _holder->totalReleased();
+    const auto waits = _holder->totalWaits();
+    const bool saturated = waits > _lastWaits;
+    const double throughput = elapsed > Milliseconds(0)
+        ? (released - _lastReleased) * 1000.0 / durationCount<Milliseconds>(elapsed)
+        : 0.0;
+    _lastReleased = released;
+    _lastWaits = waits;
+
+    const bool cachePressure = cache.applicationEvictions > 0 ||
+        cache.dirtyRatio > gWiredTigerConcurrentTransactionsAdaptiveDirtyCacheThreshold.load();
+    const int minTickets = gWiredTigerConcurrentTransactionsAdaptiveMinTickets.load();
+    const int maxTickets =
+        std::max(minTickets, gWiredTigerConcurrentTransactionsAdaptiveMaxTickets.load());
+    const int size = _holder->outof();
+    int newSize = size;
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _throughput = throughput;
+        _bestThroughputPerTicket *= kBestThroughputDecay;
+
+        if (cachePressure) {
+            newSize = size - std::max(1, size / kCachePressureDivisor);
+        } else if (saturated) {
+            // Operations queued for tickets, so the pool limited the throughput of this interval.
+            const double throughputPerTicket = throughput / size;
+            _bestThroughputPerTicket = std::max(_bestThroughputPerTicket, throughputPerTicket);
+
+            // The fraction of the pool which did not contribute to the throughput, in the way the
+            // difference between the expected and the actual rate measures queueing in TCP Vegas.
+            const double backlog = _bestThroughputPerTicket > 0.0
+                ? 1.0 - throughputPerTicket / _bestThroughputPerTicket
+                : 0.0;
+            if (backlog < kGrowThreshold) {
+                newSize = size + std::max(1, size / kStepDivisor);
+            } else if (backlog > kShrinkThreshold) {
+                newSize = size - std::max(1, size / kStepDivisor);
+            }
+        }
+    }
+
+    newSize = std::clamp(newSize, minTickets, maxTickets);
+    if (newSize == size) {
+        return;
+    }
+
+    auto status = _holder->resize(newSize);
+    if (!status.isOK()) {
+        LOGV2_DEBUG(5754713,
+                    1,
+                    "Failed to resize ticket pool",
+                    "from"_attr = size,
+                    "to"_attr = newSize,
+                    "error"_attr = status);
+        return;
+    }
+
+    LOGV2_DEBUG(5754714,
+                2,
+                "Resized ticket pool",
+                "from"_attr = size,
+                "to"_attr = newSize,
+                "throughput"_attr = throughput,
+                "dirtyCacheRatio"_attr = cache.dirtyRatio,
+                "applicationEvictions"_attr = cache.applicationEvictions);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (newSize > size) {
+        ++_numIncreases;
+    } else {
+        ++_numDecreases;
+        if (cachePressure) {
+            ++_numCachePressureDecreases;
+        }
+    }
+}
+
+void WiredTigerTicketController::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->append("throughput", _throughput);
+    builder->append("bestThroughputPerTicket", _bestThroughputPerTicket);
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+    builder->append("cachePressureDecreases", _numCachePressureDecreases);
+}
+
+}  // namespace mongo
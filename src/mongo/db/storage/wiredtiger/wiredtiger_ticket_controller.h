@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+/**
+ * Resizes a TicketHolder which admits operations into WiredTiger, in the manner of the TCP Vegas
+ * congestion control algorithm. Every call to adjust() compares the throughput each ticket
+ * achieved since the previous call against the best recent throughput per ticket. When the pool is
+ * saturated and its throughput grows with its size, the pool is grown. When additional tickets
+ * only lead to operations contending inside WiredTiger, so that the throughput per ticket drops,
+ * the pool is shrunk. Eviction pressure on the WiredTiger cache shrinks the pool multiplicatively,
+ * as admitting more operations only drafts more application threads into eviction.
+ *
+ * The pool is kept between wiredTigerConcurrentTransactionsAdaptiveMinTickets and
+ * wiredTigerConcurrentTransactionsAdaptiveMaxTickets.
+ */
+class WiredTigerTicketController {
+    WiredTigerTicketController(const WiredTigerTicketController&) = delete;
+    WiredTigerTicketController& operator=(const WiredTigerTicketController&) = delete;
+
+public:
+    /**
+     * The state of the WiredTiger cache sampled by the caller of adjust().
+     */
+    struct CacheState {
+        // The fraction of the cache holding dirty data.
+        double dirtyRatio = 0.0;
+
+        // The number of pages evicted by application threads since the previous sample.
+        long long applicationEvictions = 0;
+    };
+
+    explicit WiredTigerTicketController(TicketHolder* holder);
+
+    /**
+     * Resizes the TicketHolder based on the tickets released during the 'elapsed' time since the
+     * previous call and on 'cache'. Must not be called concurrently with itself.
+     */
+    void adjust(Milliseconds elapsed, const CacheState& cache);
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    TicketHolder* const _holder;
+
+    // The counters of '_holder' at the previous call to adjust().
+    long long _lastReleased;
+    long long _lastWaits;
+
+    // Protects the members below, which are read by serverStatus.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketController::_mutex");
+
+    // The tickets released per second during the previous interval.
+    double _throughput = 0.0;
+
+    // The best throughput per ticket recently observed while the pool was saturated. It decays on
+    // every adjustment, so that the controller follows changes in the workload.
+    double _bestThroughputPerTicket = 0.0;
+
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+    long long _numCachePressureDecreases = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Acquires and releases 'numTickets' tickets of 'holder'. If 'queue' is true, an additional
+ * acquisition is attempted while all of the tickets are held, so that it counts as a wait.
+ */
+void runOperations(TicketHolder* holder, int numTickets, bool queue) {
+    for (int i = 0; i < numTickets; ++i) {
+        ASSERT_TRUE(holder->tryAcquire());
+    }
+    if (queue) {
+        ASSERT_FALSE(holder->waitForTicketUntil(Date_t::now()));
+    }
+    for (int i = 0; i < numTickets; ++i) {
+        holder->release();
+    }
+}
+
+TEST(WiredTigerTicketControllerTest, ShrinksPoolUnderDirtyCachePressure) {
+    RAIIServerParameterControllerForTest threshold(
+        "wiredTigerConcurrentTransactionsAdaptiveDirtyCacheThreshold", 0.2);
+
+    TicketHolder holder(64);
+    WiredTigerTicketController controller(&holder);
+
+    WiredTigerTicketController::CacheState cache;
+    cache.dirtyRatio = 0.25;
+    controller.adjust(Seconds(1), cache);
+    ASSERT_EQ(48, holder.outof());
+}
+
+TEST(WiredTigerTicketControllerTest, ShrinksPoolWhenApplicationThreadsEvict) {
+    TicketHolder holder(64);
+    WiredTigerTicketController controller(&holder);
+
+    WiredTigerTicketController::CacheState cache;
+    cache.applicationEvictions = 10;
+    controller.adjust(Seconds(1), cache);
+    ASSERT_EQ(48, holder.outof());
+}
+
+TEST(WiredTigerTicketControllerTest, KeepsPoolSizeWhenNoOperationQueued) {
+    TicketHolder holder(64);
+    WiredTigerTicketController controller(&holder);
+
+    runOperations(&holder, 64, false /* queue */);
+    controller.adjust(Seconds(1), {});
+    ASSERT_EQ(64, holder.outof());
+}
+
+TEST(WiredTigerTicketControllerTest, GrowsPoolWhileThroughputScalesAndShrinksOnceItDrops) {
+    TicketHolder holder(64);
+    WiredTigerTicketController controller(&holder);
+
+    // Every ticket of the saturated pool contributed to the throughput.
+    runOperations(&holder, 64, true /* queue */);
+    controller.adjust(Seconds(1), {});
+    ASSERT_EQ(68, holder.outof());
+
+    // The additional tickets kept up the throughput per ticket.
+    runOperations(&holder, 68, true /* queue */);
+    controller.adjust(Seconds(1), {});
+    ASSERT_EQ(72, holder.outof());
+
+    // The throughput per ticket dropped by half, so the tickets only led to contention.
+    runOperations(&holder, 36, true /* queue */);
+    controller.adjust(Seconds(1), {});
+    ASSERT_EQ(68, holder.outof());
+}
+
+TEST(WiredTigerTicketControllerTest, KeepsPoolWithinBounds) {
+    RAIIServerParameterControllerForTest minTickets(
+        "wiredTigerConcurrentTransactionsAdaptiveMinTickets", 60);
+    RAIIServerParameterControllerForTest maxTickets(
+        "wiredTigerConcurrentTransactionsAdaptiveMaxTickets", 66);
+
+    TicketHolder holder(64);
+    WiredTigerTicketController controller(&holder);
+
+    runOperations(&holder, 64, true /* queue */);
+    controller.adjust(Seconds(1), {});
+    ASSERT_EQ(66, holder.outof());
+
+    WiredTigerTicketController::CacheState cache;
+    cache.applicationEvictions = 1;
+    controller.adjust(Seconds(1), cache);
+    ASSERT_EQ(60, holder.outof());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/platform/compiler.h"
@@ -114,6 +115,29 @@ void normalizeTopLevel(BSONObjBuilder* builder, const BSONElement& elem) {
     }
 }
 
+// Hashes the value of the element such that values which only differ in the order of the fields
+// of their objects, as reordered by normalizeObject(), hash the same.
+std::size_t hashIgnoringFieldOrder(const BSONElement& elem) {
+    if (!elem) {
+        return 0;
+    }
+    if (elem.type() != BSONType::Object) {
+        return absl::Hash<std::pair<int, absl::string_view>>()(
+            {elem.type(), absl::string_view(elem.value(), elem.valuesize())});
+    }
+
+    // Combine the hashes of the fields with a commutative operation so that their order doesn't
+    // matter.
+    std::size_t hash = 0;
+    for (auto&& field : elem.Obj()) {
+        auto fieldName = field.fieldNameStringData();
+        hash += absl::Hash<std::pair<absl::string_view, std::size_t>>()(
+            {absl::string_view(fieldName.rawData(), fieldName.size()),
+             hashIgnoringFieldOrder(field)});
+    }
+    return hash;
+}
+
 UUID getLsid(OperationContext* opCtx, BucketCatalog::CombineWithInsertsFromOtherClients combine) {
     static const UUID common{UUID::gen()};
     switch (combine) {
@@ -150,8 +174,11 @@ BucketCatalog& BucketCatalog::get(OperationContext* opCtx) {
     return get(opCtx->getServiceContext());
 }
 
-BSONObj BucketCatalog::getMetadata(Bucket* ptr) const {
-    BucketAccess bucket{const_cast<BucketCatalog*>(this), ptr};
+BSONObj BucketCatalog::getMetadata(const std::shared_ptr<WriteBatch>& batch) const {
+    const auto& stripe = _stripes[batch->_stripe];
+    stdx::lock_guard stripeLock{stripe.mutex};
+
+    const Bucket* bucket = _useBucket(stripe, stripeLock, batch->bucket());
     if (!bucket) {
         return {};
     }
@@ -186,7 +213,13 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
 
     auto time = timeElem.Date();
 
-    BucketAccess bucket{this, key, options, stats.get(), time};
+    // Compute the hashes outside of the lock, since they are expensive.
+    auto& stripe = _stripes[_getStripeNumber(key)];
+    auto hashedKey = BucketHasher{}.hashed_key(key);
+    stdx::lock_guard stripeLock{stripe.mutex};
+
+    Bucket* bucket =
+        _useOrCreateBucket(&stripe, stripeLock, hashedKey, &key, time, options, stats.get());
     invariant(bucket);
 
     NewFieldNames newFieldNamesToBeInserted;
@@ -198,30 +231,66 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
                                                 &newFieldNamesSize,
                                                 &sizeToBeAdded);
 
-    auto isBucketFull = [&](BucketAccess* bucket) -> bool {
-        if ((*bucket)->_numMeasurements == static_cast<std::uint64_t>(gTimeseriesBucketMaxCount)) {
+    auto hasRoom = [](Bucket* bucket, uint32_t sizeToBeAdded) {
+        return bucket->_numMeasurements < static_cast<std::uint64_t>(gTimeseriesBucketMaxCount) &&
+            bucket->_size + sizeToBeAdded <= static_cast<std::uint64_t>(gTimeseriesBucketMaxSize);
+    };
+
+    // A bucket which cannot take the measurement only because of its time range is archived
+    // instead of closed when timeseriesBucketReopening is enabled.
+    const bool archive = gTimeseriesBucketReopening.load() && hasRoom(bucket, sizeToBeAdded);
+
+    auto isBucketFull = [&](Bucket* bucket) -> bool {
+        if (bucket->_numMeasurements == static_cast<std::uint64_t>(gTimeseriesBucketMaxCount)) {
             stats->numBucketsClosedDueToCount.fetchAndAddRelaxed(1);
             return true;
         }
-        if ((*bucket)->_size + sizeToBeAdded >
-            static_cast<std::uint64_t>(gTimeseriesBucketMaxSize)) {
+        if (bucket->_size + sizeToBeAdded > static_cast<std::uint64_t>(gTimeseriesBucketMaxSize)) {
             stats->numBucketsClosedDueToSize.fetchAndAddRelaxed(1);
             return true;
         }
-        auto bucketTime = (*bucket).getTime();
+        auto bucketTime = bucket->id().asDateT();
         if (time - bucketTime >= Seconds(*options.getBucketMaxSpanSeconds())) {
-            stats->numBucketsClosedDueToTimeForward.fetchAndAddRelaxed(1);
+            (archive ? stats->numBucketsArchivedDueToTimeForward
+                     : stats->numBucketsClosedDueToTimeForward)
+                .fetchAndAddRelaxed(1);
             return true;
         }
         if (time < bucketTime) {
-            stats->numBucketsClosedDueToTimeBackward.fetchAndAddRelaxed(1);
+            (archive ? stats->numBucketsArchivedDueToTimeBackward
+                     : stats->numBucketsClosedDueToTimeBackward)
+                .fetchAndAddRelaxed(1);
             return true;
         }
         return false;
     };
 
-    if (!bucket->_ns.isEmpty() && isBucketFull(&bucket)) {
-        bucket.rollover(isBucketFull);
+    if (!bucket->_ns.isEmpty() && isBucketFull(bucket)) {
+        if (archive) {
+            auto canTakeMeasurement = [&](Bucket* candidate) {
+                NewFieldNames ignoredFieldNames;
+                uint32_t ignoredFieldNamesSize = 0;
+                uint32_t candidateSizeToBeAdded = 0;
+                candidate->_calculateBucketFieldsAndSizeChange(doc,
+                                                               options.getMetaField(),
+                                                               &ignoredFieldNames,
+                                                               &ignoredFieldNamesSize,
+                                                               &candidateSizeToBeAdded);
+                auto bucketTime = candidate->id().asDateT();
+                return hasRoom(candidate, candidateSizeToBeAdded) && time >= bucketTime &&
+                    time - bucketTime < Seconds(*options.getBucketMaxSpanSeconds());
+            };
+            bucket = _archiveAndReopen(&stripe,
+                                       stripeLock,
+                                       bucket,
+                                       &key,
+                                       time,
+                                       options,
+                                       stats.get(),
+                                       canTakeMeasurement);
+        } else {
+            bucket = _rollover(&stripe, stripeLock, bucket, &key, time, options, stats.get());
+        }
         bucket->_calculateBucketFieldsAndSizeChange(doc,
                                                     options.getMetaField(),
                                                     &newFieldNamesToBeInserted,
@@ -241,15 +310,17 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
     if (bucket->_ns.isEmpty()) {
         // The namespace and metadata only need to be set if this bucket was newly created.
         bucket->_ns = ns;
+        bucket->_timeField = options.getTimeField().toString();
         key.metadata.normalize();
         bucket->_metadata = key.metadata;
 
-        // The namespace is stored two times: the bucket itself and _openBuckets.
+        // The namespace is stored two times: the bucket itself and openBuckets.
         // The metadata is stored two times, normalized and un-normalized. A unique pointer to the
-        // bucket is stored once: _allBuckets. A raw pointer to the bucket is stored at most twice:
-        // _openBuckets, _idleBuckets.
+        // bucket is stored once: allBuckets. A raw pointer to the bucket is stored at most twice:
+        // openBuckets, idleBuckets.
         bucket->_memoryUsage += (ns.size() * 2) + (bucket->_metadata.toBSON().objsize() * 2) +
-            sizeof(Bucket) + sizeof(std::unique_ptr<Bucket>) + (sizeof(Bucket*) * 2);
+            bucket->_timeField.size() + sizeof(Bucket) + sizeof(std::unique_ptr<Bucket>) +
+            (sizeof(Bucket*) * 2);
     } else {
         _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
     }
@@ -266,16 +337,19 @@ bool BucketCatalog::prepareCommit(std::shared_ptr<WriteBatch> batch) {
 
     _waitToCommitBatch(batch);
 
-    BucketAccess bucket(this, batch->bucket());
+    auto& stripe = _stripes[batch->_stripe];
+    stdx::lock_guard stripeLock{stripe.mutex};
+
+    Bucket* bucket = _useBucket(stripe, stripeLock, batch->bucket());
     if (batch->finished()) {
         // Someone may have aborted it while we were waiting.
         return false;
     } else if (!bucket) {
-        abort(batch);
+        _abort(&stripe, stripeLock, batch, boost::none);
         return false;
     }
 
-    invariant(_setBucketState(bucket->_id, BucketState::kPrepared));
+    invariant(_setBucketState(&stripe, stripeLock, bucket->_id, BucketState::kPrepared));
 
     auto prevMemoryUsage = bucket->_memoryUsage;
     batch->_prepareCommit();
@@ -290,12 +364,15 @@ void BucketCatalog::finish(std::shared_ptr<WriteBatch> batch, const CommitInfo&
     invariant(!batch->finished());
     invariant(!batch->active());
 
+    auto& stripe = _stripes[batch->_stripe];
+    stdx::lock_guard stripeLock{stripe.mutex};
+
     Bucket* ptr(batch->bucket());
     batch->_finish(info);
 
-    BucketAccess bucket(this, ptr);
+    Bucket* bucket = _useBucket(stripe, stripeLock, ptr);
     if (bucket) {
-        invariant(_setBucketState(bucket->_id, BucketState::kNormal));
+        invariant(_setBucketState(&stripe, stripeLock, bucket->_id, BucketState::kNormal));
         bucket->_preparedBatch.reset();
     }
 
@@ -316,32 +393,25 @@ void BucketCatalog::finish(std::shared_ptr<WriteBatch> batch, const CommitInfo&
         // It's possible that we cleared the bucket in between preparing the commit and finishing
         // here. In this case, we should abort any other ongoing batches and clear the bucket from
         // the catalog so it's not hanging around idle.
-        auto lk = _lockExclusive();
-        if (_allBuckets.contains(ptr)) {
-            stdx::unique_lock blk{ptr->_mutex};
+        if (stripe.allBuckets.contains(ptr)) {
             ptr->_preparedBatch.reset();
-            _abort(blk, ptr, nullptr, boost::none);
+            _abort(&stripe, stripeLock, ptr, nullptr, boost::none);
         }
     } else if (bucket->allCommitted()) {
         if (bucket->_full) {
             // Everything in the bucket has been committed, and nothing more will be added since the
             // bucket is full. Thus, we can remove it.
             _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
-
-            bucket.release();
-            auto lk = _lockExclusive();
-
-            // Only remove from _allBuckets and _idleBuckets. If it was marked full, we know that
-            // happened in BucketAccess::rollover, and that there is already a new open bucket for
-            // this metadata.
-            _markBucketNotIdle(ptr, false /* locked */);
-            {
-                stdx::lock_guard statesLk{_statesMutex};
-                _bucketStates.erase(ptr->_id);
-            }
-            _allBuckets.erase(ptr);
+            _markBucketClosed(bucket);
+
+            // Only remove from allBuckets and idleBuckets. If it was marked full, we know that
+            // happened in _rollover, and that there is already a new open bucket for this
+            // metadata.
+            _markBucketNotIdle(&stripe, stripeLock, bucket);
+            stripe.bucketStates.erase(bucket->_id);
+            stripe.allBuckets.erase(bucket);
         } else {
-            _markBucketIdle(bucket);
+            _markBucketIdle(&stripe, stripeLock, bucket);
         }
     }
 }
@@ -356,22 +426,21 @@ void BucketCatalog::abort(std::shared_ptr<WriteBatch> batch,
         return;
     }
 
-    Bucket* bucket = batch->bucket();
-
-    // Before we access the bucket, make sure it's still there.
-    auto lk = _lockExclusive();
-    if (!_allBuckets.contains(bucket)) {
-        // Special case, bucket has already been cleared, and we need only abort this batch.
-        batch->_abort(status, false);
-        return;
-    }
-
-    stdx::unique_lock blk{bucket->_mutex};
-    _abort(blk, bucket, batch, status);
+    auto& stripe = _stripes[batch->_stripe];
+    stdx::lock_guard stripeLock{stripe.mutex};
+    _abort(&stripe, stripeLock, batch, status);
 }
 
 void BucketCatalog::clear(const OID& oid) {
-    auto result = _setBucketState(oid, BucketState::kCleared);
+    // The stripe of a bucket cannot be derived from its id, so look for it in all of them.
+    boost::optional<BucketState> result;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard stripeLock{stripe.mutex};
+        if ((result = _setBucketState(&stripe, stripeLock, oid, BucketState::kCleared))) {
+            break;
+        }
+    }
+
     if (result && *result == BucketState::kPreparedAndCleared) {
         hangTimeseriesDirectModificationBeforeWriteConflict.pauseWhileSet();
         throw WriteConflictException();
@@ -379,19 +448,35 @@ void BucketCatalog::clear(const OID& oid) {
 }
 
 void BucketCatalog::clear(const std::function<bool(const NamespaceString&)>& shouldClear) {
-    auto lk = _lockExclusive();
-    auto statsLk = _statsMutex.lockExclusive();
+    stdx::unordered_set<NamespaceString> clearedNamespaces;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard stripeLock{stripe.mutex};
+        for (auto it = stripe.allBuckets.begin(); it != stripe.allBuckets.end();) {
+            auto nextIt = std::next(it);
+
+            const auto& bucket = *it;
+            if (shouldClear(bucket->_ns)) {
+                clearedNamespaces.insert(bucket->_ns);
+                _abort(&stripe, stripeLock, bucket.get(), nullptr, boost::none);
+            }
 
-    for (auto it = _allBuckets.begin(); it != _allBuckets.end();) {
-        auto nextIt = std::next(it);
+            it = nextIt;
+        }
+    }
 
-        const auto& bucket = *it;
-        stdx::unique_lock blk{bucket->_mutex};
-        if (shouldClear(bucket->_ns)) {
-            _executionStats.erase(bucket->_ns);
-            _abort(blk, bucket.get(), nullptr, boost::none);
+    {
+        auto statsLk = _statsMutex.lockExclusive();
+        for (auto&& ns : clearedNamespaces) {
+            _executionStats.erase(ns);
         }
+    }
 
+    stdx::lock_guard closedLk{_closedBucketsMutex};
+    for (auto it = _closedBuckets.begin(); it != _closedBuckets.end();) {
+        auto nextIt = std::next(it);
+        if (shouldClear(it->first)) {
+            _closedBuckets.erase(it);
+        }
         it = nextIt;
     }
 }
@@ -404,6 +489,58 @@ void BucketCatalog::clear(StringData dbName) {
     clear([&dbName](const NamespaceString& bucketNs) { return bucketNs.db() == dbName; });
 }
 
+BucketCatalog::ClosedBuckets BucketCatalog::takeClosedBuckets(const NamespaceString& ns) {
+    stdx::lock_guard lk{_closedBucketsMutex};
+    auto it = _closedBuckets.find(ns);
+    if (it == _closedBuckets.end()) {
+        return {};
+    }
+    auto closedBuckets = std::move(it->second);
+    _closedBuckets.erase(it);
+    return closedBuckets;
+}
+
+std::vector<NamespaceString> BucketCatalog::getNamespacesWithClosedBuckets() const {
+    stdx::lock_guard lk{_closedBucketsMutex};
+    std::vector<NamespaceString> namespaces;
+    for (auto&& [ns, closedBuckets] : _closedBuckets) {
+        namespaces.push_back(ns);
+    }
+    return namespaces;
+}
+
+void BucketCatalog::returnClosedBuckets(const NamespaceString& ns, ClosedBuckets closedBuckets) {
+    if (closedBuckets.empty()) {
+        return;
+    }
+
+    stdx::lock_guard lk{_closedBucketsMutex};
+    auto& tracked = _closedBuckets[ns];
+    tracked.insert(tracked.begin(),
+                   std::make_move_iterator(closedBuckets.begin()),
+                   std::make_move_iterator(closedBuckets.end()));
+}
+
+bool BucketCatalog::isBucketCompressionEnabled() {
+    return gTimeseriesBucketCompression.load() &&
+        serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+        serverGlobalParams.featureCompatibility.isGreaterThanOrEqualTo(
+            ServerGlobalParams::FeatureCompatibility::Version::kVersion50);
+}
+
+void BucketCatalog::reportBucketCompression(const NamespaceString& ns, bool compressed) {
+    auto stats = _getExecutionStats(ns);
+    if (compressed) {
+        stats->numBucketsCompressed.fetchAndAddRelaxed(1);
+    } else {
+        stats->numBucketsCompressionFailed.fetchAndAddRelaxed(1);
+    }
+}
+
+void BucketCatalog::reportBucketMerge(const NamespaceString& ns, std::size_t numMergedBuckets) {
+    _getExecutionStats(ns)->numBucketsMerged.fetchAndAddRelaxed(numMergedBuckets);
+}
+
 void BucketCatalog::appendExecutionStats(const NamespaceString& ns, BSONObjBuilder* builder) const {
     const auto stats = _getExecutionStats(ns);
 
@@ -419,6 +556,15 @@ void BucketCatalog::appendExecutionStats(const NamespaceString& ns, BSONObjBuild
                           stats->numBucketsClosedDueToTimeBackward.load());
     builder->appendNumber("numBucketsClosedDueToMemoryThreshold",
                           stats->numBucketsClosedDueToMemoryThreshold.load());
+    builder->appendNumber("numBucketsArchivedDueToTimeForward",
+                          stats->numBucketsArchivedDueToTimeForward.load());
+    builder->appendNumber("numBucketsArchivedDueToTimeBackward",
+                          stats->numBucketsArchivedDueToTimeBackward.load());
+    builder->appendNumber("numBucketsReopened", stats->numBucketsReopened.load());
+    builder->appendNumber("numBucketsCompressed", stats->numBucketsCompressed.load());
+    builder->appendNumber("numBucketsCompressionFailed",
+                          stats->numBucketsCompressionFailed.load());
+    builder->appendNumber("numBucketsMerged", stats->numBucketsMerged.load());
     auto commits = stats->numCommits.load();
     builder->appendNumber("numCommits", commits);
     builder->appendNumber("numWaits", stats->numWaits.load());
@@ -445,37 +591,273 @@ BucketCatalog::StripedMutex::ExclusiveLock BucketCatalog::StripedMutex::lockExcl
     return ExclusiveLock{*this};
 }
 
-BucketCatalog::StripedMutex::SharedLock BucketCatalog::_lockShared() const {
-    return _bucketMutex.lockShared();
+std::size_t BucketCatalog::_getStripeNumber(const BucketKey& key) {
+    auto hash = absl::Hash<std::pair<std::size_t, std::size_t>>()(
+        {absl::Hash<NamespaceString>()(key.ns),
+         hashIgnoringFieldOrder(key.metadata.getMetaElement())});
+    return hash % kNumberOfStripes;
 }
 
-BucketCatalog::StripedMutex::ExclusiveLock BucketCatalog::_lockExclusive() const {
-    return _bucketMutex.lockExclusive();
+BucketCatalog::Bucket* BucketCatalog::_useBucket(const Stripe& stripe,
+                                                 WithLock,
+                                                 Bucket* bucket) const {
+    auto it = stripe.allBuckets.find(bucket);
+    if (it == stripe.allBuckets.end()) {
+        return nullptr;
+    }
+
+    auto statesIt = stripe.bucketStates.find(bucket->_id);
+    invariant(statesIt != stripe.bucketStates.end());
+    auto& [_, state] = *statesIt;
+    if (state == BucketState::kCleared || state == BucketState::kPreparedAndCleared) {
+        return nullptr;
+    }
+
+    return bucket;
+}
+
+BucketCatalog::Bucket* BucketCatalog::_findOpenBucket(Stripe* stripe,
+                                                      WithLock stripeLock,
+                                                      const HashedBucketKey& key) {
+    auto it = stripe->openBuckets.find(key);
+    if (it == stripe->openBuckets.end()) {
+        return nullptr;
+    }
+
+    Bucket* bucket = _useBucket(*stripe, stripeLock, it->second);
+    if (bucket) {
+        _markBucketNotIdle(stripe, stripeLock, bucket);
+    }
+    return bucket;
+}
+
+BucketCatalog::Bucket* BucketCatalog::_useOrCreateBucket(Stripe* stripe,
+                                                         WithLock stripeLock,
+                                                         const HashedBucketKey& hashedKey,
+                                                         BucketKey* key,
+                                                         const Date_t& time,
+                                                         const TimeseriesOptions& options,
+                                                         ExecutionStats* stats) {
+    // First we try to find the bucket without normalizing the key as the normalization is an
+    // expensive operation.
+    if (Bucket* bucket = _findOpenBucket(stripe, stripeLock, hashedKey)) {
+        return bucket;
+    }
+
+    // If not found, we normalize the metadata object and try to find it again. Re-construct the
+    // key as it was before normalization so that we can store it for the bucket.
+    BSONElement nonNormalizedMetadata = key->metadata.getMetaElement();
+    auto originalBucketKey = nonNormalizedMetadata
+        ? key->withCopiedMetadata(nonNormalizedMetadata.wrap())
+        : key->withCopiedMetadata(BSONObj());
+    auto hashedOriginalKey = BucketHasher{}.hashed_key(originalBucketKey);
+    key->metadata.normalize();
+    auto hashedNormalizedKey = BucketHasher{}.hashed_key(*key);
+
+    auto it = stripe->openBuckets.find(hashedNormalizedKey);
+    if (it == stripe->openBuckets.end()) {
+        // No open bucket for this metadata.
+        return _createBucket(stripe,
+                             stripeLock,
+                             hashedNormalizedKey,
+                             hashedOriginalKey,
+                             time,
+                             options,
+                             stats,
+                             true /* openedDueToMetadata */);
+    }
+
+    Bucket* bucket = it->second;
+    if (!_useBucket(*stripe, stripeLock, bucket)) {
+        _abort(stripe, stripeLock, bucket, nullptr, boost::none);
+        return _createBucket(stripe,
+                             stripeLock,
+                             hashedNormalizedKey,
+                             hashedOriginalKey,
+                             time,
+                             options,
+                             stats,
+                             true /* openedDueToMetadata */);
+    }
+
+    // Store the non-normalized key if we still have free slots, to avoid the need to normalize
+    // for future lookups with this incoming field order.
+    if (bucket->_nonNormalizedKeyMetadatas.size() <
+        bucket->_nonNormalizedKeyMetadatas.capacity()) {
+        auto [_, inserted] =
+            stripe->openBuckets.insert(std::make_pair(hashedOriginalKey, bucket));
+        if (inserted) {
+            const auto& metadata = originalBucketKey.metadata.toBSON();
+            bucket->_nonNormalizedKeyMetadatas.push_back(metadata);
+            // Increment the memory usage to store this key and value in openBuckets
+            bucket->_memoryUsage +=
+                originalBucketKey.ns.size() + metadata.objsize() + sizeof(bucket);
+        }
+    }
+
+    _markBucketNotIdle(stripe, stripeLock, bucket);
+    return bucket;
+}
+
+BucketCatalog::Bucket* BucketCatalog::_rollover(Stripe* stripe,
+                                                WithLock stripeLock,
+                                                Bucket* bucket,
+                                                BucketKey* key,
+                                                const Date_t& time,
+                                                const TimeseriesOptions& options,
+                                                ExecutionStats* stats) {
+    auto prevMetadata = key->metadata.getMetaElement();
+    auto prevBucketKey = prevMetadata ? key->withCopiedMetadata(prevMetadata.wrap())
+                                      : key->withCopiedMetadata(BSONObj());
+    auto hashedKey = BucketHasher{}.hashed_key(prevBucketKey);
+    key->metadata.normalize();
+    auto hashedNormalizedKey = BucketHasher{}.hashed_key(*key);
+
+    if (bucket->allCommitted()) {
+        // The bucket does not contain any measurements that are yet to be committed, so we can
+        // remove it now. Otherwise, we must keep the bucket around until it is committed.
+        _markBucketClosed(bucket);
+        bool removed = _removeBucket(stripe, stripeLock, bucket);
+        invariant(removed);
+    } else {
+        bucket->_full = true;
+
+        // We will recreate a new bucket for the same key below. We also need to cleanup all extra
+        // metadata keys added for the old bucket instance.
+        _removeNonNormalizedKeysForBucket(stripe, stripeLock, bucket);
+    }
+
+    return _createBucket(stripe,
+                         stripeLock,
+                         hashedNormalizedKey,
+                         hashedKey,
+                         time,
+                         options,
+                         stats,
+                         false /* openedDueToMetadata */);
+}
+
+BucketCatalog::Bucket* BucketCatalog::_archiveAndReopen(
+    Stripe* stripe,
+    WithLock stripeLock,
+    Bucket* bucket,
+    BucketKey* key,
+    const Date_t& time,
+    const TimeseriesOptions& options,
+    ExecutionStats* stats,
+    const std::function<bool(Bucket*)>& canTakeMeasurement) {
+    auto prevMetadata = key->metadata.getMetaElement();
+    auto prevBucketKey = prevMetadata ? key->withCopiedMetadata(prevMetadata.wrap())
+                                      : key->withCopiedMetadata(BSONObj());
+    auto hashedKey = BucketHasher{}.hashed_key(prevBucketKey);
+    key->metadata.normalize();
+    auto hashedNormalizedKey = BucketHasher{}.hashed_key(*key);
+
+    _archiveBucket(stripe, stripeLock, bucket);
+
+    auto it = stripe->archivedBuckets.find(hashedNormalizedKey);
+    if (it != stripe->archivedBuckets.end()) {
+        auto& archived = it->second;
+        auto candidate = std::find_if(archived.begin(), archived.end(), [&](Bucket* candidate) {
+            return _useBucket(*stripe, stripeLock, candidate) && canTakeMeasurement(candidate);
+        });
+        if (candidate != archived.end()) {
+            Bucket* reopened = *candidate;
+            archived.erase(candidate);
+            if (archived.empty()) {
+                stripe->archivedBuckets.erase(it);
+            }
+
+            reopened->_archived = false;
+            _markBucketNotIdle(stripe, stripeLock, reopened);
+            stripe->openBuckets[hashedNormalizedKey] = reopened;
+            stripe->openBuckets[hashedKey] = reopened;
+            reopened->_nonNormalizedKeyMetadatas.push_back(hashedKey.key->metadata.toBSON());
+            stats->numBucketsReopened.fetchAndAddRelaxed(1);
+            return reopened;
+        }
+    }
+
+    return _createBucket(stripe,
+                         stripeLock,
+                         hashedNormalizedKey,
+                         hashedKey,
+                         time,
+                         options,
+                         stats,
+                         false /* openedDueToMetadata */);
+}
+
+void BucketCatalog::_archiveBucket(Stripe* stripe, WithLock stripeLock, Bucket* bucket) {
+    // The bucket stays in allBuckets, but can no longer be found through the extra metadata keys.
+    // Its normalized key is taken over by the bucket which replaces it.
+    _removeNonNormalizedKeysForBucket(stripe, stripeLock, bucket);
+    bucket->_archived = true;
+    if (bucket->allCommitted()) {
+        _markBucketIdle(stripe, stripeLock, bucket);
+    }
+
+    auto& archived = stripe->archivedBuckets[{bucket->_ns, bucket->_metadata}];
+    archived.push_back(bucket);
+    if (archived.size() <= kMaxArchivedBucketsPerKey) {
+        return;
+    }
+
+    Bucket* oldest = archived.front();
+    archived.erase(archived.begin());
+    oldest->_archived = false;
+    if (oldest->allCommitted()) {
+        _markBucketClosed(oldest);
+        bool removed = _removeBucket(stripe, stripeLock, oldest);
+        invariant(removed);
+    } else {
+        // It will be removed once its outstanding measurements are committed.
+        oldest->_full = true;
+    }
+}
+
+BucketCatalog::Bucket* BucketCatalog::_createBucket(Stripe* stripe,
+                                                    WithLock stripeLock,
+                                                    const HashedBucketKey& normalizedKey,
+                                                    const HashedBucketKey& key,
+                                                    const Date_t& time,
+                                                    const TimeseriesOptions& options,
+                                                    ExecutionStats* stats,
+                                                    bool openedDuetoMetadata) {
+    Bucket* bucket = _allocateBucket(
+        stripe, stripeLock, normalizedKey, time, options, stats, openedDuetoMetadata);
+    stripe->openBuckets[key] = bucket;
+    bucket->_nonNormalizedKeyMetadatas.push_back(key.key->metadata.toBSON());
+    return bucket;
 }
 
 void BucketCatalog::_waitToCommitBatch(const std::shared_ptr<WriteBatch>& batch) {
+    auto& stripe = _stripes[batch->_stripe];
     while (true) {
-        BucketAccess bucket{this, batch->bucket()};
-        if (!bucket) {
-            return;
-        }
+        std::shared_ptr<WriteBatch> current;
+        {
+            stdx::lock_guard stripeLock{stripe.mutex};
+            Bucket* bucket = _useBucket(stripe, stripeLock, batch->bucket());
+            if (!bucket) {
+                return;
+            }
 
-        auto current = bucket->_preparedBatch;
-        if (!current) {
-            // No other batches for this bucket are currently committing, so we can proceed.
-            bucket->_preparedBatch = batch;
-            break;
+            current = bucket->_preparedBatch;
+            if (!current) {
+                // No other batches for this bucket are currently committing, so we can proceed.
+                bucket->_preparedBatch = batch;
+                return;
+            }
         }
 
         // We have to wait for someone else to finish.
-        bucket.release();
         current->getResult().getStatus().ignore();  // We don't care about the result.
     }
 }
 
-bool BucketCatalog::_removeBucket(Bucket* bucket, bool expiringBuckets) {
-    auto it = _allBuckets.find(bucket);
-    if (it == _allBuckets.end()) {
+bool BucketCatalog::_removeBucket(Stripe* stripe, WithLock stripeLock, Bucket* bucket) {
+    auto it = stripe->allBuckets.find(bucket);
+    if (it == stripe->allBuckets.end()) {
         return false;
     }
 
@@ -483,26 +865,59 @@ bool BucketCatalog::_removeBucket(Bucket* bucket, bool expiringBuckets) {
     invariant(!bucket->_preparedBatch);
 
     _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
-    _markBucketNotIdle(bucket, expiringBuckets /* locked */);
-    _removeNonNormalizedKeysForBucket(bucket);
-    _openBuckets.erase({bucket->_ns, bucket->_metadata});
-    {
-        stdx::lock_guard statesLk{_statesMutex};
-        _bucketStates.erase(bucket->_id);
+    _markBucketNotIdle(stripe, stripeLock, bucket);
+    _removeNonNormalizedKeysForBucket(stripe, stripeLock, bucket);
+
+    // The key of a bucket which was rolled over or archived may already belong to its successor.
+    BucketKey key{bucket->_ns, bucket->_metadata};
+    if (auto openIt = stripe->openBuckets.find(key);
+        openIt != stripe->openBuckets.end() && openIt->second == bucket) {
+        stripe->openBuckets.erase(openIt);
     }
-    _allBuckets.erase(it);
+    if (bucket->_archived) {
+        auto archivedIt = stripe->archivedBuckets.find(key);
+        invariant(archivedIt != stripe->archivedBuckets.end());
+        auto& archived = archivedIt->second;
+        archived.erase(std::find(archived.begin(), archived.end(), bucket));
+        if (archived.empty()) {
+            stripe->archivedBuckets.erase(archivedIt);
+        }
+    }
+    stripe->bucketStates.erase(bucket->_id);
+    stripe->allBuckets.erase(it);
 
     return true;
 }
 
-void BucketCatalog::_removeNonNormalizedKeysForBucket(Bucket* bucket) {
+void BucketCatalog::_removeNonNormalizedKeysForBucket(Stripe* stripe, WithLock, Bucket* bucket) {
     auto comparator = bucket->_metadata.getComparator();
     for (auto&& metadata : bucket->_nonNormalizedKeyMetadatas) {
-        _openBuckets.erase({bucket->_ns, {metadata.firstElement(), metadata, comparator}});
+        auto it = stripe->openBuckets.find(
+            {bucket->_ns, {metadata.firstElement(), metadata, comparator}});
+        if (it != stripe->openBuckets.end() && it->second == bucket) {
+            stripe->openBuckets.erase(it);
+        }
+    }
+    bucket->_nonNormalizedKeyMetadatas.clear();
+}
+
+void BucketCatalog::_abort(Stripe* stripe,
+                           WithLock stripeLock,
+                           std::shared_ptr<WriteBatch> batch,
+                           const boost::optional<Status>& status) {
+    // Before we access the bucket, make sure it's still there.
+    Bucket* bucket = batch->bucket();
+    if (!stripe->allBuckets.contains(bucket)) {
+        // Special case, bucket has already been cleared, and we need only abort this batch.
+        batch->_abort(status, false);
+        return;
     }
+
+    _abort(stripe, stripeLock, bucket, batch, status);
 }
 
-void BucketCatalog::_abort(stdx::unique_lock<Mutex>& lk,
+void BucketCatalog::_abort(Stripe* stripe,
+                           WithLock stripeLock,
                            Bucket* bucket,
                            std::shared_ptr<WriteBatch> batch,
                            const boost::optional<Status>& status) {
@@ -527,70 +942,91 @@ void BucketCatalog::_abort(stdx::unique_lock<Mutex>& lk,
         prepared.reset();
     }
 
-    lk.unlock();
     if (doRemove) {
-        [[maybe_unused]] bool removed = _removeBucket(bucket, false /* expiringBuckets */);
+        [[maybe_unused]] bool removed = _removeBucket(stripe, stripeLock, bucket);
     }
 }
 
-void BucketCatalog::_markBucketIdle(Bucket* bucket) {
+void BucketCatalog::_markBucketIdle(Stripe* stripe, WithLock, Bucket* bucket) {
     invariant(bucket);
-    stdx::lock_guard lk{_idleMutex};
-    _idleBuckets.push_front(bucket);
-    bucket->_idleListEntry = _idleBuckets.begin();
+    stripe->idleBuckets.push_front(bucket);
+    bucket->_idleListEntry = stripe->idleBuckets.begin();
 }
 
-void BucketCatalog::_markBucketNotIdle(Bucket* bucket, bool locked) {
+void BucketCatalog::_markBucketNotIdle(Stripe* stripe, WithLock, Bucket* bucket) {
     invariant(bucket);
     if (bucket->_idleListEntry) {
-        stdx::unique_lock<Mutex> guard;
-        if (!locked) {
-            guard = stdx::unique_lock{_idleMutex};
-        }
-        _idleBuckets.erase(*bucket->_idleListEntry);
+        stripe->idleBuckets.erase(*bucket->_idleListEntry);
         bucket->_idleListEntry = boost::none;
     }
 }
 
-void BucketCatalog::_verifyBucketIsUnused(Bucket* bucket) const {
-    // Take a lock on the bucket so we guarantee no one else is accessing it. We can release it
-    // right away since no one else can take it again without taking the catalog lock, which we
-    // also hold outside this method.
-    stdx::lock_guard<Mutex> lk{bucket->_mutex};
+void BucketCatalog::_markBucketClosed(Bucket* bucket) {
+    if (!isBucketCompressionEnabled() || bucket->_numCommittedMeasurements == 0) {
+        return;
+    }
+
+    stdx::lock_guard lk{_closedBucketsMutex};
+    _closedBuckets[bucket->_ns].push_back({bucket->_id,
+                                           bucket->_timeField,
+                                           bucket->_metadata.toBSON(),
+                                           bucket->_latestTime,
+                                           bucket->_numCommittedMeasurements});
 }
 
-void BucketCatalog::_expireIdleBuckets(ExecutionStats* stats) {
-    // Must hold an exclusive lock on _bucketMutex from outside.
-    stdx::lock_guard lk{_idleMutex};
+void BucketCatalog::_expireIdleBuckets(Stripe* stripe,
+                                       WithLock stripeLock,
+                                       ExecutionStats* stats) {
+    auto aboveThreshold = [this] {
+        return _memoryUsage.load() >
+            static_cast<std::uint64_t>(gTimeseriesIdleBucketExpiryMemoryUsageThreshold);
+    };
 
     // As long as we still need space and have entries, close idle buckets.
-    while (!_idleBuckets.empty() &&
-           _memoryUsage.load() >
-               static_cast<std::uint64_t>(gTimeseriesIdleBucketExpiryMemoryUsageThreshold)) {
-        Bucket* bucket = _idleBuckets.back();
-        _verifyBucketIsUnused(bucket);
-        if (_removeBucket(bucket, true /* expiringBuckets */)) {
-            stats->numBucketsClosedDueToMemoryThreshold.fetchAndAddRelaxed(1);
+    auto expire = [&](Stripe* target, WithLock targetLock) {
+        while (!target->idleBuckets.empty() && aboveThreshold()) {
+            Bucket* bucket = target->idleBuckets.back();
+            _markBucketClosed(bucket);
+            if (_removeBucket(target, targetLock, bucket)) {
+                stats->numBucketsClosedDueToMemoryThreshold.fetchAndAddRelaxed(1);
+            }
+        }
+    };
+
+    expire(stripe, stripeLock);
+
+    // Only steal idle buckets from other stripes if they aren't busy, both to avoid contention and
+    // because we are already holding the lock of our own stripe.
+    for (auto&& other : _stripes) {
+        if (!aboveThreshold()) {
+            break;
+        }
+        if (&other == stripe) {
+            continue;
         }
-    }
-}
 
-std::size_t BucketCatalog::_numberOfIdleBuckets() const {
-    stdx::lock_guard lk{_idleMutex};
-    return _idleBuckets.size();
+        stdx::unique_lock otherLock{other.mutex, stdx::try_to_lock};
+        if (otherLock.owns_lock()) {
+            expire(&other, otherLock);
+        }
+    }
 }
 
-BucketCatalog::Bucket* BucketCatalog::_allocateBucket(const BucketKey& key,
+BucketCatalog::Bucket* BucketCatalog::_allocateBucket(Stripe* stripe,
+                                                      WithLock stripeLock,
+                                                      const BucketKey& key,
                                                       const Date_t& time,
                                                       const TimeseriesOptions& options,
                                                       ExecutionStats* stats,
                                                       bool openedDuetoMetadata) {
-    _expireIdleBuckets(stats);
+    _expireIdleBuckets(stripe, stripeLock, stats);
 
-    auto [it, inserted] = _allBuckets.insert(std::make_unique<Bucket>());
+    auto [it, inserted] = stripe->allBuckets.insert(std::make_unique<Bucket>());
     Bucket* bucket = it->get();
+    bucket->_stripe = static_cast<std::size_t>(stripe - _stripes.data());
     _setIdTimestamp(bucket, time, options);
-    _openBuckets[key] = bucket;
+    stripe->bucketStates.emplace(bucket->_id, BucketState::kNormal);
+    stripe->openBuckets[key] = bucket;
 
     if (openedDuetoMetadata) {
         stats->numBucketsOpenedDueToMetadata.fetchAndAddRelaxed(1);
@@ -635,16 +1071,14 @@ void BucketCatalog::_setIdTimestamp(Bucket* bucket,
     auto controlDoc = buildControlMinTimestampDoc(options.getTimeField(), roundedSeconds);
     bucket->_minmax.update(
         controlDoc, bucket->_metadata.getMetaField(), bucket->_metadata.getComparator());
-
-    stdx::lock_guard statesLk{_statesMutex};
-    _bucketStates.emplace(bucket->_id, BucketState::kNormal);
 }
 
-boost::optional<BucketCatalog::BucketState> BucketCatalog::_setBucketState(const OID& id,
+boost::optional<BucketCatalog::BucketState> BucketCatalog::_setBucketState(Stripe* stripe,
+                                                                           WithLock,
+                                                                           const OID& id,
                                                                            BucketState target) {
-    stdx::lock_guard statesLk{_statesMutex};
-    auto it = _bucketStates.find(id);
-    if (it == _bucketStates.end()) {
+    auto it = stripe->bucketStates.find(id);
+    if (it == stripe->bucketStates.end()) {
         return boost::none;
     }
 
@@ -794,279 +1228,10 @@ std::shared_ptr<BucketCatalog::WriteBatch> BucketCatalog::Bucket::_activeBatch(
     return it->second;
 }
 
-BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
-                                          BucketKey& key,
-                                          const TimeseriesOptions& options,
-                                          ExecutionStats* stats,
-                                          const Date_t& time)
-    : _catalog(catalog), _key(&key), _options(&options), _stats(stats), _time(&time) {
-
-    auto bucketFound = [](BucketState bucketState) {
-        return bucketState == BucketState::kNormal || bucketState == BucketState::kPrepared;
-    };
-
-    // First we try to find the bucket without normalizing the key as the normalization is an
-    // expensive operation.
-    auto hashedKey = BucketHasher{}.hashed_key(key);
-    if (bucketFound(_findOpenBucketThenLock(hashedKey))) {
-        return;
-    }
-
-    // If not found, we normalize the metadata object and try to find it again.
-    // Save a copy of the non-normalized metadata before normalizing so we can add this key if the
-    // bucket was found for the normalized metadata. The BSON element is still refering to that of
-    // the document in current scope at this point. We will only make a copy of it when we decide to
-    // store it.
-    BSONElement nonNormalizedMetadata = key.metadata.getMetaElement();
-    key.metadata.normalize();
-    HashedBucketKey hashedNormalizedKey = BucketHasher{}.hashed_key(key);
-
-    if (bucketFound(_findOpenBucketThenLock(hashedNormalizedKey))) {
-        // Bucket found, check if we have available slots to store the non-normalized key
-        if (_bucket->_nonNormalizedKeyMetadatas.size() ==
-            _bucket->_nonNormalizedKeyMetadatas.capacity()) {
-            return;
-        }
-
-        // Release the bucket as we need to acquire the exclusive lock for the catalog.
-        release();
-
-        // Re-construct the key as it were before normalization.
-        auto originalBucketKey = nonNormalizedMetadata
-            ? key.withCopiedMetadata(nonNormalizedMetadata.wrap())
-            : key.withCopiedMetadata(BSONObj());
-        hashedKey.key = &originalBucketKey;
-
-        // Find the bucket under a catalog exclusive lock for the catalog. It may have been modified
-        // since we released our locks. If found we store the key to avoid the need to normalize for
-        // future lookups with this incoming field order.
-        BSONObj nonNormalizedMetadataObj =
-            nonNormalizedMetadata ? nonNormalizedMetadata.wrap() : BSONObj();
-        if (bucketFound(_findOpenBucketThenLockAndStoreKey(
-                hashedNormalizedKey, hashedKey, nonNormalizedMetadataObj))) {
-            return;
-        }
-    }
-
-    // Bucket not found, grab exclusive lock and create bucket with the key before normalization.
-    auto originalBucketKey = nonNormalizedMetadata
-        ? key.withCopiedMetadata(nonNormalizedMetadata.wrap())
-        : key.withCopiedMetadata(BSONObj());
-    hashedKey.key = &originalBucketKey;
-    auto lk = _catalog->_lockExclusive();
-    _findOrCreateOpenBucketThenLock(hashedNormalizedKey, hashedKey);
-}
-
-BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog, Bucket* bucket)
-    : _catalog(catalog) {
-    {
-        auto lk = _catalog->_lockShared();
-        auto bucketIt = _catalog->_allBuckets.find(bucket);
-        if (bucketIt == _catalog->_allBuckets.end()) {
-            return;
-        }
-
-        _bucket = bucket;
-        _acquire();
-    }
-
-    stdx::lock_guard statesLk{_catalog->_statesMutex};
-    auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-    invariant(statesIt != _catalog->_bucketStates.end());
-    auto& [_, state] = *statesIt;
-    if (state == BucketState::kCleared || state == BucketState::kPreparedAndCleared) {
-        release();
-    }
-}
-
-BucketCatalog::BucketAccess::~BucketAccess() {
-    if (isLocked()) {
-        release();
-    }
-}
-
-BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLock(
-    const HashedBucketKey& key) {
-    {
-        auto lk = _catalog->_lockShared();
-        auto it = _catalog->_openBuckets.find(key);
-        if (it == _catalog->_openBuckets.end()) {
-            // Bucket does not exist.
-            return BucketState::kCleared;
-        }
-
-        _bucket = it->second;
-        _acquire();
-    }
-
-    return _confirmStateForAcquiredBucket();
-}
-
-BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLockAndStoreKey(
-    const HashedBucketKey& normalizedKey,
-    const HashedBucketKey& nonNormalizedKey,
-    BSONObj nonNormalizedMetadata) {
-    invariant(!isLocked());
-    {
-        auto lk = _catalog->_lockExclusive();
-        auto it = _catalog->_openBuckets.find(normalizedKey);
-        if (it == _catalog->_openBuckets.end()) {
-            // Bucket does not exist.
-            return BucketState::kCleared;
-        }
-
-        _bucket = it->second;
-        _acquire();
-
-        // Store the non-normalized key if we still have free slots
-        if (_bucket->_nonNormalizedKeyMetadatas.size() <
-            _bucket->_nonNormalizedKeyMetadatas.capacity()) {
-            auto [_, inserted] =
-                _catalog->_openBuckets.insert(std::make_pair(nonNormalizedKey, _bucket));
-            if (inserted) {
-                _bucket->_nonNormalizedKeyMetadatas.push_back(nonNormalizedMetadata);
-                // Increment the memory usage to store this key and value in _openBuckets
-                _bucket->_memoryUsage += nonNormalizedKey.key->ns.size() +
-                    nonNormalizedMetadata.objsize() + sizeof(_bucket);
-            }
-        }
-    }
-
-    return _confirmStateForAcquiredBucket();
-}
-
-BucketCatalog::BucketState BucketCatalog::BucketAccess::_confirmStateForAcquiredBucket() {
-    stdx::lock_guard statesLk{_catalog->_statesMutex};
-    auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-    invariant(statesIt != _catalog->_bucketStates.end());
-    auto& [_, state] = *statesIt;
-    if (state == BucketState::kCleared || state == BucketState::kPreparedAndCleared) {
-        release();
-    } else {
-        _catalog->_markBucketNotIdle(_bucket, false /* locked */);
-    }
-
-    return state;
-}
-
-void BucketCatalog::BucketAccess::_findOrCreateOpenBucketThenLock(
-    const HashedBucketKey& normalizedKey, const HashedBucketKey& nonNormalizedKey) {
-    auto it = _catalog->_openBuckets.find(normalizedKey);
-    if (it == _catalog->_openBuckets.end()) {
-        // No open bucket for this metadata.
-        _create(normalizedKey, nonNormalizedKey);
-        return;
-    }
-
-    _bucket = it->second;
-    _acquire();
-
-    {
-        stdx::lock_guard statesLk{_catalog->_statesMutex};
-        auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-        invariant(statesIt != _catalog->_bucketStates.end());
-        auto& [_, state] = *statesIt;
-        if (state == BucketState::kNormal || state == BucketState::kPrepared) {
-            _catalog->_markBucketNotIdle(_bucket, false /* locked */);
-            return;
-        }
-    }
-
-    _catalog->_abort(_guard, _bucket, nullptr, boost::none);
-    _create(normalizedKey, nonNormalizedKey);
-}
-
-void BucketCatalog::BucketAccess::_acquire() {
-    invariant(_bucket);
-    _guard = stdx::unique_lock<Mutex>(_bucket->_mutex);
-}
-
-void BucketCatalog::BucketAccess::_create(const HashedBucketKey& normalizedKey,
-                                          const HashedBucketKey& nonNormalizedKey,
-                                          bool openedDuetoMetadata) {
-    invariant(_options);
-    _bucket =
-        _catalog->_allocateBucket(normalizedKey, *_time, *_options, _stats, openedDuetoMetadata);
-    _catalog->_openBuckets[nonNormalizedKey] = _bucket;
-    _bucket->_nonNormalizedKeyMetadatas.push_back(nonNormalizedKey.key->metadata.toBSON());
-    _acquire();
-}
-
-void BucketCatalog::BucketAccess::release() {
-    invariant(_guard.owns_lock());
-    _guard.unlock();
-    _bucket = nullptr;
-}
-
-bool BucketCatalog::BucketAccess::isLocked() const {
-    return _bucket && _guard.owns_lock();
-}
-
-BucketCatalog::Bucket* BucketCatalog::BucketAccess::operator->() {
-    invariant(isLocked());
-    return _bucket;
-}
-
-BucketCatalog::BucketAccess::operator bool() const {
-    return isLocked();
-}
-
-BucketCatalog::BucketAccess::operator BucketCatalog::Bucket*() const {
-    return _bucket;
-}
-
-void BucketCatalog::BucketAccess::rollover(const std::function<bool(BucketAccess*)>& isBucketFull) {
-    invariant(isLocked());
-    invariant(_key);
-    invariant(_time);
-
-    auto oldBucket = _bucket;
-    release();
-
-    // Precompute the hash outside the lock, since it's expensive.
-    auto prevMetadata = _key->metadata.getMetaElement();
-    _key->metadata.normalize();
-    auto hashedNormalizedKey = BucketHasher{}.hashed_key(*_key);
-    auto prevBucketKey = prevMetadata ? _key->withCopiedMetadata(prevMetadata.wrap())
-                                      : _key->withCopiedMetadata(BSONObj());
-    auto hashedKey = BucketHasher{}.hashed_key(prevBucketKey);
-
-    auto lk = _catalog->_lockExclusive();
-    _findOrCreateOpenBucketThenLock(hashedNormalizedKey, hashedKey);
-
-    // Recheck if still full now that we've reacquired the bucket.
-    bool sameBucket =
-        oldBucket == _bucket;  // Only record stats if bucket has changed, don't double-count.
-    if (sameBucket || isBucketFull(this)) {
-        // The bucket is indeed full, so create a new one.
-        if (_bucket->allCommitted()) {
-            // The bucket does not contain any measurements that are yet to be committed, so we can
-            // remove it now. Otherwise, we must keep the bucket around until it is committed.
-            oldBucket = _bucket;
-            release();
-            bool removed = _catalog->_removeBucket(oldBucket, false /* expiringBuckets */);
-            invariant(removed);
-        } else {
-            _bucket->_full = true;
-
-            // We will recreate a new bucket for the same key below. We also need to cleanup all
-            // extra metadata keys added for the old bucket instance.
-            _catalog->_removeNonNormalizedKeysForBucket(_bucket);
-            release();
-        }
-
-        _create(hashedNormalizedKey, hashedKey, false /* openedDueToMetadata */);
-    }
-}
-
-Date_t BucketCatalog::BucketAccess::getTime() const {
-    return _bucket->id().asDateT();
-}
-
 BucketCatalog::WriteBatch::WriteBatch(Bucket* bucket,
                                       const UUID& lsid,
                                       const std::shared_ptr<ExecutionStats>& stats)
-    : _bucket{bucket}, _lsid(lsid), _stats{stats} {}
+    : _bucket{bucket}, _stripe{bucket->_stripe}, _lsid(lsid), _stats{stats} {}
 
 bool BucketCatalog::WriteBatch::claimCommitRights() {
     return !_commitRights.swap(true);
@@ -1221,14 +1386,20 @@ public:
             }
         }
 
-        auto lk = bucketCatalog._lockShared();
+        long long numBuckets = 0;
+        long long numOpenBuckets = 0;
+        long long numIdleBuckets = 0;
+        for (const auto& stripe : bucketCatalog._stripes) {
+            stdx::lock_guard stripeLock{stripe.mutex};
+            numBuckets += stripe.allBuckets.size();
+            numOpenBuckets += stripe.openBuckets.size();
+            numIdleBuckets += stripe.idleBuckets.size();
+        }
+
         BSONObjBuilder builder;
-        builder.appendNumber("numBuckets",
-                             static_cast<long long>(bucketCatalog._allBuckets.size()));
-        builder.appendNumber("numOpenBuckets",
-                             static_cast<long long>(bucketCatalog._openBuckets.size()));
-        builder.appendNumber("numIdleBuckets",
-                             static_cast<long long>(bucketCatalog._numberOfIdleBuckets()));
+        builder.appendNumber("numBuckets", numBuckets);
+        builder.appendNumber("numOpenBuckets", numOpenBuckets);
+        builder.appendNumber("numIdleBuckets", numIdleBuckets);
         builder.appendNumber("memoryUsage",
                              static_cast<long long>(bucketCatalog._memoryUsage.load()));
         return builder.obj();
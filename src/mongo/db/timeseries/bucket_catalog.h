@@ -31,6 +31,7 @@
 
 #include <boost/container/small_vector.hpp>
 #include <boost/container/static_vector.hpp>
+#include <array>
 #include <queue>
 
 #include "mongo/bson/unordered_fields_bsonobj_comparator.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/views/view.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -65,6 +67,20 @@ public:
         boost::optional<OID> electionId;
     };
 
+    /**
+     * A bucket which will not receive any more measurements and whose measurements have all been
+     * committed. Its document can be rewritten in the compressed format, and merged with other
+     * closed buckets of the same metadata.
+     */
+    struct ClosedBucket {
+        OID bucketId;
+        std::string timeField;
+        BSONObj metadata;
+        Date_t latestTime;
+        uint32_t numMeasurements = 0;
+    };
+    using ClosedBuckets = std::vector<ClosedBucket>;
+
     /**
      * The basic unit of work for a bucket. Each insert will return a shared_ptr to a WriteBatch.
      * When a writer is finished with all their insertions, they should then take steps to ensure
@@ -149,6 +165,11 @@ public:
 
 
         Bucket* _bucket;
+
+        // The stripe of the catalog which holds the bucket. Unlike the bucket, it remains valid
+        // after the batch is finished or aborted.
+        const std::size_t _stripe;
+
         const UUID _lsid;
         std::shared_ptr<ExecutionStats> _stats;
 
@@ -173,14 +194,14 @@ public:
     BucketCatalog operator=(const BucketCatalog&) = delete;
 
     /**
-     * Returns the metadata for the given bucket in the following format:
+     * Returns the metadata for the bucket of the given batch in the following format:
      *     {<metadata field name>: <value>}
      * All measurements in the given bucket share same metadata value.
      *
-     * Returns an empty document if the given bucket cannot be found or if this time-series
-     * collection was not created with a metadata field name.
+     * Returns an empty document if the bucket cannot be found or if this time-series collection
+     * was not created with a metadata field name.
      */
-    BSONObj getMetadata(Bucket* bucket) const;
+    BSONObj getMetadata(const std::shared_ptr<WriteBatch>& batch) const;
 
     /**
      * Returns the WriteBatch into which the document was inserted. Any caller who receives the same
@@ -237,6 +258,45 @@ public:
      */
     void clear(StringData dbName);
 
+    /**
+     * Returns the buckets of the given namespace which have been closed since the last call, and
+     * forgets about them. Closed buckets are only tracked while isBucketCompressionEnabled() is
+     * true.
+     */
+    ClosedBuckets takeClosedBuckets(const NamespaceString& ns);
+
+    /**
+     * Returns the namespaces which have closed buckets waiting to be taken.
+     */
+    std::vector<NamespaceString> getNamespacesWithClosedBuckets() const;
+
+    /**
+     * Gives back closed buckets of the given namespace which were taken but not processed. They
+     * are returned ahead of the buckets closed since by the next call to takeClosedBuckets().
+     */
+    void returnClosedBuckets(const NamespaceString& ns, ClosedBuckets closedBuckets);
+
+    /**
+     * Returns whether closed buckets should be rewritten in the compressed format. Binaries older
+     * than 5.0 cannot read compressed buckets, so besides timeseriesBucketCompression being enabled
+     * this requires the featureCompatibilityVersion to be fully upgraded to 5.0. Compressed buckets
+     * cannot outlive a downgrade, since setFeatureCompatibilityVersion refuses to downgrade while
+     * any time-series collection exists.
+     */
+    static bool isBucketCompressionEnabled();
+
+    /**
+     * Records in the execution stats of the given namespace whether one of its closed buckets could
+     * be compressed.
+     */
+    void reportBucketCompression(const NamespaceString& ns, bool compressed);
+
+    /**
+     * Records in the execution stats of the given namespace that the given number of its closed
+     * buckets were merged into another closed bucket.
+     */
+    void reportBucketMerge(const NamespaceString& ns, std::size_t numMergedBuckets);
+
     /**
      * Appends the execution stats for the given namespace to the builder.
      */
@@ -333,7 +393,6 @@ private:
 public:
     class Bucket {
     public:
-        friend class BucketAccess;
         friend class BucketCatalog;
 
         /**
@@ -369,8 +428,9 @@ public:
         std::shared_ptr<WriteBatch> _activeBatch(const UUID& lsid,
                                                  const std::shared_ptr<ExecutionStats>& stats);
 
-        // Access to the bucket is controlled by this lock
-        mutable Mutex _mutex;
+        // The stripe of the catalog which holds the bucket. Access to the bucket is controlled by
+        // the lock of that stripe.
+        std::size_t _stripe = 0;
 
         // The bucket ID for the underlying document
         OID _id = OID::gen();
@@ -378,6 +438,9 @@ public:
         // The namespace that this bucket is used for.
         NamespaceString _ns;
 
+        // The time field of the namespace, needed to compress the bucket once it is closed.
+        std::string _timeField;
+
         // The metadata of the data that this bucket contains.
         BucketMetadata _metadata;
 
@@ -410,6 +473,10 @@ public:
         // range.
         bool _full = false;
 
+        // Whether the bucket was replaced as the open bucket for its key because a measurement
+        // fell outside of its time range, but is kept so that it can be reopened.
+        bool _archived = false;
+
         // The batch that has been prepared and is currently in the process of being committed, if
         // any.
         std::shared_ptr<WriteBatch> _preparedBatch;
@@ -417,7 +484,7 @@ public:
         // Batches, per logical session, that haven't been committed or aborted yet.
         stdx::unordered_map<UUID, std::shared_ptr<WriteBatch>, UUID::Hash> _batches;
 
-        // If the bucket is in _idleBuckets, then its position is recorded here.
+        // If the bucket is in its stripe's idle list, then its position is recorded here.
         boost::optional<IdleList::iterator> _idleListEntry = boost::none;
 
         // Approximate memory usage of this bucket.
@@ -434,6 +501,12 @@ private:
         AtomicWord<long long> numBucketsClosedDueToTimeForward;
         AtomicWord<long long> numBucketsClosedDueToTimeBackward;
         AtomicWord<long long> numBucketsClosedDueToMemoryThreshold;
+        AtomicWord<long long> numBucketsArchivedDueToTimeForward;
+        AtomicWord<long long> numBucketsArchivedDueToTimeBackward;
+        AtomicWord<long long> numBucketsReopened;
+        AtomicWord<long long> numBucketsCompressed;
+        AtomicWord<long long> numBucketsCompressionFailed;
+        AtomicWord<long long> numBucketsMerged;
         AtomicWord<long long> numCommits;
         AtomicWord<long long> numWaits;
         AtomicWord<long long> numMeasurementsCommitted;
@@ -537,143 +610,179 @@ private:
     };
 
     /**
-     * Helper class to handle all the locking necessary to lookup and lock a bucket for use. This
-     * is intended primarily for using a single bucket, including replacing it when it becomes full.
-     * If the usage pattern iterates over several buckets, you will instead want to use raw access
-     * using the different mutexes with the locking semantics described below.
+     * The buckets of the catalog are sharded into stripes by their namespace and metadata, so that
+     * inserts into unrelated buckets don't contend with each other. A bucket, its lookup keys, its
+     * state and its idle list entry all live in exactly one stripe and may only be accessed while
+     * holding the mutex of that stripe. No other lock of the catalog may be acquired while holding
+     * a stripe's mutex, except for _closedBucketsMutex and the mutexes of other stripes using
+     * try_lock.
      */
-    class BucketAccess {
-    public:
-        BucketAccess() = delete;
-        BucketAccess(BucketCatalog* catalog,
-                     BucketKey& key,
-                     const TimeseriesOptions& options,
-                     ExecutionStats* stats,
-                     const Date_t& time);
-        BucketAccess(BucketCatalog* catalog, Bucket* bucket);
-        ~BucketAccess();
-
-        bool isLocked() const;
-        Bucket* operator->();
-        operator bool() const;
-        operator Bucket*() const;
-
-        // Release the bucket lock, typically in order to reacquire the catalog lock.
-        void release();
+    struct Stripe {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("BucketCatalog::Stripe::mutex");
 
-        /**
-         * Close the existing, full bucket and open a new one for the same metadata.
-         * Parameter is a function which should check that the bucket is indeed still full after
-         * reacquiring the necessary locks. The first parameter will give the function access to
-         * this BucketAccess instance, with the bucket locked.
-         */
-        void rollover(const std::function<bool(BucketAccess*)>& isBucketFull);
+        // All buckets currently in the stripe, including buckets which are full but not yet
+        // committed.
+        stdx::unordered_set<std::unique_ptr<Bucket>> allBuckets;
 
-        // Retrieve the time associated with the bucket (id)
-        Date_t getTime() const;
+        // The current open bucket for each namespace and metadata pair.
+        stdx::unordered_map<BucketKey, Bucket*, BucketHasher, BucketEq> openBuckets;
 
-    private:
-        /**
-         * Helper to find and lock an open bucket for the given metadata if it exists. Takes a
-         * shared lock on the catalog. Returns the state of the bucket if it is locked and usable.
-         * In case the bucket does not exist or was previously cleared and thus is not usable, the
-         * return value will be BucketState::kCleared.
-         */
-        BucketState _findOpenBucketThenLock(const HashedBucketKey& key);
+        // The state of each bucket in the stripe.
+        stdx::unordered_map<OID, BucketState, OID::Hasher> bucketStates;
 
-        /**
-         * Same as _findOpenBucketThenLock above but takes an exclusive lock on the catalog. In
-         * addition to finding the bucket it also store a non-normalized key if there are available
-         * slots in the bucket.
-         */
-        BucketState _findOpenBucketThenLockAndStoreKey(const HashedBucketKey& normalizedKey,
-                                                       const HashedBucketKey& key,
-                                                       BSONObj metadata);
+        // Buckets that do not have any writers.
+        IdleList idleBuckets;
 
-        /**
-         * Helper to determine the state of the bucket that is found by _findOpenBucketThenLock and
-         * _findOpenBucketThenLockAndStoreKey. Requires the bucket lock to be acquired before
-         * calling this function and it may release the lock depending on the state.
-         */
-        BucketState _confirmStateForAcquiredBucket();
-
-        // Helper to find an open bucket for the given metadata if it exists, create it if it
-        // doesn't, and lock it. Requires an exclusive lock on the catalog.
-        void _findOrCreateOpenBucketThenLock(const HashedBucketKey& normalizedKey,
-                                             const HashedBucketKey& key);
-
-        // Lock _bucket.
-        void _acquire();
-
-        // Allocate a new bucket in the catalog, set the local state to that bucket, and acquire
-        // a lock on it.
-        void _create(const HashedBucketKey& normalizedKey,
-                     const HashedBucketKey& key,
-                     bool openedDuetoMetadata = true);
-
-        BucketCatalog* _catalog;
-        BucketKey* _key = nullptr;
-        const TimeseriesOptions* _options = nullptr;
-        ExecutionStats* _stats = nullptr;
-        const Date_t* _time = nullptr;
-
-        Bucket* _bucket = nullptr;
-        stdx::unique_lock<Mutex> _guard;
+        // Buckets which can be reopened for each namespace and metadata pair, from the least to
+        // the most recently archived.
+        stdx::unordered_map<BucketKey, std::vector<Bucket*>, BucketHasher, BucketEq>
+            archivedBuckets;
     };
 
+    // The maximum number of archived buckets kept for each namespace and metadata pair.
+    static constexpr std::size_t kMaxArchivedBucketsPerKey = 4;
+
     class ServerStatus;
 
-    StripedMutex::SharedLock _lockShared() const;
-    StripedMutex::ExclusiveLock _lockExclusive() const;
+    /**
+     * Returns the stripe which holds the buckets for the given key. It only depends on the
+     * namespace and on the metadata value regardless of the order of its fields, so that the key
+     * maps to the same stripe before and after its metadata is normalized.
+     */
+    static std::size_t _getStripeNumber(const BucketKey& key);
+
+    /**
+     * Returns the given bucket if it is still held by the stripe and has not been cleared, or
+     * nullptr otherwise.
+     */
+    Bucket* _useBucket(const Stripe& stripe, WithLock stripeLock, Bucket* bucket) const;
+
+    /**
+     * Returns the open bucket for the given key if it exists and can be inserted into, or nullptr
+     * otherwise.
+     */
+    Bucket* _findOpenBucket(Stripe* stripe, WithLock stripeLock, const HashedBucketKey& key);
+
+    /**
+     * Returns the open bucket for the given key, creating it if needed. The key is first looked up
+     * as it is, since normalizing the metadata is expensive. If that fails, the metadata of the key
+     * is normalized, and the original key is stored for the bucket if there is a free slot, so
+     * that future lookups with the same field order don't need to normalize.
+     */
+    Bucket* _useOrCreateBucket(Stripe* stripe,
+                               WithLock stripeLock,
+                               const HashedBucketKey& hashedKey,
+                               BucketKey* key,
+                               const Date_t& time,
+                               const TimeseriesOptions& options,
+                               ExecutionStats* stats);
+
+    /**
+     * Closes the given full bucket and opens a new one for the same key. The bucket is removed
+     * right away if all its measurements have been committed, otherwise it is kept around until
+     * they are.
+     */
+    Bucket* _rollover(Stripe* stripe,
+                      WithLock stripeLock,
+                      Bucket* bucket,
+                      BucketKey* key,
+                      const Date_t& time,
+                      const TimeseriesOptions& options,
+                      ExecutionStats* stats);
+
+    /**
+     * Archives the given bucket, which cannot take the measurement only because of its time range,
+     * and reopens an archived bucket for the same key which 'canTakeMeasurement'. Opens a new
+     * bucket if there is none.
+     */
+    Bucket* _archiveAndReopen(Stripe* stripe,
+                              WithLock stripeLock,
+                              Bucket* bucket,
+                              BucketKey* key,
+                              const Date_t& time,
+                              const TimeseriesOptions& options,
+                              ExecutionStats* stats,
+                              const std::function<bool(Bucket*)>& canTakeMeasurement);
+
+    /**
+     * Keeps the given bucket for its key so that it can be reopened later. Once there are more
+     * than kMaxArchivedBucketsPerKey archived buckets for the key, the least recently archived one
+     * is closed.
+     */
+    void _archiveBucket(Stripe* stripe, WithLock stripeLock, Bucket* bucket);
+
+    /**
+     * Allocates a new bucket for the normalized key and also stores it under the key as it was
+     * given by the user.
+     */
+    Bucket* _createBucket(Stripe* stripe,
+                          WithLock stripeLock,
+                          const HashedBucketKey& normalizedKey,
+                          const HashedBucketKey& key,
+                          const Date_t& time,
+                          const TimeseriesOptions& options,
+                          ExecutionStats* stats,
+                          bool openedDuetoMetadata);
 
     void _waitToCommitBatch(const std::shared_ptr<WriteBatch>& batch);
 
     /**
-     * Removes the given bucket from the bucket catalog's internal data structures.
+     * Removes the given bucket from the stripe's internal data structures.
      */
-    bool _removeBucket(Bucket* bucket, bool expiringBuckets);
+    bool _removeBucket(Stripe* stripe, WithLock stripeLock, Bucket* bucket);
 
     /**
-     * Removes extra non-normalized BucketKey's for the given bucket from the
-     * bucket catalog's internal data structures.
+     * Removes extra non-normalized BucketKey's for the given bucket from the stripe's internal
+     * data structures.
      */
-    void _removeNonNormalizedKeysForBucket(Bucket* bucket);
+    void _removeNonNormalizedKeysForBucket(Stripe* stripe, WithLock stripeLock, Bucket* bucket);
+
+    /**
+     * Aborts the given batch, which the caller must have commit rights for, along with any other
+     * outstanding batches on the same bucket if the bucket is still held by the stripe.
+     */
+    void _abort(Stripe* stripe,
+                WithLock stripeLock,
+                std::shared_ptr<WriteBatch> batch,
+                const boost::optional<Status>& status);
 
     /**
      * Aborts any batches it can for the given bucket, then removes the bucket. If batch is
      * non-null, it is assumed that the caller has commit rights for that batch.
      */
-    void _abort(stdx::unique_lock<Mutex>& lk,
+    void _abort(Stripe* stripe,
+                WithLock stripeLock,
                 Bucket* bucket,
                 std::shared_ptr<WriteBatch> batch,
                 const boost::optional<Status>& status);
 
     /**
-     * Adds the bucket to a list of idle buckets to be expired at a later date
+     * Adds the bucket to the stripe's list of idle buckets to be expired at a later date.
      */
-    void _markBucketIdle(Bucket* bucket);
+    void _markBucketIdle(Stripe* stripe, WithLock stripeLock, Bucket* bucket);
 
     /**
-     * Remove the bucket from the list of idle buckets. The second parameter encodes whether the
-     * caller holds a lock on _idleMutex.
+     * Removes the bucket from the stripe's list of idle buckets.
      */
-    void _markBucketNotIdle(Bucket* bucket, bool locked);
+    void _markBucketNotIdle(Stripe* stripe, WithLock stripeLock, Bucket* bucket);
 
     /**
-     * Verify the bucket is currently unused by taking a lock on it. Must hold exclusive lock from
-     * the outside for the result to be meaningful.
+     * Records that the bucket is closed for compression, if timeseriesBucketCompression is enabled.
+     * The bucket must not have any uncommitted measurements.
      */
-    void _verifyBucketIsUnused(Bucket* bucket) const;
+    void _markBucketClosed(Bucket* bucket);
 
     /**
      * Expires idle buckets until the bucket catalog's memory usage is below the expiry threshold.
+     * The idle buckets of the given stripe are expired first, then those of any other stripe whose
+     * lock is not contended.
      */
-    void _expireIdleBuckets(ExecutionStats* stats);
-
-    std::size_t _numberOfIdleBuckets() const;
+    void _expireIdleBuckets(Stripe* stripe, WithLock stripeLock, ExecutionStats* stats);
 
-    // Allocate a new bucket (and ID) and add it to the catalog
-    Bucket* _allocateBucket(const BucketKey& key,
+    // Allocate a new bucket (and ID) and add it to the stripe.
+    Bucket* _allocateBucket(Stripe* stripe,
+                            WithLock stripeLock,
+                            const BucketKey& key,
                             const Date_t& time,
                             const TimeseriesOptions& options,
                             ExecutionStats* stats,
@@ -687,46 +796,25 @@ private:
     /**
      * Changes the bucket state, taking into account the current state, the specified target state,
      * and allowed state transitions. The return value, if set, is the final state of the bucket
-     * with the given id; if no such bucket exists, the return value will not be set.
+     * with the given id; if no such bucket exists in the stripe, the return value will not be set.
      *
      * Ex. For a bucket with state kPrepared, and a target of kCleared, the return will be
      * kPreparedAndCleared.
      */
-    boost::optional<BucketState> _setBucketState(const OID& id, BucketState target);
-
-    /**
-     * You must hold a lock on _bucketMutex when accessing _allBuckets or _openBuckets.
-     * While holding a lock on _bucketMutex, you can take a lock on an individual bucket, then
-     * release _bucketMutex. Any iterators on the protected structures should be considered invalid
-     * once the lock is released. Any subsequent access to the structures requires relocking
-     * _bucketMutex. You must *not* be holding a lock on a bucket when you attempt to acquire the
-     * lock on _mutex, as this can result in deadlock.
-     *
-     * The StripedMutex class has both shared (read-only) and exclusive (write) locks. If you are
-     * going to write to any of the protected structures, you must hold an exclusive lock.
-     *
-     * Typically, if you want to acquire a bucket, you should use the BucketAccess RAII
-     * class to do so, as it will take care of most of this logic for you. Only use the _bucketMutex
-     * directly for more global maintenance where you want to take the lock once and interact with
-     * multiple buckets atomically.
-     */
-    mutable StripedMutex _bucketMutex;
-
-    // All buckets currently in the catalog, including buckets which are full but not yet committed.
-    stdx::unordered_set<std::unique_ptr<Bucket>> _allBuckets;
-
-    // The current open bucket for each namespace and metadata pair.
-    stdx::unordered_map<BucketKey, Bucket*, BucketHasher, BucketEq> _openBuckets;
+    boost::optional<BucketState> _setBucketState(Stripe* stripe,
+                                                 WithLock stripeLock,
+                                                 const OID& id,
+                                                 BucketState target);
 
-    // Bucket state
-    mutable Mutex _statesMutex = MONGO_MAKE_LATCH("BucketCatalog::_statesMutex");
-    stdx::unordered_map<OID, BucketState, OID::Hasher> _bucketStates;
+    static constexpr std::size_t kNumberOfStripes = 32;
+    std::array<Stripe, kNumberOfStripes> _stripes;
 
-    // This mutex protects access to _idleBuckets
-    mutable Mutex _idleMutex = MONGO_MAKE_LATCH("BucketCatalog::_idleMutex");
+    // This mutex protects access to _closedBuckets. It must not be held while acquiring any other
+    // lock of the catalog.
+    mutable Mutex _closedBucketsMutex = MONGO_MAKE_LATCH("BucketCatalog::_closedBucketsMutex");
 
-    // Buckets that do not have any writers.
-    IdleList _idleBuckets;
+    // Buckets which have been closed but not compressed yet, per namespace.
+    stdx::unordered_map<NamespaceString, ClosedBuckets> _closedBuckets;
 
     /**
      * This mutex protects access to the _executionStats map. Once you complete your lookup, you
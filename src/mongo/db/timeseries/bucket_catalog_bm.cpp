@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 16;  // max number of threads to insert concurrently
+
+/**
+ * Measures the rate at which measurements can be inserted into the bucket catalog by a number of
+ * concurrent writers. Every writer commits the batch it inserted into if no other writer already
+ * claimed it, the same way the insert command does.
+ */
+class BucketCatalogTest : public benchmark::Fixture {
+public:
+    void SetUp(benchmark::State& state) override {
+        if (state.thread_index == 0) {
+            catalog = std::make_unique<BucketCatalog>();
+            options = TimeseriesOptions{"time"};
+            options.setMetaField("meta"_sd);
+            options.setBucketMaxSpanSeconds(3600);
+
+            clients.clear();
+            for (int i = 0; i < state.threads; ++i) {
+                auto client = getGlobalServiceContext()->makeClient(
+                    str::stream() << "test client for thread " << i);
+                auto opCtx = client->makeOperationContext();
+                clients.emplace_back(std::move(client), std::move(opCtx));
+            }
+        }
+    }
+
+    void TearDown(benchmark::State& state) override {
+        state.SetItemsProcessed(state.iterations());
+        if (state.thread_index == 0) {
+            clients.clear();
+            catalog.reset();
+        }
+    }
+
+protected:
+    /**
+     * Inserts a measurement with the given metadata and commits its batch, unless another writer
+     * already claimed it.
+     */
+    void insertAndCommit(benchmark::State& state, const BSONObj& meta, Date_t time) {
+        auto opCtx = clients[state.thread_index].second.get();
+        auto batch = uassertStatusOK(
+            catalog->insert(opCtx,
+                            ns,
+                            nullptr,
+                            options,
+                            BSON("time" << time << "meta" << meta << "value" << 1.0),
+                            BucketCatalog::CombineWithInsertsFromOtherClients::kAllow));
+        if (batch->claimCommitRights() && catalog->prepareCommit(batch)) {
+            catalog->finish(batch, {});
+        }
+    }
+
+    const NamespaceString ns{"test.system.buckets.bm"};
+    TimeseriesOptions options;
+    std::unique_ptr<BucketCatalog> catalog;
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        clients;
+};
+
+BENCHMARK_DEFINE_F(BucketCatalogTest, BM_InsertSameSeries)(benchmark::State& state) {
+    auto meta = BSON("sensor" << 0);
+    auto now = Date_t::now();
+    for (auto keepRunning : state) {
+        insertAndCommit(state, meta, now);
+    }
+}
+
+BENCHMARK_DEFINE_F(BucketCatalogTest, BM_InsertSeriesPerThread)(benchmark::State& state) {
+    auto meta = BSON("sensor" << state.thread_index);
+    auto now = Date_t::now();
+    for (auto keepRunning : state) {
+        insertAndCommit(state, meta, now);
+    }
+}
+
+BENCHMARK_DEFINE_F(BucketCatalogTest, BM_InsertManySeries)(benchmark::State& state) {
+    // Each writer cycles through its own set of series, so that consecutive inserts go to
+    // different buckets.
+    static constexpr int kNumSeriesPerThread = 100;
+    std::vector<BSONObj> metas;
+    for (int i = 0; i < kNumSeriesPerThread; ++i) {
+        metas.push_back(BSON("sensor" << state.thread_index << "id" << i));
+    }
+
+    auto now = Date_t::now();
+    int i = 0;
+    for (auto keepRunning : state) {
+        insertAndCommit(state, metas[i++ % kNumSeriesPerThread], now);
+    }
+}
+
+BENCHMARK_REGISTER_F(BucketCatalogTest, BM_InsertSameSeries)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(BucketCatalogTest, BM_InsertSeriesPerThread)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(BucketCatalogTest, BM_InsertManySeries)->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
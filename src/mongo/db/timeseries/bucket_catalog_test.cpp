@@ -35,9 +35,11 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/timeseries/bucket_catalog.h"
 #include "mongo/db/views/view_catalog.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/bson_test_util.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/unittest/ensure_fcv.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
@@ -224,9 +226,8 @@ TEST_F(BucketCatalogTest, GetMetadataReturnsEmptyDocOnMissingBucket) {
                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
                      .getValue();
     ASSERT(batch->claimCommitRights());
-    auto bucket = batch->bucket();
     _bucketCatalog->abort(batch);
-    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(bucket));
+    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch));
 }
 
 TEST_F(BucketCatalogTest, InsertIntoDifferentBuckets) {
@@ -259,10 +260,10 @@ TEST_F(BucketCatalogTest, InsertIntoDifferentBuckets) {
 
     // Check metadata in buckets.
     ASSERT_BSONOBJ_EQ(BSON(_metaField << "123"),
-                      _bucketCatalog->getMetadata(result1.getValue()->bucket()));
+                      _bucketCatalog->getMetadata(result1.getValue()));
     ASSERT_BSONOBJ_EQ(BSON(_metaField << BSONObj()),
-                      _bucketCatalog->getMetadata(result2.getValue()->bucket()));
-    ASSERT(_bucketCatalog->getMetadata(result3.getValue()->bucket()).isEmpty());
+                      _bucketCatalog->getMetadata(result2.getValue()));
+    ASSERT(_bucketCatalog->getMetadata(result3.getValue()).isEmpty());
 
     // Committing one bucket should only return the one document in that bucket and should not
     // affect the other bucket.
@@ -292,8 +293,8 @@ TEST_F(BucketCatalogTest, InsertNullAndMissingMetaFieldIntoDifferentBuckets) {
 
     // Check metadata in buckets.
     ASSERT_BSONOBJ_EQ(BSON(_metaField << BSONNULL),
-                      _bucketCatalog->getMetadata(result1.getValue()->bucket()));
-    ASSERT(_bucketCatalog->getMetadata(result2.getValue()->bucket()).isEmpty());
+                      _bucketCatalog->getMetadata(result1.getValue()));
+    ASSERT(_bucketCatalog->getMetadata(result2.getValue()).isEmpty());
 
     // Committing one bucket should only return the one document in that bucket and should not
     // affect the other bucket.
@@ -331,6 +332,227 @@ TEST_F(BucketCatalogTest, ClearDatabaseBuckets) {
     _insertOneAndCommit(_ns3, 1);
 }
 
+TEST_F(BucketCatalogTest, ClearNamespaceBucketsForManyMetadataValues) {
+    // Use enough metadata values for the buckets to be spread across the stripes of the catalog.
+    auto insert = [&](const NamespaceString& ns, int meta) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     ns,
+                     _getCollator(ns),
+                     _getTimeseriesOptions(ns),
+                     BSON(_timeField << Date_t::now() << _metaField << meta),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+    for (int i = 0; i < 100; ++i) {
+        _commit(insert(_ns1, i), 0);
+        _commit(insert(_ns2, i), 0);
+    }
+
+    _bucketCatalog->clear(_ns1);
+
+    for (int i = 0; i < 100; ++i) {
+        _commit(insert(_ns1, i), 0);
+        _commit(insert(_ns2, i), 1);
+    }
+}
+
+TEST_F(BucketCatalogTest, InsertWithReorderedMetadataFieldsIntoSameBucket) {
+    auto result1 = _bucketCatalog->insert(
+        _opCtx,
+        _ns1,
+        _getCollator(_ns1),
+        _getTimeseriesOptions(_ns1),
+        BSON(_timeField << Date_t::now() << _metaField
+                        << BSON("a" << 1 << "b" << BSON("c" << 1 << "d" << 2))),
+        BucketCatalog::CombineWithInsertsFromOtherClients::kAllow);
+    auto result2 = _bucketCatalog->insert(
+        _opCtx,
+        _ns1,
+        _getCollator(_ns1),
+        _getTimeseriesOptions(_ns1),
+        BSON(_timeField << Date_t::now() << _metaField
+                        << BSON("b" << BSON("d" << 2 << "c" << 1) << "a" << 1)),
+        BucketCatalog::CombineWithInsertsFromOtherClients::kAllow);
+    ASSERT_EQ(result1.getValue(), result2.getValue());
+    ASSERT_BSONOBJ_EQ(BSON(_metaField << BSON("a" << 1 << "b" << BSON("c" << 1 << "d" << 2))),
+                      _bucketCatalog->getMetadata(result1.getValue()));
+
+    _commit(result1.getValue(), 0, 2);
+}
+
+TEST_F(BucketCatalogTest, ReopenArchivedBucketForLateMeasurement) {
+    RAIIServerParameterControllerForTest controller("timeseriesBucketReopening", true);
+
+    auto insert = [&](Date_t time) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     _ns1,
+                     _getCollator(_ns1),
+                     _getTimeseriesOptions(_ns1),
+                     BSON(_timeField << time << _metaField << 1),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+    auto getStat = [&](StringData name) {
+        BSONObjBuilder builder;
+        _bucketCatalog->appendExecutionStats(_ns1, &builder);
+        return builder.obj().getIntField(name);
+    };
+    auto getNumBucketsReopened = [&] { return getStat("numBucketsReopened"); };
+
+    auto time = Date_t::now();
+    auto batch1 = insert(time);
+    auto bucket1 = batch1->bucket();
+    _commit(batch1, 0);
+
+    // A measurement beyond the time range of the bucket opens a new one.
+    auto batch2 = insert(time + Hours(2));
+    auto bucket2 = batch2->bucket();
+    ASSERT_NE(bucket1, bucket2);
+    _commit(batch2, 0);
+    ASSERT_EQ(0, getNumBucketsReopened());
+
+    // A late measurement goes back into the first bucket, and the one after it into the second.
+    auto batch3 = insert(time + Minutes(1));
+    ASSERT_EQ(bucket1, batch3->bucket());
+    _commit(batch3, 1);
+    ASSERT_EQ(1, getNumBucketsReopened());
+
+    auto batch4 = insert(time + Hours(2) + Minutes(1));
+    ASSERT_EQ(bucket2, batch4->bucket());
+    _commit(batch4, 1);
+    ASSERT_EQ(2, getNumBucketsReopened());
+
+    // The buckets were only archived, never closed.
+    ASSERT_EQ(2, getStat("numBucketsArchivedDueToTimeForward"));
+    ASSERT_EQ(1, getStat("numBucketsArchivedDueToTimeBackward"));
+    ASSERT_EQ(0, getStat("numBucketsClosedDueToTimeForward"));
+    ASSERT_EQ(0, getStat("numBucketsClosedDueToTimeBackward"));
+}
+
+TEST_F(BucketCatalogTest, ClearNamespaceBucketsWithArchivedBuckets) {
+    RAIIServerParameterControllerForTest controller("timeseriesBucketReopening", true);
+
+    auto insert = [&](Date_t time) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     _ns1,
+                     _getCollator(_ns1),
+                     _getTimeseriesOptions(_ns1),
+                     BSON(_timeField << time),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+
+    // Archive more buckets than are kept for a key, so that the oldest ones are closed.
+    auto time = Date_t::now();
+    for (int i = 0; i < 10; ++i) {
+        _commit(insert(time + Hours(2 * i)), 0);
+    }
+
+    _bucketCatalog->clear(_ns1);
+
+    // Nothing is left to reopen.
+    _commit(insert(time), 0);
+    _commit(insert(time + Hours(2)), 0);
+}
+
+TEST_F(BucketCatalogTest, ClosedBucketsAreOnlyTrackedWhenFullyUpgraded) {
+    RAIIServerParameterControllerForTest controller("timeseriesBucketCompression", true);
+
+    auto insert = [&](Date_t time) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     _ns1,
+                     _getCollator(_ns1),
+                     _getTimeseriesOptions(_ns1),
+                     BSON(_timeField << time),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+
+    // Older binaries cannot read compressed buckets, so closed buckets are not compressed before
+    // the featureCompatibilityVersion is upgraded.
+    auto time = Date_t::now();
+    {
+        unittest::EnsureFCV ensureFCV(
+            ServerGlobalParams::FeatureCompatibility::Version::kVersion49);
+        ASSERT_FALSE(BucketCatalog::isBucketCompressionEnabled());
+        _commit(insert(time), 0);
+        _commit(insert(time + Hours(2)), 0);
+        ASSERT(_bucketCatalog->takeClosedBuckets(_ns1).empty());
+    }
+
+    ASSERT_TRUE(BucketCatalog::isBucketCompressionEnabled());
+    _commit(insert(time + Hours(4)), 0);
+    auto closedBuckets = _bucketCatalog->takeClosedBuckets(_ns1);
+    ASSERT_EQ(1U, closedBuckets.size());
+    ASSERT_EQ(1U, closedBuckets.front().numMeasurements);
+}
+
+TEST_F(BucketCatalogTest, ReturnedClosedBucketsAreTakenFirst) {
+    RAIIServerParameterControllerForTest controller("timeseriesBucketCompression", true);
+
+    auto insert = [&](Date_t time) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     _ns1,
+                     _getCollator(_ns1),
+                     _getTimeseriesOptions(_ns1),
+                     BSON(_timeField << time),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+
+    auto time = Date_t::now();
+    auto batch1 = insert(time);
+    auto bucket1 = batch1->bucket()->id();
+    _commit(batch1, 0);
+    auto batch2 = insert(time + Hours(2));
+    auto bucket2 = batch2->bucket()->id();
+    _commit(batch2, 0);
+
+    auto closedBuckets = _bucketCatalog->takeClosedBuckets(_ns1);
+    ASSERT_EQ(1U, closedBuckets.size());
+    ASSERT_EQ(bucket1, closedBuckets.front().bucketId);
+    ASSERT(_bucketCatalog->takeClosedBuckets(_ns1).empty());
+
+    // A bucket closed after the first one was taken comes after it once it is given back.
+    _commit(insert(time + Hours(4)), 0);
+    _bucketCatalog->returnClosedBuckets(_ns1, std::move(closedBuckets));
+    closedBuckets = _bucketCatalog->takeClosedBuckets(_ns1);
+    ASSERT_EQ(2U, closedBuckets.size());
+    ASSERT_EQ(bucket1, closedBuckets[0].bucketId);
+    ASSERT_EQ(bucket2, closedBuckets[1].bucketId);
+}
+
+TEST_F(BucketCatalogTest, NamespacesWithClosedBucketsAreListedUntilTaken) {
+    RAIIServerParameterControllerForTest controller("timeseriesBucketCompression", true);
+
+    auto insert = [&](Date_t time) {
+        return _bucketCatalog
+            ->insert(_opCtx,
+                     _ns1,
+                     _getCollator(_ns1),
+                     _getTimeseriesOptions(_ns1),
+                     BSON(_timeField << time),
+                     BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+            .getValue();
+    };
+
+    ASSERT(_bucketCatalog->getNamespacesWithClosedBuckets().empty());
+
+    auto time = Date_t::now();
+    _commit(insert(time), 0);
+    _commit(insert(time + Hours(2)), 0);
+    ASSERT_EQ(std::vector<NamespaceString>{_ns1}, _bucketCatalog->getNamespacesWithClosedBuckets());
+
+    auto closedBuckets = _bucketCatalog->takeClosedBuckets(_ns1);
+    ASSERT_EQ(1U, closedBuckets.size());
+    ASSERT(_bucketCatalog->getNamespacesWithClosedBuckets().empty());
+}
+
 TEST_F(BucketCatalogTest, InsertBetweenPrepareAndFinish) {
     auto batch1 = _bucketCatalog
                       ->insert(_opCtx,
@@ -396,7 +618,7 @@ TEST_F(BucketCatalogWithoutMetadataTest, GetMetadataReturnsEmptyDoc) {
                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
                      .getValue();
 
-    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch->bucket()));
+    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch));
 
     _commit(batch, 0);
 }
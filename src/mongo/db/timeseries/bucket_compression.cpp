@@ -0,0 +1,254 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/timeseries/minmax.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace timeseries {
+
+namespace {
+
+// Returns the row of a measurement from its field name in a column of an uncompressed bucket.
+boost::optional<size_t> rowIndex(const BSONElement& elem) {
+    return str::parseUnsignedBase10Integer(elem.fieldNameStringData());
+}
+
+// Returns the number of measurements in 'bucketDoc', or boost::none if its data region does not
+// have the expected layout.
+boost::optional<size_t> countMeasurements(const BSONObj& bucketDoc, StringData timeFieldName) {
+    auto timeElem = bucketDoc[kBucketDataFieldName][timeFieldName];
+    if (isCompressedBucket(bucketDoc)) {
+        if (timeElem.type() != BinData || timeElem.binDataType() != BinDataType::Column) {
+            return boost::none;
+        }
+        return BSONColumn(timeElem).size();
+    }
+    if (timeElem.type() != Object) {
+        return boost::none;
+    }
+    return static_cast<size_t>(timeElem.Obj().nFields());
+}
+
+// Appends the values of the data column 'columnElem' to 'builder', numbering its rows from
+// 'offset'. Returns false if the column does not have the expected layout.
+bool appendColumn(const BSONElement& columnElem, size_t offset, BSONObjBuilder* builder) {
+    if (columnElem.type() == BinData && columnElem.binDataType() == BinDataType::Column) {
+        size_t index = 0;
+        for (auto&& value : BSONColumn(columnElem)) {
+            if (!value.eoo()) {
+                builder->appendAs(value, std::to_string(offset + index));
+            }
+            ++index;
+        }
+        return true;
+    }
+
+    if (columnElem.type() != Object) {
+        return false;
+    }
+    for (auto&& value : columnElem.Obj()) {
+        auto index = rowIndex(value);
+        if (!index) {
+            return false;
+        }
+        builder->appendAs(value, std::to_string(offset + *index));
+    }
+    return true;
+}
+
+}  // namespace
+
+boost::optional<BSONObj> compressBucket(const BSONObj& bucketDoc, StringData timeFieldName) {
+    if (isCompressedBucket(bucketDoc)) {
+        return boost::none;
+    }
+
+    auto controlElem = bucketDoc[kBucketControlFieldName];
+    auto dataElem = bucketDoc[kBucketDataFieldName];
+    if (controlElem.type() != Object || dataElem.type() != Object) {
+        return boost::none;
+    }
+    auto timeElem = dataElem.Obj()[timeFieldName];
+    if (timeElem.type() != Object) {
+        return boost::none;
+    }
+
+    // Every measurement has a time, so the time column holds all the rows of the bucket. Order
+    // them on time, which is what makes delta-of-delta encoding of the time column effective.
+    struct Row {
+        Date_t time;
+        size_t index;
+    };
+    std::vector<Row> rows;
+    for (auto&& elem : timeElem.Obj()) {
+        auto index = rowIndex(elem);
+        if (!index || *index != rows.size() || elem.type() != Date) {
+            return boost::none;
+        }
+        rows.push_back({elem.date(), *index});
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& lhs, const Row& rhs) {
+        return lhs.time < rhs.time;
+    });
+
+    BSONObjBuilder builder;
+    for (auto&& elem : bucketDoc) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kBucketControlFieldName) {
+            BSONObjBuilder controlBuilder(builder.subobjStart(kBucketControlFieldName));
+            for (auto&& controlField : elem.Obj()) {
+                auto controlFieldName = controlField.fieldNameStringData();
+                if (controlFieldName == kBucketControlVersionFieldName ||
+                    controlFieldName == kBucketControlCountFieldName) {
+                    continue;
+                }
+                controlBuilder.append(controlField);
+            }
+            controlBuilder.append(kBucketControlVersionFieldName,
+                                  kTimeseriesControlCompressedVersion);
+            controlBuilder.append(kBucketControlCountFieldName, static_cast<int>(rows.size()));
+        } else if (fieldName == kBucketDataFieldName) {
+            BSONObjBuilder dataBuilder(builder.subobjStart(kBucketDataFieldName));
+            std::vector<BSONElement> column(rows.size());
+            for (auto&& columnElem : elem.Obj()) {
+                if (columnElem.type() != Object) {
+                    return boost::none;
+                }
+
+                // Columns other than time may be sparse, so place each value by its row.
+                std::fill(column.begin(), column.end(), BSONElement());
+                for (auto&& value : columnElem.Obj()) {
+                    auto index = rowIndex(value);
+                    if (!index || *index >= column.size()) {
+                        return boost::none;
+                    }
+                    column[*index] = value;
+                }
+
+                BSONColumnBuilder columnBuilder(columnElem.fieldNameStringData());
+                for (auto&& row : rows) {
+                    columnBuilder.append(column[row.index]);
+                }
+                dataBuilder.append(columnBuilder.fieldName(), columnBuilder.finalize());
+            }
+        } else {
+            builder.append(elem);
+        }
+    }
+    return builder.obj();
+}
+
+boost::optional<BSONObj> mergeBuckets(const std::vector<BSONObj>& bucketDocs,
+                                      StringData timeFieldName,
+                                      const StringData::ComparatorInterface* comparator) {
+    if (bucketDocs.empty()) {
+        return boost::none;
+    }
+
+    // The control.min of the merged bucket is the minimum of the buckets' control.min, and
+    // likewise for control.max, so there is no need to look at the measurements themselves.
+    MinMax minOfMins;
+    MinMax maxOfMaxes;
+    std::vector<size_t> offsets;
+    std::vector<StringData> columnNames;
+    size_t numMeasurements = 0;
+    for (auto&& bucketDoc : bucketDocs) {
+        auto controlElem = bucketDoc[kBucketControlFieldName];
+        auto dataElem = bucketDoc[kBucketDataFieldName];
+        if (controlElem.type() != Object || dataElem.type() != Object ||
+            controlElem.Obj()["min"].type() != Object ||
+            controlElem.Obj()["max"].type() != Object) {
+            return boost::none;
+        }
+        auto count = countMeasurements(bucketDoc, timeFieldName);
+        if (!count) {
+            return boost::none;
+        }
+
+        minOfMins.update(controlElem.Obj()["min"].Obj(), boost::none, comparator);
+        maxOfMaxes.update(controlElem.Obj()["max"].Obj(), boost::none, comparator);
+        offsets.push_back(numMeasurements);
+        numMeasurements += *count;
+        for (auto&& columnElem : dataElem.Obj()) {
+            auto name = columnElem.fieldNameStringData();
+            if (std::find(columnNames.begin(), columnNames.end(), name) == columnNames.end()) {
+                columnNames.push_back(name);
+            }
+        }
+    }
+
+    const auto& earliest = bucketDocs.front();
+    BSONObjBuilder builder;
+    builder.append(earliest[kBucketIdFieldName]);
+    {
+        BSONObjBuilder controlBuilder(builder.subobjStart(kBucketControlFieldName));
+        controlBuilder.append(kBucketControlVersionFieldName, kTimeseriesControlDefaultVersion);
+        controlBuilder.append("min", minOfMins.min());
+        controlBuilder.append("max", maxOfMaxes.max());
+    }
+    if (auto metaElem = earliest[kBucketMetaFieldName]) {
+        builder.append(metaElem);
+    }
+    {
+        BSONObjBuilder dataBuilder(builder.subobjStart(kBucketDataFieldName));
+        for (auto&& name : columnNames) {
+            BSONObjBuilder columnBuilder(dataBuilder.subobjStart(name));
+            for (size_t i = 0; i < bucketDocs.size(); ++i) {
+                auto columnElem = bucketDocs[i][kBucketDataFieldName][name];
+                if (columnElem && !appendColumn(columnElem, offsets[i], &columnBuilder)) {
+                    return boost::none;
+                }
+            }
+        }
+    }
+    return compressBucket(builder.obj(), timeFieldName);
+}
+
+bool isCompressedBucket(const BSONObj& bucketDoc) {
+    auto versionElem = bucketDoc[kBucketControlFieldName][kBucketControlVersionFieldName];
+    return versionElem.isNumber() &&
+        versionElem.numberInt() == kTimeseriesControlCompressedVersion;
+}
+
+}  // namespace timeseries
+}  // namespace mongo
@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+namespace timeseries {
+
+/**
+ * Returns a compressed copy of the bucket document 'bucketDoc'. The measurements are sorted on
+ * 'timeFieldName', every column of the data region is stored as a BSONColumn, control.version is
+ * set to 'kTimeseriesControlCompressedVersion' and control.count holds the number of
+ * measurements. All other fields are copied unchanged.
+ *
+ * Returns boost::none if the bucket is already compressed or its data region does not have the
+ * expected layout; the bucket should then be left as it is.
+ */
+boost::optional<BSONObj> compressBucket(const BSONObj& bucketDoc, StringData timeFieldName);
+
+/**
+ * Returns a compressed bucket holding the measurements of all of 'bucketDocs', which must belong to
+ * the same time-series and have the same meta. The first bucket must be the earliest one; the
+ * merged bucket takes its _id and meta, and its control.min and control.max cover all of the
+ * buckets, with strings compared using 'comparator'. The buckets may be compressed or not.
+ *
+ * Returns boost::none if any of the buckets does not have the expected layout.
+ */
+boost::optional<BSONObj> mergeBuckets(const std::vector<BSONObj>& bucketDocs,
+                                      StringData timeFieldName,
+                                      const StringData::ComparatorInterface* comparator);
+
+/**
+ * Returns whether the data region of 'bucketDoc' is stored as BSONColumns.
+ */
+bool isCompressedBucket(const BSONObj& bucketDoc);
+
+}  // namespace timeseries
+}  // namespace mongo
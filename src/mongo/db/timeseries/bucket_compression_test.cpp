@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/unittest/bson_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::timeseries {
+namespace {
+
+constexpr StringData kTimeFieldName = "time"_sd;
+
+// Decodes every value of the BSONColumn 'elem' into an array, with null in place of a missing
+// value.
+BSONArray decodeColumn(const BSONElement& elem) {
+    BSONArrayBuilder builder;
+    BSONColumn column(elem);
+    for (auto&& value : column) {
+        if (value.eoo()) {
+            builder.appendNull();
+        } else {
+            builder.append(value);
+        }
+    }
+    return builder.arr();
+}
+
+Date_t date(long long millis) {
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+TEST(BucketCompression, CompressesColumnsInTimeOrder) {
+    auto bucket = BSON("_id" << OID::gen() << "control"
+                             << BSON("version" << 1 << "min" << BSON("time" << date(1000))
+                                               << "max" << BSON("time" << date(3000)))
+                             << "meta"
+                             << "sensor"
+                             << "data"
+                             << BSON("time" << BSON("0" << date(3000) << "1" << date(1000) << "2"
+                                                        << date(2000))
+                                            << "a" << BSON("0" << 3 << "1" << 1 << "2" << 2)));
+
+    auto compressed = compressBucket(bucket, kTimeFieldName);
+    ASSERT(compressed);
+    ASSERT(isCompressedBucket(*compressed));
+
+    ASSERT_EQ((*compressed)["_id"].OID(), bucket["_id"].OID());
+    ASSERT_EQ((*compressed)["meta"].String(), "sensor");
+    ASSERT_BSONOBJ_EQ((*compressed)["control"].Obj(),
+                      BSON("min" << BSON("time" << date(1000)) << "max"
+                                 << BSON("time" << date(3000)) << "version"
+                                 << kTimeseriesControlCompressedVersion << "count" << 3));
+
+    auto data = (*compressed)["data"].Obj();
+    ASSERT_EQ(data["time"].type(), BinData);
+    ASSERT_EQ(data["time"].binDataType(), Column);
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["time"]),
+                      BSON_ARRAY(date(1000) << date(2000) << date(3000)));
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["a"]), BSON_ARRAY(1 << 2 << 3));
+}
+
+TEST(BucketCompression, SparseColumnsKeepMissingValues) {
+    auto bucket = fromjson(
+        "{control: {version: 1}, data: {time: {'0': {$date: 2000}, '1': {$date: 1000}, '2': "
+        "{$date: 3000}}, a: {'0': 'x'}, b: {'1': 1, '2': 2}}}");
+
+    auto compressed = compressBucket(bucket, kTimeFieldName);
+    ASSERT(compressed);
+    ASSERT_EQ((*compressed)["control"]["count"].numberInt(), 3);
+
+    auto data = (*compressed)["data"].Obj();
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["a"]), BSON_ARRAY(BSONNULL << "x" << BSONNULL));
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["b"]), BSON_ARRAY(1 << BSONNULL << 2));
+}
+
+TEST(BucketCompression, AlreadyCompressedBucketIsNotCompressedAgain) {
+    auto bucket = fromjson("{control: {version: 1}, data: {time: {'0': {$date: 1000}}}}");
+    auto compressed = compressBucket(bucket, kTimeFieldName);
+    ASSERT(compressed);
+    ASSERT_FALSE(compressBucket(*compressed, kTimeFieldName));
+}
+
+TEST(BucketCompression, MalformedBucketIsNotCompressed) {
+    ASSERT_FALSE(compressBucket(fromjson("{control: {version: 1}}"), kTimeFieldName));
+    ASSERT_FALSE(compressBucket(fromjson("{control: {version: 1}, data: {a: {'0': 1}}}"),
+                                kTimeFieldName));
+    ASSERT_FALSE(compressBucket(fromjson("{control: {version: 1}, data: {time: {'0': 1}}}"),
+                                kTimeFieldName));
+    ASSERT_FALSE(compressBucket(
+        fromjson("{control: {version: 1}, data: {time: {'1': {$date: 1000}}}}"), kTimeFieldName));
+    ASSERT_FALSE(compressBucket(
+        fromjson(
+            "{control: {version: 1}, data: {time: {'0': {$date: 1000}}, a: {'0': 1, '1': 2}}}"),
+        kTimeFieldName));
+}
+
+TEST(BucketCompression, MergesBucketsIntoEarliest) {
+    auto first = fromjson(
+        "{_id: {$oid: '0000000a0000000000000000'}, control: {version: 1, min: {time: {$date: "
+        "1000}, a: 1}, max: {time: {$date: 2000}, a: 5}}, meta: 'sensor', data: {time: {'0': "
+        "{$date: 2000}, '1': {$date: 1000}}, a: {'0': 5, '1': 1}}}");
+    auto second = compressBucket(
+        fromjson("{_id: {$oid: '0000000b0000000000000000'}, control: {version: 1, min: {time: "
+                 "{$date: 3000}, a: 0, b: 'x'}, max: {time: {$date: 4000}, a: 2, b: 'x'}}, meta: "
+                 "'sensor', data: {time: {'0': {$date: 4000}, '1': {$date: 3000}}, a: {'0': 2, "
+                 "'1': 0}, b: {'1': 'x'}}}"),
+        kTimeFieldName);
+    ASSERT(second);
+
+    auto merged = mergeBuckets({first, *second}, kTimeFieldName, nullptr);
+    ASSERT(merged);
+    ASSERT(isCompressedBucket(*merged));
+    ASSERT_EQ((*merged)["_id"].OID(), first["_id"].OID());
+    ASSERT_EQ((*merged)["meta"].str(), "sensor");
+    ASSERT_EQ((*merged)["control"]["count"].numberInt(), 4);
+    ASSERT_BSONOBJ_EQ((*merged)["control"]["min"].Obj(),
+                      BSON("time" << date(1000) << "a" << 0 << "b"
+                                  << "x"));
+    ASSERT_BSONOBJ_EQ((*merged)["control"]["max"].Obj(),
+                      BSON("time" << date(4000) << "a" << 5 << "b"
+                                  << "x"));
+
+    auto data = (*merged)["data"].Obj();
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["time"]),
+                      BSON_ARRAY(date(1000) << date(2000) << date(3000) << date(4000)));
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["a"]), BSON_ARRAY(1 << 5 << 0 << 2));
+    ASSERT_BSONOBJ_EQ(decodeColumn(data["b"]),
+                      BSON_ARRAY(BSONNULL << BSONNULL << "x" << BSONNULL));
+}
+
+TEST(BucketCompression, MalformedBucketIsNotMerged) {
+    auto bucket = fromjson(
+        "{control: {version: 1, min: {time: {$date: 1000}}, max: {time: {$date: 1000}}}, data: "
+        "{time: {'0': {$date: 1000}}}}");
+    ASSERT(mergeBuckets({bucket, bucket}, kTimeFieldName, nullptr));
+    ASSERT_FALSE(mergeBuckets({}, kTimeFieldName, nullptr));
+    ASSERT_FALSE(mergeBuckets({bucket, fromjson("{control: {version: 1}, data: {time: {}}}")},
+                              kTimeFieldName,
+                              nullptr));
+    ASSERT_FALSE(mergeBuckets(
+        {bucket,
+         fromjson("{control: {version: 1, min: {}, max: {}}, data: {time: {'x': {$date: 1000}}}}")},
+        kTimeFieldName,
+        nullptr));
+}
+
+}  // namespace
+}  // namespace mongo::timeseries
@@ -43,6 +43,13 @@ static constexpr StringData kBucketMetaFieldName = "meta"_sd;
 static constexpr StringData kBucketControlFieldName = "control"_sd;
 static constexpr StringData kControlMaxFieldNamePrefix = "control.max."_sd;
 static constexpr StringData kControlMinFieldNamePrefix = "control.min."_sd;
+static constexpr StringData kBucketControlVersionFieldName = "version"_sd;
+static constexpr StringData kBucketControlCountFieldName = "count"_sd;
+
+// Values of control.version. Compressed buckets store each column of their data region as a
+// BSONColumn and record their number of measurements in control.count.
+static constexpr int kTimeseriesControlDefaultVersion = 1;
+static constexpr int kTimeseriesControlCompressedVersion = 2;
 
 // These are hard-coded field names in create collection for time-series collections.
 static constexpr StringData kTimeFieldName = "timeField"_sd;
@@ -219,10 +219,22 @@ mongo::BSONArray MockRemoteDBServer::query(MockRemoteDBServer::InstanceID id,
     scoped_spinlock sLock(_lock);
     _queryCount++;
 
+    // The inclusive lower and exclusive upper bounds set by Query::minKey() and Query::maxKey().
+    const auto minKey = query.obj["$min"];
+    const auto maxKey = query.obj["$max"];
+
     auto ns = nsOrUuid.uuid() ? _uuidToNs[*nsOrUuid.uuid()] : nsOrUuid.nss()->ns();
     const vector<BSONObj>& coll = _dataMgr[ns];
     BSONArrayBuilder result;
     for (vector<BSONObj>::const_iterator iter = coll.begin(); iter != coll.end(); ++iter) {
+        if (minKey.isABSONObj() && iter->extractFieldsUndotted(minKey.Obj())
+                                           .woCompare(minKey.Obj(), BSONObj(), false) < 0) {
+            continue;
+        }
+        if (maxKey.isABSONObj() && iter->extractFieldsUndotted(maxKey.Obj())
+                                           .woCompare(maxKey.Obj(), BSONObj(), false) >= 0) {
+            continue;
+        }
         result.append(project(projectionExecutor.get(), *iter));
     }
 
@@ -164,6 +164,10 @@ public:
     //
     rpc::UniqueReply runCommand(InstanceID id, const OpMsgRequest& request);
 
+    /**
+     * Returns the documents of the collection. The filter of 'query' is ignored, only its $min and
+     * $max index bounds are applied to the fields they name.
+     */
     mongo::BSONArray query(InstanceID id,
                            const NamespaceStringOrUUID& nsOrUuid,
                            mongo::Query query = mongo::Query(),
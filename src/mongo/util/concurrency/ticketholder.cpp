@@ -27,236 +27,236 @@
  *    it in the license file.
  */
 
-#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
-
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
+#include <boost/optional.hpp>
 
-#include "mongo/logv2/log.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
-
-#if defined(__linux__)
 namespace {
 
-/**
- * Accepts an errno code, prints its error message, and exits.
- */
-void failWithErrno(int err) {
-    LOGV2_FATAL(28604,
-                "error in Ticketholder: {errnoWithDescription_err}",
-                "errnoWithDescription_err"_attr = errnoWithDescription(err));
-}
-
-/*
- * Checks the return value from a Linux semaphore function call, and fails with the set errno if the
- * call was unsucessful.
- */
-void check(int ret) {
-    if (ret == 0)
-        return;
-    failWithErrno(errno);
+StringData laneName(size_t lane) {
+    switch (static_cast<TicketLane>(lane)) {
+        case TicketLane::kReplication:
+            return "replication"_sd;
+        case TicketLane::kInternal:
+            return "internal"_sd;
+        case TicketLane::kShortRead:
+            return "shortRead"_sd;
+        case TicketLane::kUser:
+            return "user"_sd;
+    }
+    MONGO_UNREACHABLE;
 }
 
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
-}
 }  // namespace
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
-    check(sem_init(&_sem, 0, num));
-}
+TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
 
-TicketHolder::~TicketHolder() {
-    check(sem_destroy(&_sem));
-}
+TicketHolder::~TicketHolder() = default;
 
 bool TicketHolder::tryAcquire() {
-    while (0 != sem_trywait(&_sem)) {
-        if (errno == EAGAIN)
-            return false;
-        if (errno != EINTR)
-            failWithErrno(errno);
+    // Operations that are already queued take precedence, which keeps the queues FIFO.
+    if (_numWaiters.load() > 0) {
+        return false;
     }
-    return true;
+    return _tryAcquireTicket();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::waitForTicket(OperationContext* opCtx, TicketLane lane) {
+    invariant(waitForTicketUntil(opCtx, Date_t::max(), lane));
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until, TicketLane lane) {
+    if (tryAcquire()) {
         return true;
     }
 
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
+    stdx::unique_lock<Latch> lk(_mutex);
+    Waiter waiter;
+    auto& queue = _queues[static_cast<size_t>(lane)];
+    auto it = queue.insert(queue.end(), &waiter);
+
+    // A release() which does not see this waiter returned its ticket to '_num' before, so that
+    // _dispatch() hands it over here. Any later release() dispatches the ticket itself.
+    _numWaiters.fetchAndAdd(1);
+    _dispatch(lk);
+    if (waiter.isGranted) {
+        return true;
+    }
+    _totalWaits.fetchAndAddRelaxed(1);
+
+    Timer timer;
+    bool acquired = false;
+    try {
+        auto isGranted = [&] { return waiter.isGranted; };
+        if (opCtx) {
+            acquired =
+                opCtx->waitForConditionOrInterruptUntil(waiter.granted, lk, until, isGranted);
+        } else if (until == Date_t::max()) {
+            waiter.granted.wait(lk, isGranted);
+            acquired = true;
+        } else {
+            acquired = waiter.granted.wait_until(lk, until.toSystemTimePoint(), isGranted);
+        }
+    } catch (...) {
+        // A ticket handed to this waiter just as it got interrupted goes to the next waiter.
+        if (waiter.isGranted) {
+            _num.fetchAndAdd(1);
+            _dispatch(lk);
+        } else {
+            queue.erase(it);
+            _numWaiters.fetchAndSubtract(1);
         }
+        _recordWait(lk, lane, Microseconds(timer.micros()), false);
+        throw;
+    }
 
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
+    if (!acquired) {
+        queue.erase(it);
+        _numWaiters.fetchAndSubtract(1);
     }
-    return true;
+    _recordWait(lk, lane, Microseconds(timer.micros()), acquired);
+    return acquired;
 }
 
 void TicketHolder::release() {
-    check(sem_post(&_sem));
+    _totalReleased.fetchAndAddRelaxed(1);
+    _releaseTicket();
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_resizeMutex);
-
     if (newSize < 5)
         return Status(ErrorCodes::BadValue,
-                      str::stream() << "Minimum value for semaphore is 5; given " << newSize);
+                      str::stream() << "Minimum value for tickets is 5; given " << newSize);
 
-    if (newSize > SEM_VALUE_MAX)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
-                                    << "; given " << newSize);
-
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
-    }
+    stdx::lock_guard<Latch> lk(_mutex);
 
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
-    }
+    // Tickets are added and removed without going through release() so that resizing does not
+    // count towards totalReleased().
+    _num.fetchAndAdd(newSize - _outof.load());
+    _outof.store(newSize);
+    _dispatch(lk);
 
-    invariant(_outof.load() == newSize);
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    int val = 0;
-    check(sem_getvalue(&_sem, &val));
-    return val;
+    return std::max(_num.load(), 0);
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    return outof() - _num.load();
 }
 
 int TicketHolder::outof() const {
     return _outof.load();
 }
 
-#else
-
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
-
-TicketHolder::~TicketHolder() = default;
-
-bool TicketHolder::tryAcquire() {
+void TicketHolder::appendLaneStats(BSONObjBuilder* builder) const {
     stdx::lock_guard<Latch> lk(_mutex);
-    return _tryAcquire();
-}
-
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<Latch> lk(_mutex);
-
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    for (size_t lane = 0; lane < kNumLanes; ++lane) {
+        const auto& stats = _laneStats[lane];
+        BSONObjBuilder laneBuilder(builder->subobjStart(laneName(lane)));
+        laneBuilder.append("queued", static_cast<int>(_queues[lane].size()));
+        laneBuilder.append("waits", stats.waits);
+        laneBuilder.append("timeouts", stats.timeouts);
+        laneBuilder.append("totalWaitMicros", stats.totalWaitMicros);
+
+        // Only the buckets that counted any wait are appended, to minimize the data in FTDC.
+        BSONArrayBuilder histogramBuilder(laneBuilder.subarrayStart("histogram"));
+        for (size_t i = 0; i < kNumWaitTimeBuckets; ++i) {
+            if (stats.waitTimeBuckets[i] == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("micros", i == 0 ? 0LL : 1LL << (i - 1));
+            entryBuilder.append("count", stats.waitTimeBuckets[i]);
+        }
     }
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
-
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+bool TicketHolder::_tryAcquireTicket() {
+    auto num = _num.load();
+    while (num > 0) {
+        if (_num.compareAndSwap(&num, num - 1)) {
+            return true;
+        }
     }
+    return false;
 }
 
-void TicketHolder::release() {
-    {
+void TicketHolder::_releaseTicket() {
+    // While the pool is shrunk below the number of tickets in use, '_num' is negative and the
+    // released ticket leaves the pool.
+    _num.fetchAndAdd(1);
+
+    // A waiter registers itself before it checks '_num' again, so either this sees the waiter or
+    // the waiter sees the ticket.
+    if (_numWaiters.load() > 0) {
         stdx::lock_guard<Latch> lk(_mutex);
-        _num++;
+        _dispatch(lk);
     }
-    _newTicket.notify_one();
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_mutex);
-
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        LOGV2(23120, "{errmsg}", "errmsg"_attr = errmsg);
-        return Status(ErrorCodes::BadValue, errmsg);
+void TicketHolder::_dispatch(WithLock lk) {
+    while (_numWaiters.load() > 0 && _tryAcquireTicket()) {
+        auto& queue = _queues[_nextLane(lk)];
+        auto waiter = queue.front();
+        queue.pop_front();
+        _numWaiters.fetchAndSubtract(1);
+        waiter->isGranted = true;
+        // The waiter may return as soon as it observes 'isGranted', so it is notified while
+        // holding the mutex which keeps it alive.
+        waiter->granted.notify_one();
     }
-
-    _outof.store(newSize);
-    _num = _outof.load() - used;
-
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
-    return Status::OK();
 }
 
-int TicketHolder::available() const {
-    return _num;
+size_t TicketHolder::_nextLane(WithLock) {
+    boost::optional<size_t> highest;
+    boost::optional<size_t> bypassedTooOften;
+    for (size_t lane = 0; lane < kNumLanes; ++lane) {
+        if (_queues[lane].empty()) {
+            continue;
+        }
+        if (!highest) {
+            highest = lane;
+        } else if (!bypassedTooOften && _bypasses[lane] >= kMaxLaneBypasses) {
+            bypassedTooOften = lane;
+        }
+    }
+    invariant(highest);
+
+    const size_t next = bypassedTooOften ? *bypassedTooOften : *highest;
+    for (size_t lane = 0; lane < kNumLanes; ++lane) {
+        if (lane == next || _queues[lane].empty()) {
+            _bypasses[lane] = 0;
+        } else {
+            _bypasses[lane]++;
+        }
+    }
+    return next;
 }
 
-int TicketHolder::used() const {
-    return outof() - _num;
-}
+void TicketHolder::_recordWait(WithLock, TicketLane lane, Microseconds waited, bool acquired) {
+    auto& stats = _laneStats[static_cast<size_t>(lane)];
+    const auto micros = durationCount<Microseconds>(waited);
+    stats.waits++;
+    if (!acquired) {
+        stats.timeouts++;
+    }
+    stats.totalWaitMicros += micros;
 
-int TicketHolder::outof() const {
-    return _outof.load();
+    const size_t bucket = micros <= 0 ? 0 : 64 - countLeadingZeros64(micros);
+    stats.waitTimeBuckets[std::min(bucket, kNumWaitTimeBuckets - 1)]++;
 }
 
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
-        return false;
-    }
-    _num--;
-    return true;
-}
-#endif
 }  // namespace mongo
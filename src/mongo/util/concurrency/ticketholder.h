@@ -28,24 +28,40 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <array>
+#include <list>
 
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/ticket_lane.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * A pool of tickets which limits the number of operations running concurrently. While nobody waits,
+ * tickets are acquired and released with atomic operations only. Operations which cannot get a
+ * ticket immediately wait in the queue of their TicketLane. A released ticket is handed directly to
+ * the operation which waited the longest in the highest-priority lane that has any waiter, so that
+ * neither newly arriving operations nor operations in lower-priority lanes can overtake it. To keep
+ * higher-priority lanes from starving the others, a lane with waiters gets the ticket once it was
+ * passed over kMaxLaneBypasses times in a row.
+ */
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    static constexpr size_t kNumLanes = 4;
+    static constexpr int kMaxLaneBypasses = 8;
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
@@ -56,7 +72,7 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, TicketLane lane = TicketLane::kUser);
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,12 +84,18 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            TicketLane lane = TicketLane::kUser);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
     void release();
 
+    /**
+     * Changes the number of tickets. Shrinking the pool does not wait for the tickets in use to be
+     * released; the pool absorbs the excess tickets as they are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -82,22 +104,93 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of tickets released since this TicketHolder was created. Along with
+     * totalWaits(), this lets callers that periodically sample the TicketHolder derive its
+     * throughput and whether operations had to queue for tickets.
+     */
+    long long totalReleased() const {
+        return _totalReleased.loadRelaxed();
+    }
+
+    /**
+     * Returns the number of acquisitions which could not be satisfied immediately and had to wait
+     * for a ticket to be released.
+     */
+    long long totalWaits() const {
+        return _totalWaits.loadRelaxed();
+    }
+
+    /**
+     * Appends, for every lane, the number of operations queued in it and a histogram of the time
+     * operations which had to wait spent queued in it.
+     */
+    void appendLaneStats(BSONObjBuilder* builder) const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
+    // Waits of at least 2^(i-1) and less than 2^i microseconds are counted in bucket i. The last
+    // bucket counts all longer waits.
+    static constexpr size_t kNumWaitTimeBuckets = 24;
+
+    struct Waiter {
+        stdx::condition_variable granted;
+        bool isGranted = false;
+    };
+
+    struct LaneStats {
+        long long waits = 0;
+        long long timeouts = 0;
+        long long totalWaitMicros = 0;
+        std::array<long long, kNumWaitTimeBuckets> waitTimeBuckets{};
+    };
 
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicWord<int> _outof;
-    Mutex _resizeMutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
-#else
-    bool _tryAcquire();
+    /**
+     * Takes a ticket from '_num' if one is available, regardless of whether anybody waits.
+     */
+    bool _tryAcquireTicket();
+
+    /**
+     * Returns a ticket to '_num' and, if anybody waits, hands it over with _dispatch().
+     */
+    void _releaseTicket();
+
+    /**
+     * Hands tickets available in '_num' to waiters for as long as there are both.
+     */
+    void _dispatch(WithLock);
+
+    /**
+     * Returns the lane whose first waiter gets the next ticket. At least one lane must have
+     * waiters.
+     */
+    size_t _nextLane(WithLock);
+
+    void _recordWait(WithLock, TicketLane lane, Microseconds waited, bool acquired);
 
+    AtomicWord<long long> _totalReleased{0};
+    AtomicWord<long long> _totalWaits{0};
+
+    // You can read _outof without a lock, but have to hold _mutex to change.
     AtomicWord<int> _outof;
-    int _num;
-    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
-    stdx::condition_variable _newTicket;
-#endif
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
+
+    // The number of tickets in the pool. It is negative while the pool was shrunk by more than the
+    // number of tickets available at the time. Tickets are taken from and returned to it without
+    // holding _mutex.
+    AtomicWord<int> _num;
+
+    // The number of operations in '_queues'. Only changed while holding _mutex, but read without it
+    // to decide whether acquiring or releasing a ticket has to take _mutex.
+    AtomicWord<int> _numWaiters{0};
+
+    std::array<std::list<Waiter*>, kNumLanes> _queues;
+
+    // For every lane, the number of tickets in a row which went to other lanes while it had
+    // waiters.
+    std::array<int, kNumLanes> _bypasses{};
+    std::array<LaneStats, kNumLanes> _laneStats;
 };
 
 class ScopedTicket {
@@ -32,8 +32,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -72,4 +76,155 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+/**
+ * Waits until 'numQueued' operations queue for tickets of 'holder' in the lane named 'lane'.
+ */
+void waitUntilQueued(const TicketHolder& holder, StringData lane, int numQueued) {
+    while (true) {
+        BSONObjBuilder builder;
+        holder.appendLaneStats(&builder);
+        if (builder.obj()[lane]["queued"].numberInt() == numQueued) {
+            return;
+        }
+        sleepmillis(1);
+    }
+}
+
+/**
+ * Runs a thread which waits for a ticket in 'lane', records 'id' in 'order' once it got one, and
+ * releases the ticket again.
+ */
+stdx::thread waitForTicketInThread(TicketHolder* holder,
+                                   TicketLane lane,
+                                   int id,
+                                   Mutex* mutex,
+                                   std::vector<int>* order) {
+    return stdx::thread([=] {
+        holder->waitForTicket(nullptr, lane);
+        {
+            stdx::lock_guard<Latch> lk(*mutex);
+            order->push_back(id);
+        }
+        holder->release();
+    });
+}
+
+TEST(TicketholderTest, WaitersOfALaneAcquireTicketsInFIFOOrder) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<int> order;
+    std::vector<stdx::thread> threads;
+    for (int id = 0; id < 3; ++id) {
+        threads.push_back(waitForTicketInThread(&holder, TicketLane::kUser, id, &mutex, &order));
+        waitUntilQueued(holder, "user", id + 1);
+    }
+
+    // A queued waiter takes precedence over operations that did not queue yet.
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(std::vector<int>({0, 1, 2}), order);
+    ASSERT_EQ(holder.available(), 1);
+}
+
+TEST(TicketholderTest, HigherPriorityLanesAcquireTicketsFirst) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<int> order;
+    std::vector<stdx::thread> threads;
+    threads.push_back(waitForTicketInThread(&holder, TicketLane::kUser, 0, &mutex, &order));
+    waitUntilQueued(holder, "user", 1);
+    threads.push_back(waitForTicketInThread(&holder, TicketLane::kShortRead, 1, &mutex, &order));
+    waitUntilQueued(holder, "shortRead", 1);
+    threads.push_back(waitForTicketInThread(&holder, TicketLane::kInternal, 2, &mutex, &order));
+    waitUntilQueued(holder, "internal", 1);
+    threads.push_back(waitForTicketInThread(&holder, TicketLane::kReplication, 3, &mutex, &order));
+    waitUntilQueued(holder, "replication", 1);
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(std::vector<int>({3, 2, 1, 0}), order);
+}
+
+TEST(TicketholderTest, LanesPassedOverTooOftenAcquireTheNextTicket) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<int> order;
+    std::vector<stdx::thread> threads;
+    const int kUserId = -1;
+    threads.push_back(waitForTicketInThread(&holder, TicketLane::kUser, kUserId, &mutex, &order));
+    waitUntilQueued(holder, "user", 1);
+    for (int id = 0; id <= TicketHolder::kMaxLaneBypasses; ++id) {
+        threads.push_back(
+            waitForTicketInThread(&holder, TicketLane::kReplication, id, &mutex, &order));
+        waitUntilQueued(holder, "replication", id + 1);
+    }
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The user lane gets the ticket after being passed over kMaxLaneBypasses times, even though
+    // the replication lane still has a waiter.
+    std::vector<int> expected;
+    for (int id = 0; id < TicketHolder::kMaxLaneBypasses; ++id) {
+        expected.push_back(id);
+    }
+    expected.push_back(kUserId);
+    expected.push_back(TicketHolder::kMaxLaneBypasses);
+    ASSERT_EQ(expected, order);
+}
+
+TEST(TicketholderTest, ShrinkingBelowTicketsInUseAbsorbsReleasedTickets) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.outof(), 5);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_EQ(holder.used(), 8);
+
+    for (int i = 0; i < 3; ++i) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.used(), 4);
+}
+
+TEST(TicketholderTest, RecordsWaitsPerLane) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(nullptr, Date_t::now(), TicketLane::kInternal));
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendLaneStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats["internal"]["waits"].numberLong(), 1);
+    ASSERT_EQ(stats["internal"]["timeouts"].numberLong(), 1);
+    ASSERT_EQ(stats["internal"]["histogram"].Array().size(), 1U);
+    ASSERT_EQ(stats["user"]["waits"].numberLong(), 0);
+    ASSERT_EQ(stats["user"]["histogram"].Array().size(), 0U);
+    ASSERT_EQ(holder.totalWaits(), 1);
+    ASSERT_EQ(holder.totalReleased(), 1);
+}
 }  // namespace